@@ -1,7 +1,16 @@
 #pragma once
 
-#if !defined(_WIN32) && !defined(_WIN64)
-	#error GG Only Can support Windows!
+#if defined(_WIN32) || defined(_WIN64)
+	#define GG_PLATFORM_WINDOWS
+#elif defined(__linux__)
+	#define GG_PLATFORM_LINUX
+#else
+	#error GG Only Can support Windows and Linux!
+#endif
+
+// The windowed backend needs Win32 and Vulkan, everything else also builds headless.
+#if defined(GG_PLATFORM_WINDOWS) && defined(GG_GRAPHICS_API_VULKAN)
+	#define GG_WINDOWED_BACKEND
 #endif
 
 
@@ -19,6 +28,19 @@
 #include <cstdint>
 #include <cassert>
 
+// Scoped zones of the Profiler, the build turns them off with GG_PROFILER_DISABLED.
+#ifndef GG_PROFILER_DISABLED
+	#define GG_PROFILER_ENABLED
+#endif
+
+#ifdef _MSC_VER
+	#define GG_DEBUG_BREAK()	__debugbreak()
+	#define GG_UNREACHABLE()	__assume(0)
+#else
+	#define GG_DEBUG_BREAK()	__builtin_trap()
+	#define GG_UNREACHABLE()	__builtin_unreachable()
+#endif
+
 
 typedef int8_t int8;
 typedef uint8_t uint8;
@@ -52,21 +74,21 @@ typedef uint64_t uint64;
 #endif
 
 #ifdef GG_ASSERTION_ENABLED
-#define GG_ASSERT(x, ...) do { if(!(x)) { GG_CRITICAL("Assertion failed: {0} in {1}(Line: {2})", __VA_ARGS__, __FILE__, __LINE__); __debugbreak(); } } while(0);
-#define GG_ASSERT_WITHOUG_MESSAGE(x) do { if(!(x)) { GG_CRITICAL("Assertion faled: {0} (Line: {1})", __FILE__, __LINE__); __debugbreak(); } } while(0);
+#define GG_ASSERT(x, ...) do { if(!(x)) { GG_CRITICAL("Assertion failed: {0} in {1}(Line: {2})", __VA_ARGS__, __FILE__, __LINE__); GG_DEBUG_BREAK(); } } while(0);
+#define GG_ASSERT_WITHOUG_MESSAGE(x) do { if(!(x)) { GG_CRITICAL("Assertion faled: {0} (Line: {1})", __FILE__, __LINE__); GG_DEBUG_BREAK(); } } while(0);
 #define GG_NEVER_HAPPEN static_assert(false);
 
 #define GG_ASSERT_WITH_ERROR_CODE(x) \
 	do\
 	{\
 		GG_CRITICAL("Assertion failed: ErrorCode{0} in {1}(line: {2})", GetLastError(), __FILE__, __LINE__);\
-		__debugbreak();\
+		GG_DEBUG_BREAK();\
 	} while (0);
 
 #else
 #define GG_ASSERT(x, ...)
 #define GG_ASSERT_WITHOUT_MESSAEG(x) 
-#define GG_NEVER_HAPPEN	__assume(0);
+#define GG_NEVER_HAPPEN	GG_UNREACHABLE();
 #define GG_ASSERT_WITH_ERROR_CODE
 
 #endif
\ No newline at end of file
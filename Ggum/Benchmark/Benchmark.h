@@ -0,0 +1,148 @@
+#pragma once
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <functional>
+#include <random>
+#include <vector>
+
+#include "Base.hpp"
+#include "Renderer/Rasterizer.h"
+
+namespace Benchmark {
+
+// Runs func until at least minSeconds have passed and returns the average seconds per call.
+inline double Measure(const std::function<void()>& func, double minSeconds = 0.5)
+{
+	using Clock = std::chrono::steady_clock;
+
+	// Warm up caches and lazily selected kernels.
+	func();
+
+	uint64 iterations = 0;
+	auto start = Clock::now();
+	double elapsed = 0.0;
+	do
+	{
+		func();
+		iterations++;
+		elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+	} while (elapsed < minSeconds);
+
+	return elapsed / static_cast<double>(iterations);
+}
+
+inline void ReportPixels(const char* name, double secondsPerCall, double pixelsPerCall)
+{
+	double mpixPerSecond = pixelsPerCall / secondsPerCall * 1e-6;
+	double gbPerSecond = pixelsPerCall * sizeof(uint32) / secondsPerCall * 1e-9;
+	std::printf("  %-40s %10.3f ms %12.1f Mpix/s %8.2f GB/s\n", name, secondsPerCall * 1e3, mpixPerSecond, gbPerSecond);
+}
+
+inline void ReportTriangles(const char* name, double secondsPerCall, double trianglesPerCall, double pixelsPerCall)
+{
+	double mtrisPerSecond = trianglesPerCall / secondsPerCall * 1e-6;
+	double mpixPerSecond = pixelsPerCall / secondsPerCall * 1e-6;
+	std::printf("  %-40s %10.3f ms %10.2f Mtri/s %10.1f Mpix/s\n", name, secondsPerCall * 1e3, mtrisPerSecond, mpixPerSecond);
+}
+
+inline void ReportVertices(const char* name, double secondsPerCall, double verticesPerCall)
+{
+	double mvertsPerSecond = verticesPerCall / secondsPerCall * 1e-6;
+	std::printf("  %-40s %10.3f ms %10.1f Mvert/s\n", name, secondsPerCall * 1e3, mvertsPerSecond);
+}
+
+struct Triangle
+{
+	GG::RasterVertex v[3];
+	uint32 color;
+};
+
+// Shape of the triangles made by MakeTriangles().
+struct TriangleSceneDesc
+{
+	uint32 width = 1920;
+	uint32 height = 1080;
+	// Diameter of the circle the corners lie on, uniform in [minSize, maxSize].
+	float minSize = 8.0f;
+	float maxSize = 64.0f;
+	// One in largeInterval triangles gets largeSize instead, 0 for none.
+	uint32 largeInterval = 0;
+	float largeSize = 400.0f;
+	// Distance of the centers from the edges, negative to cross them.
+	float margin = 0.0f;
+	// Random offset of each corner from an equilateral triangle in radians, keeps the triangles from degenerating into slivers.
+	float cornerJitter = 0.0f;
+	// One random depth per triangle instead of one per corner.
+	bool isFlat = false;
+};
+
+// Random triangles with random colors, the same seed gives the same triangles.
+inline std::vector<Triangle> MakeTriangles(uint32 seed, uint32 count, const TriangleSceneDesc& desc = {})
+{
+	std::mt19937 random(seed);
+	std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+	std::vector<Triangle> triangles(count);
+	for (auto& triangle : triangles)
+	{
+		const bool isLarge = desc.largeInterval != 0 && random() % desc.largeInterval == 0;
+		const float size = isLarge ? desc.largeSize : desc.minSize + unit(random) * (desc.maxSize - desc.minSize);
+		const float centerX = desc.margin + unit(random) * (desc.width - desc.margin * 2.0f);
+		const float centerY = desc.margin + unit(random) * (desc.height - desc.margin * 2.0f);
+		const float depth = unit(random);
+		const float base = unit(random) * 6.2831853f;
+		for (uint32 i = 0; i < 3; i++)
+		{
+			const float a = base + 2.0943951f * i + (unit(random) - 0.5f) * desc.cornerJitter;
+			triangle.v[i].x = centerX + std::cos(a) * size * 0.5f;
+			triangle.v[i].y = centerY + std::sin(a) * size * 0.5f;
+			triangle.v[i].z = desc.isFlat ? depth : unit(random);
+		}
+		triangle.color = random() | 0xFF000000u;
+	}
+
+	return triangles;
+}
+
+// Pixels that differ between two targets of the same size, used to check a fast path against a reference.
+inline uint64 CountMismatches(const GG::TextureBuffer& lhs, const GG::TextureBuffer& rhs)
+{
+	uint64 mismatchCount = 0;
+	for (uint32 row = 0; row < lhs.GetHeight(); row++)
+	{
+		for (uint32 col = 0; col < lhs.GetWidth(); col++)
+		{
+			mismatchCount += lhs.GetPixel(static_cast<int32>(row), static_cast<int32>(col)) != rhs.GetPixel(static_cast<int32>(row), static_cast<int32>(col));
+		}
+	}
+
+	return mismatchCount;
+}
+
+inline void ReportMismatches(const char* name, uint64 mismatchCount)
+{
+	std::printf("  %-40s %s (%llu pixels differ)\n", name, mismatchCount == 0 ? "match" : "MISMATCH", static_cast<unsigned long long>(mismatchCount));
+}
+
+}
+
+// Benchmark suites, one per file.
+void RunFillBenchmark();
+void RunTiledBenchmark();
+void RunHeadlessBenchmark();
+void RunRasterBenchmark();
+void RunBinnedBenchmark();
+void RunDepthBenchmark();
+void RunVertexBenchmark();
+void RunShaderBenchmark();
+void RunTextureBenchmark();
+void RunLineBenchmark();
+void RunMultisampleBenchmark();
+void RunDrawQueueBenchmark();
+void RunBlendBenchmark();
+void RunJobBenchmark();
+void RunRenderGraphBenchmark();
+void RunPipelineBenchmark();
+void RunPacingBenchmark();
+void RunProfilerBenchmark();
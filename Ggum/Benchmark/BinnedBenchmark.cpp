@@ -0,0 +1,106 @@
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+#include "Benchmark.h"
+#include "gg.h"
+
+using namespace GG;
+
+namespace {
+
+const uint32 s_width = 1920;
+const uint32 s_height = 1080;
+
+// Mostly small triangles with some large ones, overlapping so the draw order matters.
+Benchmark::TriangleSceneDesc make_scene_desc(uint32 width, uint32 height)
+{
+	Benchmark::TriangleSceneDesc desc;
+	desc.width = width;
+	desc.height = height;
+	desc.largeInterval = 16;
+	desc.cornerJitter = 1.2f;
+	return desc;
+}
+
+// Binned output against the single threaded Rasterizer on a size that leaves the bins along the right and bottom edges partial.
+uint64 check_odd_size(eTextureLayout layout, uint32 width, uint32 height, uint32 threadCount)
+{
+	Benchmark::TriangleSceneDesc desc = make_scene_desc(width, height);
+	desc.margin = -8.0f;
+	const std::vector<Benchmark::Triangle> triangles = Benchmark::MakeTriangles(5, 2000, desc);
+
+	TextureBuffer binnedTarget;
+	TextureBuffer referenceTarget;
+	binnedTarget.Create(width, height, layout);
+	referenceTarget.Create(width, height, layout);
+	binnedTarget.Clear(0xFF000000u);
+	referenceTarget.Clear(0xFF000000u);
+
+	BinnedRasterizer binnedRasterizer(threadCount);
+	Rasterizer rasterizer;
+	for (const auto& triangle : triangles)
+	{
+		binnedRasterizer.DrawTriangle(triangle.v[0], triangle.v[1], triangle.v[2], triangle.color);
+		rasterizer.DrawTriangle(referenceTarget, triangle.v[0], triangle.v[1], triangle.v[2], triangle.color);
+	}
+	binnedRasterizer.Flush(binnedTarget);
+
+	return Benchmark::CountMismatches(binnedTarget, referenceTarget);
+}
+
+}
+
+// Scaling of one frame worth of triangles from 1 thread up to every hardware thread.
+void RunBinnedBenchmark()
+{
+	const uint32 triangleCount = 50000;
+	const std::vector<Benchmark::Triangle> triangles = Benchmark::MakeTriangles(1234, triangleCount, make_scene_desc(s_width, s_height));
+
+	std::vector<uint32> threadCounts{ 1 };
+	const uint32 hardwareThreadCount = std::max(std::thread::hardware_concurrency(), 2u);
+	for (uint32 count = 2; count < hardwareThreadCount; count *= 2)
+	{
+		threadCounts.push_back(count);
+	}
+	threadCounts.push_back(hardwareThreadCount);
+
+	for (eTextureLayout layout : { eTextureLayout::Linear, eTextureLayout::Tiled })
+	{
+		TextureBuffer target;
+		target.Create(s_width, s_height, layout);
+
+		double singleThreadSeconds = 0.0;
+		for (uint32 threadCount : threadCounts)
+		{
+			BinnedRasterizer rasterizer(threadCount);
+			auto draw = [&]() {
+				target.Clear(0xFF000000u);
+				for (const auto& triangle : triangles)
+				{
+					rasterizer.DrawTriangle(triangle.v[0], triangle.v[1], triangle.v[2], triangle.color);
+				}
+				rasterizer.Flush(target);
+			};
+			draw();
+			double pixels = static_cast<double>(rasterizer.GetStatistics().pixelCount);
+
+			double seconds = Benchmark::Measure(draw);
+			if (threadCount == 1)
+			{
+				singleThreadSeconds = seconds;
+			}
+
+			char name[64];
+			std::snprintf(name, sizeof(name), "%s, %u triangles, %2u threads", layout == eTextureLayout::Linear ? "linear" : "tiled", triangleCount, threadCount);
+			Benchmark::ReportTriangles(name, seconds, static_cast<double>(triangleCount), pixels);
+
+			double speedup = singleThreadSeconds / seconds;
+			std::printf("  %-40s %10.2fx speedup, %.0f%% efficiency\n", "", speedup, speedup / threadCount * 100.0);
+		}
+
+		char name[64];
+		std::snprintf(name, sizeof(name), "%s 1021x579, binned vs 1 thread", layout == eTextureLayout::Linear ? "linear" : "tiled");
+		Benchmark::ReportMismatches(name, check_odd_size(layout, 1021, 579, hardwareThreadCount));
+	}
+}
\ No newline at end of file
@@ -0,0 +1,202 @@
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "Benchmark.h"
+#include "System/Graphics/TextureBuffer.h"
+
+using namespace GG;
+
+namespace {
+
+const uint32 s_width = 1920;
+const uint32 s_height = 1080;
+const uint32 s_particleSize = 32;
+const uint32 s_particleCount = 20000;
+
+// Per-channel blend of straight alpha floats, the way a shader would write it without the kernels.
+void blend_scalar(uint32* dst, const uint32* src, uint32 count)
+{
+	for (uint32 i = 0; i < count; i++)
+	{
+		const float alpha = (src[i] >> 24) / 255.0f;
+		uint32 result = 0;
+		for (uint32 shift = 0; shift < 32; shift += 8)
+		{
+			const float s = ((src[i] >> shift) & 0xFF) / 255.0f;
+			const float d = ((dst[i] >> shift) & 0xFF) / 255.0f;
+			const float value = std::min(s + d * (1.0f - alpha), 1.0f);
+			result |= static_cast<uint32>(value * 255.0f + 0.5f) << shift;
+		}
+		dst[i] = result;
+	}
+}
+
+const char* get_path_name(eKernelPath path)
+{
+	return path == eKernelPath::SSE2 ? "SSE2" : path == eKernelPath::AVX2 ? "AVX2" : "scalar";
+}
+
+const char* get_mode_name(eBlendMode mode)
+{
+	switch (mode)
+	{
+	case eBlendMode::SourceOver:
+		return "source over";
+	case eBlendMode::Additive:
+		return "additive";
+	case eBlendMode::Multiply:
+		return "multiply";
+	case eBlendMode::Min:
+		return "min";
+	default:
+		return "max";
+	}
+}
+
+// Blends every kind of bulk write of every mode on a target whose size isn't a multiple of the tile or vector width,
+// partly clipped, with the kernels of path. Both dst and src have random colors and src has transparent black pixels.
+void draw_blend_scene(TextureBuffer& target, eKernelPath path, bool isGammaCorrect)
+{
+	std::mt19937 random(7);
+	const uint32 width = target.GetWidth();
+	const uint32 height = target.GetHeight();
+	std::vector<uint32> pixels(width);
+	for (uint32 row = 0; row < height; row++)
+	{
+		for (auto& pixel : pixels)
+		{
+			pixel = random() | 0xFF000000u;
+		}
+		target.WriteRow(static_cast<int32>(row), 0, pixels.data(), width);
+	}
+
+	const uint32 srcWidth = 96;
+	const uint32 srcHeight = 80;
+	std::vector<uint32> src(srcWidth * srcHeight);
+	for (auto& pixel : src)
+	{
+		pixel = random() % 8 == 0 ? 0 : random();
+	}
+	PixelKernel::Premultiply(src.data(), static_cast<uint32>(src.size()), isGammaCorrect);
+	uint32 color = 0xA0C08040u;
+	PixelKernel::Premultiply(&color, 1, isGammaCorrect);
+
+	PixelKernel::SetBlendKernelPath(path);
+	for (eBlendMode mode : { eBlendMode::SourceOver, eBlendMode::Additive, eBlendMode::Multiply, eBlendMode::Min, eBlendMode::Max })
+	{
+		for (const int32 position : { -30, 45, 170 })
+		{
+			target.BlendRect(position, position + 20, srcWidth, srcHeight, src.data(), srcWidth, mode, isGammaCorrect);
+		}
+		target.BlendColorRect(10, 5, width - 20, 37, color, mode, isGammaCorrect);
+		target.BlendRow(120, -3, src.data(), width - 10, mode, isGammaCorrect);
+		target.BlendSpan(130, 7, width - 9, color, mode, isGammaCorrect);
+	}
+	PixelKernel::SetBlendKernelPath(eKernelPath::Default);
+}
+
+// Pixels where the SSE2 or AVX2 kernels don't give the same result as the scalar ones.
+uint64 check_blend(eTextureLayout layout, eKernelPath path, bool isGammaCorrect)
+{
+	TextureBuffer reference;
+	TextureBuffer target;
+	reference.Create(301, 203, layout);
+	target.Create(301, 203, layout);
+	draw_blend_scene(reference, eKernelPath::Scalar, isGammaCorrect);
+	draw_blend_scene(target, path, isGammaCorrect);
+
+	return Benchmark::CountMismatches(target, reference);
+}
+
+}
+
+// Full screen blends of every mode and a particle heavy screen of small additive quads.
+void RunBlendBenchmark()
+{
+	const uint32 pixelCount = s_width * s_height;
+	std::mt19937 random(5);
+	std::vector<uint32> src(pixelCount);
+	for (auto& pixel : src)
+	{
+		pixel = random();
+	}
+	PixelKernel::Premultiply(src.data(), pixelCount);
+	std::vector<uint32> dst(pixelCount, 0xFF204060u);
+
+	Benchmark::ReportPixels("full screen, scalar float source over", Benchmark::Measure([&]() {
+		blend_scalar(dst.data(), src.data(), pixelCount);
+	}), pixelCount);
+	for (eBlendMode mode : { eBlendMode::SourceOver, eBlendMode::Additive, eBlendMode::Multiply, eBlendMode::Min, eBlendMode::Max })
+	{
+		char name[64];
+		std::snprintf(name, sizeof(name), "full screen, %s", get_mode_name(mode));
+		Benchmark::ReportPixels(name, Benchmark::Measure([&]() {
+			PixelKernel::Blend(dst.data(), src.data(), pixelCount, mode);
+		}), pixelCount);
+	}
+	for (eBlendMode mode : { eBlendMode::SourceOver, eBlendMode::Additive })
+	{
+		char name[64];
+		std::snprintf(name, sizeof(name), "full screen, %s, sRGB", get_mode_name(mode));
+		Benchmark::ReportPixels(name, Benchmark::Measure([&]() {
+			PixelKernel::Blend(dst.data(), src.data(), pixelCount, mode, true);
+		}), pixelCount);
+	}
+	Benchmark::ReportPixels("full screen, color source over", Benchmark::Measure([&]() {
+		PixelKernel::BlendColor(dst.data(), 0x80402010u, pixelCount, eBlendMode::SourceOver);
+	}), pixelCount);
+
+	// Soft round particles, premultiplied.
+	std::vector<uint32> sprite(s_particleSize * s_particleSize);
+	for (uint32 y = 0; y < s_particleSize; y++)
+	{
+		for (uint32 x = 0; x < s_particleSize; x++)
+		{
+			const float dx = (x + 0.5f) / s_particleSize * 2.0f - 1.0f;
+			const float dy = (y + 0.5f) / s_particleSize * 2.0f - 1.0f;
+			const uint8 alpha = static_cast<uint8>(std::max(0.0f, 1.0f - (dx * dx + dy * dy)) * 255.0f);
+			sprite[y * s_particleSize + x] = PackColor(255, 160, 64, alpha);
+		}
+	}
+	PixelKernel::Premultiply(sprite.data(), static_cast<uint32>(sprite.size()));
+
+	std::vector<int32> positions(s_particleCount * 2);
+	for (uint32 i = 0; i < s_particleCount; i++)
+	{
+		positions[i * 2] = static_cast<int32>(random() % (s_height + s_particleSize)) - static_cast<int32>(s_particleSize);
+		positions[i * 2 + 1] = static_cast<int32>(random() % (s_width + s_particleSize)) - static_cast<int32>(s_particleSize);
+	}
+
+	for (eTextureLayout layout : { eTextureLayout::Linear, eTextureLayout::Tiled })
+	{
+		TextureBuffer target;
+		target.Create(s_width, s_height, layout);
+		for (bool isGammaCorrect : { false, true })
+		{
+			char name[64];
+			std::snprintf(name, sizeof(name), "%u particles, %s%s", s_particleCount, layout == eTextureLayout::Linear ? "linear" : "tiled", isGammaCorrect ? ", sRGB" : "");
+			Benchmark::ReportPixels(name, Benchmark::Measure([&]() {
+				target.Clear(0xFF000000u);
+				for (uint32 i = 0; i < s_particleCount; i++)
+				{
+					target.BlendRect(positions[i * 2], positions[i * 2 + 1], s_particleSize, s_particleSize, sprite.data(), s_particleSize, eBlendMode::Additive, isGammaCorrect);
+				}
+			}), static_cast<double>(s_particleCount) * s_particleSize * s_particleSize);
+		}
+	}
+
+	for (eTextureLayout layout : { eTextureLayout::Linear, eTextureLayout::Tiled })
+	{
+		for (bool isGammaCorrect : { false, true })
+		{
+			for (eKernelPath path : { eKernelPath::SSE2, eKernelPath::AVX2 })
+			{
+				char name[64];
+				std::snprintf(name, sizeof(name), "%s%s, %s vs scalar", layout == eTextureLayout::Linear ? "linear" : "tiled", isGammaCorrect ? ", sRGB" : "",
+					get_path_name(path));
+				Benchmark::ReportMismatches(name, check_blend(layout, path, isGammaCorrect));
+			}
+		}
+	}
+}
\ No newline at end of file
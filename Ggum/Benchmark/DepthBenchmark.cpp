@@ -0,0 +1,73 @@
+#include <algorithm>
+#include <vector>
+
+#include "Benchmark.h"
+#include "gg.h"
+
+using namespace GG;
+
+namespace {
+
+const uint32 s_width = 1920;
+const uint32 s_height = 1080;
+
+// Large overlapping triangles with a constant depth each, about 20x overdraw, sorted far to near.
+std::vector<Benchmark::Triangle> make_layers(uint32 count)
+{
+	Benchmark::TriangleSceneDesc desc;
+	desc.width = s_width;
+	desc.height = s_height;
+	desc.minSize = 200.0f;
+	desc.maxSize = 600.0f;
+	desc.isFlat = true;
+	std::vector<Benchmark::Triangle> triangles = Benchmark::MakeTriangles(77, count, desc);
+	std::sort(triangles.begin(), triangles.end(), [](const Benchmark::Triangle& lhs, const Benchmark::Triangle& rhs) { return lhs.v[0].z > rhs.v[0].z; });
+
+	return triangles;
+}
+
+}
+
+// Savings of the coarse Z and the early depth test, drawing the same triangles far to near and near to far.
+void RunDepthBenchmark()
+{
+	std::vector<Benchmark::Triangle> triangles = make_layers(600);
+
+	TextureBuffer target;
+	target.Create(s_width, s_height, eTextureLayout::Tiled);
+	DepthBuffer depthBuffer;
+	depthBuffer.Create(s_width, s_height, eTextureLayout::Tiled);
+
+	struct Case
+	{
+		const char* name;
+		bool isDepthTested;
+		bool isNearToFar;
+	};
+	const Case cases[]
+	{
+		{ "no depth", false, false },
+		{ "depth, far to near", true, false },
+		{ "depth, near to far", true, true },
+	};
+
+	for (const auto& testCase : cases)
+	{
+		Rasterizer rasterizer;
+		auto draw = [&]() {
+			target.Clear(0xFF000000u);
+			depthBuffer.Clear(1.0f);
+			rasterizer.ResetStatistics();
+			for (uint32 i = 0; i < triangles.size(); i++)
+			{
+				const Benchmark::Triangle& triangle = triangles[testCase.isNearToFar ? triangles.size() - 1 - i : i];
+				rasterizer.DrawTriangle(target, triangle.v[0], triangle.v[1], triangle.v[2], triangle.color, testCase.isDepthTested ? &depthBuffer : nullptr);
+			}
+		};
+		draw();
+		const RasterStatistics statistics = rasterizer.GetStatistics();
+
+		Benchmark::ReportTriangles(testCase.name, Benchmark::Measure(draw), static_cast<double>(triangles.size()), static_cast<double>(statistics.pixelCount));
+		std::printf("  %-40s %10llu blocks %10llu pixels rejected\n", "", static_cast<unsigned long long>(statistics.depthRejectedBlockCount), static_cast<unsigned long long>(statistics.depthRejectedPixelCount));
+	}
+}
\ No newline at end of file
@@ -0,0 +1,122 @@
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "Benchmark.h"
+#include "gg.h"
+
+using namespace GG;
+
+namespace {
+
+const uint32 s_width = 1920;
+const uint32 s_height = 1080;
+const uint32 s_drawCount = 50000;
+
+struct Draw
+{
+	uint64 key;
+	uint32 index;
+};
+
+// Triangles of 30 to 130 pixels with a constant depth each, in random depth order.
+std::vector<Benchmark::Triangle> make_triangles(uint32 count)
+{
+	Benchmark::TriangleSceneDesc desc;
+	desc.width = s_width;
+	desc.height = s_height;
+	desc.minSize = 30.0f;
+	desc.maxSize = 130.0f;
+	desc.isFlat = true;
+	return Benchmark::MakeTriangles(19, count, desc);
+}
+
+void report_draws(const char* name, double secondsPerCall, double drawsPerCall)
+{
+	std::printf("  %-40s %10.3f ms %10.1f Mdraw/s\n", name, secondsPerCall * 1e3, drawsPerCall / secondsPerCall * 1e-6);
+}
+
+}
+
+// Radix sorting a frame's draw keys against comparison sorts, and what sorting opaque draws front to back saves the depth test.
+void RunDrawQueueBenchmark()
+{
+	std::vector<Benchmark::Triangle> triangles = make_triangles(s_drawCount);
+
+	// Opaque draws over 64 states, then a transparent pass.
+	std::mt19937 random(7);
+	std::vector<Draw> draws(s_drawCount);
+	for (uint32 i = 0; i < s_drawCount; i++)
+	{
+		const RenderPassOrder order = i % 4 == 0 ? RenderPassOrder::Transparent : RenderPassOrder::Opaque;
+		draws[i] = Draw{ DrawQueue::MakeKey(order, random() % 64, triangles[i].v[0].z), i };
+	}
+
+	DrawQueue queue;
+	auto push = [&]() {
+		queue.Clear();
+		for (const auto& draw : draws)
+		{
+			const Benchmark::Triangle& triangle = triangles[draw.index];
+			queue.PushTriangle(draw.key, triangle.v[0], triangle.v[1], triangle.v[2], triangle.color);
+		}
+	};
+	const double pushSeconds = Benchmark::Measure(push);
+	report_draws("push", pushSeconds, s_drawCount);
+	report_draws("radix sort (without push)", Benchmark::Measure([&]() { push(); queue.Sort(); }) - pushSeconds, s_drawCount);
+
+	std::vector<Draw> sortedDraws;
+	auto sortBy = [&](auto sort) {
+		return Benchmark::Measure([&]() {
+			sortedDraws = draws;
+			sort(sortedDraws.begin(), sortedDraws.end(), [](const Draw& lhs, const Draw& rhs) { return lhs.key < rhs.key; });
+		});
+	};
+	report_draws("std::sort", sortBy([](auto first, auto last, auto less) { std::sort(first, last, less); }), s_drawCount);
+	report_draws("std::stable_sort", sortBy([](auto first, auto last, auto less) { std::stable_sort(first, last, less); }), s_drawCount);
+
+	push();
+	queue.Sort();
+	std::stable_sort(draws.begin(), draws.end(), [](const Draw& lhs, const Draw& rhs) { return lhs.key < rhs.key; });
+	for (uint32 i = 0; i < s_drawCount; i++)
+	{
+		if (queue.GetKey(i) != draws[i].key)
+		{
+			std::printf("  radix sort order differs at %u!\n", i);
+			break;
+		}
+	}
+
+	TextureBuffer target;
+	target.Create(s_width, s_height, eTextureLayout::Tiled);
+	DepthBuffer depthBuffer;
+	depthBuffer.Create(s_width, s_height, eTextureLayout::Tiled);
+	for (bool isSorted : { false, true })
+	{
+		BinnedRasterizer rasterizer;
+		auto draw = [&]() {
+			target.Clear(0xFF000000u);
+			depthBuffer.Clear(1.0f);
+			rasterizer.ResetStatistics();
+			queue.Clear();
+			for (const auto& triangle : triangles)
+			{
+				if (isSorted)
+				{
+					queue.PushTriangle(DrawQueue::MakeKey(RenderPassOrder::Opaque, 0, triangle.v[0].z), triangle.v[0], triangle.v[1], triangle.v[2], triangle.color);
+				}
+				else
+				{
+					rasterizer.DrawTriangle(triangle.v[0], triangle.v[1], triangle.v[2], triangle.color);
+				}
+			}
+			queue.Draw(rasterizer, target, &depthBuffer);
+			rasterizer.Flush(target, &depthBuffer);
+		};
+		draw();
+		const RasterStatistics statistics = rasterizer.GetStatistics();
+
+		Benchmark::ReportTriangles(isSorted ? "opaque, front to back" : "opaque, submission order", Benchmark::Measure(draw), static_cast<double>(triangles.size()), static_cast<double>(statistics.pixelCount));
+		std::printf("  %-40s %10llu blocks %10llu pixels rejected\n", "", static_cast<unsigned long long>(statistics.depthRejectedBlockCount), static_cast<unsigned long long>(statistics.depthRejectedPixelCount));
+	}
+}
\ No newline at end of file
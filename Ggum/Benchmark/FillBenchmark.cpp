@@ -0,0 +1,173 @@
+#include <cstring>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "Benchmark.h"
+#include "System/Graphics/TextureBuffer.h"
+
+using namespace GG;
+
+namespace {
+
+const uint32 s_width = 1280;
+const uint32 s_height = 720;
+
+// Reproduces the per-pixel path we had before the bulk API:
+// Renderer::SetPixelForDebug -> GraphicsAPI::SetPixel(row, col, uint8*).
+class IPixelSurface
+{
+public:
+	virtual ~IPixelSurface() = default;
+	virtual void SetPixel(uint32 row, uint32 col, uint8* color) = 0;
+};
+
+class LegacySurface : public IPixelSurface
+{
+public:
+	LegacySurface()
+		: _buffer(s_width * s_height * 4, 0)
+	{}
+
+	virtual void SetPixel(uint32 row, uint32 col, uint8* color) override
+	{
+		if (row >= s_height || col >= s_width)
+		{
+			return;
+		}
+		uint32 index = (s_width * row + col) * 4;
+		for (uint32 i = 0; i < 4; i++)
+		{
+			_buffer[index + i] = color[i];
+		}
+		_needUpdateTexture = true;
+	}
+
+private:
+	std::vector<uint8> _buffer;
+	bool _needUpdateTexture = false;
+};
+
+// Read through a volatile pointer so the virtual call is not devirtualized.
+IPixelSurface* volatile s_legacySurface = nullptr;
+
+}
+
+void RunFillBenchmark()
+{
+	auto legacy = std::make_unique<LegacySurface>();
+	s_legacySurface = legacy.get();
+
+	TextureBuffer buffer;
+	buffer.Create(s_width, s_height);
+
+	const double fullScreen = static_cast<double>(s_width) * s_height;
+
+	std::vector<uint8> reference(s_width * s_height * 4);
+	Benchmark::ReportPixels("memset (bandwidth reference)", Benchmark::Measure([&]() {
+		::memset(reference.data(), 0x7f, reference.size());
+		}), fullScreen);
+
+	// Solid full screen fill.
+	Benchmark::ReportPixels("full screen, per-pixel SetPixel", Benchmark::Measure([&]() {
+		uint8 color[]{ 10, 20, 30, 255 };
+		for (uint32 row = 0; row < s_height; row++)
+		{
+			for (uint32 col = 0; col < s_width; col++)
+			{
+				s_legacySurface->SetPixel(row, col, color);
+			}
+		}
+		}), fullScreen);
+
+	Benchmark::ReportPixels("full screen, FillRect", Benchmark::Measure([&]() {
+		buffer.FillRect(0, 0, s_width, s_height, PackColor(10, 20, 30, 255));
+		}), fullScreen);
+
+	// Row data coming from a rasterizer or a decoder.
+	std::vector<uint32> rowData(s_width);
+	std::mt19937 random(1234);
+	for (auto& pixel : rowData)
+	{
+		pixel = random() | 0xFF000000u;
+	}
+
+	Benchmark::ReportPixels("full screen rows, per-pixel SetPixel", Benchmark::Measure([&]() {
+		for (uint32 row = 0; row < s_height; row++)
+		{
+			for (uint32 col = 0; col < s_width; col++)
+			{
+				s_legacySurface->SetPixel(row, col, reinterpret_cast<uint8*>(&rowData[col]));
+			}
+		}
+		}), fullScreen);
+
+	Benchmark::ReportPixels("full screen rows, WriteRow", Benchmark::Measure([&]() {
+		for (uint32 row = 0; row < s_height; row++)
+		{
+			buffer.WriteRow(static_cast<int32>(row), 0, rowData.data(), s_width);
+		}
+		}), fullScreen);
+
+	// Short spans of random length and position, partially off screen.
+	struct Span { int32 row, col; uint32 count; };
+	std::vector<Span> spans(100000);
+	double spanPixels = 0.0;
+	for (auto& span : spans)
+	{
+		span.row = static_cast<int32>(random() % s_height);
+		span.col = static_cast<int32>(random() % (s_width + 64)) - 32;
+		span.count = 1 + random() % 64;
+		spanPixels += span.count;
+	}
+
+	Benchmark::ReportPixels("1-64px spans, per-pixel SetPixel", Benchmark::Measure([&]() {
+		uint8 color[]{ 200, 100, 50, 255 };
+		for (const auto& span : spans)
+		{
+			for (uint32 i = 0; i < span.count; i++)
+			{
+				s_legacySurface->SetPixel(static_cast<uint32>(span.row), static_cast<uint32>(span.col + static_cast<int32>(i)), color);
+			}
+		}
+		}), spanPixels);
+
+	Benchmark::ReportPixels("1-64px spans, FillSpan", Benchmark::Measure([&]() {
+		for (const auto& span : spans)
+		{
+			buffer.FillSpan(span.row, span.col, span.count, PackColor(200, 100, 50, 255));
+		}
+		}), spanPixels);
+
+	// Sprite blits.
+	const uint32 spriteSize = 128;
+	std::vector<uint32> sprite(spriteSize * spriteSize);
+	for (auto& pixel : sprite)
+	{
+		pixel = random();
+	}
+
+	Benchmark::ReportPixels("128x128 sprites x64, per-pixel SetPixel", Benchmark::Measure([&]() {
+		for (uint32 i = 0; i < 64; i++)
+		{
+			uint32 baseRow = (i * 97) % (s_height - spriteSize);
+			uint32 baseCol = (i * 331) % (s_width - spriteSize);
+			for (uint32 row = 0; row < spriteSize; row++)
+			{
+				for (uint32 col = 0; col < spriteSize; col++)
+				{
+					s_legacySurface->SetPixel(baseRow + row, baseCol + col, reinterpret_cast<uint8*>(&sprite[row * spriteSize + col]));
+				}
+			}
+		}
+		}), 64.0 * spriteSize * spriteSize);
+
+	Benchmark::ReportPixels("128x128 sprites x64, BlitRect", Benchmark::Measure([&]() {
+		for (uint32 i = 0; i < 64; i++)
+		{
+			int32 baseRow = static_cast<int32>((i * 97) % (s_height - spriteSize));
+			int32 baseCol = static_cast<int32>((i * 331) % (s_width - spriteSize));
+			buffer.BlitRect(baseRow, baseCol, spriteSize, spriteSize, sprite.data(), spriteSize);
+		}
+		}), 64.0 * spriteSize * spriteSize);
+}
\ No newline at end of file
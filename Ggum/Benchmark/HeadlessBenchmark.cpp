@@ -0,0 +1,112 @@
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include "Benchmark.h"
+#include "gg.h"
+
+using namespace GG;
+
+namespace {
+
+const uint32 s_width = 1280;
+const uint32 s_height = 720;
+const uint32 s_framesPerRun = 60;
+
+// Moving rects and sprites, deterministic so frame dumps of two runs can be diffed.
+class SceneRenderPass : public RenderPass
+{
+public:
+	SceneRenderPass()
+		: RenderPass("Headless scene", RenderPassOrder::Opaque)
+		, _sprite(s_spriteSize * s_spriteSize)
+	{
+		std::mt19937 random(2024);
+		for (auto& pixel : _sprite)
+		{
+			pixel = random() | 0xFF000000u;
+		}
+		_rects.resize(400);
+		for (auto& rect : _rects)
+		{
+			rect.x = static_cast<float>(random() % s_width);
+			rect.y = static_cast<float>(random() % s_height);
+			rect.speedX = static_cast<float>(random() % 400) - 200.0f;
+			rect.speedY = static_cast<float>(random() % 400) - 200.0f;
+			rect.size = 8 + random() % 56;
+			rect.color = random() | 0xFF000000u;
+		}
+	}
+
+	virtual void OnUpdate(float deltaTime) override
+	{
+		for (auto& rect : _rects)
+		{
+			rect.x = wrap(rect.x + rect.speedX * deltaTime, static_cast<float>(s_width));
+			rect.y = wrap(rect.y + rect.speedY * deltaTime, static_cast<float>(s_height));
+		}
+	}
+
+	virtual void OnRender(float alpha) override
+	{
+		TextureBuffer& backBuffer = _renderer->AcquireBackBuffer();
+		for (uint32 i = 0; i < _rects.size(); i++)
+		{
+			const auto& rect = _rects[i];
+			if (i % 8 == 0)
+			{
+				backBuffer.BlitRect(static_cast<int32>(rect.y), static_cast<int32>(rect.x), s_spriteSize, s_spriteSize, _sprite.data(), s_spriteSize);
+			}
+			else
+			{
+				backBuffer.FillRect(static_cast<int32>(rect.y), static_cast<int32>(rect.x), rect.size, rect.size, rect.color);
+			}
+		}
+	}
+
+private:
+	static float wrap(float value, float size)
+	{
+		return value < 0.0f ? value + size : value >= size ? value - size : value;
+	}
+
+	static constexpr uint32 s_spriteSize = 48;
+
+	struct MovingRect
+	{
+		float x, y;
+		float speedX, speedY;
+		uint32 size;
+		uint32 color;
+	};
+
+	std::vector<MovingRect> _rects;
+	std::vector<uint32> _sprite;
+};
+
+}
+
+// Set GG_FRAME_DUMP_DIRECTORY to write every frame as PPM.
+void RunHeadlessBenchmark()
+{
+	ApplicationProperty prop("Headless benchmark", s_width, s_height);
+	prop.isHeadless = true;
+	prop.frameCount = s_framesPerRun;
+	if (const char* directory = std::getenv("GG_FRAME_DUMP_DIRECTORY"))
+	{
+		prop.frameDumpDirectory = directory;
+	}
+
+	Application* app = Application::Create(prop);
+	// Every run logs its frame time, only the summary below is wanted here.
+	Log::GetLogger()->set_level(spdlog::level::warn);
+	app->AddRenderPass(std::make_shared<SceneRenderPass>());
+	app->GetRenderer()->SetClearColor(PackColor(30, 30, 40, 255));
+
+	double secondsPerRun = Benchmark::Measure([&]() {
+		app->Run();
+		});
+	Benchmark::ReportPixels("RenderPath frame, 400 rects and sprites", secondsPerRun / s_framesPerRun, static_cast<double>(s_width) * s_height);
+
+	delete app;
+}
\ No newline at end of file
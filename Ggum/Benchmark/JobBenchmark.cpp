@@ -0,0 +1,102 @@
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+#include "Benchmark.h"
+#include "gg.h"
+
+using namespace GG;
+
+namespace {
+
+const uint32 s_width = 1920;
+const uint32 s_height = 1080;
+const uint32 s_jobCount = 10000;
+const uint32 s_triangleCount = 20000;
+
+// A few multiply-adds per pixel, so rows cost more than the job overhead at small grains too.
+void shade_rows(uint32* pixels, uint32 beginRow, uint32 endRow)
+{
+	for (uint32 row = beginRow; row < endRow; row++)
+	{
+		uint32* dst = pixels + static_cast<size_t>(row) * s_width;
+		for (uint32 col = 0; col < s_width; col++)
+		{
+			const float u = col * (1.0f / s_width);
+			const float v = row * (1.0f / s_height);
+			const float value = u * u * 0.5f + v * 0.25f + u * v * 0.25f;
+			dst[col] = PackColor(static_cast<uint8>(value * 255.0f), static_cast<uint8>(u * 255.0f), static_cast<uint8>(v * 255.0f), 255);
+		}
+	}
+}
+
+}
+
+// Job overhead, ParallelFor scaling and the binned rasterizer on its own threads against the job system's.
+void RunJobBenchmark()
+{
+	const uint32 threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+	JobSystem jobSystem;
+	jobSystem.Start(threadCount);
+	std::printf("  %u threads\n", threadCount);
+
+	std::vector<uint32> pixels(static_cast<size_t>(s_width) * s_height);
+	Benchmark::ReportPixels("shade rows, serial", Benchmark::Measure([&]() {
+		shade_rows(pixels.data(), 0, s_height);
+	}), static_cast<double>(pixels.size()));
+	for (uint32 grain : { 1u, 8u, 64u })
+	{
+		char name[64];
+		std::snprintf(name, sizeof(name), "shade rows, ParallelFor grain %u", grain);
+		Benchmark::ReportPixels(name, Benchmark::Measure([&]() {
+			jobSystem.ParallelFor(0, s_height, grain, [&](uint32 begin, uint32 end) { shade_rows(pixels.data(), begin, end); });
+		}), static_cast<double>(pixels.size()));
+	}
+
+	const double groupSeconds = Benchmark::Measure([&]() {
+		Job* group = jobSystem.CreateJob([]() {});
+		for (uint32 i = 0; i < s_jobCount; i++)
+		{
+			jobSystem.Run(jobSystem.CreateJob([]() {}, group));
+		}
+		jobSystem.Run(group);
+		jobSystem.Wait(group);
+	});
+	std::printf("  %-40s %10.3f ms %10.1f Mjob/s\n", "empty child jobs", groupSeconds * 1e3, s_jobCount / groupSeconds * 1e-6);
+
+	Benchmark::TriangleSceneDesc desc;
+	desc.width = s_width;
+	desc.height = s_height;
+	desc.minSize = 16.0f;
+	desc.maxSize = 128.0f;
+	desc.cornerJitter = 1.0f;
+	const std::vector<Benchmark::Triangle> triangles = Benchmark::MakeTriangles(21, s_triangleCount, desc);
+
+	TextureBuffer target;
+	target.Create(s_width, s_height, eTextureLayout::Tiled);
+	for (bool isOnJobSystem : { false, true })
+	{
+		BinnedRasterizer rasterizer;
+		if (isOnJobSystem)
+		{
+			rasterizer.SetJobSystem(&jobSystem);
+		}
+		else
+		{
+			rasterizer.SetThreadCount(threadCount);
+		}
+
+		const double seconds = Benchmark::Measure([&]() {
+			target.Clear(0xFF000000u);
+			rasterizer.ResetStatistics();
+			for (uint32 i = 0; i < s_triangleCount; i++)
+			{
+				rasterizer.DrawTriangle(triangles[i].v[0], triangles[i].v[1], triangles[i].v[2], 0xFF000000u | (i * 2654435761u));
+			}
+			rasterizer.Flush(target);
+		});
+		Benchmark::ReportTriangles(isOnJobSystem ? "binned, on the job system" : "binned, own threads", seconds, s_triangleCount, static_cast<double>(rasterizer.GetStatistics().pixelCount));
+	}
+
+	jobSystem.Stop();
+}
\ No newline at end of file
@@ -0,0 +1,123 @@
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "Benchmark.h"
+#include "gg.h"
+
+using namespace GG;
+
+namespace {
+
+const uint32 s_width = 1920;
+const uint32 s_height = 1080;
+
+// The per pixel path debug overlays used before: a float DDA with a bounds test and TextureBuffer::SetPixel() per pixel.
+void draw_lines_per_pixel(TextureBuffer& target, const std::vector<LineSegment>& segments)
+{
+	for (const auto& segment : segments)
+	{
+		const float dx = segment.x1 - segment.x0;
+		const float dy = segment.y1 - segment.y0;
+		const uint32 steps = static_cast<uint32>(std::max(std::abs(dx), std::abs(dy))) + 1;
+		const float stepX = dx / steps;
+		const float stepY = dy / steps;
+		float x = segment.x0;
+		float y = segment.y0;
+		for (uint32 i = 0; i <= steps; i++, x += stepX, y += stepY)
+		{
+			const int32 row = static_cast<int32>(std::floor(y));
+			const int32 col = static_cast<int32>(std::floor(x));
+			if (row >= 0 && col >= 0 && row < static_cast<int32>(s_height) && col < static_cast<int32>(s_width))
+			{
+				target.SetPixel(row, col, segment.color);
+			}
+		}
+	}
+}
+
+void report_lines(const char* name, TextureBuffer& target, const std::vector<LineSegment>& segments, bool isAntialiased)
+{
+	LineRasterizer rasterizer;
+	auto draw = [&]() { rasterizer.DrawLines(target, segments.data(), static_cast<uint32>(segments.size()), isAntialiased); };
+	draw();
+	const uint64 pixelCount = rasterizer.GetStatistics().pixelCount;
+	Benchmark::ReportPixels(name, Benchmark::Measure(draw), static_cast<double>(pixelCount));
+}
+
+}
+
+void RunLineBenchmark()
+{
+	std::mt19937 random(5);
+	std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+	// Full screen grid every 16 pixels.
+	std::vector<LineSegment> grid;
+	for (uint32 x = 0; x < s_width; x += 16)
+	{
+		grid.push_back(LineSegment{ x + 0.5f, 0.0f, x + 0.5f, static_cast<float>(s_height), 0xFF404040u });
+	}
+	for (uint32 y = 0; y < s_height; y += 16)
+	{
+		grid.push_back(LineSegment{ 0.0f, y + 0.5f, static_cast<float>(s_width), y + 0.5f, 0xFF404040u });
+	}
+
+	// Short segments like bounding boxes and paths, up to 64 pixels long.
+	std::vector<LineSegment> shortLines(10000);
+	for (auto& segment : shortLines)
+	{
+		segment.x0 = unit(random) * s_width;
+		segment.y0 = unit(random) * s_height;
+		segment.x1 = segment.x0 + (unit(random) - 0.5f) * 128.0f;
+		segment.y1 = segment.y0 + (unit(random) - 0.5f) * 128.0f;
+		segment.color = static_cast<uint32>(random()) | 0xFF000000u;
+	}
+
+	// Long segments reaching far out of the screen, most of their length is clipped away.
+	std::vector<LineSegment> longLines(2000);
+	for (auto& segment : longLines)
+	{
+		segment.x0 = (unit(random) * 3.0f - 1.0f) * s_width;
+		segment.y0 = (unit(random) * 3.0f - 1.0f) * s_height;
+		segment.x1 = (unit(random) * 3.0f - 1.0f) * s_width;
+		segment.y1 = (unit(random) * 3.0f - 1.0f) * s_height;
+		segment.color = static_cast<uint32>(random()) | 0xFF000000u;
+	}
+
+	std::vector<RasterPoint> points(20000);
+	for (auto& point : points)
+	{
+		point = RasterPoint{ unit(random) * s_width, unit(random) * s_height, static_cast<uint32>(random()) | 0xFF000000u };
+	}
+
+	for (eTextureLayout layout : { eTextureLayout::Linear, eTextureLayout::Tiled })
+	{
+		TextureBuffer target;
+		target.Create(s_width, s_height, layout);
+		target.Clear(0xFF000000u);
+		std::printf(" %s\n", layout == eTextureLayout::Linear ? "linear" : "tiled");
+
+		LineRasterizer counter;
+		counter.DrawLines(target, shortLines.data(), static_cast<uint32>(shortLines.size()));
+		Benchmark::ReportPixels("10k short lines, per pixel SetPixel", Benchmark::Measure([&]() { draw_lines_per_pixel(target, shortLines); }),
+			static_cast<double>(counter.GetStatistics().pixelCount));
+
+		report_lines("10k short lines", target, shortLines, false);
+		report_lines("10k short lines, antialiased", target, shortLines, true);
+		report_lines("2k clipped long lines", target, longLines, false);
+		report_lines("2k clipped long lines, antialiased", target, longLines, true);
+		report_lines("16 px grid", target, grid, false);
+		report_lines("16 px grid, antialiased", target, grid, true);
+
+		LineRasterizer rasterizer;
+		for (bool isAntialiased : { false, true })
+		{
+			auto draw = [&]() { rasterizer.DrawPoints(target, points.data(), static_cast<uint32>(points.size()), 3.0f, isAntialiased); };
+			rasterizer.ResetStatistics();
+			draw();
+			const uint64 pixelCount = rasterizer.GetStatistics().pixelCount;
+			Benchmark::ReportPixels(isAntialiased ? "20k 3 px points, antialiased" : "20k 3 px points", Benchmark::Measure(draw), static_cast<double>(pixelCount));
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,54 @@
+#include <cstdio>
+#include <cstring>
+
+#include "Benchmark.h"
+
+struct BenchmarkSuite
+{
+	const char* name;
+	void (*run)();
+};
+
+static const BenchmarkSuite s_suites[]
+{
+	{ "fill", RunFillBenchmark },
+	{ "tiled", RunTiledBenchmark },
+	{ "headless", RunHeadlessBenchmark },
+	{ "raster", RunRasterBenchmark },
+	{ "binned", RunBinnedBenchmark },
+	{ "depth", RunDepthBenchmark },
+	{ "vertex", RunVertexBenchmark },
+	{ "shader", RunShaderBenchmark },
+	{ "texture", RunTextureBenchmark },
+	{ "line", RunLineBenchmark },
+	{ "msaa", RunMultisampleBenchmark },
+	{ "drawqueue", RunDrawQueueBenchmark },
+	{ "blend", RunBlendBenchmark },
+	{ "jobs", RunJobBenchmark },
+	{ "graph", RunRenderGraphBenchmark },
+	{ "pipeline", RunPipelineBenchmark },
+	{ "pacing", RunPacingBenchmark },
+	{ "profiler", RunProfilerBenchmark },
+};
+
+// Usage: Benchmark [suite...], runs every suite when none is given.
+int main(int argc, char** argv)
+{
+	for (const auto& suite : s_suites)
+	{
+		bool isSelected = argc <= 1;
+		for (int i = 1; i < argc; i++)
+		{
+			isSelected |= ::strcmp(argv[i], suite.name) == 0;
+		}
+		if (!isSelected)
+		{
+			continue;
+		}
+
+		std::printf("[%s]\n", suite.name);
+		suite.run();
+	}
+
+	return 0;
+}
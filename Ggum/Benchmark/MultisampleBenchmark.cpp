@@ -0,0 +1,179 @@
+#include <algorithm>
+#include <vector>
+
+#include "Benchmark.h"
+#include "gg.h"
+
+using namespace GG;
+
+namespace {
+
+const uint32 s_width = 1920;
+const uint32 s_height = 1080;
+
+// Mid sized triangles with random depths, so there are plenty of edges and intersections to split pixels.
+std::vector<Benchmark::Triangle> make_scene(uint32 count)
+{
+	Benchmark::TriangleSceneDesc desc;
+	desc.width = s_width;
+	desc.height = s_height;
+	desc.minSize = 20.0f;
+	desc.maxSize = 200.0f;
+	desc.cornerJitter = 0.5f;
+	return Benchmark::MakeTriangles(18, count, desc);
+}
+
+// Split pixels have to hold the rounded average of their samples, the other pixels away from edges the single sample color.
+// Unsplit pixels next to an edge aren't checked, a corner can cover the pixel center and miss every sample. Returns the pixels which differ.
+uint64 check_resolve(const std::vector<Benchmark::Triangle>& triangles, uint32 sampleCount)
+{
+	TextureBuffer reference;
+	TextureBuffer expected;
+	TextureBuffer target;
+	for (TextureBuffer* buffer : { &reference, &expected, &target })
+	{
+		buffer->Create(s_width, s_height, eTextureLayout::Tiled);
+		buffer->Clear(0xFF000000u);
+	}
+	MultisampleBuffer multisampleBuffer;
+	multisampleBuffer.Create(s_width, s_height, eTextureLayout::Tiled, sampleCount);
+
+	Rasterizer rasterizer;
+	for (const auto& triangle : triangles)
+	{
+		rasterizer.DrawTriangle(reference, triangle.v[0], triangle.v[1], triangle.v[2], triangle.color);
+		rasterizer.DrawTriangle(expected, triangle.v[0], triangle.v[1], triangle.v[2], triangle.color);
+		rasterizer.DrawTriangle(target, triangle.v[0], triangle.v[1], triangle.v[2], triangle.color, nullptr, &multisampleBuffer);
+	}
+
+	// Bit i of a split mask is pixel i of the block in the layout's block order.
+	const RasterBlockPattern& pattern = Rasterizer::GetBlockPattern(eTextureLayout::Tiled);
+	const uint32 blockSize = MultisampleBuffer::s_blockSize;
+	std::vector<uint8> isSplit(static_cast<size_t>(s_width) * s_height, 0);
+	for (uint32 row = 0; row < s_height; row += blockSize)
+	{
+		for (uint32 col = 0; col < s_width; col += blockSize)
+		{
+			const uint64 splitMask = multisampleBuffer.GetSplitMask(row, col);
+			if (splitMask == 0)
+			{
+				continue;
+			}
+
+			const uint32* colors = multisampleBuffer.GetBlockSamplesForWrite(row, col).colors;
+			for (uint32 pixel = 0; pixel < MultisampleBuffer::s_blockPixels; pixel++)
+			{
+				if ((splitMask >> pixel & 1) == 0)
+				{
+					continue;
+				}
+
+				uint32 average = 0;
+				for (uint32 shift = 0; shift < 32; shift += 8)
+				{
+					uint32 sum = sampleCount / 2;
+					for (uint32 sample = 0; sample < sampleCount; sample++)
+					{
+						sum += colors[sample * MultisampleBuffer::s_blockPixels + pixel] >> shift & 0xFF;
+					}
+					average |= sum / sampleCount << shift;
+				}
+				const int32 x = static_cast<int32>(col) + pattern.runX[pixel / blockSize] + pattern.laneX[pixel % blockSize];
+				const int32 y = static_cast<int32>(row) + pattern.runY[pixel / blockSize] + pattern.laneY[pixel % blockSize];
+				expected.SetPixel(y, x, average);
+				isSplit[static_cast<size_t>(y) * s_width + x] = 1;
+			}
+		}
+	}
+
+	multisampleBuffer.Resolve(target);
+
+	for (int32 y = 0; y < static_cast<int32>(s_height); y++)
+	{
+		for (int32 x = 0; x < static_cast<int32>(s_width); x++)
+		{
+			if (isSplit[static_cast<size_t>(y) * s_width + x])
+			{
+				continue;
+			}
+
+			const uint32 color = reference.GetPixel(y, x);
+			bool isEdge = false;
+			for (int32 dy = std::max(y - 1, 0); dy <= std::min(y + 1, static_cast<int32>(s_height) - 1); dy++)
+			{
+				for (int32 dx = std::max(x - 1, 0); dx <= std::min(x + 1, static_cast<int32>(s_width) - 1); dx++)
+				{
+					isEdge |= reference.GetPixel(dy, dx) != color;
+				}
+			}
+			if (isEdge)
+			{
+				expected.SetPixel(y, x, target.GetPixel(y, x));
+			}
+		}
+	}
+
+	return Benchmark::CountMismatches(target, expected);
+}
+
+}
+
+// Cost of 2x/4x/8x multisampling over the single sample path, with and without depth test, and of the resolve.
+void RunMultisampleBenchmark()
+{
+	std::vector<Benchmark::Triangle> triangles = make_scene(4000);
+
+	TextureBuffer target;
+	target.Create(s_width, s_height, eTextureLayout::Tiled);
+	DepthBuffer depthBuffer;
+	depthBuffer.Create(s_width, s_height, eTextureLayout::Tiled);
+	MultisampleBuffer multisampleBuffer;
+
+	for (bool isDepthTested : { false, true })
+	{
+		for (uint32 sampleCount : { 1u, 2u, 4u, 8u })
+		{
+			if (sampleCount != 1)
+			{
+				multisampleBuffer.Create(s_width, s_height, eTextureLayout::Tiled, sampleCount);
+			}
+
+			Rasterizer rasterizer;
+			auto draw = [&]() {
+				target.Clear(0xFF000000u);
+				depthBuffer.Clear(1.0f);
+				multisampleBuffer.Clear();
+				rasterizer.ResetStatistics();
+				for (const auto& triangle : triangles)
+				{
+					rasterizer.DrawTriangle(target, triangle.v[0], triangle.v[1], triangle.v[2], triangle.color, isDepthTested ? &depthBuffer : nullptr,
+						sampleCount != 1 ? &multisampleBuffer : nullptr);
+				}
+			};
+			draw();
+			const RasterStatistics statistics = rasterizer.GetStatistics();
+
+			char name[64];
+			std::snprintf(name, sizeof(name), "%ux%s", sampleCount, isDepthTested ? ", depth" : "");
+			Benchmark::ReportTriangles(name, Benchmark::Measure(draw), static_cast<double>(triangles.size()), static_cast<double>(statistics.pixelCount));
+			if (sampleCount == 1)
+			{
+				continue;
+			}
+
+			const uint32 splitBlockCount = multisampleBuffer.GetSplitBlockCount();
+			std::printf("  %-40s %10llu blocks multisampled %8u blocks split\n", "", static_cast<unsigned long long>(statistics.multisampleBlockCount), splitBlockCount);
+
+			std::snprintf(name, sizeof(name), "%ux%s resolve", sampleCount, isDepthTested ? ", depth" : "");
+			Benchmark::ReportPixels(name, Benchmark::Measure([&]() { multisampleBuffer.Resolve(target); }),
+				static_cast<double>(splitBlockCount) * MultisampleBuffer::s_blockPixels);
+		}
+	}
+
+	for (uint32 sampleCount : { 2u, 4u, 8u })
+	{
+		char name[64];
+		std::snprintf(name, sizeof(name), "%ux resolve vs 1x and sample averages", sampleCount);
+		Benchmark::ReportMismatches(name, check_resolve(triangles, sampleCount));
+	}
+}
\ No newline at end of file
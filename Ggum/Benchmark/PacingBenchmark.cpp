@@ -0,0 +1,150 @@
+#include <algorithm>
+#include <cmath>
+#include <ctime>
+
+#include "Benchmark.h"
+#include "gg.h"
+
+using namespace GG;
+
+namespace {
+
+const double s_runSeconds = 1.0;
+const uint64 s_millisecond = IClock::s_ticksPerSecond / 1000;
+
+// Deterministic clock, time only moves when the scheduler sleeps or spins or the caller advances it.
+class FakeClock : public IClock
+{
+public:
+	explicit FakeClock(uint64 oversleepTicks)
+		: _oversleepTicks{ oversleepTicks }
+	{}
+
+	virtual uint64 GetTicks() const override { return _ticks; }
+	virtual void Sleep(uint64 ticks) override
+	{
+		_ticks += ticks + _oversleepTicks + _spikeTicks;
+		_spikeTicks = 0;
+		_sleepCount++;
+	}
+	virtual void SpinWait() override { _ticks += s_spinTicks; }
+
+	void Advance(uint64 ticks) { _ticks += ticks; }
+	// The next sleep oversleeps this much more, like a preempted thread.
+	void AddSpike(uint64 ticks) { _spikeTicks += ticks; }
+	uint32 GetSleepCount() const { return _sleepCount; }
+
+private:
+	static constexpr uint64 s_spinTicks = 1000;
+
+	uint64 _ticks = 0;
+	uint64 _oversleepTicks;
+	uint64 _spikeTicks = 0;
+	uint32 _sleepCount = 0;
+};
+
+// Frames whose step count or alpha differ from the time simulated so far, with irregular frames and stalls past the step cap.
+// A stall only simulates maxSteps steps, the rest of it is dropped.
+uint32 check_fixed_steps()
+{
+	const uint64 stepTicks = 10 * s_millisecond;
+	const uint32 maxSteps = 3;
+	FakeClock clock(0);
+	FrameScheduler scheduler(clock);
+	scheduler.SetFixedTimestep(stepTicks);
+	scheduler.SetMaxStepsPerFrame(maxSteps);
+
+	uint32 mismatchCount = 0;
+	uint64 simulatedTicks = 0;
+	uint64 stepSum = 0;
+	for (uint32 frame = 0; frame < 240; frame++)
+	{
+		const FrameTiming timing = scheduler.BeginFrame();
+		stepSum += timing.stepCount;
+		simulatedTicks += std::min<uint64>(timing.frameTicks, maxSteps * stepTicks);
+		const float alpha = static_cast<float>(simulatedTicks % stepTicks) / stepTicks;
+		const bool isMatch = stepSum == simulatedTicks / stepTicks && timing.stepCount <= maxSteps && std::abs(timing.alpha - alpha) < 1e-6f
+			&& timing.stepSeconds == static_cast<float>(IClock::ToSeconds(stepTicks));
+		mismatchCount += isMatch ? 0 : 1;
+
+		// 1 to 17 ms frames with a 95 ms stall every 50 frames.
+		clock.Advance(frame % 50 == 49 ? 95 * s_millisecond : (1 + frame * 7 % 17) * s_millisecond + frame * 1234);
+	}
+
+	return mismatchCount;
+}
+
+// Frames which don't last exactly the target or never sleep. The first slice oversleeps by 50 ms, the sleep estimate
+// must stay capped after it so the limiter keeps sleeping instead of spinning every wait from then on.
+uint32 check_paced_frames()
+{
+	const uint64 targetTicks = 16 * s_millisecond;
+	FakeClock clock(s_millisecond / 2);
+	FrameScheduler scheduler(clock);
+	scheduler.SetTargetFrameTicks(targetTicks);
+	clock.AddSpike(50 * s_millisecond);
+
+	uint32 mismatchCount = 0;
+	for (uint32 frame = 0; frame < 120; frame++)
+	{
+		const FrameTiming timing = scheduler.BeginFrame();
+		const uint32 sleepCount = clock.GetSleepCount();
+		clock.Advance(targetTicks / 4);
+		scheduler.WaitForNextFrame();
+		// The spike overruns frame 0, frame 1 restarts the schedule without waiting and frame 2 is short of it.
+		const bool isMatch = frame <= 2 || (timing.frameTicks == targetTicks && clock.GetSleepCount() > sleepCount);
+		mismatchCount += isMatch ? 0 : 1;
+	}
+
+	return mismatchCount;
+}
+
+void report_check(const char* name, uint32 mismatchCount)
+{
+	std::printf("  %-40s %s (%u frames differ)\n", name, mismatchCount == 0 ? "match" : "MISMATCH", mismatchCount);
+}
+
+}
+
+// Frame limiter accuracy and the CPU time it burns while waiting, with a short fake workload per frame.
+void RunPacingBenchmark()
+{
+	report_check("fixed steps and alpha, fake clock", check_fixed_steps());
+	report_check("paced frames after a spike, fake clock", check_paced_frames());
+
+	SteadyClock clock;
+	for (uint32 frameRate : { 60u, 144u, 240u })
+	{
+		FrameScheduler scheduler(clock);
+		const uint64 targetTicks = IClock::s_ticksPerSecond / frameRate;
+		scheduler.SetTargetFrameTicks(targetTicks);
+
+		const uint32 frameCount = static_cast<uint32>(s_runSeconds * frameRate);
+		double errorSum = 0.0;
+		double maxError = 0.0;
+		const std::clock_t cpuStart = std::clock();
+		const uint64 start = clock.GetTicks();
+		for (uint32 frame = 0; frame < frameCount; frame++)
+		{
+			const FrameTiming timing = scheduler.BeginFrame();
+			if (frame > 0)
+			{
+				const double error = std::abs(static_cast<double>(timing.frameTicks) - static_cast<double>(targetTicks)) * 1e-3;
+				errorSum += error;
+				maxError = std::max(maxError, error);
+			}
+
+			const uint64 workEnd = clock.GetTicks() + targetTicks / 4;
+			while (clock.GetTicks() < workEnd)
+			{
+			}
+
+			scheduler.WaitForNextFrame();
+		}
+		const double wallSeconds = IClock::ToSeconds(clock.GetTicks() - start);
+		const double cpuSeconds = static_cast<double>(std::clock() - cpuStart) / CLOCKS_PER_SEC;
+
+		std::printf("  %3u Hz: %8.1f us mean error %8.1f us max error %6.1f%% CPU (25%% is work), sleep estimate %.1f us\n", frameRate,
+			errorSum / (frameCount - 1), maxError, cpuSeconds / wallSeconds * 100.0, IClock::ToSeconds(scheduler.GetSleepEstimate()) * 1e6);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,101 @@
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "Benchmark.h"
+#include "gg.h"
+
+using namespace GG;
+
+namespace {
+
+const uint32 s_width = 1280;
+const uint32 s_height = 720;
+const uint32 s_framesPerRun = 30;
+const uint32 s_particleCount = 200000;
+
+struct Particle
+{
+	float x, y;
+	float speedX, speedY;
+};
+
+// Simulates particles in OnUpdate() and splats them in OnRender(), about the same cost each.
+class ParticlePass : public RenderPass
+{
+public:
+	ParticlePass()
+		: RenderPass("Particles", RenderPassOrder::Opaque)
+	{
+		std::mt19937 random(23);
+		std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+		std::vector<Particle>& particles = _particles.GetUpdateState();
+		particles.resize(s_particleCount);
+		for (auto& particle : particles)
+		{
+			particle = Particle{ unit(random) * s_width, unit(random) * s_height, unit(random) * 200.0f - 100.0f, unit(random) * 200.0f - 100.0f };
+		}
+		_particles.Publish();
+	}
+
+	virtual void OnUpdate(float deltaTime) override
+	{
+		for (auto& particle : _particles.GetUpdateState())
+		{
+			// A swirl around the center, so the update costs a few transcendentals per particle.
+			const float angle = std::atan2(particle.y - s_height * 0.5f, particle.x - s_width * 0.5f);
+			particle.speedX += -std::sin(angle) * 30.0f * deltaTime;
+			particle.speedY += std::cos(angle) * 30.0f * deltaTime;
+			particle.x = wrap(particle.x + particle.speedX * deltaTime, static_cast<float>(s_width));
+			particle.y = wrap(particle.y + particle.speedY * deltaTime, static_cast<float>(s_height));
+		}
+	}
+
+	virtual void OnSnapshot() override
+	{
+		_particles.Publish();
+	}
+
+	virtual void OnRender(float alpha) override
+	{
+		TextureBuffer& backBuffer = _renderer->AcquireBackBuffer();
+		for (const auto& particle : _particles.GetRenderState())
+		{
+			backBuffer.BlendColorRect(static_cast<int32>(particle.y), static_cast<int32>(particle.x), 2, 2, PackColor(40, 30, 10, 64), eBlendMode::Additive);
+		}
+	}
+
+private:
+	static float wrap(float value, float size)
+	{
+		return value < 0.0f ? value + size : value >= size ? value - size : value;
+	}
+
+	FrameSnapshot<std::vector<Particle>> _particles;
+};
+
+}
+
+// Application frames with the update on the render thread against the update overlapped with the previous frame's render.
+void RunPipelineBenchmark()
+{
+	for (bool isPipelined : { false, true })
+	{
+		ApplicationProperty prop("Pipeline benchmark", s_width, s_height);
+		prop.isHeadless = true;
+		prop.frameCount = s_framesPerRun;
+		prop.isPipelined = isPipelined;
+
+		Application* app = Application::Create(prop);
+		Log::GetLogger()->set_level(spdlog::level::warn);
+		app->AddRenderPass(std::make_shared<ParticlePass>());
+
+		const double secondsPerRun = Benchmark::Measure([&]() {
+			app->Run();
+			});
+		Benchmark::ReportPixels(isPipelined ? "frame, pipelined update" : "frame, update then render", secondsPerRun / s_framesPerRun,
+			static_cast<double>(s_width) * s_height);
+
+		delete app;
+	}
+}
\ No newline at end of file
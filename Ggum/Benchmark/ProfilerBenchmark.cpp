@@ -0,0 +1,67 @@
+#include <cstdio>
+#include <filesystem>
+
+#include "Benchmark.h"
+#include "gg.h"
+
+using namespace GG;
+
+namespace {
+
+const uint32 s_zoneCount = 100000;
+const uint32 s_framesPerRun = 60;
+
+void run_zones()
+{
+	for (uint32 i = 0; i < s_zoneCount; i++)
+	{
+		GG_PROFILE_SCOPE("Benchmark zone");
+	}
+}
+
+// A few zones per frame, like a pass which instruments its own stages.
+class ProfiledRenderPass : public RenderPass
+{
+public:
+	ProfiledRenderPass()
+		: RenderPass("Profiled pass", RenderPassOrder::Opaque)
+	{}
+
+	virtual void OnRender(float alpha) override
+	{
+		TextureBuffer& backBuffer = _renderer->AcquireBackBuffer();
+		for (uint32 i = 0; i < 16; i++)
+		{
+			GG_PROFILE_SCOPE("Profiled pass rect");
+			backBuffer.FillRect(static_cast<int32>(i * 40), static_cast<int32>(i * 70), 200, 120, PackColor(40 + i * 10, 80, 160, 255));
+		}
+	}
+};
+
+}
+
+// Cost of a zone outside and inside of a capture, and a traced headless run written as a Chrome trace.
+void RunProfilerBenchmark()
+{
+	const double idleSeconds = Benchmark::Measure(run_zones);
+	Profiler::BeginCapture();
+	const double captureSeconds = Benchmark::Measure(run_zones);
+	Profiler::EndCapture();
+	std::printf("  %-40s %10.2f ns/zone\n", "zone, no capture", idleSeconds / s_zoneCount * 1e9);
+	std::printf("  %-40s %10.2f ns/zone\n", "zone, capturing", captureSeconds / s_zoneCount * 1e9);
+
+	const std::string path = (std::filesystem::temp_directory_path() / "gg_profiler_benchmark.json").string();
+	ApplicationProperty prop("Profiler benchmark", 1280, 720);
+	prop.isHeadless = true;
+	prop.frameCount = s_framesPerRun;
+	prop.traceCapturePath = path;
+
+	Application* app = Application::Create(prop);
+	Log::GetLogger()->set_level(spdlog::level::warn);
+	app->AddRenderPass(std::make_shared<ProfiledRenderPass>());
+	app->Run();
+	std::printf("  %u frames traced: %llu zones, %llu bytes in %s\n", s_framesPerRun, static_cast<unsigned long long>(Profiler::GetEventCount()),
+		static_cast<unsigned long long>(std::filesystem::file_size(path)), path.c_str());
+
+	delete app;
+}
\ No newline at end of file
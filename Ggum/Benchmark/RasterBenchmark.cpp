@@ -0,0 +1,59 @@
+#include <algorithm>
+#include <vector>
+
+#include "Benchmark.h"
+#include "gg.h"
+
+using namespace GG;
+
+namespace {
+
+const uint32 s_width = 1920;
+const uint32 s_height = 1080;
+
+// Triangles inscribed in a circle of the given diameter, random position and orientation.
+std::vector<Benchmark::Triangle> make_triangles(uint32 seed, float size, uint32 count)
+{
+	Benchmark::TriangleSceneDesc desc;
+	desc.width = s_width;
+	desc.height = s_height;
+	desc.minSize = size;
+	desc.maxSize = size;
+	desc.margin = size * 0.5f;
+	desc.cornerJitter = 1.2f;
+	return Benchmark::MakeTriangles(seed, count, desc);
+}
+
+}
+
+void RunRasterBenchmark()
+{
+	const float sizes[]{ 4.0f, 8.0f, 16.0f, 32.0f, 64.0f, 128.0f, 256.0f, 512.0f };
+
+	for (eTextureLayout layout : { eTextureLayout::Linear, eTextureLayout::Tiled })
+	{
+		TextureBuffer target;
+		target.Create(s_width, s_height, layout);
+
+		for (float size : sizes)
+		{
+			// Roughly the same number of pixels per size.
+			uint32 count = std::clamp(static_cast<uint32>(8e6f / (size * size)), 200u, 200000u);
+			std::vector<Benchmark::Triangle> triangles = make_triangles(99 + static_cast<uint32>(size), size, count);
+
+			Rasterizer rasterizer;
+			auto draw = [&]() {
+				for (const auto& triangle : triangles)
+				{
+					rasterizer.DrawTriangle(target, triangle.v[0], triangle.v[1], triangle.v[2], 0xFF40A0E0u);
+				}
+			};
+			draw();
+			double pixels = static_cast<double>(rasterizer.GetStatistics().pixelCount);
+
+			char name[64];
+			std::snprintf(name, sizeof(name), "%s, %3.0fpx triangles x%u", layout == eTextureLayout::Linear ? "linear" : "tiled", size, count);
+			Benchmark::ReportTriangles(name, Benchmark::Measure(draw), static_cast<double>(count), pixels);
+		}
+	}
+}
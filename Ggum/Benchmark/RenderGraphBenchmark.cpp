@@ -0,0 +1,193 @@
+#include <cmath>
+#include <memory>
+#include <vector>
+
+#include "Benchmark.h"
+#include "gg.h"
+
+using namespace GG;
+
+namespace {
+
+const uint32 s_width = 1280;
+const uint32 s_height = 720;
+const uint32 s_layerCount = 4;
+const uint32 s_triangleCount = 4000;
+// Fixed so that the async passes always have workers to run on and runs compare across machines.
+const uint32 s_threadCount = 4;
+
+// Triangles through the renderer, runs on the render thread.
+class SceneGraphPass : public RenderPass
+{
+public:
+	SceneGraphPass()
+		: RenderPass("Graph scene", RenderPassOrder::Opaque)
+	{
+		Benchmark::TriangleSceneDesc desc;
+		desc.width = s_width;
+		desc.height = s_height;
+		desc.minSize = 16.0f;
+		desc.maxSize = 96.0f;
+		desc.cornerJitter = 1.0f;
+		_triangles = Benchmark::MakeTriangles(22, s_triangleCount, desc);
+	}
+
+	virtual void OnRender(float alpha) override
+	{
+		for (const auto& triangle : _triangles)
+		{
+			_renderer->DrawTriangle(triangle.v[0], triangle.v[1], triangle.v[2], triangle.color);
+		}
+	}
+
+private:
+	std::vector<Benchmark::Triangle> _triangles;
+};
+
+// Shades a half resolution layer into its own transient texture, independent of the scene.
+// Shares the order of the composites, so each layer is added right before its composite and the
+// texture of a layer is dead by the time the next one is created, which lets the graph alias them.
+class LayerGraphPass : public RenderPass
+{
+public:
+	LayerGraphPass(uint32 layer)
+		: RenderPass("Graph layer", RenderPassOrder::AfterPostProcess)
+		, _layer{ layer }
+		, _row(s_width / 2)
+	{}
+
+	virtual void OnSetup(RenderGraphBuilder& builder) override
+	{
+		RenderTextureDesc desc;
+		desc.width = s_width / 2;
+		desc.height = s_height / 2;
+		_texture = builder.CreateTexture("layer" + std::to_string(_layer), desc);
+	}
+
+	virtual void OnExecute(RenderGraphContext& context) override
+	{
+		TextureBuffer& texture = context.GetTexture(_texture);
+		const uint32 width = texture.GetWidth();
+		for (uint32 row = 0; row < texture.GetHeight(); row++)
+		{
+			for (uint32 col = 0; col < width; col++)
+			{
+				const float u = col * (1.0f / width);
+				const float v = row * (1.0f / texture.GetHeight());
+				const float value = std::sin(u * 12.0f + _layer) * std::cos(v * 9.0f) * 0.5f + 0.5f;
+				_row[col] = PackColor(static_cast<uint8>(value * 255.0f), static_cast<uint8>(u * 255.0f), static_cast<uint8>(_layer * 60), 128);
+			}
+			texture.WriteRow(static_cast<int32>(row), 0, _row.data(), width);
+		}
+	}
+
+private:
+	uint32 _layer;
+	RenderResource _texture = RenderGraph::s_invalidResource;
+	std::vector<uint32> _row;
+};
+
+// Blends a layer over its quadrant of the back buffer, quadrants are disjoint so the composites run concurrently.
+class CompositeGraphPass : public RenderPass
+{
+public:
+	CompositeGraphPass(uint32 layer)
+		: RenderPass("Graph composite", RenderPassOrder::AfterPostProcess)
+		, _layer{ layer }
+		, _pixels(static_cast<size_t>(s_width / 2) * (s_height / 2))
+	{}
+
+	virtual void OnSetup(RenderGraphBuilder& builder) override
+	{
+		_texture = builder.FindTexture("layer" + std::to_string(_layer));
+		builder.Read(_texture);
+		builder.WriteBackBuffer(getQuadrant());
+	}
+
+	virtual void OnExecute(RenderGraphContext& context) override
+	{
+		const TextureRegion quadrant = getQuadrant();
+		context.GetTexture(_texture).Resolve(TextureRegion{ 0, 0, quadrant.width, quadrant.height }, _pixels.data(), quadrant.width);
+		context.GetBackBuffer().BlendRect(static_cast<int32>(quadrant.y), static_cast<int32>(quadrant.x), quadrant.width, quadrant.height,
+			_pixels.data(), quadrant.width, eBlendMode::SourceOver);
+	}
+
+private:
+	TextureRegion getQuadrant() const
+	{
+		return TextureRegion{ (_layer % 2) * (s_width / 2), (_layer / 2) * (s_height / 2), s_width / 2, s_height / 2 };
+	}
+
+	uint32 _layer;
+	RenderResource _texture = RenderGraph::s_invalidResource;
+	std::vector<uint32> _pixels;
+};
+
+// Copies the resolved pixels of a frame, the back buffer is reused by the next one.
+void copy_frame(const TextureBuffer& src, TextureBuffer& dst)
+{
+	dst.Create(src.GetWidth(), src.GetHeight());
+	std::vector<uint32> pixels(src.GetWidth());
+	for (uint32 row = 0; row < src.GetHeight(); row++)
+	{
+		for (uint32 col = 0; col < src.GetWidth(); col++)
+		{
+			pixels[col] = src.GetPixel(static_cast<int32>(row), static_cast<int32>(col));
+		}
+		dst.WriteRow(static_cast<int32>(row), 0, pixels.data(), src.GetWidth());
+	}
+}
+
+}
+
+// A frame of a scene pass, independent layer passes and their composites, run in pass order against the job system.
+void RunRenderGraphBenchmark()
+{
+	auto jobSystem = std::make_shared<JobSystem>();
+	jobSystem->Start(s_threadCount);
+	auto renderer = std::make_shared<HeadlessRenderer>(s_width, s_height);
+	renderer->SetJobSystem(jobSystem.get());
+	std::printf("  %u threads\n", s_threadCount);
+
+	RenderPath renderPath;
+	renderPath.SetRenderer(renderer);
+	renderPath.AddRenderPass(std::make_shared<SceneGraphPass>());
+	for (uint32 layer = 0; layer < s_layerCount; layer++)
+	{
+		renderPath.AddRenderPass(std::make_shared<LayerGraphPass>(layer));
+		renderPath.AddRenderPass(std::make_shared<CompositeGraphPass>(layer));
+	}
+
+	auto renderFrame = [&]() {
+		renderer->Prepare();
+		renderPath.Render();
+		renderer->Submit();
+		renderer->Present();
+	};
+
+	Benchmark::ReportPixels("graph frame, sequential", Benchmark::Measure(renderFrame), static_cast<double>(s_width) * s_height);
+	TextureBuffer reference;
+	copy_frame(renderer->AcquireBackBuffer(), reference);
+	renderer->ReleaseBackBuffer();
+
+	renderPath.SetJobSystem(jobSystem);
+	for (bool isTextureAliasingEnabled : { true, false })
+	{
+		renderPath.GetRenderGraph().SetTextureAliasingEnabled(isTextureAliasingEnabled);
+		const double seconds = Benchmark::Measure(renderFrame);
+		const RenderGraph& graph = renderPath.GetRenderGraph();
+		char name[64];
+		std::snprintf(name, sizeof(name), "graph frame, jobs, aliasing %s", isTextureAliasingEnabled ? "on" : "off");
+		Benchmark::ReportPixels(name, seconds, static_cast<double>(s_width) * s_height);
+		std::printf("    %u passes, %u async, %u edges, %u transient textures in %u buffers\n", graph.GetPassCount(), graph.GetAsyncPassCount(),
+			graph.GetDependencyCount(), graph.GetTransientTextureCount(), graph.GetPhysicalTextureCount());
+
+		std::snprintf(name, sizeof(name), "aliasing %s vs sequential", isTextureAliasingEnabled ? "on" : "off");
+		Benchmark::ReportMismatches(name, Benchmark::CountMismatches(renderer->AcquireBackBuffer(), reference));
+		renderer->ReleaseBackBuffer();
+	}
+
+	renderer->SetJobSystem(nullptr);
+	renderPath.Clear();
+	jobSystem->Stop();
+}
\ No newline at end of file
@@ -0,0 +1,207 @@
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <random>
+#include <vector>
+
+#include "Benchmark.h"
+#include "gg.h"
+
+using namespace GG;
+
+namespace {
+
+const uint32 s_width = 1920;
+const uint32 s_height = 1080;
+
+inline uint32 pack_unorm(float r, float g, float b)
+{
+	return static_cast<uint32>(r * 255.0f) | (static_cast<uint32>(g * 255.0f) << 8) | (static_cast<uint32>(b * 255.0f) << 16) | 0xFF000000u;
+}
+
+struct SolidShader : public PixelShader<SolidShader, 0>
+{
+	void Shade(const Run&, uint32* outColors) const
+	{
+		for (uint32 lane = 0; lane < Run::s_laneCount; lane++)
+		{
+			outColors[lane] = 0xFF40A0E0u;
+		}
+	}
+};
+
+// Vertex colors.
+struct GradientShader : public PixelShader<GradientShader, 3>
+{
+	void Shade(const Run& run, uint32* outColors) const
+	{
+		for (uint32 lane = 0; lane < Run::s_laneCount; lane++)
+		{
+			outColors[lane] = pack_unorm(run.attributes[0][lane], run.attributes[1][lane], run.attributes[2][lane]);
+		}
+	}
+};
+
+// Vertices with four attributes of which only the third one is read, the others are never interpolated.
+struct SingleAttributeShader : public PixelShader<SingleAttributeShader, 4>
+{
+	static constexpr uint32 s_usedAttributeMask = BIT_UINT32(2);
+
+	void Shade(const Run& run, uint32* outColors) const
+	{
+		for (uint32 lane = 0; lane < Run::s_laneCount; lane++)
+		{
+			const float value = run.attributes[2][lane];
+			outColors[lane] = pack_unorm(value, value, value);
+		}
+	}
+};
+
+// Same output as GradientShader through a std::function per pixel, what the template interface avoids.
+struct FunctionShader : public PixelShader<FunctionShader, 3>
+{
+	std::function<uint32(float, float, float)> shadePixel;
+
+	void Shade(const Run& run, uint32* outColors) const
+	{
+		for (uint32 lane = 0; lane < Run::s_laneCount; lane++)
+		{
+			outColors[lane] = shadePixel(run.attributes[0][lane], run.attributes[1][lane], run.attributes[2][lane]);
+		}
+	}
+};
+
+// Triangles inscribed in a circle of the given diameter with random attributes in [0, 1] and 1 / w in [0.25, 1].
+template<uint32 AttributeCount>
+std::vector<ShadedVertex<AttributeCount>> make_triangles(float size, uint32 count)
+{
+	std::mt19937 random(3);
+	std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+	std::vector<ShadedVertex<AttributeCount>> vertices(count * 3);
+	for (uint32 triangle = 0; triangle < count; triangle++)
+	{
+		float centerX = size * 0.5f + unit(random) * (s_width - size);
+		float centerY = size * 0.5f + unit(random) * (s_height - size);
+		float base = unit(random) * 6.2831853f;
+		for (uint32 i = 0; i < 3; i++)
+		{
+			auto& vertex = vertices[triangle * 3 + i];
+			float a = base + 2.0943951f * i;
+			vertex.x = centerX + std::cos(a) * size * 0.5f;
+			vertex.y = centerY + std::sin(a) * size * 0.5f;
+			vertex.z = 0.0f;
+			vertex.inverseW = 0.25f + unit(random) * 0.75f;
+			for (uint32 attribute = 0; attribute < AttributeCount; attribute++)
+			{
+				vertex.attributes[attribute] = unit(random);
+			}
+		}
+	}
+
+	return vertices;
+}
+
+template<typename Shader>
+void run_shader(const char* name, const Shader& shader, TextureBuffer& target, float size, uint32 count)
+{
+	const auto vertices = make_triangles<Shader::s_attributeCount>(size, count);
+	Rasterizer rasterizer;
+	auto draw = [&]() {
+		for (uint32 i = 0; i < count; i++)
+		{
+			Shader::DrawTriangle(rasterizer, target, shader, vertices[i * 3], vertices[i * 3 + 1], vertices[i * 3 + 2]);
+		}
+	};
+	draw();
+	const double pixels = static_cast<double>(rasterizer.GetStatistics().pixelCount);
+
+	Benchmark::ReportTriangles(name, Benchmark::Measure(draw), static_cast<double>(count), pixels);
+}
+
+// Shades triangles crossing the edges of a linear target whose size isn't a multiple of the block size, where runs of border blocks
+// leave the row, and compares it against the unshaded path. Returns the pixels which differ.
+uint64 check_odd_size(uint32 width, uint32 height)
+{
+	Benchmark::TriangleSceneDesc desc;
+	desc.width = width;
+	desc.height = height;
+	desc.largeInterval = 8;
+	desc.margin = -8.0f;
+	const std::vector<Benchmark::Triangle> triangles = Benchmark::MakeTriangles(15, 300, desc);
+
+	TextureBuffer solidTarget;
+	TextureBuffer shadedTarget;
+	solidTarget.Create(width, height);
+	shadedTarget.Create(width, height);
+	solidTarget.Clear(0xFF000000u);
+	shadedTarget.Clear(0xFF000000u);
+
+	Rasterizer rasterizer;
+	const SolidShader shader;
+	for (const auto& triangle : triangles)
+	{
+		const RasterVertex* v = triangle.v;
+		rasterizer.DrawTriangle(solidTarget, v[0], v[1], v[2], 0xFF40A0E0u);
+		SolidShader::DrawTriangle(rasterizer, shadedTarget, shader, ShadedVertex<0>{ v[0].x, v[0].y, 0.0f, 1.0f, {} },
+			ShadedVertex<0>{ v[1].x, v[1].y, 0.0f, 1.0f, {} }, ShadedVertex<0>{ v[2].x, v[2].y, 0.0f, 1.0f, {} });
+	}
+
+	return Benchmark::CountMismatches(solidTarget, shadedTarget);
+}
+
+}
+
+void RunShaderBenchmark()
+{
+	TextureBuffer target;
+	target.Create(s_width, s_height, eTextureLayout::Tiled);
+
+	const float size = 128.0f;
+	const uint32 count = 2000;
+
+	{
+		const auto vertices = make_triangles<0>(size, count);
+		Rasterizer rasterizer;
+		auto draw = [&]() {
+			for (uint32 i = 0; i < count; i++)
+			{
+				const auto* v = &vertices[i * 3];
+				rasterizer.DrawTriangle(target, RasterVertex{ v[0].x, v[0].y }, RasterVertex{ v[1].x, v[1].y }, RasterVertex{ v[2].x, v[2].y }, 0xFF40A0E0u);
+			}
+		};
+		draw();
+		const double pixels = static_cast<double>(rasterizer.GetStatistics().pixelCount);
+		Benchmark::ReportTriangles("solid color, no shader", Benchmark::Measure(draw), static_cast<double>(count), pixels);
+	}
+
+	run_shader("solid shader, 0 attributes", SolidShader{}, target, size, count);
+	run_shader("gradient shader, 3 attributes", GradientShader{}, target, size, count);
+	run_shader("1 of 4 attributes used", SingleAttributeShader{}, target, size, count);
+
+	FunctionShader functionShader;
+	functionShader.shadePixel = [](float r, float g, float b) { return pack_unorm(r, g, b); };
+	run_shader("gradient, std::function per pixel", functionShader, target, size, count);
+
+	// Same gradient through the binned batch path.
+	const auto vertices = make_triangles<3>(size, count);
+	std::vector<uint32> indices(count * 3);
+	for (uint32 i = 0; i < count * 3; i++)
+	{
+		indices[i] = i;
+	}
+	const GradientShader gradientShader;
+	const ShadedBatch batch = GradientShader::MakeBatch(gradientShader, vertices.data(), indices.data(), count * 3);
+	BinnedRasterizer binnedRasterizer(1);
+	auto drawBatch = [&]() { binnedRasterizer.DrawBatch(target, batch); };
+	drawBatch();
+	const double pixels = static_cast<double>(binnedRasterizer.GetStatistics().pixelCount);
+	binnedRasterizer.ResetStatistics();
+	Benchmark::ReportTriangles("gradient batch, binned, 1 thread", Benchmark::Measure(drawBatch), static_cast<double>(count), pixels);
+
+	for (const auto& size : { std::make_pair(13u, 13u), std::make_pair(1021u, 579u) })
+	{
+		char name[64];
+		std::snprintf(name, sizeof(name), "linear %ux%u, shaded vs solid", size.first, size.second);
+		Benchmark::ReportMismatches(name, check_odd_size(size.first, size.second));
+	}
+}
\ No newline at end of file
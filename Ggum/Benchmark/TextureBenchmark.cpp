@@ -0,0 +1,121 @@
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "Benchmark.h"
+#include "gg.h"
+
+using namespace GG;
+
+namespace {
+
+const uint32 s_width = 1920;
+const uint32 s_height = 1080;
+const uint32 s_textureSize = 1024;
+
+// Screen pixels in 2x2 quads, mapped onto a rotated and scaled texture plane.
+void make_quad_coordinates(float angle, float texelsPerPixel, std::vector<float>& outU, std::vector<float>& outV)
+{
+	const float scale = texelsPerPixel / s_textureSize;
+	const float c = std::cos(angle) * scale;
+	const float s = std::sin(angle) * scale;
+	outU.clear();
+	outV.clear();
+	for (uint32 y = 0; y < s_height; y += 2)
+	{
+		for (uint32 x = 0; x < s_width; x += 2)
+		{
+			for (uint32 corner = 0; corner < 4; corner++)
+			{
+				const float px = x + (corner & 1) + 0.5f;
+				const float py = y + (corner >> 1) + 0.5f;
+				outU.push_back(px * c - py * s);
+				outV.push_back(px * s + py * c);
+			}
+		}
+	}
+}
+
+// Draws the texture with the perspective of a floor, through the pixel shader path.
+struct TexturedShader : public PixelShader<TexturedShader, 2>
+{
+	const Texture2D* texture;
+	SamplerState sampler;
+
+	void Shade(const Run& run, uint32* outColors) const
+	{
+		texture->SampleQuads(sampler, run.attributes[0], run.attributes[1], outColors, Run::s_laneCount);
+	}
+};
+
+}
+
+void RunTextureBenchmark()
+{
+	std::mt19937 random(11);
+	std::vector<uint32> pixels(s_textureSize * s_textureSize);
+	for (uint32 y = 0; y < s_textureSize; y++)
+	{
+		for (uint32 x = 0; x < s_textureSize; x++)
+		{
+			// Checker with noise, so the mips aren't flat.
+			pixels[y * s_textureSize + x] = (((x >> 4) ^ (y >> 4)) & 1 ? 0xFFE0E0E0u : 0xFF202020u) ^ (random() & 0x001F1F1Fu);
+		}
+	}
+
+	std::vector<float> u;
+	std::vector<float> v;
+	std::vector<uint32> colors(s_width * s_height);
+	const uint32 count = s_width * s_height;
+
+	for (eTextureLayout layout : { eTextureLayout::Linear, eTextureLayout::Tiled })
+	{
+		Texture2D texture;
+		texture.Create(s_textureSize, s_textureSize, pixels.data(), s_textureSize, true, layout);
+		const char* layoutName = layout == eTextureLayout::Linear ? "linear" : "tiled";
+
+		for (float angle : { 0.0f, 1.3f })
+		{
+			make_quad_coordinates(angle, 1.5f, u, v);
+			char name[64];
+
+			SamplerState sampler;
+			sampler.filter = eTextureFilter::Point;
+			std::snprintf(name, sizeof(name), "%s, %.1f rad, point lod 0", layoutName, angle);
+			Benchmark::ReportPixels(name, Benchmark::Measure([&]() { texture.Sample(sampler, u.data(), v.data(), 0.0f, colors.data(), count); }), count);
+
+			sampler.filter = eTextureFilter::Bilinear;
+			std::snprintf(name, sizeof(name), "%s, %.1f rad, bilinear lod 0", layoutName, angle);
+			Benchmark::ReportPixels(name, Benchmark::Measure([&]() { texture.Sample(sampler, u.data(), v.data(), 0.0f, colors.data(), count); }), count);
+
+			sampler.filter = eTextureFilter::Trilinear;
+			std::snprintf(name, sizeof(name), "%s, %.1f rad, trilinear quads", layoutName, angle);
+			Benchmark::ReportPixels(name, Benchmark::Measure([&]() { texture.SampleQuads(sampler, u.data(), v.data(), colors.data(), count); }), count);
+		}
+	}
+
+	// Full screen floor, the LOD changes from 0 at the bottom to the smallest mips at the horizon.
+	Texture2D texture;
+	texture.Create(s_textureSize, s_textureSize, pixels.data(), s_textureSize);
+	TextureBuffer target;
+	target.Create(s_width, s_height, eTextureLayout::Tiled);
+
+	TexturedShader shader;
+	shader.texture = &texture;
+	const float nearW = 1.0f;
+	const float farW = 40.0f;
+	const TexturedShader::Vertex corners[4]{
+		{ 0.0f, 0.0f, 0.0f, 1.0f / farW, { 0.0f, 0.0f } },
+		{ static_cast<float>(s_width), 0.0f, 0.0f, 1.0f / farW, { 40.0f, 0.0f } },
+		{ 0.0f, static_cast<float>(s_height), 0.0f, 1.0f / nearW, { 0.0f, 40.0f } },
+		{ static_cast<float>(s_width), static_cast<float>(s_height), 0.0f, 1.0f / nearW, { 40.0f, 40.0f } },
+	};
+	Rasterizer rasterizer;
+	auto draw = [&]() {
+		TexturedShader::DrawTriangle(rasterizer, target, shader, corners[0], corners[1], corners[2]);
+		TexturedShader::DrawTriangle(rasterizer, target, shader, corners[1], corners[3], corners[2]);
+	};
+	draw();
+	rasterizer.ResetStatistics();
+	Benchmark::ReportPixels("floor, trilinear shader", Benchmark::Measure(draw), count);
+}
\ No newline at end of file
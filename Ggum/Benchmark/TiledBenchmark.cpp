@@ -0,0 +1,153 @@
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "Benchmark.h"
+#include "System/Graphics/TextureBuffer.h"
+
+using namespace GG;
+
+namespace {
+
+// Larger than the last level cache on our boxes, so the layout actually matters.
+const uint32 s_width = 1920;
+const uint32 s_height = 1080;
+
+struct Rect
+{
+	int32 row, col;
+	uint32 width, height;
+};
+
+struct Triangle
+{
+	int32 x[3];
+	int32 y[3];
+};
+
+int32 edge(int32 ax, int32 ay, int32 bx, int32 by, int32 px, int32 py)
+{
+	return (bx - ax) * (py - ay) - (by - ay) * (px - ax);
+}
+
+// Walks the bounding box in 8x8 blocks the way a tile based rasterizer does and writes the covered pixels one by one.
+uint64 rasterize_blocks(TextureBuffer& buffer, const Triangle& triangle, uint32 color)
+{
+	int32 minX = std::max(0, std::min({ triangle.x[0], triangle.x[1], triangle.x[2] }));
+	int32 minY = std::max(0, std::min({ triangle.y[0], triangle.y[1], triangle.y[2] }));
+	int32 maxX = std::min(static_cast<int32>(s_width) - 1, std::max({ triangle.x[0], triangle.x[1], triangle.x[2] }));
+	int32 maxY = std::min(static_cast<int32>(s_height) - 1, std::max({ triangle.y[0], triangle.y[1], triangle.y[2] }));
+
+	uint64 covered = 0;
+	for (int32 blockY = minY & ~7; blockY <= maxY; blockY += 8)
+	{
+		for (int32 blockX = minX & ~7; blockX <= maxX; blockX += 8)
+		{
+			for (int32 y = std::max(blockY, minY); y < std::min(blockY + 8, maxY + 1); y++)
+			{
+				for (int32 x = std::max(blockX, minX); x < std::min(blockX + 8, maxX + 1); x++)
+				{
+					int32 w0 = edge(triangle.x[1], triangle.y[1], triangle.x[2], triangle.y[2], x, y);
+					int32 w1 = edge(triangle.x[2], triangle.y[2], triangle.x[0], triangle.y[0], x, y);
+					int32 w2 = edge(triangle.x[0], triangle.y[0], triangle.x[1], triangle.y[1], x, y);
+					if ((w0 | w1 | w2) >= 0)
+					{
+						buffer.SetPixel(y, x, color);
+						covered++;
+					}
+				}
+			}
+		}
+	}
+
+	return covered;
+}
+
+void run_layout(const char* layoutName, eTextureLayout layout, const std::vector<Rect>& rects, const std::vector<Triangle>& triangles, double rectPixels, double trianglePixels)
+{
+	TextureBuffer buffer;
+	buffer.Create(s_width, s_height, layout);
+
+	char name[64];
+
+	std::snprintf(name, sizeof(name), "%s, random 4-48px FillRect", layoutName);
+	Benchmark::ReportPixels(name, Benchmark::Measure([&]() {
+		for (const auto& rect : rects)
+		{
+			buffer.FillRect(rect.row, rect.col, rect.width, rect.height, 0xFF3080C0u);
+		}
+		}), rectPixels);
+
+	std::vector<uint32> sprite(48 * 48, 0xFF102030u);
+	std::snprintf(name, sizeof(name), "%s, random 4-48px BlitRect", layoutName);
+	Benchmark::ReportPixels(name, Benchmark::Measure([&]() {
+		for (const auto& rect : rects)
+		{
+			buffer.BlitRect(rect.row, rect.col, rect.width, rect.height, sprite.data(), 48);
+		}
+		}), rectPixels);
+
+	std::snprintf(name, sizeof(name), "%s, triangles in 8x8 blocks", layoutName);
+	Benchmark::ReportPixels(name, Benchmark::Measure([&]() {
+		for (const auto& triangle : triangles)
+		{
+			rasterize_blocks(buffer, triangle, 0xFF00FF00u);
+		}
+		}), trianglePixels);
+
+	// Upload side: everything was written, so the whole frame is resolved into a linear staging area.
+	std::vector<uint32> staging(static_cast<size_t>(s_width) * s_height);
+	TextureRegion frame{ 0, 0, s_width, s_height };
+	std::snprintf(name, sizeof(name), "%s, full frame resolve", layoutName);
+	Benchmark::ReportPixels(name, Benchmark::Measure([&]() {
+		buffer.Resolve(frame, staging.data(), s_width);
+		}), static_cast<double>(s_width) * s_height);
+}
+
+}
+
+void RunTiledBenchmark()
+{
+	std::mt19937 random(4321);
+
+	std::vector<Rect> rects(20000);
+	double rectPixels = 0.0;
+	for (auto& rect : rects)
+	{
+		rect.width = 4 + random() % 45;
+		rect.height = 4 + random() % 45;
+		rect.row = static_cast<int32>(random() % (s_height - rect.height));
+		rect.col = static_cast<int32>(random() % (s_width - rect.width));
+		rectPixels += static_cast<double>(rect.width) * rect.height;
+	}
+
+	// Small and medium triangles scattered over the screen, wound so the edge functions are positive inside.
+	std::vector<Triangle> triangles(4000);
+	for (auto& triangle : triangles)
+	{
+		int32 size = 8 + static_cast<int32>(random() % 120);
+		int32 x = static_cast<int32>(random() % (s_width - size));
+		int32 y = static_cast<int32>(random() % (s_height - size));
+		for (uint32 i = 0; i < 3; i++)
+		{
+			triangle.x[i] = x + static_cast<int32>(random() % size);
+			triangle.y[i] = y + static_cast<int32>(random() % size);
+		}
+		if (edge(triangle.x[0], triangle.y[0], triangle.x[1], triangle.y[1], triangle.x[2], triangle.y[2]) < 0)
+		{
+			std::swap(triangle.x[1], triangle.x[2]);
+			std::swap(triangle.y[1], triangle.y[2]);
+		}
+	}
+
+	TextureBuffer counter;
+	counter.Create(s_width, s_height);
+	double trianglePixels = 0.0;
+	for (const auto& triangle : triangles)
+	{
+		trianglePixels += static_cast<double>(rasterize_blocks(counter, triangle, 0));
+	}
+
+	run_layout("linear", eTextureLayout::Linear, rects, triangles, rectPixels, trianglePixels);
+	run_layout("tiled", eTextureLayout::Tiled, rects, triangles, rectPixels, trianglePixels);
+}
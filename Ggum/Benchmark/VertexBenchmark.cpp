@@ -0,0 +1,86 @@
+#include <random>
+#include <vector>
+
+#include "Benchmark.h"
+#include "gg.h"
+
+using namespace GG;
+
+namespace {
+
+const uint32 s_width = 1920;
+const uint32 s_height = 1080;
+
+// A grid of quads bent into a wavy sheet starting behind the camera, so its first rows cross the near plane and leave the guard band.
+struct Mesh
+{
+	std::vector<float> x;
+	std::vector<float> y;
+	std::vector<float> z;
+	std::vector<uint32> indices;
+};
+
+Mesh make_sheet(uint32 columns, uint32 rows)
+{
+	Mesh mesh;
+	std::mt19937 random(5);
+	std::uniform_real_distribution<float> jitter(-0.2f, 0.2f);
+	for (uint32 row = 0; row <= rows; row++)
+	{
+		for (uint32 column = 0; column <= columns; column++)
+		{
+			float u = static_cast<float>(column) / columns;
+			float v = static_cast<float>(row) / rows;
+			mesh.x.push_back((u - 0.5f) * 60.0f);
+			mesh.y.push_back((std::sin(u * 20.0f) * std::cos(v * 13.0f) + jitter(random)) * v * 4.0f);
+			mesh.z.push_back(-v * 80.0f + 2.0f);
+		}
+	}
+	for (uint32 row = 0; row < rows; row++)
+	{
+		for (uint32 column = 0; column < columns; column++)
+		{
+			uint32 i = row * (columns + 1) + column;
+			uint32 quad[6]{ i, i + 1, i + columns + 2, i, i + columns + 2, i + columns + 1 };
+			mesh.indices.insert(mesh.indices.end(), quad, quad + 6);
+		}
+	}
+
+	return mesh;
+}
+
+}
+
+void RunVertexBenchmark()
+{
+	Mesh mesh = make_sheet(1000, 250);
+	const uint32 vertexCount = static_cast<uint32>(mesh.x.size());
+	const uint32 indexCount = static_cast<uint32>(mesh.indices.size());
+	const VertexPositions positions{ mesh.x.data(), mesh.y.data(), mesh.z.data(), vertexCount };
+	const Matrix4 transform = Matrix4::Perspective(1.0f, static_cast<float>(s_width) / s_height, 0.1f, 100.0f) * Matrix4::Translation(0.0f, -0.05f, 0.0f);
+
+	VertexPipeline pipeline;
+	pipeline.SetViewport(s_width, s_height);
+
+	char name[64];
+	std::snprintf(name, sizeof(name), "transform, %u vertices", vertexCount);
+	Benchmark::ReportVertices(name, Benchmark::Measure([&]() {
+		pipeline.TransformVertices(transform, positions);
+		}), static_cast<double>(vertexCount));
+
+	pipeline.ResetStatistics();
+	uint64 emittedCount = 0;
+	auto assemble = [&]() {
+		pipeline.AssembleTriangles(mesh.indices.data(), indexCount, [&](const RasterVertex&, const RasterVertex&, const RasterVertex&, uint32) {
+			emittedCount++;
+			});
+	};
+	assemble();
+	const VertexStatistics statistics = pipeline.GetStatistics();
+	const uint64 triangleCount = emittedCount;
+
+	std::snprintf(name, sizeof(name), "assembly, %u triangles", indexCount / 3);
+	Benchmark::ReportVertices(name, Benchmark::Measure(assemble), static_cast<double>(indexCount));
+	std::printf("  %-40s %10llu culled %8llu clipped %10llu emitted\n", "", static_cast<unsigned long long>(statistics.culledTriangleCount),
+		static_cast<unsigned long long>(statistics.clippedTriangleCount), static_cast<unsigned long long>(triangleCount));
+}
\ No newline at end of file
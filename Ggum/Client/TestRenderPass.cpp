@@ -2,6 +2,23 @@
 
 using namespace GG;
 
+namespace {
+
+// Interpolates the vertex colors.
+struct VertexColorShader : public GG::PixelShader<VertexColorShader, 3>
+{
+	void Shade(const Run& run, uint32* outColors) const
+	{
+		for (uint32 lane = 0; lane < Run::s_laneCount; lane++)
+		{
+			outColors[lane] = GG::PackColor(static_cast<uint8>(run.attributes[0][lane] * 255.0f), static_cast<uint8>(run.attributes[1][lane] * 255.0f),
+				static_cast<uint8>(run.attributes[2][lane] * 255.0f), 255);
+		}
+	}
+};
+
+}
+
 TestRenderPass::TestRenderPass(std::string passName, GG::RenderPassOrder order)
 	: Base(passName, order)
 {}
@@ -18,7 +35,7 @@ void TestRenderPass::OnDetach()
 
 void TestRenderPass::OnUpdate(float deltaTime)
 {
-
+	_angle += deltaTime;
 }
 
 void TestRenderPass::OnEvent(Event& e)
@@ -27,7 +44,7 @@ void TestRenderPass::OnEvent(Event& e)
 	dispatcher.Dispatch<GG::KeyPressedEvent>(std::bind(&TestRenderPass::onKeyPressedEvent, this, std::placeholders::_1));
 }
 
-void TestRenderPass::OnRender()
+void TestRenderPass::OnRender(float alpha)
 {
 	static uint8 r = 0, g = 0, b = 0;
 	r += 2;
@@ -36,6 +53,42 @@ void TestRenderPass::OnRender()
 	uint8 color[]{ r, g, b, 255 };
 	drawG(225, 400, color);
 	drawG(225, 700, color);
+
+	// Spinning triangle next to the letters with red, green and blue corners.
+	const float centerX = 1250.0f;
+	const float centerY = 400.0f;
+	VertexColorShader::Vertex vertices[3];
+	for (uint32 i = 0; i < 3; i++)
+	{
+		float angle = _angle + 2.0943951f * i;
+		vertices[i] = VertexColorShader::Vertex{ centerX + std::cos(angle) * 150.0f, centerY + std::sin(angle) * 150.0f, 0.0f, 1.0f, { i == 0 ? 1.0f : 0.0f, i == 1 ? 1.0f : 0.0f, i == 2 ? 1.0f : 0.0f } };
+	}
+	static const uint32 s_indices[]{ 0, 1, 2 };
+	const VertexColorShader shader;
+	_renderer->DrawShaded(VertexColorShader::MakeBatch(shader, vertices, s_indices, 3));
+
+	// Debug overlay: bounding box of the triangle, antialiased outline and its corners.
+	float minX = vertices[0].x, maxX = vertices[0].x, minY = vertices[0].y, maxY = vertices[0].y;
+	GG::LineSegment lines[7];
+	GG::RasterPoint corners[3];
+	for (uint32 i = 0; i < 3; i++)
+	{
+		const VertexColorShader::Vertex& v0 = vertices[i];
+		const VertexColorShader::Vertex& v1 = vertices[(i + 1) % 3];
+		lines[i] = GG::LineSegment{ v0.x, v0.y, v1.x, v1.y, 0xFFFFFFFFu };
+		corners[i] = GG::RasterPoint{ v0.x, v0.y, 0xFF00FFFFu };
+		minX = std::min(minX, v0.x);
+		maxX = std::max(maxX, v0.x);
+		minY = std::min(minY, v0.y);
+		maxY = std::max(maxY, v0.y);
+	}
+	lines[3] = GG::LineSegment{ minX, minY, maxX, minY, 0xFF808080u };
+	lines[4] = GG::LineSegment{ maxX, minY, maxX, maxY, 0xFF808080u };
+	lines[5] = GG::LineSegment{ maxX, maxY, minX, maxY, 0xFF808080u };
+	lines[6] = GG::LineSegment{ minX, maxY, minX, minY, 0xFF808080u };
+	_renderer->DrawLines(lines, 3, true);
+	_renderer->DrawLines(lines + 3, 4);
+	_renderer->DrawPoints(corners, 3, 6.0f, true);
 }
 
 void TestRenderPass::OnGUI()
@@ -57,61 +110,70 @@ void TestRenderPass::OnGUI()
 	ImGui::NewLine();
 
 	ImGui::Text("Application average %.3f ms/frame (%.1f FPS)", 1000.0f / io.Framerate, io.Framerate);
-	ImGui::End();
-}
 
-void TestRenderPass::drawG(uint32 row, uint32 col, uint8* color)
-{
-	uint8 randomColor[]{ 0,0,0,255 };
-	for (uint32 i = row; i < row + 50; i++)
+	const GG::UploadStatistics& uploadStatistics = _renderer->GetUploadStatistics();
+	ImGui::Text("Dirty tiles %u / %u, %u cleared (%u regions, %.1f KB)", uploadStatistics.dirtyTileCount, uploadStatistics.totalTileCount, uploadStatistics.clearedTileCount, uploadStatistics.regionCount, uploadStatistics.uploadedBytes / 1024.0f);
+
+	const GG::RasterStatistics& rasterStatistics = _renderer->GetRasterStatistics();
+	ImGui::Text("Triangles %llu, blocks %llu full / %llu partial, %llu pixels", rasterStatistics.triangleCount, rasterStatistics.fullBlockCount, rasterStatistics.partialBlockCount, rasterStatistics.pixelCount);
+	ImGui::Text("Depth rejected %llu blocks, %llu pixels", rasterStatistics.depthRejectedBlockCount, rasterStatistics.depthRejectedPixelCount);
+	ImGui::Text("Multisampled blocks %llu", rasterStatistics.multisampleBlockCount);
+
+	ImGui::ColorEdit3("Clear color", &clearColor.x);
+	_renderer->SetClearColor(GG::PackColor(&clearColor.x));
+
+	int framesInFlight = static_cast<int>(_renderer->GetFramesInFlight());
+	if (ImGui::SliderInt("Frames in flight", &framesInFlight, 1, 3))
 	{
-		for (uint32 j = col; j < col + 200; j++)
-		{
-			randomColor[0] = static_cast<uint8>(GG::Random::UInt());
-			randomColor[1] = static_cast<uint8>(GG::Random::UInt());
-			randomColor[2] = static_cast<uint8>(GG::Random::UInt());
-			_renderer->SetPixelForDebug(i, j, randomColor);
-		}
+		_renderer->SetFramesInFlight(static_cast<uint32>(framesInFlight));
 	}
-	for (uint32 i = row + 50; i < row + 250; i++)
+
+	static const char* s_sampleCountNames[]{ "Off", "2x", "4x", "8x" };
+	const uint32 sampleCount = _renderer->GetSampleCount();
+	int sampleCountIndex = sampleCount == 8 ? 3 : static_cast<int>(sampleCount / 2);
+	if (ImGui::Combo("MSAA", &sampleCountIndex, s_sampleCountNames, IM_ARRAYSIZE(s_sampleCountNames)))
 	{
-		for (uint32 j = col; j < col + 50; j++)
-		{
-			randomColor[0] = static_cast<uint8>(GG::Random::UInt());
-			randomColor[1] = static_cast<uint8>(GG::Random::UInt());
-			randomColor[2] = static_cast<uint8>(GG::Random::UInt());
-			_renderer->SetPixelForDebug(i, j, randomColor);
-		}
+		_renderer->SetSampleCount(1u << sampleCountIndex);
 	}
-	for (uint32 i = row + 200; i < row + 250; i++)
+
+	bool isDynamicResolution = _renderer->IsDynamicResolutionEnabled();
+	if (ImGui::Checkbox("Dynamic resolution (4 ms budget)", &isDynamicResolution))
 	{
-		for (uint32 j = col + 50; j < col + 200; j++)
+		if (isDynamicResolution)
 		{
-			randomColor[0] = static_cast<uint8>(GG::Random::UInt());
-			randomColor[1] = static_cast<uint8>(GG::Random::UInt());
-			randomColor[2] = static_cast<uint8>(GG::Random::UInt());
-			_renderer->SetPixelForDebug(i, j, randomColor);
+			_renderer->EnableDynamicResolution(4.0f);
 		}
-	}
-	for (uint32 i = row + 100; i < row + 200; i++)
-	{
-		for (uint32 j = col + 150; j < col + 200; j++)
+		else
 		{
-			randomColor[0] = static_cast<uint8>(GG::Random::UInt());
-			randomColor[1] = static_cast<uint8>(GG::Random::UInt());
-			randomColor[2] = static_cast<uint8>(GG::Random::UInt());
-			_renderer->SetPixelForDebug(i, j, randomColor);
+			_renderer->DisableDynamicResolution();
 		}
 	}
-	for (uint32 i = row + 100; i < row + 150; i++)
+	ImGui::Text("Framebuffer %u x %u (scale %.2f)", _renderer->GetFramebufferWidth(), _renderer->GetFramebufferHeight(), _renderer->GetResolutionScale());
+	ImGui::End();
+}
+
+void TestRenderPass::drawG(uint32 row, uint32 col, uint8* color)
+{
+	drawRandomRect(row, col, 200, 50);
+	drawRandomRect(row + 50, col, 50, 200);
+	drawRandomRect(row + 200, col + 50, 150, 50);
+	drawRandomRect(row + 100, col + 150, 50, 100);
+	drawRandomRect(row + 100, col + 100, 50, 50);
+}
+
+void TestRenderPass::drawRandomRect(uint32 row, uint32 col, uint32 width, uint32 height)
+{
+	GG_ASSERT(width <= s_maxRowWidth, "Rect is wider than row buffer!");
+
+	GG::TextureBuffer& backBuffer = _renderer->AcquireBackBuffer();
+	for (uint32 i = row; i < row + height; i++)
 	{
-		for (uint32 j = col + 100; j < col + 150; j++)
+		for (uint32 j = 0; j < width; j++)
 		{
-			randomColor[0] = static_cast<uint8>(GG::Random::UInt());
-			randomColor[1] = static_cast<uint8>(GG::Random::UInt());
-			randomColor[2] = static_cast<uint8>(GG::Random::UInt());
-			_renderer->SetPixelForDebug(i, j, randomColor);
+			// Random RGB with opaque alpha.
+			_rowBuffer[j] = static_cast<uint32>(GG::Random::UInt()) | 0xFF000000u;
 		}
+		backBuffer.WriteRow(static_cast<int32>(i), static_cast<int32>(col), _rowBuffer, width);
 	}
 }
 
@@ -18,13 +18,18 @@ public:
 	// Application ̺Ʈ ߻  ȣ˴ϴ
 	virtual void OnEvent(GG::Event& e);
 	// Application  Render Loop ȣ˴ϴ
-	virtual void OnRender();
+	virtual void OnRender(float alpha);
 	// Application GUI Render Loop ȣ˴ϴ
 	virtual void OnGUI();
 
 private:
 	void drawG(uint32 row, uint32 col, uint8* color);
+	void drawRandomRect(uint32 row, uint32 col, uint32 width, uint32 height);
 	bool onKeyPressedEvent(GG::KeyPressedEvent& e);
 
 	uint8 _color[4];
+	float _angle = 0.0f;
+
+	static const uint32 s_maxRowWidth = 256;
+	uint32 _rowBuffer[s_maxRowWidth];
 };
\ No newline at end of file
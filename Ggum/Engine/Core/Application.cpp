@@ -2,9 +2,17 @@
 
 #include "Application.h"
 
+#include "Renderer/HeadlessRenderer.h"
+#include "Renderer/Renderer.h"
+
 #include <memory>
 #include <functional>
 
+#ifdef GG_WINDOWED_BACKEND
+#include <timeapi.h>
+#pragma comment(lib, "winmm")
+#endif
+
 namespace GG {
 
 Application* Application::s_instance = nullptr;
@@ -19,81 +27,302 @@ Application* Application::Get()
 	return s_instance;
 }
 
-Application::Application(const char* title, uint32 width, uint32 height)
+Application* Application::Create(const ApplicationProperty& prop)
+{
+	GG_ASSERT(nullptr == s_instance, "Application is already created!");
+
+	s_instance = new Application(prop);
+
+	return s_instance;
+}
+
+Application::Application(const ApplicationProperty& prop)
+	: _property{ prop }
+	, _frameScheduler{ _clock }
 {
 	GG::Log::Init();
+	Profiler::SetThreadName("Main");
+
+#ifdef GG_WINDOWED_BACKEND
+	if (!_property.isHeadless)
+	{
+		WindowProperty windowProp(_property.title, _property.width, _property.height);
 
-	WindowProperty prop(title, width, height);
+		_window = std::make_unique<Window>(windowProp);
+		_window->SetEventCallback(std::bind(&Application::OnEvent, this, std::placeholders::_1));
 
-	_window = std::make_unique<Window>(prop);
-	_window->SetEventCallback(std::bind(&Application::OnEvent, this, std::placeholders::_1));
+		std::shared_ptr<GraphicsAPI> api = std::make_shared<GraphicsAPI>(_window->GetWindowHandle(), _property.width, _property.height);
+		api->Init();
 
-	std::shared_ptr<GraphicsAPI> api = std::make_shared<GraphicsAPI>(_window->GetWindowHandle(), width, height);
-	api->Init();
+		auto renderer = std::make_shared<Renderer>();
+		renderer->Init(api);
+		_renderer = renderer;
+	}
+#else
+	_property.isHeadless = true;
+#endif
+
+	if (_property.isHeadless)
+	{
+		auto renderer = std::make_shared<HeadlessRenderer>(_property.width, _property.height);
+		renderer->SetFrameDumpDirectory(_property.frameDumpDirectory);
+		_renderer = renderer;
+	}
 
-	_renderer = std::make_shared<Renderer>();
-	_renderer->Init(_window->GetWindowHandle(), api);
+	// The main thread is the job system's first worker, it runs jobs whenever a pass waits on them.
+	_jobSystem = std::make_shared<JobSystem>();
+	_jobSystem->Start(_property.jobThreadCount);
 
+	if (_property.isRasterOnJobSystem)
+	{
+		_renderer->SetJobSystem(_jobSystem.get());
+	}
+	else
+	{
+		_renderer->SetRasterThreadCount(_property.rasterThreadCount);
+	}
 	_renderPath.SetRenderer(_renderer);
+	_renderPath.SetJobSystem(_jobSystem);
+
+	if (_property.isPipelined)
+	{
+		startUpdateThread();
+	}
 
-	_timer.Init();
+	_frameScheduler.SetFixedTimestep(_property.fixedUpdateRate != 0 ? IClock::s_ticksPerSecond / _property.fixedUpdateRate : 0);
+	_frameScheduler.SetTargetFrameTicks(_property.maxFrameRate != 0 ? IClock::s_ticksPerSecond / _property.maxFrameRate : 0);
 }
 
 Application::~Application()
 {
+	stopUpdateThread();
 	_renderPath.Clear();
+	// The renderer may still hold the job system's threads.
+	_renderer->SetJobSystem(nullptr);
+	_jobSystem->Stop();
+
+	if (s_instance == this)
+	{
+		s_instance = nullptr;
+	}
 }
 
 void Application::Run()
 {
 	GG_TRACE("Application is Run.");
+
+	const bool isTraceCaptured = !_property.traceCapturePath.empty();
+	if (isTraceCaptured)
+	{
+		Profiler::BeginCapture();
+	}
+
+	if (_property.isHeadless)
+	{
+		runHeadless();
+	}
+	else
+	{
+		runWindowed();
+	}
+
+	if (isTraceCaptured)
+	{
+		Profiler::EndCapture();
+		if (Profiler::WriteChromeTrace(_property.traceCapturePath))
+		{
+			GG_INFO("Wrote {0} profiler zones to {1}.", Profiler::GetEventCount(), _property.traceCapturePath);
+		}
+	}
+}
+
+void Application::runWindowed()
+{
+#ifdef GG_WINDOWED_BACKEND
 	MSG msg{};
 
-	_timer.Start();
-	float lastTime = 0.0f;
+	// The limiter sleeps in 1 ms slices, the default timer resolution would round each of them up to about 15.6 ms.
+	timeBeginPeriod(1);
+	_frameScheduler.Reset();
 
 	while (msg.message != WM_QUIT)
 	{
-		if (PeekMessage(&msg, nullptr, 0, 0, PM_REMOVE))
+		// Every pending message is handled between two frames, so events never run next to the update thread.
+		bool isQuit = false;
+		while (PeekMessage(&msg, nullptr, 0, 0, PM_REMOVE))
 		{
+			if (msg.message == WM_QUIT)
+			{
+				isQuit = true;
+				break;
+			}
 			TranslateMessage(&msg);
 			DispatchMessage(&msg);
 		}
-		else
+		if (isQuit)
 		{
-			float curTime = _timer.Elapsed();
-			float deltaTime = curTime - lastTime;
-			lastTime = curTime;
+			break;
+		}
 
+		runFrame(_frameScheduler.BeginFrame());
 
-			// Rendering---------------------
-			_renderer->Prepare();
+		// Window Update-----------------
+		_window->OnUpdate();
+		// Window Update-----------------
 
-			for (const auto& renderPass : _renderPath)
-			{
-				renderPass->OnUpdate(deltaTime);
-				renderPass->OnRender();
-			}
+		GG_PROFILE_SCOPE("Application::WaitForNextFrame");
+		_frameScheduler.WaitForNextFrame();
+	}
+	timeEndPeriod(1);
+#endif
+}
 
-			_renderer->Submit();
-			// Rendering---------------------
+void Application::runHeadless()
+{
+	if (_property.frameCount == 0)
+	{
+		GG_WARNING("Headless application has no frames to run.");
+		return;
+	}
 
-			// GUI Rendering-----------------
-			_renderer->PrepareGUI();
+	// One step per frame, so runs are reproducible whatever the machine's speed.
+	FrameTiming timing{};
+	timing.stepCount = 1;
+	timing.stepSeconds = _property.fixedUpdateRate != 0 ? 1.0f / _property.fixedUpdateRate : s_headlessDeltaTime;
+	timing.frameTicks = IClock::FromSeconds(timing.stepSeconds);
+	timing.alpha = 1.0f;
 
-			for (const auto& renderPass : _renderPath)
-			{
-				renderPass->OnGUI();
-			}
-			_renderer->SubmitGUI();
-			// GUI Rendering-----------------
-			_renderer->Present();
+	const uint64 start = _clock.GetTicks();
+	for (uint32 frame = 0; frame < _property.frameCount; frame++)
+	{
+		timing.frameIndex = frame;
+		runFrame(timing);
+	}
+	const double elapsed = IClock::ToSeconds(_clock.GetTicks() - start) * 1000.0;
 
+	GG_INFO("Rendered {0} headless frames, {1:.3f} ms/frame.", _property.frameCount, elapsed / _property.frameCount);
+}
+
+void Application::runFrame(const FrameTiming& timing)
+{
+	GG_PROFILE_SCOPE("Application::Frame");
+
+	if (!_property.isPipelined)
+	{
+		// Every pass is updated before the graph runs, so passes declare the resources of this frame's state.
+		updatePasses(timing);
+		snapshotPasses();
+		renderFrame(timing.alpha);
+		return;
+	}
+
+	// The update thread is idle here, the last update becomes what this frame renders.
+	snapshotPasses();
+
+	{
+		std::lock_guard<std::mutex> lock(_updateMutex);
+		_pendingTiming = timing;
+		_isUpdatePending = true;
+	}
+	_updateCondition.notify_all();
+
+	renderFrame(_snapshotAlpha);
+
+	GG_PROFILE_SCOPE("Application::WaitForUpdate");
+	std::unique_lock<std::mutex> lock(_updateMutex);
+	_updateCondition.wait(lock, [this]() { return !_isUpdatePending; });
+	_snapshotAlpha = timing.alpha;
+}
+
+void Application::updatePasses(const FrameTiming& timing)
+{
+	for (uint32 step = 0; step < timing.stepCount; step++)
+	{
+		for (const auto& renderPass : _renderPath)
+		{
+			GG_PROFILE_SCOPE_CATEGORY(renderPass->GetProfileName(), "OnUpdate");
+			renderPass->OnUpdate(timing.stepSeconds);
+		}
+	}
+}
+
+void Application::snapshotPasses()
+{
+	for (const auto& renderPass : _renderPath)
+	{
+		GG_PROFILE_SCOPE_CATEGORY(renderPass->GetProfileName(), "OnSnapshot");
+		renderPass->OnSnapshot();
+	}
+}
+
+void Application::renderFrame(float alpha)
+{
+	// Rendering---------------------
+	_renderer->Prepare();
+
+	_renderPath.Render(alpha);
+
+	_renderer->Submit();
+	// Rendering---------------------
+
+	// GUI Rendering-----------------
+	if (!_property.isHeadless)
+	{
+		_renderer->PrepareGUI();
+
+		for (const auto& renderPass : _renderPath)
+		{
+			GG_PROFILE_SCOPE_CATEGORY(renderPass->GetProfileName(), "OnGUI");
+			renderPass->OnGUI();
+		}
+		_renderer->SubmitGUI();
+	}
+	// GUI Rendering-----------------
+	_renderer->Present();
+}
+
+void Application::startUpdateThread()
+{
+	_isUpdateThreadStopping = false;
+	_updateThread = std::thread(&Application::updateLoop, this);
+}
+
+void Application::stopUpdateThread()
+{
+	if (!_updateThread.joinable())
+	{
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(_updateMutex);
+		_isUpdateThreadStopping = true;
+	}
+	_updateCondition.notify_all();
+	_updateThread.join();
+}
+
+void Application::updateLoop()
+{
+	Profiler::SetThreadName("Update");
 
-			// Window Update-----------------
-			_window->OnUpdate();
-			// Window Update-----------------
+	std::unique_lock<std::mutex> lock(_updateMutex);
+	while (true)
+	{
+		_updateCondition.wait(lock, [this]() { return _isUpdatePending || _isUpdateThreadStopping; });
+		if (_isUpdateThreadStopping)
+		{
+			return;
 		}
+
+		// runFrame() doesn't touch the passes until the update is done, the lock isn't needed meanwhile.
+		const FrameTiming timing = _pendingTiming;
+		lock.unlock();
+		updatePasses(timing);
+		lock.lock();
+
+		_isUpdatePending = false;
+		_updateCondition.notify_all();
 	}
 }
 
@@ -1,7 +1,12 @@
 #pragma once
 
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+
 #include "Base.hpp"
-#include "Renderer/Renderer.h"
+#include "Renderer/Drawable.hpp"
 
 #include "Renderer/RenderPath.h"
 
@@ -10,6 +15,51 @@
 
 namespace GG {
 
+struct ApplicationProperty
+{
+	std::string title;
+	uint32 width;
+	uint32 height;
+	// Renders into a CPU only framebuffer without a window. Always on when the window backend isn't built.
+	bool isHeadless;
+	// Headless only: Run() renders this many frames and returns.
+	uint32 frameCount;
+	// Headless only: every frame is written there as PPM, empty disables it.
+	std::string frameDumpDirectory;
+	// Threads rasterizing triangles including the render thread, 0 uses every hardware thread. Unused with isRasterOnJobSystem.
+	uint32 rasterThreadCount;
+	// Threads of the job system including the main thread, 0 uses every hardware thread.
+	uint32 jobThreadCount;
+	// Rasterizes on the job system's threads instead of a second set of threads.
+	bool isRasterOnJobSystem;
+	// Runs OnUpdate() of frame N + 1 on an update thread while frame N renders. Passes hand their state over in OnSnapshot(),
+	// so OnUpdate() must not touch what the render callbacks read nor the renderer. Frames show the state one update late.
+	bool isPipelined;
+	// Updates per second with a fixed deltaTime, OnRender() gets the interpolation alpha. 0 updates once per frame by the frame's time.
+	uint32 fixedUpdateRate;
+	// Frame limiter of the windowed loop, 0 runs unlimited. Headless runs never wait.
+	uint32 maxFrameRate;
+	// Run() records a Profiler capture and writes it there as a Chrome trace, empty disables it.
+	// Only the last Profiler::s_eventCapacity zones of each thread are kept.
+	std::string traceCapturePath;
+
+	ApplicationProperty(const std::string& title = "GG Engine", uint32 width = 1600, uint32 height = 900)
+		: title(title)
+		, width(width)
+		, height(height)
+		, isHeadless(false)
+		, frameCount(0)
+		, frameDumpDirectory()
+		, rasterThreadCount(0)
+		, jobThreadCount(0)
+		, isRasterOnJobSystem(true)
+		, isPipelined(false)
+		, fixedUpdateRate(0)
+		, maxFrameRate(0)
+		, traceCapturePath()
+	{}
+};
+
 class Application
 {
 public:
@@ -22,18 +72,56 @@ public:
 	void AddRenderPass(std::shared_ptr<RenderPass> renderPass);
 	void DeleteRenderPass(std::shared_ptr<RenderPass> renderPass);
 
+	inline std::shared_ptr<IDrawable> GetRenderer() const { return _renderer; }
+	inline std::shared_ptr<JobSystem> GetJobSystem() const { return _jobSystem; }
+	inline bool IsHeadless() const { return _property.isHeadless; }
+	inline FrameScheduler& GetFrameScheduler() { return _frameScheduler; }
+
 	static Application* Get();
+	// Creates the instance with prop instead of the defaults, call it before the first Get().
+	static Application* Create(const ApplicationProperty& prop);
 
 protected:
-	Application(const char* title = "GG Engine", uint32 width = 1600, uint32 height = 900);
+	Application(const ApplicationProperty& prop = ApplicationProperty());
 
 private:
+	void runWindowed();
+	void runHeadless();
+	// Updates and renders one frame, the update is overlapped with the render when pipelined.
+	void runFrame(const FrameTiming& timing);
+	void updatePasses(const FrameTiming& timing);
+	void snapshotPasses();
+	// One pass over the RenderPath, the GUI is skipped when headless since there is no ImGui context.
+	void renderFrame(float alpha);
+
+	void startUpdateThread();
+	void stopUpdateThread();
+	void updateLoop();
+
+	// Headless frames advance by a fixed step so runs are reproducible.
+	static constexpr float s_headlessDeltaTime = 1.0f / 60.0f;
+
 	static Application* s_instance;
-	std::shared_ptr<Renderer> _renderer;
+	std::shared_ptr<IDrawable> _renderer;
+	std::shared_ptr<JobSystem> _jobSystem;
 
+#ifdef GG_WINDOWED_BACKEND
 	std::unique_ptr<Window> _window;
+#endif
 	RenderPath _renderPath;
+	ApplicationProperty _property;
 	
-	Timer _timer;
+	SteadyClock _clock;
+	FrameScheduler _frameScheduler;
+
+	// Pipelined mode: the render thread hands the update thread one deltaTime per frame and waits for it before the next one.
+	std::thread _updateThread;
+	std::mutex _updateMutex;
+	std::condition_variable _updateCondition;
+	FrameTiming _pendingTiming{};
+	// Alpha of the update the snapshot holds, one frame behind the scheduler's.
+	float _snapshotAlpha = 1.0f;
+	bool _isUpdatePending = false;
+	bool _isUpdateThreadStopping = false;
 };
 }
\ No newline at end of file
@@ -0,0 +1,30 @@
+#pragma once
+
+namespace GG {
+
+// Double buffered state of a RenderPass for the pipelined Application (see ApplicationProperty::isPipelined).
+// OnUpdate() writes GetUpdateState() while the previous frame renders from GetRenderState(), OnSnapshot() calls Publish().
+// Without pipelining OnSnapshot() follows OnUpdate() on the same thread and Publish() only costs the copy.
+template <typename T>
+class FrameSnapshot
+{
+public:
+	FrameSnapshot() = default;
+	explicit FrameSnapshot(const T& state)
+		: _updateState{ state }
+		, _renderState{ state }
+	{}
+
+	inline T& GetUpdateState() { return _updateState; }
+	inline const T& GetUpdateState() const { return _updateState; }
+	inline const T& GetRenderState() const { return _renderState; }
+
+	// Copies the update state into the render state. Only valid while neither thread touches the pass.
+	inline void Publish() { _renderState = _updateState; }
+
+private:
+	T _updateState;
+	T _renderState;
+};
+
+}
\ No newline at end of file
@@ -0,0 +1,348 @@
+#include "EnginePch.h"
+#include "BinnedRasterizer.h"
+
+namespace GG {
+
+// True if one edge has the whole pixel rectangle [x0, x1] x [y0, y1] outside.
+// Multisampled pixels are covered up to half a pixel away from their centers.
+static bool is_rect_outside(const RasterTriangle& triangle, int32 x0, int32 y0, int32 x1, int32 y1, bool isMultisampled)
+{
+	for (uint32 edge = 0; edge < 3; edge++)
+	{
+		const int64 stepX = triangle.stepX[edge];
+		const int64 stepY = triangle.stepY[edge];
+		const int64 sampleReach = isMultisampled ? (std::abs(stepX) + std::abs(stepY)) / 2 : 0;
+		const int64 maxValue = triangle.origin[edge] + std::max(stepX * x0, stepX * x1) + std::max(stepY * y0, stepY * y1) + sampleReach;
+		if (maxValue < 0)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+BinnedRasterizer::BinnedRasterizer(uint32 threadCount)
+{
+	startThreads(threadCount);
+}
+
+BinnedRasterizer::~BinnedRasterizer()
+{
+	stopThreads();
+}
+
+void BinnedRasterizer::SetThreadCount(uint32 threadCount)
+{
+	stopThreads();
+	_jobSystem = nullptr;
+	startThreads(threadCount);
+}
+
+void BinnedRasterizer::SetJobSystem(JobSystem* jobSystem)
+{
+	stopThreads();
+	_jobSystem = jobSystem;
+	if (!jobSystem)
+	{
+		startThreads(1);
+		return;
+	}
+
+	_workers.resize(jobSystem->GetThreadCount());
+	for (auto& worker : _workers)
+	{
+		worker = std::make_unique<Worker>();
+	}
+}
+
+void BinnedRasterizer::DrawTriangle(const RasterVertex& v0, const RasterVertex& v1, const RasterVertex& v2, uint32 color)
+{
+	_pendingTriangles.push_back(PendingTriangle{ { v0, v1, v2 }, color });
+}
+
+void BinnedRasterizer::Flush(TextureBuffer& target, DepthBuffer* depthBuffer, MultisampleBuffer* multisampleBuffer)
+{
+	if (_pendingTriangles.empty())
+	{
+		return;
+	}
+
+	drawTriangles(target, depthBuffer, multisampleBuffer, static_cast<uint32>(_pendingTriangles.size()));
+	_pendingTriangles.clear();
+	gatherStatistics();
+}
+
+void BinnedRasterizer::DrawBatch(TextureBuffer& target, const ShadedBatch& batch, DepthBuffer* depthBuffer, MultisampleBuffer* multisampleBuffer)
+{
+	Flush(target, depthBuffer, multisampleBuffer);
+	if (batch.triangleCount == 0)
+	{
+		return;
+	}
+
+	_batch = &batch;
+	drawTriangles(target, depthBuffer, multisampleBuffer, batch.triangleCount);
+	_batch = nullptr;
+	gatherStatistics();
+}
+
+void BinnedRasterizer::ResetStatistics()
+{
+	for (auto& worker : _workers)
+	{
+		worker->rasterizer.ResetStatistics();
+	}
+	_statistics = RasterStatistics{};
+}
+
+void BinnedRasterizer::drawTriangles(TextureBuffer& target, DepthBuffer* depthBuffer, MultisampleBuffer* multisampleBuffer, uint32 triangleCount)
+{
+	if (triangleCount < s_minBinnedTriangleCount)
+	{
+		Rasterizer& rasterizer = _workers[0]->rasterizer;
+		const TextureRegion scissor{ 0, 0, target.GetWidth(), target.GetHeight() };
+		for (uint32 i = 0; i < triangleCount; i++)
+		{
+			if (_batch)
+			{
+				RasterTriangle triangle;
+				if (_batch->setupTriangle(*_batch, i, rasterizer, target.GetWidth(), target.GetHeight(), triangle))
+				{
+					_batch->drawTriangle(*_batch, i, rasterizer, target, triangle, scissor, depthBuffer, multisampleBuffer);
+				}
+			}
+			else
+			{
+				const PendingTriangle& triangle = _pendingTriangles[i];
+				rasterizer.DrawTriangle(target, triangle.v[0], triangle.v[1], triangle.v[2], triangle.color, depthBuffer, multisampleBuffer);
+			}
+		}
+
+		return;
+	}
+
+	_target = &target;
+	_depthBuffer = depthBuffer;
+	_multisampleBuffer = multisampleBuffer;
+	_triangleCount = triangleCount;
+	_binColumns = (target.GetWidth() + s_binSize - 1) / s_binSize;
+	_binRows = (target.GetHeight() + s_binSize - 1) / s_binSize;
+	_triangles.resize(triangleCount);
+	for (auto& worker : _workers)
+	{
+		worker->bins.resize(static_cast<size_t>(_binColumns) * _binRows);
+		for (auto& bin : worker->bins)
+		{
+			bin.clear();
+		}
+	}
+
+	runOnWorkers(&BinnedRasterizer::setupAndBin);
+	_nextBin.store(0, std::memory_order_relaxed);
+	runOnWorkers(&BinnedRasterizer::rasterizeBins);
+
+	_target = nullptr;
+	_depthBuffer = nullptr;
+	_multisampleBuffer = nullptr;
+}
+
+void BinnedRasterizer::gatherStatistics()
+{
+	_statistics = RasterStatistics{};
+	for (const auto& worker : _workers)
+	{
+		const RasterStatistics& statistics = worker->rasterizer.GetStatistics();
+		_statistics.triangleCount += statistics.triangleCount;
+		_statistics.culledTriangleCount += statistics.culledTriangleCount;
+		_statistics.fullBlockCount += statistics.fullBlockCount;
+		_statistics.partialBlockCount += statistics.partialBlockCount;
+		_statistics.pixelCount += statistics.pixelCount;
+		_statistics.depthRejectedBlockCount += statistics.depthRejectedBlockCount;
+		_statistics.depthRejectedPixelCount += statistics.depthRejectedPixelCount;
+		_statistics.multisampleBlockCount += statistics.multisampleBlockCount;
+	}
+}
+
+void BinnedRasterizer::startThreads(uint32 threadCount)
+{
+	if (threadCount == 0)
+	{
+		threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+	}
+
+	_isStopping = false;
+	_workers.resize(threadCount);
+	for (auto& worker : _workers)
+	{
+		worker = std::make_unique<Worker>();
+	}
+	// Worker 0 is whichever thread calls Flush().
+	for (uint32 i = 1; i < threadCount; i++)
+	{
+		_workers[i]->thread = std::thread(&BinnedRasterizer::workerMain, this, i);
+	}
+}
+
+void BinnedRasterizer::stopThreads()
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_isStopping = true;
+	}
+	_wakeCondition.notify_all();
+
+	for (auto& worker : _workers)
+	{
+		if (worker->thread.joinable())
+		{
+			worker->thread.join();
+		}
+	}
+	_workers.clear();
+}
+
+void BinnedRasterizer::workerMain(uint32 workerIndex)
+{
+	uint64 generation = 0;
+	while (true)
+	{
+		WorkerTask task = nullptr;
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+			_wakeCondition.wait(lock, [&]() { return _isStopping || _taskGeneration != generation; });
+			if (_isStopping)
+			{
+				return;
+			}
+			generation = _taskGeneration;
+			task = _task;
+		}
+
+		(this->*task)(workerIndex);
+
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			if (--_busyWorkerCount == 0)
+			{
+				_doneCondition.notify_one();
+			}
+		}
+	}
+}
+
+void BinnedRasterizer::runOnWorkers(WorkerTask task)
+{
+	if (_jobSystem)
+	{
+		const uint32 workerCount = static_cast<uint32>(_workers.size());
+		if (!_jobSystem->IsWorkerThread())
+		{
+			for (uint32 i = 0; i < workerCount; i++)
+			{
+				(this->*task)(i);
+			}
+			return;
+		}
+
+		Job* group = _jobSystem->CreateJob([]() {});
+		for (uint32 i = 1; i < workerCount; i++)
+		{
+			_jobSystem->Run(_jobSystem->CreateJob([this, task, i]() { (this->*task)(i); }, group));
+		}
+		(this->*task)(0);
+		_jobSystem->Run(group);
+		_jobSystem->Wait(group);
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_task = task;
+		_taskGeneration++;
+		_busyWorkerCount = static_cast<uint32>(_workers.size()) - 1;
+	}
+	_wakeCondition.notify_all();
+
+	(this->*task)(0);
+
+	std::unique_lock<std::mutex> lock(_mutex);
+	_doneCondition.wait(lock, [&]() { return _busyWorkerCount == 0; });
+}
+
+// Every worker takes a contiguous range of the queue, so reading the bins worker by worker keeps the submission order.
+void BinnedRasterizer::setupAndBin(uint32 workerIndex)
+{
+	Worker& worker = *_workers[workerIndex];
+	const uint64 triangleCount = _triangleCount;
+	const uint32 begin = static_cast<uint32>(triangleCount * workerIndex / _workers.size());
+	const uint32 end = static_cast<uint32>(triangleCount * (workerIndex + 1) / _workers.size());
+	const uint32 width = _target->GetWidth();
+	const uint32 height = _target->GetHeight();
+
+	for (uint32 i = begin; i < end; i++)
+	{
+		RasterTriangle& triangle = _triangles[i];
+		const bool isVisible = _batch
+			? _batch->setupTriangle(*_batch, i, worker.rasterizer, width, height, triangle)
+			: worker.rasterizer.SetupTriangle(_pendingTriangles[i].v[0], _pendingTriangles[i].v[1], _pendingTriangles[i].v[2], _pendingTriangles[i].color, width, height, triangle);
+		if (!isVisible)
+		{
+			continue;
+		}
+
+		const uint32 minColumn = static_cast<uint32>(triangle.minX) / s_binSize;
+		const uint32 maxColumn = static_cast<uint32>(triangle.maxX) / s_binSize;
+		const uint32 minRow = static_cast<uint32>(triangle.minY) / s_binSize;
+		const uint32 maxRow = static_cast<uint32>(triangle.maxY) / s_binSize;
+		const bool isSingleBin = minColumn == maxColumn && minRow == maxRow;
+
+		for (uint32 row = minRow; row <= maxRow; row++)
+		{
+			for (uint32 column = minColumn; column <= maxColumn; column++)
+			{
+				// Large triangles cover the corners of their bounding box only partly, skip the bins next to them.
+				const int32 binX = static_cast<int32>(column * s_binSize);
+				const int32 binY = static_cast<int32>(row * s_binSize);
+				if (!isSingleBin && is_rect_outside(triangle, binX, binY, binX + s_binSize - 1, binY + s_binSize - 1, _multisampleBuffer != nullptr))
+				{
+					continue;
+				}
+
+				worker.bins[row * _binColumns + column].push_back(i);
+			}
+		}
+	}
+}
+
+void BinnedRasterizer::rasterizeBins(uint32 workerIndex)
+{
+	Rasterizer& rasterizer = _workers[workerIndex]->rasterizer;
+	const uint32 binCount = _binColumns * _binRows;
+	const uint32 width = _target->GetWidth();
+	const uint32 height = _target->GetHeight();
+
+	for (uint32 bin = _nextBin.fetch_add(1, std::memory_order_relaxed); bin < binCount; bin = _nextBin.fetch_add(1, std::memory_order_relaxed))
+	{
+		const uint32 x = (bin % _binColumns) * s_binSize;
+		const uint32 y = (bin / _binColumns) * s_binSize;
+		const TextureRegion scissor{ x, y, std::min(s_binSize, width - x), std::min(s_binSize, height - y) };
+
+		for (const auto& worker : _workers)
+		{
+			for (uint32 triangleIndex : worker->bins[bin])
+			{
+				if (_batch)
+				{
+					_batch->drawTriangle(*_batch, triangleIndex, rasterizer, *_target, _triangles[triangleIndex], scissor, _depthBuffer, _multisampleBuffer);
+				}
+				else
+				{
+					rasterizer.DrawTriangle(*_target, _triangles[triangleIndex], scissor, _depthBuffer, _multisampleBuffer);
+				}
+			}
+		}
+	}
+}
+
+}
\ No newline at end of file
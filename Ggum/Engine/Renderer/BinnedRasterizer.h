@@ -0,0 +1,113 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Base.hpp"
+
+#include "Core/JobSystem.h"
+#include "Renderer/Rasterizer.h"
+
+namespace GG {
+
+// Sort-middle rasterizer: triangles are queued, then Flush() sets them up and bins them into s_binSize tiles in parallel,
+// and the workers rasterize whole tiles. A tile is only ever written by the worker which took it, so the framebuffer needs no locks,
+// and the triangles of a tile are drawn in submission order, so the result doesn't depend on the thread count.
+// Bins match the TextureBuffer tiles, which keeps the lazy tile clear of each worker on its own tiles as well.
+// Binning pays off on a single thread too, a bin stays in the cache while all of its triangles are drawn.
+// Shaded batches (see PixelShader) take the same path with their own setup and block shading.
+class BinnedRasterizer
+{
+public:
+	static constexpr uint32			s_binSize = TextureBuffer::s_tileSize;
+	// Smaller batches are drawn directly on the calling thread, binning and waking the workers would cost more than it saves.
+	static constexpr uint32			s_minBinnedTriangleCount = 64;
+
+	// threadCount includes the calling thread, 0 uses every hardware thread.
+	explicit BinnedRasterizer(uint32 threadCount = 1);
+	~BinnedRasterizer();
+
+	BinnedRasterizer(const BinnedRasterizer&) = delete;
+	BinnedRasterizer& operator=(const BinnedRasterizer&) = delete;
+
+	void SetThreadCount(uint32 threadCount);
+	inline uint32 GetThreadCount() const { return static_cast<uint32>(_workers.size()); }
+	// Runs the workers as jobs on jobSystem's threads instead of threads of its own, until the next SetThreadCount().
+	// Null goes back to a single thread. Flushes from outside of the job system's threads run every worker on the calling thread.
+	void SetJobSystem(JobSystem* jobSystem);
+
+	// Queues a triangle, nothing is written before Flush().
+	void DrawTriangle(const RasterVertex& v0, const RasterVertex& v1, const RasterVertex& v2, uint32 color);
+	// Draws every queued triangle into target and empties the queue, depth tested if depthBuffer isn't null
+	// and multisampled if multisampleBuffer isn't null. Bins never share a block, so workers never split the same block.
+	void Flush(TextureBuffer& target, DepthBuffer* depthBuffer = nullptr, MultisampleBuffer* multisampleBuffer = nullptr);
+	inline bool HasPendingTriangles() const { return !_pendingTriangles.empty(); }
+	// Flushes the queue, then draws the shaded triangles of batch into target the same way, see PixelShader.
+	void DrawBatch(TextureBuffer& target, const ShadedBatch& batch, DepthBuffer* depthBuffer = nullptr, MultisampleBuffer* multisampleBuffer = nullptr);
+
+	// Sum over the workers, updated by Flush().
+	inline const RasterStatistics& GetStatistics() const { return _statistics; }
+	void ResetStatistics();
+
+private:
+	struct PendingTriangle
+	{
+		RasterVertex v[3];
+		uint32 color;
+	};
+
+	// Own cache lines, every worker updates its statistics all the time.
+	struct alignas(64) Worker
+	{
+		Rasterizer rasterizer;
+		// Triangle indices per bin, in submission order.
+		std::vector<std::vector<uint32>> bins;
+		std::thread thread;
+	};
+
+	using WorkerTask = void (BinnedRasterizer::*)(uint32);
+
+	void startThreads(uint32 threadCount);
+	void stopThreads();
+	void workerMain(uint32 workerIndex);
+	// Runs task on every worker, the calling thread is worker 0, and returns once all of them are done.
+	// With a job system every other worker is a job, so workers are only lanes of state and may share a thread.
+	void runOnWorkers(WorkerTask task);
+
+	// Draws either the queued triangles or _batch.
+	void drawTriangles(TextureBuffer& target, DepthBuffer* depthBuffer, MultisampleBuffer* multisampleBuffer, uint32 triangleCount);
+	void gatherStatistics();
+
+	void setupAndBin(uint32 workerIndex);
+	void rasterizeBins(uint32 workerIndex);
+
+	std::vector<std::unique_ptr<Worker>>	_workers;
+	JobSystem*						_jobSystem = nullptr;
+	std::vector<PendingTriangle>	_pendingTriangles;
+	std::vector<RasterTriangle>		_triangles;
+	RasterStatistics				_statistics;
+
+	// State of the current Flush(), read by the workers.
+	TextureBuffer*					_target = nullptr;
+	DepthBuffer*					_depthBuffer = nullptr;
+	MultisampleBuffer*				_multisampleBuffer = nullptr;
+	const ShadedBatch*				_batch = nullptr;
+	uint32							_triangleCount = 0;
+	uint32							_binColumns = 0;
+	uint32							_binRows = 0;
+	std::atomic<uint32>				_nextBin{ 0 };
+
+	std::mutex						_mutex;
+	std::condition_variable			_wakeCondition;
+	std::condition_variable			_doneCondition;
+	WorkerTask						_task = nullptr;
+	uint64							_taskGeneration = 0;
+	uint32							_busyWorkerCount = 0;
+	bool							_isStopping = false;
+};
+
+}
\ No newline at end of file
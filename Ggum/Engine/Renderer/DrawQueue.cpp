@@ -0,0 +1,137 @@
+#include "EnginePch.h"
+#include "DrawQueue.h"
+
+namespace GG {
+
+uint64 DrawQueue::MakeKey(RenderPassOrder order, uint32 state, float depth)
+{
+	constexpr uint32 maxDepth = (1u << s_depthBits) - 1;
+	constexpr uint32 stateMask = (1u << s_stateBits) - 1;
+
+	// NaN and negative depths sort as nearest.
+	const float clampedDepth = depth > 0.0f ? std::min(depth, 1.0f) : 0.0f;
+	uint64 depthBits = static_cast<uint64>(clampedDepth * static_cast<float>(maxDepth));
+	uint64 key = static_cast<uint64>(static_cast<uint32>(order) & ((1u << s_passOrderBits) - 1)) << (s_stateBits + s_depthBits);
+	if (IsBackToFront(order))
+	{
+		depthBits = maxDepth - depthBits;
+		key |= (depthBits << s_stateBits) | (state & stateMask);
+	}
+	else
+	{
+		key |= (static_cast<uint64>(state & stateMask) << s_depthBits) | depthBits;
+	}
+
+	return key;
+}
+
+bool DrawQueue::IsBackToFront(RenderPassOrder order)
+{
+	return order >= RenderPassOrder::Transparent && order < RenderPassOrder::BeforePostProcess;
+}
+
+void DrawQueue::PushTriangle(uint64 key, const RasterVertex& v0, const RasterVertex& v1, const RasterVertex& v2, uint32 color)
+{
+	_items.push_back(DrawItem{ key, static_cast<uint32>(_triangles.size()) });
+	_triangles.push_back(QueuedTriangle{ { v0, v1, v2 }, color });
+}
+
+void DrawQueue::PushShaded(uint64 key, const ShadedBatch& batch)
+{
+	_items.push_back(DrawItem{ key, static_cast<uint32>(_batches.size()) | s_batchFlag });
+	_batches.push_back(batch);
+}
+
+void DrawQueue::Sort()
+{
+	const size_t count = _items.size();
+	if (count <= s_insertionSortCount)
+	{
+		for (size_t i = 1; i < count; i++)
+		{
+			const DrawItem item = _items[i];
+			size_t j = i;
+			for (; j > 0 && _items[j - 1].key > item.key; j--)
+			{
+				_items[j] = _items[j - 1];
+			}
+			_items[j] = item;
+		}
+		return;
+	}
+
+	// All eight histograms in one pass over the keys.
+	uint32 histograms[8][256] = {};
+	for (const auto& item : _items)
+	{
+		const uint64 key = item.key;
+		for (uint32 digit = 0; digit < 8; digit++)
+		{
+			histograms[digit][(key >> (digit * 8)) & 0xFF]++;
+		}
+	}
+
+	_sortedItems.resize(count);
+	DrawItem* src = _items.data();
+	DrawItem* dst = _sortedItems.data();
+	bool isSortedInScratch = false;
+	for (uint32 digit = 0; digit < 8; digit++)
+	{
+		const uint32 shift = digit * 8;
+		const uint32* histogram = histograms[digit];
+		// A digit every key shares doesn't change the order, typically the pass and most of the state bits.
+		if (histogram[(src[0].key >> shift) & 0xFF] == count)
+		{
+			continue;
+		}
+
+		uint32 offsets[256];
+		uint32 offset = 0;
+		for (uint32 bucket = 0; bucket < 256; bucket++)
+		{
+			offsets[bucket] = offset;
+			offset += histogram[bucket];
+		}
+		for (size_t i = 0; i < count; i++)
+		{
+			dst[offsets[(src[i].key >> shift) & 0xFF]++] = src[i];
+		}
+
+		std::swap(src, dst);
+		isSortedInScratch = !isSortedInScratch;
+	}
+
+	if (isSortedInScratch)
+	{
+		_items.swap(_sortedItems);
+	}
+}
+
+void DrawQueue::Draw(BinnedRasterizer& rasterizer, TextureBuffer& target, DepthBuffer* depthBuffer, MultisampleBuffer* multisampleBuffer)
+{
+	Sort();
+
+	for (const auto& item : _items)
+	{
+		if (item.index & s_batchFlag)
+		{
+			rasterizer.DrawBatch(target, _batches[item.index & ~s_batchFlag], depthBuffer, multisampleBuffer);
+		}
+		else
+		{
+			const QueuedTriangle& triangle = _triangles[item.index];
+			rasterizer.DrawTriangle(triangle.v[0], triangle.v[1], triangle.v[2], triangle.color);
+		}
+	}
+
+	Clear();
+}
+
+void DrawQueue::Clear()
+{
+	_items.clear();
+	_triangles.clear();
+	_batches.clear();
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <vector>
+
+#include "Base.hpp"
+
+#include "System/gg_system.h"
+#include "Renderer/BinnedRasterizer.h"
+#include "Renderer/RenderPassOrder.hpp"
+
+namespace GG {
+
+// One frame's draws with a 64-bit sort key each, drawn in key order.
+// Keys from MakeKey() hold the pass order in the top bits, then state and depth: opaque passes sort by state and front to back
+// inside a state so the early depth test rejects as much as possible, transparent passes sort back to front before the state
+// so blending stays correct. Any other key layout works as well, draws with equal keys keep their submission order.
+// Sort() is an LSD radix sort over 8-bit digits which skips the digits every key shares, O(n) at 50k draws a frame.
+class DrawQueue
+{
+public:
+	static constexpr uint32			s_passOrderBits = 10;
+	static constexpr uint32			s_stateBits = 24;
+	static constexpr uint32			s_depthBits = 30;
+
+	DrawQueue() = default;
+	~DrawQueue() = default;
+
+	// state is up to s_stateBits bits chosen by the caller (e.g. shader and texture), depth is in [0, 1] with 0 nearest.
+	// Passes from Transparent up to BeforePostProcess are sorted back to front.
+	static uint64 MakeKey(RenderPassOrder order, uint32 state, float depth);
+	static bool IsBackToFront(RenderPassOrder order);
+
+	// The batch's shader, vertices and indices have to outlive Draw().
+	void PushTriangle(uint64 key, const RasterVertex& v0, const RasterVertex& v1, const RasterVertex& v2, uint32 color);
+	void PushShaded(uint64 key, const ShadedBatch& batch);
+
+	void Sort();
+	// Sorts, queues every draw into rasterizer in key order and empties the queue. The queued triangles are left for the caller's Flush().
+	void Draw(BinnedRasterizer& rasterizer, TextureBuffer& target, DepthBuffer* depthBuffer = nullptr, MultisampleBuffer* multisampleBuffer = nullptr);
+	void Clear();
+
+	inline bool IsEmpty() const { return _items.empty(); }
+	inline uint32 GetDrawCount() const { return static_cast<uint32>(_items.size()); }
+	// Key of the i-th draw, in key order after Sort().
+	inline uint64 GetKey(uint32 index) const { return _items[index].key; }
+
+private:
+	// Below this many draws an insertion sort is faster than the histograms.
+	static constexpr uint32			s_insertionSortCount = 64;
+	// Set in DrawItem::index for shaded batches.
+	static constexpr uint32			s_batchFlag = 0x80000000u;
+
+	struct DrawItem
+	{
+		uint64 key;
+		uint32 index;
+	};
+
+	struct QueuedTriangle
+	{
+		RasterVertex v[3];
+		uint32 color;
+	};
+
+	std::vector<DrawItem>			_items;
+	std::vector<DrawItem>			_sortedItems;
+	std::vector<QueuedTriangle>		_triangles;
+	std::vector<ShadedBatch>		_batches;
+};
+
+}
\ No newline at end of file
@@ -3,6 +3,10 @@
 #include "System/gg_system.h"
 #include "Base.hpp"
 
+#include "Renderer/BinnedRasterizer.h"
+#include "Renderer/DrawQueue.h"
+#include "Renderer/LineRasterizer.h"
+
 namespace GG {
 
 class IDrawable
@@ -10,7 +14,6 @@ class IDrawable
 public:
 	virtual ~IDrawable() {}
 
-	virtual void Init(HWND hWnd, std::shared_ptr<GraphicsAPI> api) = 0;
 	virtual void Prepare() = 0;
 	virtual void Submit() = 0;
 	virtual void Present() = 0;
@@ -23,10 +26,69 @@ public:
 
 	virtual void SetPixelForDebug(uint32 row, uint32 col, uint8* color) = 0;
 
-protected:
-	std::shared_ptr<GraphicsAPI> _api = nullptr;
-	//... 
+	// Bulk framebuffer writes, color/src are packed RGBA8 words (see PackColor).
+	virtual void FillSpan(int32 row, int32 col, uint32 count, uint32 color) = 0;
+	virtual void FillRect(int32 row, int32 col, uint32 width, uint32 height, uint32 color) = 0;
+	virtual void WriteRow(int32 row, int32 col, const uint32* src, uint32 count) = 0;
+	virtual void BlitRect(int32 row, int32 col, uint32 width, uint32 height, const uint32* src, uint32 srcPitch) = 0;
+	// Blending bulk writes for translucent content, colors are premultiplied by alpha (see PixelKernel::Premultiply()).
+	// With isGammaCorrect the colors are treated as sRGB and blended in linear space.
+	virtual void BlendSpan(int32 row, int32 col, uint32 count, uint32 color, eBlendMode mode, bool isGammaCorrect = false) = 0;
+	virtual void BlendColorRect(int32 row, int32 col, uint32 width, uint32 height, uint32 color, eBlendMode mode, bool isGammaCorrect = false) = 0;
+	virtual void BlendRow(int32 row, int32 col, const uint32* src, uint32 count, eBlendMode mode, bool isGammaCorrect = false) = 0;
+	virtual void BlendRect(int32 row, int32 col, uint32 width, uint32 height, const uint32* src, uint32 srcPitch, eBlendMode mode, bool isGammaCorrect = false) = 0;
+
+	// Queues a solid triangle for this frame's back buffer, see BinnedRasterizer.
+	// Queued triangles are drawn before any other write, AcquireBackBuffer() and Submit(), so the draw order is kept.
+	virtual void DrawTriangle(const RasterVertex& v0, const RasterVertex& v1, const RasterVertex& v2, uint32 color) = 0;
+	// Draws the triangles of a pixel shader (see PixelShader::MakeBatch()) right away, after the queued ones and with the same depth test.
+	virtual void DrawShaded(const ShadedBatch& batch) = 0;
+	// Sorted draws of this frame. They are drawn in key order before any other write, DrawShaded(), AcquireBackBuffer() and Submit(),
+	// after the triangles queued by DrawTriangle() so far.
+	virtual DrawQueue& GetDrawQueue() = 0;
+	// Draws debug lines and points right away on top of everything drawn so far, without depth test, see LineRasterizer.
+	virtual void DrawLines(const LineSegment* segments, uint32 count, bool isAntialiased = false) = 0;
+	virtual void DrawPoints(const RasterPoint* points, uint32 count, float size = 1.0f, bool isAntialiased = false) = 0;
+	// Counters of the current frame, reset by Prepare().
+	virtual const RasterStatistics& GetRasterStatistics() const = 0;
+	// Threads drawing the queued triangles including the render thread, 0 uses every hardware thread.
+	virtual void SetRasterThreadCount(uint32 count) = 0;
+	virtual uint32 GetRasterThreadCount() const = 0;
+	// Rasterizes on the threads of jobSystem instead of its own until the next SetRasterThreadCount(), null goes back to a single thread.
+	// The job system has to outlive the renderer or be reset here before it stops.
+	virtual void SetJobSystem(JobSystem* jobSystem) = 0;
+	// Depth test of the triangles (see Rasterizer), off by default so 2D triangles keep their draw order.
+	// The depth buffer follows the back buffer's size and is cleared to 1 by Prepare().
+	virtual void SetDepthTestEnabled(bool isDepthTestEnabled) = 0;
+	virtual bool IsDepthTestEnabled() const = 0;
+	// Multisampling of the triangles with 2, 4 or 8 samples per pixel, 1 (the default) turns it off, see MultisampleBuffer.
+	// Pixels are still shaded once. Split pixels are resolved into the back buffer before any other write,
+	// AcquireBackBuffer() and the upload, so lines, points and bulk writes land on resolved pixels.
+	virtual void SetSampleCount(uint32 count) = 0;
+	virtual uint32 GetSampleCount() const = 0;
+
+	// Direct access to this frame's CPU framebuffer, see GraphicsAPI::AcquireBackBuffer().
+	virtual TextureBuffer& AcquireBackBuffer() = 0;
+	virtual void ReleaseBackBuffer() = 0;
+
+	virtual const UploadStatistics& GetUploadStatistics() const = 0;
+
+	// Latency depth between the CPU and the GPU, 1 to 3 frames.
+	virtual void SetFramesInFlight(uint32 count) = 0;
+	virtual uint32 GetFramesInFlight() const = 0;
+
+	// Packed RGBA8 clear color. Passes which overwrite the whole framebuffer (e.g. a Skybox pass) can turn clearing off.
+	virtual void SetClearColor(uint32 color) = 0;
+	virtual void SetClearEnabled(bool isClearEnabled) = 0;
 
+	// Internal render resolution. Without dynamic resolution it follows the window size.
+	virtual uint32 GetFramebufferWidth() const = 0;
+	virtual uint32 GetFramebufferHeight() const = 0;
+	// Scales the render resolution between minScale and 1 of the window size to keep the CPU render time under the target.
+	virtual void EnableDynamicResolution(float targetMilliseconds, float minScale = 0.5f) = 0;
+	virtual void DisableDynamicResolution() = 0;
+	virtual bool IsDynamicResolutionEnabled() const = 0;
+	virtual float GetResolutionScale() const = 0;
 };
 
 
@@ -0,0 +1,99 @@
+#include "EnginePch.h"
+#include "DynamicResolution.h"
+
+namespace GG {
+
+DynamicResolution::DynamicResolution()
+	: _targetMilliseconds{ 1000.0f / 60.0f }
+	, _minScale{ 0.5f }
+	, _maxScale{ 1.0f }
+	, _scale{ 1.0f }
+	, _averageMilliseconds{ 0.0f }
+	, _overBudgetFrames{ 0 }
+	, _underBudgetFrames{ 0 }
+{
+
+}
+
+void DynamicResolution::SetTargetFrameTime(float milliseconds)
+{
+	_targetMilliseconds = milliseconds;
+	Reset();
+}
+
+void DynamicResolution::SetScaleRange(float minScale, float maxScale)
+{
+	_minScale = minScale;
+	_maxScale = maxScale;
+	_scale = std::clamp(_scale, _minScale, _maxScale);
+	Reset();
+}
+
+void DynamicResolution::Reset()
+{
+	_averageMilliseconds = 0.0f;
+	_overBudgetFrames = 0;
+	_underBudgetFrames = 0;
+}
+
+bool DynamicResolution::Update(float renderMilliseconds)
+{
+	if (_averageMilliseconds <= 0.0f)
+	{
+		_averageMilliseconds = renderMilliseconds;
+	}
+	else
+	{
+		_averageMilliseconds += (renderMilliseconds - _averageMilliseconds) * s_smoothing;
+	}
+
+	float scale = _scale;
+	if (_averageMilliseconds > _targetMilliseconds)
+	{
+		_underBudgetFrames = 0;
+		if (++_overBudgetFrames >= s_stepDownFrames)
+		{
+			scale = _scale - s_scaleStep;
+		}
+	}
+	else
+	{
+		_overBudgetFrames = 0;
+		float nextScale = _scale + s_scaleStep;
+		float predicted = _averageMilliseconds * (nextScale * nextScale) / (_scale * _scale);
+		if (predicted < _targetMilliseconds * s_headroom)
+		{
+			if (++_underBudgetFrames >= s_stepUpFrames)
+			{
+				scale = nextScale;
+			}
+		}
+		else
+		{
+			_underBudgetFrames = 0;
+		}
+	}
+
+	scale = std::clamp(scale, _minScale, _maxScale);
+	if (scale == _scale)
+	{
+		return false;
+	}
+
+	// Start the new level from the predicted time instead of the one measured at the old resolution.
+	_averageMilliseconds *= (scale * scale) / (_scale * _scale);
+	_scale = scale;
+	_overBudgetFrames = 0;
+	_underBudgetFrames = 0;
+
+	return true;
+}
+
+uint32 DynamicResolution::ScaleSize(uint32 size) const
+{
+	uint32 scaled = static_cast<uint32>(static_cast<float>(size) * _scale + 0.5f);
+
+	return scaled > 0 ? scaled : 1;
+}
+
+}
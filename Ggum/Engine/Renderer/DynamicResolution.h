@@ -0,0 +1,47 @@
+#pragma once
+
+#include "Base.hpp"
+
+namespace GG {
+
+// Picks the internal render resolution from the measured CPU render time.
+// Rasterization cost grows with the pixel count, so the scale is predicted quadratically and moves in fixed steps.
+// A step is only taken after the budget was missed, or clearly met, for several frames in a row,
+// which keeps the framebuffer from being reallocated every frame.
+class DynamicResolution
+{
+public:
+	DynamicResolution();
+	~DynamicResolution() = default;
+
+	void SetTargetFrameTime(float milliseconds);
+	void SetScaleRange(float minScale, float maxScale);
+	void Reset();
+
+	// Feeds one frame's render time, returns true if the scale changed.
+	bool Update(float renderMilliseconds);
+
+	inline float GetScale() const { return _scale; }
+	inline float GetTargetFrameTime() const { return _targetMilliseconds; }
+	inline float GetAverageFrameTime() const { return _averageMilliseconds; }
+	// Scaled size, never zero.
+	uint32 ScaleSize(uint32 size) const;
+
+private:
+	static constexpr float	s_scaleStep = 0.05f;
+	static constexpr float	s_smoothing = 0.1f;
+	// A step up is only taken if it's predicted to stay below this fraction of the budget.
+	static constexpr float	s_headroom = 0.85f;
+	static constexpr uint32	s_stepDownFrames = 10;
+	static constexpr uint32	s_stepUpFrames = 60;
+
+	float					_targetMilliseconds;
+	float					_minScale;
+	float					_maxScale;
+	float					_scale;
+	float					_averageMilliseconds;
+	uint32					_overBudgetFrames;
+	uint32					_underBudgetFrames;
+};
+
+}
@@ -0,0 +1,195 @@
+#include "EnginePch.h"
+#include "HeadlessRenderer.h"
+
+#include <cstdio>
+
+namespace GG {
+
+HeadlessRenderer::HeadlessRenderer(uint32 width, uint32 height)
+	: _pendingWidth{ width }
+	, _pendingHeight{ height }
+{
+	_windowWidth = width;
+	_windowHeight = height;
+	_backBuffer.Create(width, height);
+}
+
+void HeadlessRenderer::Prepare()
+{
+	GG_PROFILE_SCOPE("HeadlessRenderer::Prepare");
+	if (_pendingWidth != _backBuffer.GetWidth() || _pendingHeight != _backBuffer.GetHeight())
+	{
+		_backBuffer.Create(_pendingWidth, _pendingHeight);
+	}
+	if (_isClearEnabled)
+	{
+		_backBuffer.Clear(_clearColor);
+	}
+	beginFrame();
+}
+
+void HeadlessRenderer::Submit()
+{
+	GG_PROFILE_SCOPE("HeadlessRenderer::Submit");
+	flushTriangles();
+	resolveSamples();
+	endFrame();
+
+	const std::vector<uint8>& writtenTiles = _backBuffer.GetWrittenTiles();
+	_tileMask.assign(writtenTiles.begin(), writtenTiles.end());
+	_backBuffer.BuildRegions(_tileMask, _regions);
+
+	_uploadStatistics = UploadStatistics{};
+	_uploadStatistics.totalTileCount = _backBuffer.GetTileCount();
+	_uploadStatistics.regionCount = static_cast<uint32>(_regions.size());
+	for (uint8 isWritten : _tileMask)
+	{
+		_uploadStatistics.dirtyTileCount += isWritten ? 1 : 0;
+	}
+	for (const auto& region : _regions)
+	{
+		_uploadStatistics.uploadedBytes += static_cast<uint64>(region.width) * region.height * sizeof(uint32);
+	}
+}
+
+void HeadlessRenderer::PrepareGUI()
+{
+
+}
+
+void HeadlessRenderer::SubmitGUI()
+{
+
+}
+
+void HeadlessRenderer::Present()
+{
+	GG_PROFILE_SCOPE("HeadlessRenderer::Present");
+	if (!_frameDumpDirectory.empty())
+	{
+		char fileName[32];
+		std::snprintf(fileName, sizeof(fileName), "/frame_%05u.ppm", _frameIndex);
+		if (!SaveFrame(_frameDumpDirectory + fileName))
+		{
+			GG_ERROR("Failed to dump frame {0} to {1}", _frameIndex, _frameDumpDirectory);
+		}
+	}
+
+	_frameIndex++;
+}
+
+void HeadlessRenderer::PresentGUI()
+{
+
+}
+
+void HeadlessRenderer::OnResize(uint32 width, uint32 height)
+{
+	if (width == 0 || height == 0)
+	{
+		return;
+	}
+
+	_windowWidth = width;
+	_windowHeight = height;
+	applyResolution();
+}
+
+const UploadStatistics& HeadlessRenderer::GetUploadStatistics() const
+{
+	return _uploadStatistics;
+}
+
+void HeadlessRenderer::SetFramesInFlight(uint32 count)
+{
+	_framesInFlight = std::clamp(count, 1u, 3u);
+}
+
+uint32 HeadlessRenderer::GetFramesInFlight() const
+{
+	return _framesInFlight;
+}
+
+void HeadlessRenderer::SetClearColor(uint32 color)
+{
+	_clearColor = color;
+}
+
+void HeadlessRenderer::SetClearEnabled(bool isClearEnabled)
+{
+	_isClearEnabled = isClearEnabled;
+}
+
+uint32 HeadlessRenderer::GetFramebufferWidth() const
+{
+	return _pendingWidth;
+}
+
+uint32 HeadlessRenderer::GetFramebufferHeight() const
+{
+	return _pendingHeight;
+}
+
+void HeadlessRenderer::SetFrameDumpDirectory(const std::string& directory)
+{
+	_frameDumpDirectory = directory;
+}
+
+bool HeadlessRenderer::SaveFrame(const std::string& path) const
+{
+	const uint32 width = _backBuffer.GetWidth();
+	const uint32 height = _backBuffer.GetHeight();
+
+	// Unwritten tiles hold no pixels, start from the clear color and resolve the written regions over it.
+	std::vector<uint32> pixels(static_cast<size_t>(width) * height);
+	PixelKernel::Fill(pixels.data(), _backBuffer.GetClearColor(), static_cast<uint32>(pixels.size()));
+
+	std::vector<TextureRegion> regions;
+	_backBuffer.BuildRegions(_backBuffer.GetWrittenTiles(), regions);
+	for (const auto& region : regions)
+	{
+		_backBuffer.Resolve(region, pixels.data() + static_cast<size_t>(region.y) * width + region.x, width);
+	}
+
+	std::FILE* file = std::fopen(path.c_str(), "wb");
+	if (file == nullptr)
+	{
+		return false;
+	}
+
+	std::fprintf(file, "P6\n%u %u\n255\n", width, height);
+	std::vector<uint8> row(static_cast<size_t>(width) * 3);
+	bool isWritten = true;
+	for (uint32 y = 0; y < height && isWritten; y++)
+	{
+		const uint32* src = pixels.data() + static_cast<size_t>(y) * width;
+		for (uint32 x = 0; x < width; x++)
+		{
+			row[x * 3 + 0] = static_cast<uint8>(src[x]);
+			row[x * 3 + 1] = static_cast<uint8>(src[x] >> 8);
+			row[x * 3 + 2] = static_cast<uint8>(src[x] >> 16);
+		}
+		isWritten = std::fwrite(row.data(), 1, row.size(), file) == row.size();
+	}
+	std::fclose(file);
+
+	return isWritten;
+}
+
+TextureBuffer& HeadlessRenderer::acquireBackBuffer()
+{
+	return _backBuffer;
+}
+
+void HeadlessRenderer::releaseBackBuffer()
+{
+
+}
+
+void HeadlessRenderer::setFramebufferSize(uint32 width, uint32 height)
+{
+	_pendingWidth = width;
+	_pendingHeight = height;
+}
+
+}
\ No newline at end of file
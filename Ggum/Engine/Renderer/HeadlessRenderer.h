@@ -0,0 +1,67 @@
+#pragma once
+
+#include <string>
+
+#include "Renderer/SoftwareRenderer.h"
+
+namespace GG {
+
+// CPU only backend without a window or a GPU, for benchmarks and regression runs on build machines.
+// There is a single back buffer, so frames in flight are only stored and nothing is uploaded.
+// The upload statistics count the written tiles the window backend would upload, cleared tiles aren't tracked.
+class HeadlessRenderer : public SoftwareRenderer
+{
+public:
+	HeadlessRenderer(uint32 width, uint32 height);
+	virtual ~HeadlessRenderer() = default;
+
+	virtual void Prepare() override;
+	virtual void Submit() override;
+	virtual void PrepareGUI() override;
+	virtual void SubmitGUI() override;
+	virtual void Present() override;
+	virtual void PresentGUI() override;
+
+	virtual void OnResize(uint32 width, uint32 height) override;
+
+	virtual const UploadStatistics& GetUploadStatistics() const override;
+
+	virtual void SetFramesInFlight(uint32 count) override;
+	virtual uint32 GetFramesInFlight() const override;
+
+	virtual void SetClearColor(uint32 color) override;
+	virtual void SetClearEnabled(bool isClearEnabled) override;
+
+	virtual uint32 GetFramebufferWidth() const override;
+	virtual uint32 GetFramebufferHeight() const override;
+
+	// Writes every presented frame to directory/frame_NNNNN.ppm, an empty directory disables it.
+	void SetFrameDumpDirectory(const std::string& directory);
+	// Writes the current back buffer as a binary PPM, returns false if the file can't be written.
+	bool SaveFrame(const std::string& path) const;
+
+	inline uint32 GetFrameIndex() const { return _frameIndex; }
+
+protected:
+	virtual TextureBuffer& acquireBackBuffer() override;
+	virtual void releaseBackBuffer() override;
+	virtual void setFramebufferSize(uint32 width, uint32 height) override;
+
+private:
+	TextureBuffer		_backBuffer;
+	uint32				_pendingWidth;
+	uint32				_pendingHeight;
+
+	uint32				_framesInFlight = 1;
+	uint32				_clearColor = 0;
+	bool				_isClearEnabled = true;
+	uint32				_frameIndex = 0;
+
+	UploadStatistics	_uploadStatistics;
+	std::vector<uint8>	_tileMask;
+	std::vector<TextureRegion>	_regions;
+
+	std::string			_frameDumpDirectory;
+};
+
+}
\ No newline at end of file
@@ -0,0 +1,395 @@
+#include "EnginePch.h"
+#include "LineRasterizer.h"
+
+#include <cmath>
+
+#include "Renderer/Rasterizer.h"
+
+namespace GG {
+
+static constexpr int32 s_blockSize = static_cast<int32>(TextureBuffer::s_blockSize);
+// Shorter spans are written pixel by pixel, longer ones with TextureBuffer::FillSpan().
+static constexpr int32 s_bulkSpanLength = 16;
+
+// Writes pixels through the block of the last written pixel, the block is only looked up again when a pixel leaves it.
+struct BlockCursor
+{
+	TextureBuffer& target;
+	const uint32* blockOffsets;
+	uint32* block = nullptr;
+	int32 blockX = -1;
+	int32 blockY = -1;
+
+	inline uint32& At(int32 x, int32 y)
+	{
+		const int32 pixelBlockX = x & ~(s_blockSize - 1);
+		const int32 pixelBlockY = y & ~(s_blockSize - 1);
+		if (pixelBlockX != blockX || pixelBlockY != blockY)
+		{
+			block = target.GetBlockForWrite(static_cast<uint32>(pixelBlockY), static_cast<uint32>(pixelBlockX));
+			blockX = pixelBlockX;
+			blockY = pixelBlockY;
+		}
+
+		return block[blockOffsets[(y - pixelBlockY) * s_blockSize + (x - pixelBlockX)]];
+	}
+};
+
+static inline int64 to_fixed(double value)
+{
+	return static_cast<int64>(std::floor(value * 4294967296.0));
+}
+
+// Both round towards negative infinity, divisor is positive.
+static inline int64 floor_div(int64 value, int64 divisor)
+{
+	return value >= 0 ? value / divisor : -((-value + divisor - 1) / divisor);
+}
+
+static inline int64 ceil_div(int64 value, int64 divisor)
+{
+	return -floor_div(-value, divisor);
+}
+
+// dst + (src - dst) * weight / 256 for all four channels, weight is in [0, 256].
+static inline uint32 blend_pixel(uint32 dst, uint32 src, uint32 weight)
+{
+	const uint32 inverse = 256 - weight;
+	const uint32 rb = (((src & 0x00FF00FFu) * weight + (dst & 0x00FF00FFu) * inverse) >> 8) & 0x00FF00FFu;
+	const uint32 ga = (((src >> 8) & 0x00FF00FFu) * weight + ((dst >> 8) & 0x00FF00FFu) * inverse) & 0xFF00FF00u;
+
+	return rb | ga;
+}
+
+static inline uint32 opacity_of(uint32 color)
+{
+	const uint32 alpha = color >> 24;
+
+	return alpha + (alpha >> 7);
+}
+
+// Liang-Barsky, clips the segment to [minX, maxX] x [minY, maxY] and returns false if nothing is left.
+static bool clip_segment(float& x0, float& y0, float& x1, float& y1, float minX, float minY, float maxX, float maxY)
+{
+	const float dx = x1 - x0;
+	const float dy = y1 - y0;
+	const float p[4]{ -dx, dx, -dy, dy };
+	const float q[4]{ x0 - minX, maxX - x0, y0 - minY, maxY - y0 };
+
+	float t0 = 0.0f;
+	float t1 = 1.0f;
+	for (uint32 i = 0; i < 4; i++)
+	{
+		if (p[i] == 0.0f)
+		{
+			if (q[i] < 0.0f)
+			{
+				return false;
+			}
+			continue;
+		}
+
+		const float t = q[i] / p[i];
+		if (p[i] < 0.0f)
+		{
+			t0 = std::max(t0, t);
+		}
+		else
+		{
+			t1 = std::min(t1, t);
+		}
+	}
+	if (t0 > t1)
+	{
+		return false;
+	}
+
+	const float startX = x0;
+	const float startY = y0;
+	x0 = startX + dx * t0;
+	y0 = startY + dy * t0;
+	x1 = startX + dx * t1;
+	y1 = startY + dy * t1;
+
+	return true;
+}
+
+static void write_span(TextureBuffer& target, BlockCursor& cursor, int32 row, int32 col, int32 count, uint32 color)
+{
+	if (count >= s_bulkSpanLength)
+	{
+		target.FillSpan(row, col, static_cast<uint32>(count), color);
+		return;
+	}
+
+	for (int32 i = 0; i < count; i++)
+	{
+		cursor.At(col + i, row) = color;
+	}
+}
+
+// a is the major and b the minor axis of the line, in pixels with pixel i centered at i, aSize and bSize are the target's extents
+// along them. Lights the pixel nearest to the line in every column of the major axis, returns the number of written pixels.
+template<bool IsSteep>
+static uint64 draw_aliased_line(TextureBuffer& target, BlockCursor& cursor, float a0, float b0, float a1, float b1, int32 aSize, int32 bSize, uint32 color)
+{
+	if (a1 < a0)
+	{
+		std::swap(a0, a1);
+		std::swap(b0, b1);
+	}
+
+	// The pixel of column a is row (base + a * step) >> 32 in 32.32 fixed point.
+	const double slope = a1 > a0 ? (static_cast<double>(b1) - b0) / (static_cast<double>(a1) - a0) : 0.0;
+	const int64 step = to_fixed(slope);
+	const int64 base = to_fixed(b0 + 0.5 - a0 * slope);
+
+	// Columns of the segment whose pixel lies inside of the target, so the walk needs no bounds test.
+	const int64 bEnd = static_cast<int64>(bSize) << 32;
+	int64 aFirst = std::max<int64>(static_cast<int64>(std::floor(a0 + 0.5f)), 0);
+	int64 aLast = std::min<int64>(static_cast<int64>(std::floor(a1 + 0.5f)), aSize - 1);
+	if (step > 0)
+	{
+		aFirst = std::max(aFirst, ceil_div(-base, step));
+		aLast = std::min(aLast, ceil_div(bEnd - base, step) - 1);
+	}
+	else if (step < 0)
+	{
+		aFirst = std::max(aFirst, floor_div(base - bEnd, -step) + 1);
+		aLast = std::min(aLast, floor_div(base, -step));
+	}
+	else if (base < 0 || base >= bEnd)
+	{
+		return 0;
+	}
+	if (aFirst > aLast)
+	{
+		return 0;
+	}
+
+	const int32 first = static_cast<int32>(aFirst);
+	const int32 last = static_cast<int32>(aLast);
+	int64 b = base + first * step;
+	if constexpr (IsSteep)
+	{
+		for (int32 a = first; a <= last; a++, b += step)
+		{
+			cursor.At(static_cast<int32>(b >> 32), a) = color;
+		}
+	}
+	else
+	{
+		// Shallow lines are runs of pixels on the same row.
+		int32 spanStart = first;
+		int32 spanRow = static_cast<int32>(b >> 32);
+		for (int32 a = first + 1; a <= last; a++)
+		{
+			b += step;
+			const int32 row = static_cast<int32>(b >> 32);
+			if (row != spanRow)
+			{
+				write_span(target, cursor, spanRow, spanStart, a - spanStart, color);
+				spanStart = a;
+				spanRow = row;
+			}
+		}
+		write_span(target, cursor, spanRow, spanStart, last + 1 - spanStart, color);
+	}
+
+	return static_cast<uint64>(last - first + 1);
+}
+
+// Xiaolin Wu's line with the same axes as draw_aliased_line(). Every column blends the two pixels around the line
+// by their distance to it, the end columns by how much of them the segment covers along the major axis.
+template<bool IsSteep>
+static uint64 draw_antialiased_line(BlockCursor& cursor, float a0, float b0, float a1, float b1, int32 aSize, int32 bSize, uint32 color)
+{
+	if (a1 < a0)
+	{
+		std::swap(a0, a1);
+		std::swap(b0, b1);
+	}
+
+	const int32 aStart = static_cast<int32>(std::floor(a0 + 0.5f));
+	const int32 aEnd = static_cast<int32>(std::floor(a1 + 0.5f));
+	const int32 first = std::max(aStart, 0);
+	const int32 last = std::min(aEnd, aSize - 1);
+	if (first > last)
+	{
+		return 0;
+	}
+
+	// The line passes column a at (base + a * step) in 32.32 fixed point, between the pixel of the integer part and the next one.
+	const double slope = a1 > a0 ? (static_cast<double>(b1) - b0) / (static_cast<double>(a1) - a0) : 0.0;
+	const int64 step = to_fixed(slope);
+	const int64 base = to_fixed(b0 - a0 * slope);
+	const uint32 opacity = opacity_of(color);
+
+	uint64 pixelCount = 0;
+	int64 b = base + first * step;
+	for (int32 a = first; a <= last; a++, b += step)
+	{
+		uint32 coverage = opacity;
+		if (a == aStart || a == aEnd)
+		{
+			const float gap = std::min(a + 0.5f, a1) - std::max(a - 0.5f, a0);
+			coverage = static_cast<uint32>(std::clamp(gap, 0.0f, 1.0f) * opacity + 0.5f);
+		}
+
+		const int32 row = static_cast<int32>(b >> 32);
+		const uint32 fraction = static_cast<uint32>(b >> 24) & 0xFF;
+		const uint32 farWeight = (coverage * fraction) >> 8;
+		const uint32 nearWeight = coverage - farWeight;
+		if (nearWeight != 0 && static_cast<uint32>(row) < static_cast<uint32>(bSize))
+		{
+			uint32& pixel = IsSteep ? cursor.At(row, a) : cursor.At(a, row);
+			pixel = blend_pixel(pixel, color, nearWeight);
+			pixelCount++;
+		}
+		if (farWeight != 0 && static_cast<uint32>(row + 1) < static_cast<uint32>(bSize))
+		{
+			uint32& pixel = IsSteep ? cursor.At(row + 1, a) : cursor.At(a, row + 1);
+			pixel = blend_pixel(pixel, color, farWeight);
+			pixelCount++;
+		}
+	}
+
+	return pixelCount;
+}
+
+void LineRasterizer::DrawLines(TextureBuffer& target, const LineSegment* segments, uint32 count, bool isAntialiased)
+{
+	_statistics.lineCount += count;
+	if (!target.IsCreated())
+	{
+		_statistics.culledCount += count;
+		return;
+	}
+
+	buildBlockOffsets(target);
+	BlockCursor cursor{ target, _blockOffsets };
+	const int32 width = static_cast<int32>(target.GetWidth());
+	const int32 height = static_cast<int32>(target.GetHeight());
+
+	for (uint32 i = 0; i < count; i++)
+	{
+		const LineSegment& segment = segments[i];
+		// Pixel centers at integer coordinates from here on.
+		float x0 = segment.x0 - 0.5f;
+		float y0 = segment.y0 - 0.5f;
+		float x1 = segment.x1 - 0.5f;
+		float y1 = segment.y1 - 0.5f;
+
+		// One pixel of margin keeps the antialiased fringe of lines just outside of the target.
+		if (!std::isfinite(x0 + y0 + x1 + y1) || !clip_segment(x0, y0, x1, y1, -1.0f, -1.0f, static_cast<float>(width), static_cast<float>(height)))
+		{
+			_statistics.culledCount++;
+			continue;
+		}
+
+		const bool isSteep = std::abs(y1 - y0) > std::abs(x1 - x0);
+		uint64 pixelCount;
+		if (isAntialiased)
+		{
+			pixelCount = isSteep
+				? draw_antialiased_line<true>(cursor, y0, x0, y1, x1, height, width, segment.color)
+				: draw_antialiased_line<false>(cursor, x0, y0, x1, y1, width, height, segment.color);
+		}
+		else
+		{
+			pixelCount = isSteep
+				? draw_aliased_line<true>(target, cursor, y0, x0, y1, x1, height, width, segment.color)
+				: draw_aliased_line<false>(target, cursor, x0, y0, x1, y1, width, height, segment.color);
+		}
+
+		_statistics.pixelCount += pixelCount;
+		_statistics.culledCount += pixelCount == 0 ? 1 : 0;
+	}
+}
+
+void LineRasterizer::DrawPoints(TextureBuffer& target, const RasterPoint* points, uint32 count, float size, bool isAntialiased)
+{
+	_statistics.pointCount += count;
+	if (!target.IsCreated())
+	{
+		_statistics.culledCount += count;
+		return;
+	}
+
+	buildBlockOffsets(target);
+	BlockCursor cursor{ target, _blockOffsets };
+	const int32 width = static_cast<int32>(target.GetWidth());
+	const int32 height = static_cast<int32>(target.GetHeight());
+	const float radius = size * 0.5f;
+	// Aliased points light the pixels centered in [x - radius, x + radius), antialiased ones also the soft edge around.
+	const float reach = isAntialiased ? radius + 0.5f : radius;
+
+	for (uint32 i = 0; i < count; i++)
+	{
+		const RasterPoint& point = points[i];
+		const float x = point.x - 0.5f;
+		const float y = point.y - 0.5f;
+		if (!std::isfinite(x + y))
+		{
+			_statistics.culledCount++;
+			continue;
+		}
+
+		const float rightEdge = isAntialiased ? std::floor(x + reach) : std::ceil(x + reach) - 1.0f;
+		const float bottomEdge = isAntialiased ? std::floor(y + reach) : std::ceil(y + reach) - 1.0f;
+		const int32 left = static_cast<int32>(std::clamp(std::ceil(x - reach), 0.0f, static_cast<float>(width)));
+		const int32 top = static_cast<int32>(std::clamp(std::ceil(y - reach), 0.0f, static_cast<float>(height)));
+		const int32 right = static_cast<int32>(std::clamp(rightEdge, -1.0f, static_cast<float>(width - 1)));
+		const int32 bottom = static_cast<int32>(std::clamp(bottomEdge, -1.0f, static_cast<float>(height - 1)));
+		if (left > right || top > bottom)
+		{
+			_statistics.culledCount++;
+			continue;
+		}
+
+		if (!isAntialiased)
+		{
+			for (int32 row = top; row <= bottom; row++)
+			{
+				write_span(target, cursor, row, left, right - left + 1, point.color);
+			}
+			_statistics.pixelCount += static_cast<uint64>(right - left + 1) * (bottom - top + 1);
+			continue;
+		}
+
+		const uint32 opacity = opacity_of(point.color);
+		for (int32 row = top; row <= bottom; row++)
+		{
+			const float dy = row - y;
+			for (int32 col = left; col <= right; col++)
+			{
+				const float dx = col - x;
+				const float coverage = std::clamp(reach - std::sqrt(dx * dx + dy * dy), 0.0f, 1.0f);
+				const uint32 weight = static_cast<uint32>(coverage * opacity + 0.5f);
+				if (weight != 0)
+				{
+					uint32& pixel = cursor.At(col, row);
+					pixel = blend_pixel(pixel, point.color, weight);
+					_statistics.pixelCount++;
+				}
+			}
+		}
+	}
+}
+
+void LineRasterizer::buildBlockOffsets(const TextureBuffer& target)
+{
+	const RasterBlockPattern& pattern = Rasterizer::GetBlockPattern(target.GetLayout());
+	const uint32 runPitch = target.GetBlockRunPitch();
+	for (int32 run = 0; run < s_blockSize; run++)
+	{
+		for (int32 lane = 0; lane < s_blockSize; lane++)
+		{
+			const int32 x = pattern.runX[run] + pattern.laneX[lane];
+			const int32 y = pattern.runY[run] + pattern.laneY[lane];
+			_blockOffsets[y * s_blockSize + x] = run * runPitch + lane;
+		}
+	}
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "Base.hpp"
+
+#include "System/gg_system.h"
+
+namespace GG {
+
+// Screen space positions in pixels like RasterVertex, pixel (x, y) covers [x, x + 1) x [y, y + 1).
+struct LineSegment
+{
+	float x0;
+	float y0;
+	float x1;
+	float y1;
+	uint32 color;
+};
+
+struct RasterPoint
+{
+	float x;
+	float y;
+	uint32 color;
+};
+
+struct LineStatistics
+{
+	uint64 lineCount = 0;
+	uint64 pointCount = 0;
+	// Lines and points completely outside of the target.
+	uint64 culledCount = 0;
+	uint64 pixelCount = 0;
+};
+
+// Batched line and point rasterizer for debug overlays, writing straight into a TextureBuffer.
+// Every segment is clipped against the target once, then walked along its major axis with a 32.32 fixed point DDA
+// without any per pixel bounds test. Aliased lines light the pixel nearest to the line in every column (row for steep lines)
+// and write horizontal spans in bulk, antialiased lines follow Xiaolin Wu and blend two pixels per column by their distance
+// to the line, scaled by the color's alpha. Pixels are written through the block of the last pixel, so both layouts
+// only look up the block again when the line leaves it. There is no depth test.
+class LineRasterizer
+{
+public:
+	LineRasterizer() = default;
+	~LineRasterizer() = default;
+
+	void DrawLines(TextureBuffer& target, const LineSegment* segments, uint32 count, bool isAntialiased = false);
+	// Squares of size x size pixels, or discs of diameter size with a one pixel soft edge when antialiased.
+	void DrawPoints(TextureBuffer& target, const RasterPoint* points, uint32 count, float size = 1.0f, bool isAntialiased = false);
+
+	inline const LineStatistics& GetStatistics() const { return _statistics; }
+	inline void ResetStatistics() { _statistics = LineStatistics{}; }
+
+private:
+	// Offset of every pixel of a block from the block's first pixel for the target's layout, see TextureBuffer::GetBlockForWrite().
+	void buildBlockOffsets(const TextureBuffer& target);
+
+	uint32							_blockOffsets[TextureBuffer::s_blockSize * TextureBuffer::s_blockSize];
+	LineStatistics					_statistics;
+};
+
+}
\ No newline at end of file
@@ -0,0 +1,271 @@
+#pragma once
+
+#include <algorithm>
+#include <type_traits>
+#include <utility>
+
+#include "Base.hpp"
+
+#include "System/gg_system.h"
+#include "System/Utility/Simd.hpp"
+#include "Renderer/Rasterizer.h"
+
+namespace GG {
+
+// Vertex of a shaded triangle: the screen space position of RasterVertex, 1 / w of its clip space position and the attributes.
+// inverseW = 1 for every vertex interpolates the attributes affinely in screen space.
+template<uint32 AttributeCount>
+struct ShadedVertex
+{
+	float x;
+	float y;
+	float z;
+	float inverseW;
+	float attributes[std::max(AttributeCount, 1u)];
+};
+
+// Inputs of one run of pixels (a row of a block, see RasterBlockPattern), in structure of arrays layout so shaders loop over the lanes.
+// Only the attributes of the shader's s_usedAttributeMask are written.
+template<uint32 AttributeCount>
+struct PixelRun
+{
+	static constexpr uint32 s_laneCount = TextureBuffer::s_blockSize;
+
+	alignas(16) float attributes[std::max(AttributeCount, 1u)][s_laneCount];
+	// Lanes which are written, the shader may compute all of them anyway.
+	uint8 mask;
+};
+
+// Attribute value over the screen, value(x, y) = origin + stepX * x + stepY * y at pixel centers, and its offsets inside a block.
+struct InterpolationPlane
+{
+	// At pixel (0, 0), in double like RasterTriangle::depthOrigin so blocks far from the origin keep their precision.
+	double origin;
+	float stepX;
+	float stepY;
+	alignas(16) float laneOffset[TextureBuffer::s_blockSize];
+	float runOffset[TextureBuffer::s_blockSize];
+
+	void Setup(const float* x, const float* y, const float* values, const RasterBlockPattern& pattern)
+	{
+		const double x1 = static_cast<double>(x[1]) - x[0];
+		const double y1 = static_cast<double>(y[1]) - y[0];
+		const double x2 = static_cast<double>(x[2]) - x[0];
+		const double y2 = static_cast<double>(y[2]) - y[0];
+		const double value1 = static_cast<double>(values[1]) - values[0];
+		const double value2 = static_cast<double>(values[2]) - values[0];
+		const double area = x1 * y2 - x2 * y1;
+		const double inverseArea = area != 0.0 ? 1.0 / area : 0.0;
+		const double planeStepX = (value1 * y2 - value2 * y1) * inverseArea;
+		const double planeStepY = (value2 * x1 - value1 * x2) * inverseArea;
+
+		origin = values[0] + planeStepX * (0.5 - x[0]) + planeStepY * (0.5 - y[0]);
+		stepX = static_cast<float>(planeStepX);
+		stepY = static_cast<float>(planeStepY);
+		for (uint32 i = 0; i < TextureBuffer::s_blockSize; i++)
+		{
+			laneOffset[i] = stepX * pattern.laneX[i] + stepY * pattern.laneY[i];
+			runOffset[i] = stepX * pattern.runX[i] + stepY * pattern.runY[i];
+		}
+	}
+
+	inline float At(int32 x, int32 y) const { return static_cast<float>(origin + static_cast<double>(stepX) * x + static_cast<double>(stepY) * y); }
+};
+
+// Calls func(std::integral_constant<uint32, i>) for every i of Indices whose bit is set in Mask, unrolled at compile time.
+template<uint32 Mask, typename Func, uint32... Indices>
+inline void ForEachBit(Func&& func, std::integer_sequence<uint32, Indices...>)
+{
+	auto callIfSet = [&](auto index) {
+		if constexpr (((Mask >> decltype(index)::value) & 1u) != 0)
+		{
+			func(index);
+		}
+	};
+	// Unused for shaders without attributes.
+	(void)callIfSet;
+	(callIfSet(std::integral_constant<uint32, Indices>{}), ...);
+}
+
+// Base of the pixel shaders, Derived is the shader itself:
+//
+//	struct GradientShader : public PixelShader<GradientShader, 3>
+//	{
+//		// 8 packed RGBA8 colors per run.
+//		void Shade(const Run& run, uint32* outColors) const;
+//	};
+//
+// The block loop is instantiated per shader type with Shade() inlined into it, there is no virtual call or function object per pixel.
+// Attributes are interpolated perspective correct 4 lanes per instruction and only the ones in s_usedAttributeMask,
+// a shader reading fewer attributes than its vertices carry redeclares the mask. Without used attributes 1 / w isn't interpolated either.
+template<typename Derived, uint32 AttributeCount>
+class PixelShader
+{
+public:
+	static constexpr uint32 s_attributeCount = AttributeCount;
+	static constexpr uint32 s_usedAttributeMask = AttributeCount >= 32 ? ~0u : (1u << AttributeCount) - 1;
+
+	using Vertex = ShadedVertex<AttributeCount>;
+	using Run = PixelRun<AttributeCount>;
+
+	// Draws one triangle into the whole target right away, depthBuffer and multisampleBuffer are optional like in Rasterizer::DrawTriangle().
+	// With multisampling every pixel is still shaded once, at its center.
+	static void DrawTriangle(Rasterizer& rasterizer, TextureBuffer& target, const Derived& shader, const Vertex& v0, const Vertex& v1, const Vertex& v2, DepthBuffer* depthBuffer = nullptr,
+		MultisampleBuffer* multisampleBuffer = nullptr);
+	// Indexed triangle list for IDrawable::DrawShaded(), shader, vertices and indices have to outlive the draw.
+	static ShadedBatch MakeBatch(const Derived& shader, const Vertex* vertices, const uint32* indices, uint32 indexCount);
+
+private:
+	// Planes of one triangle, the shadeBlock() state.
+	struct Interpolation
+	{
+		const Derived* shader;
+		InterpolationPlane inverseW;
+		InterpolationPlane attributes[std::max(AttributeCount, 1u)];
+
+		Interpolation(const Derived& pixelShader, const Vertex& v0, const Vertex& v1, const Vertex& v2, const RasterBlockPattern& pattern);
+	};
+
+	static constexpr bool hasAttributes() { return Derived::s_usedAttributeMask != 0; }
+	static RasterVertex toRasterVertex(const Vertex& vertex) { return RasterVertex{ vertex.x, vertex.y, vertex.z }; }
+
+	static void shadeBlock(const void* state, const ShadeBlock& block);
+	static bool setupBatchTriangle(const ShadedBatch& batch, uint32 triangleIndex, Rasterizer& rasterizer, uint32 width, uint32 height, RasterTriangle& outTriangle);
+	static void drawBatchTriangle(const ShadedBatch& batch, uint32 triangleIndex, Rasterizer& rasterizer, TextureBuffer& target, const RasterTriangle& triangle, const TextureRegion& scissor,
+		DepthBuffer* depthBuffer, MultisampleBuffer* multisampleBuffer);
+};
+
+template<typename Derived, uint32 AttributeCount>
+PixelShader<Derived, AttributeCount>::Interpolation::Interpolation(const Derived& pixelShader, const Vertex& v0, const Vertex& v1, const Vertex& v2, const RasterBlockPattern& pattern)
+	: shader{ &pixelShader }
+{
+	if constexpr (!hasAttributes())
+	{
+		return;
+	}
+
+	// attribute / w and 1 / w are linear in screen space, the attribute is their ratio at every pixel.
+	const float x[3]{ v0.x, v1.x, v2.x };
+	const float y[3]{ v0.y, v1.y, v2.y };
+	const float inverseWs[3]{ v0.inverseW, v1.inverseW, v2.inverseW };
+	inverseW.Setup(x, y, inverseWs, pattern);
+
+	ForEachBit<Derived::s_usedAttributeMask>([&](auto index) {
+		constexpr uint32 i = decltype(index)::value;
+		const float values[3]{ v0.attributes[i] * v0.inverseW, v1.attributes[i] * v1.inverseW, v2.attributes[i] * v2.inverseW };
+		attributes[i].Setup(x, y, values, pattern);
+	}, std::make_integer_sequence<uint32, AttributeCount>{});
+}
+
+template<typename Derived, uint32 AttributeCount>
+void PixelShader<Derived, AttributeCount>::DrawTriangle(Rasterizer& rasterizer, TextureBuffer& target, const Derived& shader, const Vertex& v0, const Vertex& v1, const Vertex& v2, DepthBuffer* depthBuffer,
+	MultisampleBuffer* multisampleBuffer)
+{
+	RasterTriangle triangle;
+	if (!rasterizer.SetupTriangle(toRasterVertex(v0), toRasterVertex(v1), toRasterVertex(v2), 0, target.GetWidth(), target.GetHeight(), triangle))
+	{
+		return;
+	}
+
+	const Interpolation interpolation(shader, v0, v1, v2, Rasterizer::GetBlockPattern(target.GetLayout()));
+	rasterizer.DrawShadedTriangle(target, triangle, TextureRegion{ 0, 0, target.GetWidth(), target.GetHeight() }, depthBuffer, multisampleBuffer, &shadeBlock, &interpolation);
+}
+
+template<typename Derived, uint32 AttributeCount>
+ShadedBatch PixelShader<Derived, AttributeCount>::MakeBatch(const Derived& shader, const Vertex* vertices, const uint32* indices, uint32 indexCount)
+{
+	return ShadedBatch{ &shader, vertices, indices, indexCount / 3, &setupBatchTriangle, &drawBatchTriangle };
+}
+
+template<typename Derived, uint32 AttributeCount>
+void PixelShader<Derived, AttributeCount>::shadeBlock(const void* state, const ShadeBlock& block)
+{
+	constexpr uint32 laneCount = Run::s_laneCount;
+	static_assert(laneCount == 8, "Runs are shaded as two SSE vectors!");
+
+	const Interpolation& interpolation = *static_cast<const Interpolation*>(state);
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128i laneBits0 = _mm_setr_epi32(1, 2, 4, 8);
+	const __m128i laneBits1 = _mm_setr_epi32(16, 32, 64, 128);
+
+	// Plane values at the block's first pixel.
+	float inverseWBase = 0.0f;
+	float attributeBases[std::max(AttributeCount, 1u)];
+	if constexpr (hasAttributes())
+	{
+		inverseWBase = interpolation.inverseW.At(block.x, block.y);
+		ForEachBit<Derived::s_usedAttributeMask>([&](auto index) {
+			constexpr uint32 i = decltype(index)::value;
+			attributeBases[i] = interpolation.attributes[i].At(block.x, block.y);
+		}, std::make_integer_sequence<uint32, AttributeCount>{});
+	}
+
+	Run run;
+	alignas(16) uint32 colors[laneCount];
+	for (uint32 runIndex = 0; runIndex < laneCount; runIndex++)
+	{
+		const uint8 mask = block.runMasks[runIndex];
+		if (mask == 0)
+		{
+			continue;
+		}
+		run.mask = mask;
+
+		if constexpr (hasAttributes())
+		{
+			const InterpolationPlane& inverseW = interpolation.inverseW;
+			const __m128 inverseWRun = _mm_set1_ps(inverseWBase + inverseW.runOffset[runIndex]);
+			const __m128 w0 = _mm_div_ps(one, _mm_add_ps(inverseWRun, _mm_load_ps(inverseW.laneOffset)));
+			const __m128 w1 = _mm_div_ps(one, _mm_add_ps(inverseWRun, _mm_load_ps(inverseW.laneOffset + 4)));
+
+			ForEachBit<Derived::s_usedAttributeMask>([&](auto index) {
+				constexpr uint32 i = decltype(index)::value;
+				const InterpolationPlane& plane = interpolation.attributes[i];
+				const __m128 valueRun = _mm_set1_ps(attributeBases[i] + plane.runOffset[runIndex]);
+				_mm_store_ps(run.attributes[i], _mm_mul_ps(_mm_add_ps(valueRun, _mm_load_ps(plane.laneOffset)), w0));
+				_mm_store_ps(run.attributes[i] + 4, _mm_mul_ps(_mm_add_ps(valueRun, _mm_load_ps(plane.laneOffset + 4)), w1));
+			}, std::make_integer_sequence<uint32, AttributeCount>{});
+		}
+
+		interpolation.shader->Shade(run, colors);
+
+		__m128i* pixels = reinterpret_cast<__m128i*>(block.pixels + runIndex * block.runPitch);
+		const __m128i color0 = _mm_load_si128(reinterpret_cast<const __m128i*>(colors));
+		const __m128i color1 = _mm_load_si128(reinterpret_cast<const __m128i*>(colors + 4));
+		if (mask == 0xFF)
+		{
+			_mm_storeu_si128(pixels, color0);
+			_mm_storeu_si128(pixels + 1, color1);
+		}
+		else
+		{
+			const __m128i maskValue = _mm_set1_epi32(mask);
+			const __m128i mask0 = _mm_cmpeq_epi32(_mm_and_si128(maskValue, laneBits0), laneBits0);
+			const __m128i mask1 = _mm_cmpeq_epi32(_mm_and_si128(maskValue, laneBits1), laneBits1);
+			_mm_storeu_si128(pixels, _mm_or_si128(_mm_and_si128(mask0, color0), _mm_andnot_si128(mask0, _mm_loadu_si128(pixels))));
+			_mm_storeu_si128(pixels + 1, _mm_or_si128(_mm_and_si128(mask1, color1), _mm_andnot_si128(mask1, _mm_loadu_si128(pixels + 1))));
+		}
+	}
+}
+
+template<typename Derived, uint32 AttributeCount>
+bool PixelShader<Derived, AttributeCount>::setupBatchTriangle(const ShadedBatch& batch, uint32 triangleIndex, Rasterizer& rasterizer, uint32 width, uint32 height, RasterTriangle& outTriangle)
+{
+	const Vertex* vertices = static_cast<const Vertex*>(batch.vertices);
+	const uint32* indices = batch.indices + triangleIndex * 3;
+
+	return rasterizer.SetupTriangle(toRasterVertex(vertices[indices[0]]), toRasterVertex(vertices[indices[1]]), toRasterVertex(vertices[indices[2]]), 0, width, height, outTriangle);
+}
+
+template<typename Derived, uint32 AttributeCount>
+void PixelShader<Derived, AttributeCount>::drawBatchTriangle(const ShadedBatch& batch, uint32 triangleIndex, Rasterizer& rasterizer, TextureBuffer& target, const RasterTriangle& triangle, const TextureRegion& scissor,
+	DepthBuffer* depthBuffer, MultisampleBuffer* multisampleBuffer)
+{
+	const Vertex* vertices = static_cast<const Vertex*>(batch.vertices);
+	const uint32* indices = batch.indices + triangleIndex * 3;
+	const Interpolation interpolation(*static_cast<const Derived*>(batch.shader), vertices[indices[0]], vertices[indices[1]], vertices[indices[2]], Rasterizer::GetBlockPattern(target.GetLayout()));
+
+	rasterizer.DrawShadedTriangle(target, triangle, scissor, depthBuffer, multisampleBuffer, &shadeBlock, &interpolation);
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,999 @@
+#include "EnginePch.h"
+#include "Rasterizer.h"
+
+#include "System/Utility/Simd.hpp"
+
+namespace GG {
+
+static constexpr int32 s_subPixelScale = 1 << Rasterizer::s_subPixelBits;
+static constexpr uint32 s_blockSize = TextureBuffer::s_blockSize;
+static constexpr uint32 s_blockPixels = s_blockSize * s_blockSize;
+// Value of an edge which doesn't cut the block, stays positive for every lane offset the guard band allows.
+static constexpr int32 s_insideEdgeValue = 1 << 30;
+
+static constexpr RasterBlockPattern s_linearPattern
+{
+	{ 0, 0, 0, 0, 0, 0, 0, 0 },
+	{ 0, 1, 2, 3, 4, 5, 6, 7 },
+	{ 0, 1, 2, 3, 4, 5, 6, 7 },
+	{ 0, 0, 0, 0, 0, 0, 0, 0 },
+};
+
+static constexpr RasterBlockPattern s_tiledPattern
+{
+	{ 0, 0, 4, 4, 0, 0, 4, 4 },
+	{ 0, 2, 0, 2, 4, 6, 4, 6 },
+	{ 0, 1, 0, 1, 2, 3, 2, 3 },
+	{ 0, 0, 1, 1, 0, 0, 1, 1 },
+};
+
+static constexpr uint8 s_bitCount[16]{ 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4 };
+
+// Per block offsets of a RasterTriangle's edges for one block pattern.
+// Steps and offsets inside a block fit in 32 bits because of the guard band, the edge values at the block don't.
+struct BlockSetup
+{
+	// Smallest and largest offset from a block's first pixel to any pixel of the block.
+	int32 minOffset[3];
+	int32 maxOffset[3];
+
+	alignas(32) int32 laneOffset[3][s_blockSize];
+	int32 runOffset[3][s_blockSize];
+
+	// Same for the depth plane, only set up when a depth buffer is bound.
+	float minDepthOffset;
+	alignas(32) float depthLaneOffset[s_blockSize];
+	float depthRunOffset[s_blockSize];
+};
+
+using PartialBlockFunc = uint32(*)(const BlockSetup&, const int32*, uint32*, uint32, uint32);
+using DepthBlockFunc = uint32(*)(const BlockSetup&, const int32*, float, uint32*, uint32, float*, uint32, uint32&);
+using CoverBlockFunc = uint32(*)(const BlockSetup&, const int32*, float, float*, uint8*, uint32&);
+
+static int32 floor_div(int32 value, int32 divisor)
+{
+	return value >= 0 ? value / divisor : -((-value + divisor - 1) / divisor);
+}
+
+// Pixels of a block which is cut by at least one edge, edgeValues are the edges at the block's first pixel.
+static uint32 draw_partial_block_sse2(const BlockSetup& setup, const int32* edgeValues, uint32* block, uint32 runPitch, uint32 color)
+{
+	const __m128i colorValue = _mm_set1_epi32(static_cast<int>(color));
+	const __m128i minusOne = _mm_set1_epi32(-1);
+	const __m128i* lanes0 = reinterpret_cast<const __m128i*>(setup.laneOffset[0]);
+	const __m128i* lanes1 = reinterpret_cast<const __m128i*>(setup.laneOffset[1]);
+	const __m128i* lanes2 = reinterpret_cast<const __m128i*>(setup.laneOffset[2]);
+
+	uint32 pixelCount = 0;
+	for (uint32 run = 0; run < s_blockSize; run++)
+	{
+		const __m128i base0 = _mm_set1_epi32(edgeValues[0] + setup.runOffset[0][run]);
+		const __m128i base1 = _mm_set1_epi32(edgeValues[1] + setup.runOffset[1][run]);
+		const __m128i base2 = _mm_set1_epi32(edgeValues[2] + setup.runOffset[2][run]);
+
+		// The sign bits of the three edges are or'ed, a lane is inside if the result is still positive.
+		__m128i outside0 = _mm_or_si128(_mm_add_epi32(base0, _mm_load_si128(lanes0)), _mm_add_epi32(base1, _mm_load_si128(lanes1)));
+		__m128i outside1 = _mm_or_si128(_mm_add_epi32(base0, _mm_load_si128(lanes0 + 1)), _mm_add_epi32(base1, _mm_load_si128(lanes1 + 1)));
+		__m128i mask0 = _mm_cmpgt_epi32(_mm_or_si128(outside0, _mm_add_epi32(base2, _mm_load_si128(lanes2))), minusOne);
+		__m128i mask1 = _mm_cmpgt_epi32(_mm_or_si128(outside1, _mm_add_epi32(base2, _mm_load_si128(lanes2 + 1))), minusOne);
+
+		const int bits0 = _mm_movemask_ps(_mm_castsi128_ps(mask0));
+		const int bits1 = _mm_movemask_ps(_mm_castsi128_ps(mask1));
+		if ((bits0 | bits1) == 0)
+		{
+			continue;
+		}
+
+		__m128i* pixels = reinterpret_cast<__m128i*>(block + run * runPitch);
+		__m128i old0 = _mm_loadu_si128(pixels);
+		__m128i old1 = _mm_loadu_si128(pixels + 1);
+		_mm_storeu_si128(pixels, _mm_or_si128(_mm_and_si128(mask0, colorValue), _mm_andnot_si128(mask0, old0)));
+		_mm_storeu_si128(pixels + 1, _mm_or_si128(_mm_and_si128(mask1, colorValue), _mm_andnot_si128(mask1, old1)));
+		pixelCount += s_bitCount[bits0] + s_bitCount[bits1];
+	}
+
+	return pixelCount;
+}
+
+GG_TARGET_AVX2 static uint32 draw_partial_block_avx2(const BlockSetup& setup, const int32* edgeValues, uint32* block, uint32 runPitch, uint32 color)
+{
+	const __m256i colorValue = _mm256_set1_epi32(static_cast<int>(color));
+	const __m256i minusOne = _mm256_set1_epi32(-1);
+	const __m256i lanes0 = _mm256_load_si256(reinterpret_cast<const __m256i*>(setup.laneOffset[0]));
+	const __m256i lanes1 = _mm256_load_si256(reinterpret_cast<const __m256i*>(setup.laneOffset[1]));
+	const __m256i lanes2 = _mm256_load_si256(reinterpret_cast<const __m256i*>(setup.laneOffset[2]));
+
+	uint32 pixelCount = 0;
+	for (uint32 run = 0; run < s_blockSize; run++)
+	{
+		__m256i outside = _mm256_or_si256(
+			_mm256_add_epi32(_mm256_set1_epi32(edgeValues[0] + setup.runOffset[0][run]), lanes0),
+			_mm256_add_epi32(_mm256_set1_epi32(edgeValues[1] + setup.runOffset[1][run]), lanes1));
+		outside = _mm256_or_si256(outside, _mm256_add_epi32(_mm256_set1_epi32(edgeValues[2] + setup.runOffset[2][run]), lanes2));
+		const __m256i mask = _mm256_cmpgt_epi32(outside, minusOne);
+
+		const int bits = _mm256_movemask_ps(_mm256_castsi256_ps(mask));
+		if (bits == 0)
+		{
+			continue;
+		}
+
+		__m256i* pixels = reinterpret_cast<__m256i*>(block + run * runPitch);
+		_mm256_storeu_si256(pixels, _mm256_blendv_epi8(_mm256_loadu_si256(pixels), colorValue, mask));
+		pixelCount += s_bitCount[bits & 15] + s_bitCount[bits >> 4];
+	}
+
+	return pixelCount;
+}
+
+static PartialBlockFunc get_partial_block_func()
+{
+	static const PartialBlockFunc s_func = Simd::IsAVX2Supported() ? draw_partial_block_avx2 : draw_partial_block_sse2;
+
+	return s_func;
+}
+
+// Same as the partial block kernels with an early depth test before the color write: covered pixels pass if they are closer
+// than the stored depth, and both color and depth are written for them. Fully covered blocks take this path as well.
+static uint32 draw_depth_block_sse2(const BlockSetup& setup, const int32* edgeValues, float blockDepth, uint32* block, uint32 runPitch, float* depths, uint32 color, uint32& outRejectedPixelCount)
+{
+	const __m128i colorValue = _mm_set1_epi32(static_cast<int>(color));
+	const __m128i minusOne = _mm_set1_epi32(-1);
+	const __m128i* lanes0 = reinterpret_cast<const __m128i*>(setup.laneOffset[0]);
+	const __m128i* lanes1 = reinterpret_cast<const __m128i*>(setup.laneOffset[1]);
+	const __m128i* lanes2 = reinterpret_cast<const __m128i*>(setup.laneOffset[2]);
+	const __m128 depthLanes0 = _mm_load_ps(setup.depthLaneOffset);
+	const __m128 depthLanes1 = _mm_load_ps(setup.depthLaneOffset + 4);
+
+	uint32 pixelCount = 0;
+	for (uint32 run = 0; run < s_blockSize; run++)
+	{
+		const __m128i base0 = _mm_set1_epi32(edgeValues[0] + setup.runOffset[0][run]);
+		const __m128i base1 = _mm_set1_epi32(edgeValues[1] + setup.runOffset[1][run]);
+		const __m128i base2 = _mm_set1_epi32(edgeValues[2] + setup.runOffset[2][run]);
+
+		__m128i outside0 = _mm_or_si128(_mm_add_epi32(base0, _mm_load_si128(lanes0)), _mm_add_epi32(base1, _mm_load_si128(lanes1)));
+		__m128i outside1 = _mm_or_si128(_mm_add_epi32(base0, _mm_load_si128(lanes0 + 1)), _mm_add_epi32(base1, _mm_load_si128(lanes1 + 1)));
+		const __m128i covered0 = _mm_cmpgt_epi32(_mm_or_si128(outside0, _mm_add_epi32(base2, _mm_load_si128(lanes2))), minusOne);
+		const __m128i covered1 = _mm_cmpgt_epi32(_mm_or_si128(outside1, _mm_add_epi32(base2, _mm_load_si128(lanes2 + 1))), minusOne);
+
+		const int coveredBits = _mm_movemask_ps(_mm_castsi128_ps(covered0)) | (_mm_movemask_ps(_mm_castsi128_ps(covered1)) << 4);
+		if (coveredBits == 0)
+		{
+			continue;
+		}
+
+		float* runDepths = depths + run * s_blockSize;
+		const __m128 runDepth = _mm_set1_ps(blockDepth + setup.depthRunOffset[run]);
+		const __m128 depth0 = _mm_add_ps(runDepth, depthLanes0);
+		const __m128 depth1 = _mm_add_ps(runDepth, depthLanes1);
+		const __m128 oldDepth0 = _mm_loadu_ps(runDepths);
+		const __m128 oldDepth1 = _mm_loadu_ps(runDepths + 4);
+		const __m128i mask0 = _mm_and_si128(covered0, _mm_castps_si128(_mm_cmplt_ps(depth0, oldDepth0)));
+		const __m128i mask1 = _mm_and_si128(covered1, _mm_castps_si128(_mm_cmplt_ps(depth1, oldDepth1)));
+
+		const int bits0 = _mm_movemask_ps(_mm_castsi128_ps(mask0));
+		const int bits1 = _mm_movemask_ps(_mm_castsi128_ps(mask1));
+		const int rejectedBits = coveredBits & ~(bits0 | (bits1 << 4));
+		outRejectedPixelCount += s_bitCount[rejectedBits & 15] + s_bitCount[rejectedBits >> 4];
+		if ((bits0 | bits1) == 0)
+		{
+			continue;
+		}
+
+		_mm_storeu_ps(runDepths, _mm_or_ps(_mm_and_ps(_mm_castsi128_ps(mask0), depth0), _mm_andnot_ps(_mm_castsi128_ps(mask0), oldDepth0)));
+		_mm_storeu_ps(runDepths + 4, _mm_or_ps(_mm_and_ps(_mm_castsi128_ps(mask1), depth1), _mm_andnot_ps(_mm_castsi128_ps(mask1), oldDepth1)));
+
+		__m128i* pixels = reinterpret_cast<__m128i*>(block + run * runPitch);
+		__m128i old0 = _mm_loadu_si128(pixels);
+		__m128i old1 = _mm_loadu_si128(pixels + 1);
+		_mm_storeu_si128(pixels, _mm_or_si128(_mm_and_si128(mask0, colorValue), _mm_andnot_si128(mask0, old0)));
+		_mm_storeu_si128(pixels + 1, _mm_or_si128(_mm_and_si128(mask1, colorValue), _mm_andnot_si128(mask1, old1)));
+		pixelCount += s_bitCount[bits0] + s_bitCount[bits1];
+	}
+
+	return pixelCount;
+}
+
+GG_TARGET_AVX2 static uint32 draw_depth_block_avx2(const BlockSetup& setup, const int32* edgeValues, float blockDepth, uint32* block, uint32 runPitch, float* depths, uint32 color, uint32& outRejectedPixelCount)
+{
+	const __m256i colorValue = _mm256_set1_epi32(static_cast<int>(color));
+	const __m256i minusOne = _mm256_set1_epi32(-1);
+	const __m256i lanes0 = _mm256_load_si256(reinterpret_cast<const __m256i*>(setup.laneOffset[0]));
+	const __m256i lanes1 = _mm256_load_si256(reinterpret_cast<const __m256i*>(setup.laneOffset[1]));
+	const __m256i lanes2 = _mm256_load_si256(reinterpret_cast<const __m256i*>(setup.laneOffset[2]));
+	const __m256 depthLanes = _mm256_load_ps(setup.depthLaneOffset);
+
+	uint32 pixelCount = 0;
+	for (uint32 run = 0; run < s_blockSize; run++)
+	{
+		__m256i outside = _mm256_or_si256(
+			_mm256_add_epi32(_mm256_set1_epi32(edgeValues[0] + setup.runOffset[0][run]), lanes0),
+			_mm256_add_epi32(_mm256_set1_epi32(edgeValues[1] + setup.runOffset[1][run]), lanes1));
+		outside = _mm256_or_si256(outside, _mm256_add_epi32(_mm256_set1_epi32(edgeValues[2] + setup.runOffset[2][run]), lanes2));
+		const __m256i covered = _mm256_cmpgt_epi32(outside, minusOne);
+
+		const int coveredBits = _mm256_movemask_ps(_mm256_castsi256_ps(covered));
+		if (coveredBits == 0)
+		{
+			continue;
+		}
+
+		float* runDepths = depths + run * s_blockSize;
+		const __m256 depth = _mm256_add_ps(_mm256_set1_ps(blockDepth + setup.depthRunOffset[run]), depthLanes);
+		const __m256 oldDepth = _mm256_loadu_ps(runDepths);
+		const __m256 mask = _mm256_and_ps(_mm256_castsi256_ps(covered), _mm256_cmp_ps(depth, oldDepth, _CMP_LT_OQ));
+
+		const int bits = _mm256_movemask_ps(mask);
+		const int rejectedBits = coveredBits & ~bits;
+		outRejectedPixelCount += s_bitCount[rejectedBits & 15] + s_bitCount[rejectedBits >> 4];
+		if (bits == 0)
+		{
+			continue;
+		}
+
+		_mm256_storeu_ps(runDepths, _mm256_blendv_ps(oldDepth, depth, mask));
+
+		__m256i* pixels = reinterpret_cast<__m256i*>(block + run * runPitch);
+		_mm256_storeu_si256(pixels, _mm256_blendv_epi8(_mm256_loadu_si256(pixels), colorValue, _mm256_castps_si256(mask)));
+		pixelCount += s_bitCount[bits & 15] + s_bitCount[bits >> 4];
+	}
+
+	return pixelCount;
+}
+
+static DepthBlockFunc get_depth_block_func()
+{
+	static const DepthBlockFunc s_func = Simd::IsAVX2Supported() ? draw_depth_block_avx2 : draw_depth_block_sse2;
+
+	return s_func;
+}
+
+// Coverage and depth test of a shaded block: writes the mask of the pixels to shade per run instead of a color.
+// depths is null without a depth buffer.
+static uint32 cover_block_sse2(const BlockSetup& setup, const int32* edgeValues, float blockDepth, float* depths, uint8* outRunMasks, uint32& outRejectedPixelCount)
+{
+	const __m128i minusOne = _mm_set1_epi32(-1);
+	const __m128i* lanes0 = reinterpret_cast<const __m128i*>(setup.laneOffset[0]);
+	const __m128i* lanes1 = reinterpret_cast<const __m128i*>(setup.laneOffset[1]);
+	const __m128i* lanes2 = reinterpret_cast<const __m128i*>(setup.laneOffset[2]);
+
+	uint32 pixelCount = 0;
+	for (uint32 run = 0; run < s_blockSize; run++)
+	{
+		const __m128i base0 = _mm_set1_epi32(edgeValues[0] + setup.runOffset[0][run]);
+		const __m128i base1 = _mm_set1_epi32(edgeValues[1] + setup.runOffset[1][run]);
+		const __m128i base2 = _mm_set1_epi32(edgeValues[2] + setup.runOffset[2][run]);
+
+		__m128i outside0 = _mm_or_si128(_mm_add_epi32(base0, _mm_load_si128(lanes0)), _mm_add_epi32(base1, _mm_load_si128(lanes1)));
+		__m128i outside1 = _mm_or_si128(_mm_add_epi32(base0, _mm_load_si128(lanes0 + 1)), _mm_add_epi32(base1, _mm_load_si128(lanes1 + 1)));
+		__m128i mask0 = _mm_cmpgt_epi32(_mm_or_si128(outside0, _mm_add_epi32(base2, _mm_load_si128(lanes2))), minusOne);
+		__m128i mask1 = _mm_cmpgt_epi32(_mm_or_si128(outside1, _mm_add_epi32(base2, _mm_load_si128(lanes2 + 1))), minusOne);
+
+		int bits = _mm_movemask_ps(_mm_castsi128_ps(mask0)) | (_mm_movemask_ps(_mm_castsi128_ps(mask1)) << 4);
+		if (bits != 0 && depths)
+		{
+			float* runDepths = depths + run * s_blockSize;
+			const __m128 runDepth = _mm_set1_ps(blockDepth + setup.depthRunOffset[run]);
+			const __m128 depth0 = _mm_add_ps(runDepth, _mm_load_ps(setup.depthLaneOffset));
+			const __m128 depth1 = _mm_add_ps(runDepth, _mm_load_ps(setup.depthLaneOffset + 4));
+			const __m128 oldDepth0 = _mm_loadu_ps(runDepths);
+			const __m128 oldDepth1 = _mm_loadu_ps(runDepths + 4);
+			const __m128 passed0 = _mm_and_ps(_mm_castsi128_ps(mask0), _mm_cmplt_ps(depth0, oldDepth0));
+			const __m128 passed1 = _mm_and_ps(_mm_castsi128_ps(mask1), _mm_cmplt_ps(depth1, oldDepth1));
+			_mm_storeu_ps(runDepths, _mm_or_ps(_mm_and_ps(passed0, depth0), _mm_andnot_ps(passed0, oldDepth0)));
+			_mm_storeu_ps(runDepths + 4, _mm_or_ps(_mm_and_ps(passed1, depth1), _mm_andnot_ps(passed1, oldDepth1)));
+
+			const int passedBits = _mm_movemask_ps(passed0) | (_mm_movemask_ps(passed1) << 4);
+			const int rejectedBits = bits & ~passedBits;
+			outRejectedPixelCount += s_bitCount[rejectedBits & 15] + s_bitCount[rejectedBits >> 4];
+			bits = passedBits;
+		}
+
+		outRunMasks[run] = static_cast<uint8>(bits);
+		pixelCount += s_bitCount[bits & 15] + s_bitCount[bits >> 4];
+	}
+
+	return pixelCount;
+}
+
+GG_TARGET_AVX2 static uint32 cover_block_avx2(const BlockSetup& setup, const int32* edgeValues, float blockDepth, float* depths, uint8* outRunMasks, uint32& outRejectedPixelCount)
+{
+	const __m256i minusOne = _mm256_set1_epi32(-1);
+	const __m256i lanes0 = _mm256_load_si256(reinterpret_cast<const __m256i*>(setup.laneOffset[0]));
+	const __m256i lanes1 = _mm256_load_si256(reinterpret_cast<const __m256i*>(setup.laneOffset[1]));
+	const __m256i lanes2 = _mm256_load_si256(reinterpret_cast<const __m256i*>(setup.laneOffset[2]));
+
+	uint32 pixelCount = 0;
+	for (uint32 run = 0; run < s_blockSize; run++)
+	{
+		__m256i outside = _mm256_or_si256(
+			_mm256_add_epi32(_mm256_set1_epi32(edgeValues[0] + setup.runOffset[0][run]), lanes0),
+			_mm256_add_epi32(_mm256_set1_epi32(edgeValues[1] + setup.runOffset[1][run]), lanes1));
+		outside = _mm256_or_si256(outside, _mm256_add_epi32(_mm256_set1_epi32(edgeValues[2] + setup.runOffset[2][run]), lanes2));
+		const __m256i covered = _mm256_cmpgt_epi32(outside, minusOne);
+
+		int bits = _mm256_movemask_ps(_mm256_castsi256_ps(covered));
+		if (bits != 0 && depths)
+		{
+			float* runDepths = depths + run * s_blockSize;
+			const __m256 depth = _mm256_add_ps(_mm256_set1_ps(blockDepth + setup.depthRunOffset[run]), _mm256_load_ps(setup.depthLaneOffset));
+			const __m256 oldDepth = _mm256_loadu_ps(runDepths);
+			const __m256 passed = _mm256_and_ps(_mm256_castsi256_ps(covered), _mm256_cmp_ps(depth, oldDepth, _CMP_LT_OQ));
+			_mm256_storeu_ps(runDepths, _mm256_blendv_ps(oldDepth, depth, passed));
+
+			const int passedBits = _mm256_movemask_ps(passed);
+			const int rejectedBits = bits & ~passedBits;
+			outRejectedPixelCount += s_bitCount[rejectedBits & 15] + s_bitCount[rejectedBits >> 4];
+			bits = passedBits;
+		}
+
+		outRunMasks[run] = static_cast<uint8>(bits);
+		pixelCount += s_bitCount[bits & 15] + s_bitCount[bits >> 4];
+	}
+
+	return pixelCount;
+}
+
+static CoverBlockFunc get_cover_block_func()
+{
+	static const CoverBlockFunc s_func = Simd::IsAVX2Supported() ? cover_block_avx2 : cover_block_sse2;
+
+	return s_func;
+}
+
+// Blocks crossing the right or bottom border of the buffer, only the first width x height pixels exist.
+// depths is the block of the depth buffer or null without one. With outRunMasks the pixels are only marked for a shader, not written.
+static uint32 draw_border_block(const RasterTriangle& triangle, const BlockSetup& setup, const RasterBlockPattern& pattern, const int64* edgeValues, uint32* block, uint32 runPitch, uint32 width, uint32 height,
+	uint32 color, float* depths, float blockDepth, uint32& outRejectedPixelCount, uint8* outRunMasks = nullptr)
+{
+	uint32 pixelCount = 0;
+	for (uint32 run = 0; run < s_blockSize; run++)
+	{
+		if (outRunMasks)
+		{
+			outRunMasks[run] = 0;
+		}
+
+		for (uint32 lane = 0; lane < s_blockSize; lane++)
+		{
+			const int32 x = pattern.runX[run] + pattern.laneX[lane];
+			const int32 y = pattern.runY[run] + pattern.laneY[lane];
+			if (static_cast<uint32>(x) >= width || static_cast<uint32>(y) >= height)
+			{
+				continue;
+			}
+
+			bool isInside = true;
+			for (uint32 edge = 0; edge < 3; edge++)
+			{
+				isInside &= edgeValues[edge] + static_cast<int64>(triangle.stepX[edge]) * x + static_cast<int64>(triangle.stepY[edge]) * y >= 0;
+			}
+			if (!isInside)
+			{
+				continue;
+			}
+
+			if (depths)
+			{
+				const float depth = blockDepth + setup.depthRunOffset[run] + setup.depthLaneOffset[lane];
+				float& oldDepth = depths[run * s_blockSize + lane];
+				if (!(depth < oldDepth))
+				{
+					outRejectedPixelCount++;
+					continue;
+				}
+				oldDepth = depth;
+			}
+			if (outRunMasks)
+			{
+				outRunMasks[run] |= static_cast<uint8>(1u << lane);
+			}
+			else
+			{
+				block[run * runPitch + lane] = color;
+			}
+			pixelCount++;
+		}
+	}
+
+	return pixelCount;
+}
+
+// Sample offsets of a triangle's edge functions and depth plane for the sample pattern of a MultisampleBuffer.
+struct MultisampleSetup
+{
+	uint32 sampleCount;
+	uint32 fullSampleMask;
+	int32 edgeOffset[3][MultisampleBuffer::s_maxSampleCount];
+	float depthOffset[MultisampleBuffer::s_maxSampleCount];
+	// Bounds of the offsets over the samples, they widen a block's footprint to the samples of its border pixels.
+	int32 minEdgeOffset[3];
+	int32 maxEdgeOffset[3];
+	float minDepthOffset;
+};
+
+static void setup_multisample(const RasterTriangle& triangle, uint32 sampleCount, MultisampleSetup& outSetup)
+{
+	const SamplePattern& pattern = MultisampleBuffer::GetSamplePattern(sampleCount);
+	outSetup.sampleCount = pattern.count;
+	outSetup.fullSampleMask = (1u << pattern.count) - 1;
+
+	// Sample positions are on the 1/16 pixel grid of the snapped vertices, so the edge offsets are exact.
+	for (uint32 edge = 0; edge < 3; edge++)
+	{
+		outSetup.minEdgeOffset[edge] = 0;
+		outSetup.maxEdgeOffset[edge] = 0;
+		for (uint32 sample = 0; sample < pattern.count; sample++)
+		{
+			const int32 offset = (triangle.stepX[edge] * pattern.x[sample] + triangle.stepY[edge] * pattern.y[sample]) / s_subPixelScale;
+			outSetup.edgeOffset[edge][sample] = offset;
+			outSetup.minEdgeOffset[edge] = std::min(outSetup.minEdgeOffset[edge], offset);
+			outSetup.maxEdgeOffset[edge] = std::max(outSetup.maxEdgeOffset[edge], offset);
+		}
+	}
+
+	outSetup.minDepthOffset = 0.0f;
+	for (uint32 sample = 0; sample < pattern.count; sample++)
+	{
+		outSetup.depthOffset[sample] = (triangle.depthStepX * pattern.x[sample] + triangle.depthStepY * pattern.y[sample]) / static_cast<float>(s_subPixelScale);
+		outSetup.minDepthOffset = std::min(outSetup.minDepthOffset, outSetup.depthOffset[sample]);
+	}
+}
+
+// Pixels of a block which exist in a width x height buffer, in the bit order of the multisample masks.
+static uint64 get_valid_pixel_mask(const RasterBlockPattern& pattern, uint32 width, uint32 height)
+{
+	uint64 mask = 0;
+	for (uint32 run = 0; run < s_blockSize; run++)
+	{
+		for (uint32 lane = 0; lane < s_blockSize; lane++)
+		{
+			const uint32 x = static_cast<uint32>(pattern.runX[run] + pattern.laneX[lane]);
+			const uint32 y = static_cast<uint32>(pattern.runY[run] + pattern.laneY[lane]);
+			mask |= static_cast<uint64>(x < width && y < height) << (run * s_blockSize + lane);
+		}
+	}
+
+	return mask;
+}
+
+// Lanes of a run whose depth is below the stored depth, bit i for lane i.
+static inline uint32 less_depth_mask(__m128 depth0, __m128 depth1, const float* storedDepths)
+{
+	return static_cast<uint32>(_mm_movemask_ps(_mm_cmplt_ps(depth0, _mm_loadu_ps(storedDepths))) | (_mm_movemask_ps(_mm_cmplt_ps(depth1, _mm_loadu_ps(storedDepths + 4))) << 4));
+}
+
+// Writes color to the pixels of a block set in mask, bit run * s_blockSize + lane.
+static void fill_masked(uint32* block, uint32 runPitch, uint64 mask, uint32 color)
+{
+	const __m128i colors = _mm_set1_epi32(static_cast<int>(color));
+	const __m128i laneBits0 = _mm_setr_epi32(1, 2, 4, 8);
+	const __m128i laneBits1 = _mm_setr_epi32(16, 32, 64, 128);
+	for (uint32 run = 0; run < s_blockSize; run++)
+	{
+		const uint32 laneMask = static_cast<uint32>(mask >> (run * s_blockSize)) & 0xFF;
+		if (laneMask == 0)
+		{
+			continue;
+		}
+
+		__m128i* pixels = reinterpret_cast<__m128i*>(block + run * runPitch);
+		const __m128i maskValue = _mm_set1_epi32(static_cast<int>(laneMask));
+		const __m128i mask0 = _mm_cmpeq_epi32(_mm_and_si128(maskValue, laneBits0), laneBits0);
+		const __m128i mask1 = _mm_cmpeq_epi32(_mm_and_si128(maskValue, laneBits1), laneBits1);
+		_mm_storeu_si128(pixels, _mm_or_si128(_mm_and_si128(mask0, colors), _mm_andnot_si128(mask0, _mm_loadu_si128(pixels))));
+		_mm_storeu_si128(pixels + 1, _mm_or_si128(_mm_and_si128(mask1, colors), _mm_andnot_si128(mask1, _mm_loadu_si128(pixels + 1))));
+	}
+}
+
+// Multisampled block which is cut by an edge, crosses the border or holds split pixels. Coverage is tested per sample with the
+// block kernels and every sample depth against the sample's stored depth, which is the DepthBuffer's for pixels which aren't split,
+// so each sample ends up as a 64-bit mask of the block. Pixels passing with every sample are written like without multisampling
+// and collapse to a single color again, only the remaining edge pixels are split and written sample by sample.
+// Every pixel is shaded once, at its center.
+static uint32 draw_multisample_block(const BlockSetup& setup, const MultisampleSetup& multisample, CoverBlockFunc coverBlock, const int32* edgeValues, bool isPartial,
+	uint64 validMask, uint32* block, uint32 runPitch, float* depths, float blockDepth, MultisampleBuffer& buffer, int32 blockX, int32 blockY, uint32 color,
+	ShadeBlockFunc shadeBlock, const void* shadeState, uint32& outRejectedPixelCount)
+{
+	const uint32 sampleCount = multisample.sampleCount;
+	const uint32 blockRow = static_cast<uint32>(blockY);
+	const uint32 blockCol = static_cast<uint32>(blockX);
+	const uint64 splitMask = buffer.GetSplitMask(blockRow, blockCol);
+	MultisampleBuffer::BlockSamples samples{ nullptr, nullptr };
+	if (splitMask != 0)
+	{
+		samples = buffer.GetBlockSamplesForWrite(blockRow, blockCol);
+	}
+
+	uint64 passed[MultisampleBuffer::s_maxSampleCount];
+	uint64 anyCoverage = 0;
+	for (uint32 sample = 0; sample < sampleCount; sample++)
+	{
+		uint64 coverage = validMask;
+		if (isPartial)
+		{
+			const int32 sampleValues[3]{ edgeValues[0] + multisample.edgeOffset[0][sample], edgeValues[1] + multisample.edgeOffset[1][sample], edgeValues[2] + multisample.edgeOffset[2][sample] };
+			uint8 runMasks[s_blockSize];
+			uint32 rejectedPixelCount = 0;
+			coverBlock(setup, sampleValues, 0.0f, nullptr, runMasks, rejectedPixelCount);
+
+			std::memcpy(&coverage, runMasks, sizeof(coverage));
+			coverage &= validMask;
+		}
+		anyCoverage |= coverage;
+		passed[sample] = coverage;
+	}
+	if (anyCoverage == 0)
+	{
+		return 0;
+	}
+
+	if (depths)
+	{
+		const __m128 laneOffset0 = _mm_loadu_ps(setup.depthLaneOffset);
+		const __m128 laneOffset1 = _mm_loadu_ps(setup.depthLaneOffset + 4);
+		for (uint32 run = 0; run < s_blockSize; run++)
+		{
+			const uint32 shift = run * s_blockSize;
+			if (((anyCoverage >> shift) & 0xFF) == 0)
+			{
+				continue;
+			}
+
+			const uint64 runSplitMask = (splitMask >> shift) & 0xFF;
+			const __m128 runDepth = _mm_set1_ps(blockDepth + setup.depthRunOffset[run]);
+			const __m128 depth0 = _mm_add_ps(runDepth, laneOffset0);
+			const __m128 depth1 = _mm_add_ps(runDepth, laneOffset1);
+			for (uint32 sample = 0; sample < sampleCount; sample++)
+			{
+				const __m128 offset = _mm_set1_ps(multisample.depthOffset[sample]);
+				const __m128 sampleDepth0 = _mm_add_ps(depth0, offset);
+				const __m128 sampleDepth1 = _mm_add_ps(depth1, offset);
+				uint64 runPassed = less_depth_mask(sampleDepth0, sampleDepth1, depths + shift) & ~runSplitMask;
+				if (runSplitMask != 0)
+				{
+					runPassed |= less_depth_mask(sampleDepth0, sampleDepth1, samples.depths + sample * s_blockPixels + shift) & runSplitMask;
+				}
+				passed[sample] &= ~(static_cast<uint64>(0xFF) << shift) | (runPassed << shift);
+			}
+		}
+	}
+
+	uint64 anyPassed = 0;
+	uint64 allPassed = ~static_cast<uint64>(0);
+	for (uint32 sample = 0; sample < sampleCount; sample++)
+	{
+		anyPassed |= passed[sample];
+		allPassed &= passed[sample];
+	}
+	outRejectedPixelCount += Simd::CountBits(anyCoverage & ~anyPassed);
+	if (anyPassed == 0)
+	{
+		return 0;
+	}
+
+	// Edge pixels and every pixel of a border block are shaded into a block of their own, runs of border blocks may leave the target.
+	const bool isBorder = validMask != ~static_cast<uint64>(0);
+	const uint64 partialPassed = anyPassed & ~allPassed;
+	const uint64 indirectMask = isBorder ? anyPassed : partialPassed;
+	alignas(32) uint32 shadedColors[s_blockPixels];
+	if (shadeBlock && indirectMask != 0)
+	{
+		ShadeBlock shade{ shadedColors, s_blockSize, blockX, blockY, {} };
+		std::memcpy(shade.runMasks, &indirectMask, sizeof(shade.runMasks));
+		shadeBlock(shadeState, shade);
+	}
+
+	// Pixels with every sample written are drawn like without multisampling.
+	if (allPassed != 0)
+	{
+		if (isBorder)
+		{
+			for (uint64 pixels = allPassed; pixels != 0; pixels &= pixels - 1)
+			{
+				const uint32 pixel = Simd::CountTrailingZeros(pixels);
+				block[pixel / s_blockSize * runPitch + pixel % s_blockSize] = shadeBlock ? shadedColors[pixel] : color;
+			}
+		}
+		else if (shadeBlock)
+		{
+			ShadeBlock shade{ block, runPitch, blockX, blockY, {} };
+			std::memcpy(shade.runMasks, &allPassed, sizeof(shade.runMasks));
+			shadeBlock(shadeState, shade);
+		}
+		else
+		{
+			fill_masked(block, runPitch, allPassed, color);
+		}
+
+		if (depths)
+		{
+			for (uint64 pixels = allPassed; pixels != 0; pixels &= pixels - 1)
+			{
+				const uint32 pixel = Simd::CountTrailingZeros(pixels);
+				depths[pixel] = blockDepth + setup.depthRunOffset[pixel / s_blockSize] + setup.depthLaneOffset[pixel % s_blockSize];
+			}
+		}
+	}
+
+	uint64 newSplitMask = splitMask & ~allPassed;
+	if (partialPassed != 0)
+	{
+		if (samples.colors == nullptr)
+		{
+			samples = buffer.GetBlockSamplesForWrite(blockRow, blockCol);
+		}
+
+		for (uint64 pixels = partialPassed; pixels != 0; pixels &= pixels - 1)
+		{
+			const uint32 pixel = Simd::CountTrailingZeros(pixels);
+			const uint64 pixelBit = static_cast<uint64>(1) << pixel;
+			const uint32 pixelColor = shadeBlock ? shadedColors[pixel] : color;
+
+			if ((newSplitMask & pixelBit) == 0)
+			{
+				// Every sample starts out as the pixel's single color and depth.
+				const uint32 pixelValue = block[pixel / s_blockSize * runPitch + pixel % s_blockSize];
+				for (uint32 sample = 0; sample < sampleCount; sample++)
+				{
+					samples.colors[sample * s_blockPixels + pixel] = pixelValue;
+				}
+				if (depths)
+				{
+					for (uint32 sample = 0; sample < sampleCount; sample++)
+					{
+						samples.depths[sample * s_blockPixels + pixel] = depths[pixel];
+					}
+				}
+				newSplitMask |= pixelBit;
+			}
+
+			for (uint32 sample = 0; sample < sampleCount; sample++)
+			{
+				if (passed[sample] & pixelBit)
+				{
+					samples.colors[sample * s_blockPixels + pixel] = pixelColor;
+				}
+			}
+			if (depths)
+			{
+				const float depth = blockDepth + setup.depthRunOffset[pixel / s_blockSize] + setup.depthLaneOffset[pixel % s_blockSize];
+				float maxDepth = 0.0f;
+				for (uint32 sample = 0; sample < sampleCount; sample++)
+				{
+					float& sampleDepth = samples.depths[sample * s_blockPixels + pixel];
+					if (passed[sample] & pixelBit)
+					{
+						sampleDepth = depth + multisample.depthOffset[sample];
+					}
+					maxDepth = std::max(maxDepth, sampleDepth);
+				}
+				// The coarse Z only ever compares against the largest depth of a block.
+				depths[pixel] = maxDepth;
+			}
+		}
+	}
+
+	if (newSplitMask != splitMask)
+	{
+		buffer.SetSplitMask(blockRow, blockCol, newSplitMask);
+	}
+
+	return Simd::CountBits(anyPassed);
+}
+
+void Rasterizer::DrawTriangle(TextureBuffer& target, const RasterVertex& v0, const RasterVertex& v1, const RasterVertex& v2, uint32 color, DepthBuffer* depthBuffer, MultisampleBuffer* multisampleBuffer)
+{
+	RasterTriangle triangle;
+	if (SetupTriangle(v0, v1, v2, color, target.GetWidth(), target.GetHeight(), triangle))
+	{
+		DrawTriangle(target, triangle, TextureRegion{ 0, 0, target.GetWidth(), target.GetHeight() }, depthBuffer, multisampleBuffer);
+	}
+}
+
+bool Rasterizer::SetupTriangle(const RasterVertex& v0, const RasterVertex& v1, const RasterVertex& v2, uint32 color, uint32 width, uint32 height, RasterTriangle& outTriangle)
+{
+	_statistics.triangleCount++;
+
+	// Snaps all six coordinates at once, round to nearest.
+	const __m128 position01 = _mm_setr_ps(v0.x, v0.y, v1.x, v1.y);
+	const __m128 position2 = _mm_setr_ps(v2.x, v2.y, 0.0f, 0.0f);
+	const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+	const __m128 guardBand = _mm_set1_ps(s_guardBand);
+	const int isInGuardBand01 = _mm_movemask_ps(_mm_cmple_ps(_mm_and_ps(position01, absMask), guardBand));
+	const int isInGuardBand2 = _mm_movemask_ps(_mm_cmple_ps(_mm_and_ps(position2, absMask), guardBand)) & 0x3;
+	if (isInGuardBand01 != 0xF || isInGuardBand2 != 0x3)
+	{
+		_statistics.culledTriangleCount++;
+		return false;
+	}
+
+	alignas(16) int32 fixed01[4];
+	alignas(16) int32 fixed2[4];
+	const __m128 scale = _mm_set1_ps(static_cast<float>(s_subPixelScale));
+	_mm_store_si128(reinterpret_cast<__m128i*>(fixed01), _mm_cvtps_epi32(_mm_mul_ps(position01, scale)));
+	_mm_store_si128(reinterpret_cast<__m128i*>(fixed2), _mm_cvtps_epi32(_mm_mul_ps(position2, scale)));
+	int32 x[3]{ fixed01[0], fixed01[2], fixed2[0] };
+	int32 y[3]{ fixed01[1], fixed01[3], fixed2[1] };
+	float z[3]{ v0.z, v1.z, v2.z };
+
+	// Twice the signed area, the edge functions are positive inside of a positive triangle.
+	int64 area = static_cast<int64>(x[2] - x[0]) * (y[1] - y[0]) - static_cast<int64>(y[2] - y[0]) * (x[1] - x[0]);
+	if (area == 0)
+	{
+		_statistics.culledTriangleCount++;
+		return false;
+	}
+	if (area < 0)
+	{
+		std::swap(x[1], x[2]);
+		std::swap(y[1], y[2]);
+		std::swap(z[1], z[2]);
+		area = -area;
+	}
+
+	outTriangle.minX = std::max(floor_div(std::min({ x[0], x[1], x[2] }), s_subPixelScale), 0);
+	outTriangle.minY = std::max(floor_div(std::min({ y[0], y[1], y[2] }), s_subPixelScale), 0);
+	outTriangle.maxX = std::min(floor_div(std::max({ x[0], x[1], x[2] }), s_subPixelScale), static_cast<int32>(width) - 1);
+	outTriangle.maxY = std::min(floor_div(std::max({ y[0], y[1], y[2] }), s_subPixelScale), static_cast<int32>(height) - 1);
+	if (outTriangle.minX > outTriangle.maxX || outTriangle.minY > outTriangle.maxY)
+	{
+		_statistics.culledTriangleCount++;
+		return false;
+	}
+
+	for (uint32 edge = 0; edge < 3; edge++)
+	{
+		const uint32 next = edge == 2 ? 0 : edge + 1;
+		const int32 dx = x[next] - x[edge];
+		const int32 dy = y[next] - y[edge];
+		// Top-left rule: pixel centers exactly on an edge belong to the triangle only if it's a left edge or a horizontal top edge.
+		const bool isTopLeft = dy > 0 || (dy == 0 && dx < 0);
+
+		outTriangle.stepX[edge] = dy * s_subPixelScale;
+		outTriangle.stepY[edge] = -dx * s_subPixelScale;
+		outTriangle.origin[edge] = static_cast<int64>(s_subPixelScale / 2 - x[edge]) * dy - static_cast<int64>(s_subPixelScale / 2 - y[edge]) * dx - (isTopLeft ? 0 : 1);
+	}
+	outTriangle.color = color;
+
+	// Depth plane through the snapped vertices, area is the determinant of the two edge vectors in fixed point.
+	const double edgeX1 = x[1] - x[0];
+	const double edgeY1 = y[1] - y[0];
+	const double edgeX2 = x[2] - x[0];
+	const double edgeY2 = y[2] - y[0];
+	const double depth1 = static_cast<double>(z[1]) - z[0];
+	const double depth2 = static_cast<double>(z[2]) - z[0];
+	const double inverseArea = static_cast<double>(s_subPixelScale) / static_cast<double>(area);
+	const double depthStepX = (depth2 * edgeY1 - depth1 * edgeY2) * inverseArea;
+	const double depthStepY = (depth1 * edgeX2 - depth2 * edgeX1) * inverseArea;
+	outTriangle.depthOrigin = z[0] + depthStepX * (0.5 - static_cast<double>(x[0]) / s_subPixelScale) + depthStepY * (0.5 - static_cast<double>(y[0]) / s_subPixelScale);
+	outTriangle.depthStepX = static_cast<float>(depthStepX);
+	outTriangle.depthStepY = static_cast<float>(depthStepY);
+	outTriangle.minDepth = std::min({ z[0], z[1], z[2] });
+
+	return true;
+}
+
+void Rasterizer::DrawTriangle(TextureBuffer& target, const RasterTriangle& triangle, const TextureRegion& scissor, DepthBuffer* depthBuffer, MultisampleBuffer* multisampleBuffer)
+{
+	drawBlocks(target, triangle, scissor, depthBuffer, multisampleBuffer, nullptr, nullptr);
+}
+
+void Rasterizer::DrawShadedTriangle(TextureBuffer& target, const RasterTriangle& triangle, const TextureRegion& scissor, DepthBuffer* depthBuffer, MultisampleBuffer* multisampleBuffer,
+	ShadeBlockFunc shadeBlock, const void* shadeState)
+{
+	drawBlocks(target, triangle, scissor, depthBuffer, multisampleBuffer, shadeBlock, shadeState);
+}
+
+const RasterBlockPattern& Rasterizer::GetBlockPattern(eTextureLayout layout)
+{
+	return layout == eTextureLayout::Linear ? s_linearPattern : s_tiledPattern;
+}
+
+void Rasterizer::drawBlocks(TextureBuffer& target, const RasterTriangle& triangle, const TextureRegion& scissor, DepthBuffer* depthBuffer, MultisampleBuffer* multisampleBuffer,
+	ShadeBlockFunc shadeBlock, const void* shadeState)
+{
+	GG_ASSERT(!depthBuffer || (depthBuffer->GetWidth() == target.GetWidth() && depthBuffer->GetHeight() == target.GetHeight() && depthBuffer->GetLayout() == target.GetLayout()),
+		"Depth buffer doesn't match the target!");
+	GG_ASSERT(!multisampleBuffer || (multisampleBuffer->GetWidth() == target.GetWidth() && multisampleBuffer->GetHeight() == target.GetHeight() && multisampleBuffer->GetLayout() == target.GetLayout()),
+		"Multisample buffer doesn't match the target!");
+	GG_ASSERT(scissor.x % s_blockSize == 0 && scissor.y % s_blockSize == 0, "Scissor has to start on a block!");
+	GG_ASSERT((scissor.x + scissor.width) % s_blockSize == 0 || scissor.x + scissor.width >= target.GetWidth(), "Scissor has to end on a block or the border!");
+	GG_ASSERT((scissor.y + scissor.height) % s_blockSize == 0 || scissor.y + scissor.height >= target.GetHeight(), "Scissor has to end on a block or the border!");
+
+	const int32 width = static_cast<int32>(target.GetWidth());
+	const int32 height = static_cast<int32>(target.GetHeight());
+	const int32 minX = std::max(triangle.minX, static_cast<int32>(scissor.x));
+	const int32 minY = std::max(triangle.minY, static_cast<int32>(scissor.y));
+	const int32 maxX = std::min({ triangle.maxX, static_cast<int32>(scissor.x + scissor.width) - 1, width - 1 });
+	const int32 maxY = std::min({ triangle.maxY, static_cast<int32>(scissor.y + scissor.height) - 1, height - 1 });
+	if (minX > maxX || minY > maxY)
+	{
+		return;
+	}
+
+	const RasterBlockPattern& pattern = GetBlockPattern(target.GetLayout());
+
+	BlockSetup setup;
+	for (uint32 edge = 0; edge < 3; edge++)
+	{
+		const int32 stepX = triangle.stepX[edge];
+		const int32 stepY = triangle.stepY[edge];
+		setup.minOffset[edge] = (std::min(stepX, 0) + std::min(stepY, 0)) * static_cast<int32>(s_blockSize - 1);
+		setup.maxOffset[edge] = (std::max(stepX, 0) + std::max(stepY, 0)) * static_cast<int32>(s_blockSize - 1);
+
+		for (uint32 i = 0; i < s_blockSize; i++)
+		{
+			setup.laneOffset[edge][i] = stepX * pattern.laneX[i] + stepY * pattern.laneY[i];
+			setup.runOffset[edge][i] = stepX * pattern.runX[i] + stepY * pattern.runY[i];
+		}
+	}
+	if (depthBuffer)
+	{
+		const float stepX = triangle.depthStepX;
+		const float stepY = triangle.depthStepY;
+		setup.minDepthOffset = (std::min(stepX, 0.0f) + std::min(stepY, 0.0f)) * static_cast<float>(s_blockSize - 1);
+
+		for (uint32 i = 0; i < s_blockSize; i++)
+		{
+			setup.depthLaneOffset[i] = stepX * pattern.laneX[i] + stepY * pattern.laneY[i];
+			setup.depthRunOffset[i] = stepX * pattern.runX[i] + stepY * pattern.runY[i];
+		}
+	}
+
+	// Blocks are classified by the samples of their pixels instead of the centers: a block is only partial
+	// (and multisampled) if an edge passes through the sample footprint of its pixels.
+	MultisampleSetup multisample{};
+	if (multisampleBuffer)
+	{
+		setup_multisample(triangle, multisampleBuffer->GetSampleCount(), multisample);
+		for (uint32 edge = 0; edge < 3; edge++)
+		{
+			setup.minOffset[edge] += multisample.minEdgeOffset[edge];
+			setup.maxOffset[edge] += multisample.maxEdgeOffset[edge];
+		}
+		setup.minDepthOffset += multisample.minDepthOffset;
+	}
+
+	const PartialBlockFunc drawPartialBlock = get_partial_block_func();
+	const DepthBlockFunc drawDepthBlock = get_depth_block_func();
+	const CoverBlockFunc coverBlock = get_cover_block_func();
+	const uint32 runPitch = target.GetBlockRunPitch();
+	const uint32 color = triangle.color;
+	const int32 beginX = minX & ~static_cast<int32>(s_blockSize - 1);
+	const int32 beginY = minY & ~static_cast<int32>(s_blockSize - 1);
+
+	for (int32 blockY = beginY; blockY <= maxY; blockY += s_blockSize)
+	{
+		int64 edgeValues[3];
+		for (uint32 edge = 0; edge < 3; edge++)
+		{
+			edgeValues[edge] = triangle.origin[edge] + static_cast<int64>(triangle.stepX[edge]) * beginX + static_cast<int64>(triangle.stepY[edge]) * blockY;
+		}
+
+		for (int32 blockX = beginX; blockX <= maxX; blockX += s_blockSize)
+		{
+			bool isRejected = false;
+			bool isPartial = false;
+			int32 partialValues[3];
+			for (uint32 edge = 0; edge < 3; edge++)
+			{
+				isRejected |= edgeValues[edge] + setup.maxOffset[edge] < 0;
+				const bool isCut = edgeValues[edge] + setup.minOffset[edge] < 0;
+				isPartial |= isCut;
+				partialValues[edge] = isCut ? static_cast<int32>(edgeValues[edge]) : s_insideEdgeValue;
+			}
+
+			// Coarse Z: the block is rejected if the closest depth the triangle can have in it isn't closer than its farthest depth.
+			float blockDepth = 0.0f;
+			if (!isRejected && depthBuffer)
+			{
+				blockDepth = static_cast<float>(triangle.depthOrigin + static_cast<double>(triangle.depthStepX) * blockX + static_cast<double>(triangle.depthStepY) * blockY);
+				const float minDepth = std::max(blockDepth + setup.minDepthOffset, triangle.minDepth);
+				if (minDepth >= depthBuffer->GetBlockMaxDepth(static_cast<uint32>(blockY), static_cast<uint32>(blockX)))
+				{
+					isRejected = true;
+					_statistics.depthRejectedBlockCount++;
+				}
+			}
+
+			if (!isRejected)
+			{
+				uint32* block = target.GetBlockForWrite(static_cast<uint32>(blockY), static_cast<uint32>(blockX));
+				float* depths = depthBuffer ? depthBuffer->GetBlockForWrite(static_cast<uint32>(blockY), static_cast<uint32>(blockX)) : nullptr;
+				uint32 pixelCount = 0;
+				uint32 rejectedPixelCount = 0;
+
+				const bool isBorder = blockX + static_cast<int32>(s_blockSize) > width || blockY + static_cast<int32>(s_blockSize) > height;
+
+				if (multisampleBuffer && (isPartial || isBorder || multisampleBuffer->GetSplitMask(static_cast<uint32>(blockY), static_cast<uint32>(blockX)) != 0))
+				{
+					const uint64 validMask = isBorder ? get_valid_pixel_mask(pattern, static_cast<uint32>(width - blockX), static_cast<uint32>(height - blockY)) : ~static_cast<uint64>(0);
+					pixelCount = draw_multisample_block(setup, multisample, coverBlock, partialValues, isPartial, validMask, block, runPitch, depths, blockDepth, *multisampleBuffer, blockX, blockY,
+						color, shadeBlock, shadeState, rejectedPixelCount);
+					(isBorder || isPartial ? _statistics.partialBlockCount : _statistics.fullBlockCount)++;
+					_statistics.multisampleBlockCount++;
+				}
+				else if (shadeBlock)
+				{
+					ShadeBlock shade{ block, runPitch, blockX, blockY, {} };
+					if (isBorder)
+					{
+						const uint32 blockWidth = static_cast<uint32>(std::min<int32>(s_blockSize, width - blockX));
+						const uint32 blockHeight = static_cast<uint32>(std::min<int32>(s_blockSize, height - blockY));
+						pixelCount = draw_border_block(triangle, setup, pattern, edgeValues, block, runPitch, blockWidth, blockHeight, color, depths, blockDepth, rejectedPixelCount, shade.runMasks);
+					}
+					else if (isPartial || depths)
+					{
+						pixelCount = coverBlock(setup, partialValues, blockDepth, depths, shade.runMasks, rejectedPixelCount);
+					}
+					else
+					{
+						std::memset(shade.runMasks, 0xFF, sizeof(shade.runMasks));
+						pixelCount = s_blockPixels;
+					}
+					(isBorder || isPartial ? _statistics.partialBlockCount : _statistics.fullBlockCount)++;
+
+					if (pixelCount != 0 && isBorder)
+					{
+						// Runs of a linear border block leave the row, the shader writes a block of its own and only covered pixels are copied.
+						alignas(32) uint32 shadedColors[s_blockPixels];
+						ShadeBlock scratch{ shadedColors, s_blockSize, blockX, blockY, {} };
+						std::memcpy(scratch.runMasks, shade.runMasks, sizeof(scratch.runMasks));
+						shadeBlock(shadeState, scratch);
+
+						uint64 covered = 0;
+						std::memcpy(&covered, shade.runMasks, sizeof(covered));
+						for (; covered != 0; covered &= covered - 1)
+						{
+							const uint32 pixel = Simd::CountTrailingZeros(covered);
+							block[pixel / s_blockSize * runPitch + pixel % s_blockSize] = shadedColors[pixel];
+						}
+					}
+					else if (pixelCount != 0)
+					{
+						shadeBlock(shadeState, shade);
+					}
+				}
+				else if (isBorder)
+				{
+					const uint32 blockWidth = static_cast<uint32>(std::min<int32>(s_blockSize, width - blockX));
+					const uint32 blockHeight = static_cast<uint32>(std::min<int32>(s_blockSize, height - blockY));
+					pixelCount = draw_border_block(triangle, setup, pattern, edgeValues, block, runPitch, blockWidth, blockHeight, color, depths, blockDepth, rejectedPixelCount);
+					_statistics.partialBlockCount++;
+				}
+				else if (depths)
+				{
+					pixelCount = drawDepthBlock(setup, partialValues, blockDepth, block, runPitch, depths, color, rejectedPixelCount);
+					(isPartial ? _statistics.partialBlockCount : _statistics.fullBlockCount)++;
+				}
+				else if (!isPartial)
+				{
+					PixelKernel::FillRect(block, runPitch, s_blockSize, s_blockSize, color);
+					pixelCount = s_blockPixels;
+					_statistics.fullBlockCount++;
+				}
+				else
+				{
+					pixelCount = drawPartialBlock(setup, partialValues, block, runPitch, color);
+					_statistics.partialBlockCount++;
+				}
+
+				if (depths && pixelCount != 0)
+				{
+					depthBuffer->UpdateBlockBounds(static_cast<uint32>(blockY), static_cast<uint32>(blockX));
+				}
+				_statistics.pixelCount += pixelCount;
+				_statistics.depthRejectedPixelCount += rejectedPixelCount;
+			}
+
+			for (uint32 edge = 0; edge < 3; edge++)
+			{
+				edgeValues[edge] += triangle.stepX[edge] * static_cast<int32>(s_blockSize);
+			}
+		}
+	}
+}
+
+}
\ No newline at end of file
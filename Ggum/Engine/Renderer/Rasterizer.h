@@ -0,0 +1,142 @@
+#pragma once
+
+#include "Base.hpp"
+
+#include "System/gg_system.h"
+
+namespace GG {
+
+// Screen space position in pixels, pixel (x, y) covers [x, x + 1) x [y, y + 1) and is sampled at its center.
+// z is the depth in [0, 1], only used when a depth buffer is bound.
+struct RasterVertex
+{
+	float x;
+	float y;
+	float z = 0.0f;
+};
+
+// Snapped triangle with its edge functions, see Rasterizer::SetupTriangle().
+// e(x, y) = origin + stepX * x + stepY * y at pixel centers, a pixel is inside if all three are >= 0.
+struct RasterTriangle
+{
+	int64 origin[3];
+	int32 stepX[3];
+	int32 stepY[3];
+	// Inclusive pixel bounds, already clamped to the target.
+	int32 minX;
+	int32 minY;
+	int32 maxX;
+	int32 maxY;
+	uint32 color;
+	// Depth plane, depth(x, y) = depthOrigin + depthStepX * x + depthStepY * y at pixel centers.
+	double depthOrigin;
+	float depthStepX;
+	float depthStepY;
+	// Smallest vertex depth, clamps the plane when a whole block is tested.
+	float minDepth;
+};
+
+struct RasterStatistics
+{
+	uint64 triangleCount = 0;
+	// Degenerate, off screen or outside of the guard band.
+	uint64 culledTriangleCount = 0;
+	// Blocks completely inside the triangle, filled without per pixel tests.
+	uint64 fullBlockCount = 0;
+	uint64 partialBlockCount = 0;
+	uint64 pixelCount = 0;
+	// Blocks rejected against the coarse Z of the depth buffer, and covered pixels failing the per pixel depth test.
+	uint64 depthRejectedBlockCount = 0;
+	uint64 depthRejectedPixelCount = 0;
+	// Blocks tested per sample, see MultisampleBuffer. They are counted as full or partial blocks as well.
+	uint64 multisampleBlockCount = 0;
+};
+
+// Pixel positions of the runs of a block and of the pixels inside a run relative to the block's first pixel,
+// see TextureBuffer::GetBlockForWrite().
+struct RasterBlockPattern
+{
+	int32 runX[TextureBuffer::s_blockSize];
+	int32 runY[TextureBuffer::s_blockSize];
+	int32 laneX[TextureBuffer::s_blockSize];
+	int32 laneY[TextureBuffer::s_blockSize];
+};
+
+// A block of a shaded triangle after the coverage and depth tests, see Rasterizer::DrawShadedTriangle().
+struct ShadeBlock
+{
+	uint32* pixels;
+	uint32 runPitch;
+	// First pixel of the block.
+	int32 x;
+	int32 y;
+	// Pixels to write, bit i of run r is the pixel at lane i of run r of the block pattern.
+	uint8 runMasks[TextureBuffer::s_blockSize];
+};
+
+// Colors the pixels of one block, state is whatever the shader set up for the triangle.
+using ShadeBlockFunc = void(*)(const void* state, const ShadeBlock& block);
+
+class Rasterizer;
+
+// Type erased indexed triangle list of a pixel shader, see PixelShader.hpp.
+// The callbacks run once per triangle for the setup and once per triangle and bin for drawing, never per pixel.
+struct ShadedBatch
+{
+	const void* shader;
+	const void* vertices;
+	const uint32* indices;
+	uint32 triangleCount;
+	bool (*setupTriangle)(const ShadedBatch& batch, uint32 triangleIndex, Rasterizer& rasterizer, uint32 width, uint32 height, RasterTriangle& outTriangle);
+	void (*drawTriangle)(const ShadedBatch& batch, uint32 triangleIndex, Rasterizer& rasterizer, TextureBuffer& target, const RasterTriangle& triangle, const TextureRegion& scissor,
+		DepthBuffer* depthBuffer, MultisampleBuffer* multisampleBuffer);
+};
+
+// Half-space triangle rasterizer writing straight into a TextureBuffer.
+// Vertices are snapped to 1/16 pixel and the edge functions are evaluated exactly in fixed point with the top-left fill rule,
+// so triangles sharing an edge never overlap or leave gaps.
+// The bounding box is walked in s_blockSize blocks: blocks outside of an edge are rejected and blocks inside of all edges are filled,
+// only the remaining blocks are tested per pixel, 8 pixels at a time with AVX2 or 4 with SSE2.
+// With a depth buffer every block is tested against its coarse Z first, then pixels pass if they are closer than the stored depth
+// (less test with depth writes). The test runs before any color is written.
+// With a multisample buffer blocks are classified by the sample positions of their pixels. Blocks fully inside keep the path above,
+// blocks cut by an edge, on the border or holding split pixels test the coverage (and depth of split pixels) per sample,
+// shade their covered pixels once at the center and split pixels with only some samples written, see MultisampleBuffer.
+class Rasterizer
+{
+public:
+	static constexpr uint32			s_subPixelBits = 4;
+	// Vertices have to stay within this many pixels of the origin, larger triangles have to be clipped first.
+	static constexpr float			s_guardBand = 8192.0f;
+
+	Rasterizer() = default;
+	~Rasterizer() = default;
+
+	// Both windings are drawn, color is a packed RGBA8 word (see PackColor).
+	// depthBuffer and multisampleBuffer are optional and have to match the target's size and layout.
+	void DrawTriangle(TextureBuffer& target, const RasterVertex& v0, const RasterVertex& v1, const RasterVertex& v2, uint32 color, DepthBuffer* depthBuffer = nullptr,
+		MultisampleBuffer* multisampleBuffer = nullptr);
+
+	// The two halves of DrawTriangle() for binning: setup once, then draw the triangle into every bin it touches.
+	// Returns false if the triangle is culled against a width x height target.
+	bool SetupTriangle(const RasterVertex& v0, const RasterVertex& v1, const RasterVertex& v2, uint32 color, uint32 width, uint32 height, RasterTriangle& outTriangle);
+	// Only pixels inside of scissor are written. It has to start on a block and end on a block or the border of the target.
+	void DrawTriangle(TextureBuffer& target, const RasterTriangle& triangle, const TextureRegion& scissor, DepthBuffer* depthBuffer = nullptr, MultisampleBuffer* multisampleBuffer = nullptr);
+	// Same traversal and depth test, but the covered pixels of every block are colored by shadeBlock instead of triangle.color.
+	void DrawShadedTriangle(TextureBuffer& target, const RasterTriangle& triangle, const TextureRegion& scissor, DepthBuffer* depthBuffer, MultisampleBuffer* multisampleBuffer,
+		ShadeBlockFunc shadeBlock, const void* shadeState);
+
+	static const RasterBlockPattern& GetBlockPattern(eTextureLayout layout);
+
+	inline const RasterStatistics& GetStatistics() const { return _statistics; }
+	inline void ResetStatistics() { _statistics = RasterStatistics{}; }
+
+private:
+	// Without shadeBlock the blocks are filled with triangle.color.
+	void drawBlocks(TextureBuffer& target, const RasterTriangle& triangle, const TextureRegion& scissor, DepthBuffer* depthBuffer, MultisampleBuffer* multisampleBuffer,
+		ShadeBlockFunc shadeBlock, const void* shadeState);
+
+	RasterStatistics				_statistics;
+};
+
+}
\ No newline at end of file
@@ -0,0 +1,416 @@
+#include "EnginePch.h"
+#include "RenderGraph.h"
+
+#include "Renderer/RenderPass.hpp"
+
+namespace GG {
+
+static bool is_overlapping(const TextureRegion& lhs, const TextureRegion& rhs)
+{
+	return lhs.x < rhs.x + rhs.width && rhs.x < lhs.x + lhs.width && lhs.y < rhs.y + rhs.height && rhs.y < lhs.y + lhs.height;
+}
+
+RenderResource RenderGraphBuilder::CreateTexture(const std::string& name, const RenderTextureDesc& desc)
+{
+	GG_ASSERT(FindTexture(name) == RenderGraph::s_invalidResource, "Render graph texture is already created!");
+
+	const RenderResource resource = RenderGraph::s_firstTexture + static_cast<uint32>(_graph._textures.size());
+	_graph._textures.push_back(RenderGraph::TransientTexture{ name, desc, _passIndex, _passIndex, 0 });
+	// The creating pass produces the texture.
+	Write(resource);
+
+	return resource;
+}
+
+RenderResource RenderGraphBuilder::FindTexture(const std::string& name) const
+{
+	for (size_t i = 0; i < _graph._textures.size(); i++)
+	{
+		if (_graph._textures[i].name == name)
+		{
+			return RenderGraph::s_firstTexture + static_cast<uint32>(i);
+		}
+	}
+
+	return RenderGraph::s_invalidResource;
+}
+
+void RenderGraphBuilder::Read(RenderResource resource)
+{
+	_graph.addAccess(_passIndex, RenderGraph::ResourceAccess{ resource, false, false, TextureRegion{} });
+}
+
+void RenderGraphBuilder::Write(RenderResource resource)
+{
+	_graph.addAccess(_passIndex, RenderGraph::ResourceAccess{ resource, true, false, TextureRegion{} });
+}
+
+void RenderGraphBuilder::WriteBackBuffer(const TextureRegion& region)
+{
+	_graph.addAccess(_passIndex, RenderGraph::ResourceAccess{ RenderGraph::s_backBuffer, true, true, region });
+}
+
+void RenderGraphBuilder::UseRenderer()
+{
+	_graph._passes[_passIndex].isRendererPass = true;
+	Write(RenderGraph::s_backBuffer);
+	Write(RenderGraph::s_depthBuffer);
+}
+
+TextureBuffer& RenderGraphContext::GetTexture(RenderResource resource) const
+{
+	GG_ASSERT(resource >= RenderGraph::s_firstTexture && resource - RenderGraph::s_firstTexture < _graph._textures.size(), "Not a render graph texture!");
+
+	const RenderGraph::TransientTexture& texture = _graph._textures[resource - RenderGraph::s_firstTexture];
+	return *_graph._physicalTextures[texture.physicalIndex].buffer;
+}
+
+TextureBuffer& RenderGraphContext::GetBackBuffer() const
+{
+	GG_ASSERT(_graph._backBuffer != nullptr, "The pass didn't declare the back buffer!");
+
+	return *_graph._backBuffer;
+}
+
+float RenderGraphContext::GetAlpha() const
+{
+	return _graph._alpha;
+}
+
+void RenderGraph::Build(const std::vector<RenderPass*>& passes, uint32 width, uint32 height)
+{
+	GG_PROFILE_SCOPE("RenderGraph::Build");
+
+	const uint32 passCount = static_cast<uint32>(passes.size());
+	_width = width;
+	_height = height;
+	_textures.clear();
+	// Nodes are reused so their vectors keep their capacity from frame to frame.
+	_passes.resize(passCount);
+	for (uint32 i = 0; i < passCount; i++)
+	{
+		PassNode& node = _passes[i];
+		node.pass = passes[i];
+		node.accesses.clear();
+		node.successors.clear();
+		node.firstUses.clear();
+		node.dependencyCount = 0;
+		node.isRendererPass = false;
+		node.isBackBufferPass = false;
+		node.isFlushNeeded = false;
+	}
+
+	for (uint32 i = 0; i < passCount; i++)
+	{
+		RenderGraphBuilder builder(*this, i);
+		passes[i]->OnSetup(builder);
+
+		PassNode& node = _passes[i];
+		for (const auto& access : node.accesses)
+		{
+			node.isBackBufferPass |= !node.isRendererPass && access.resource < s_firstTexture;
+		}
+	}
+
+	_dependencyMatrix.assign(static_cast<size_t>(passCount) * passCount, 0);
+	_dependencyCount = 0;
+	for (uint32 later = 0; later < passCount; later++)
+	{
+		for (uint32 earlier = 0; earlier < later; earlier++)
+		{
+			if (isConflicting(_passes[earlier], _passes[later]))
+			{
+				addDependency(earlier, later);
+			}
+		}
+	}
+
+	assignPhysicalTextures();
+
+	for (auto& node : _passes)
+	{
+		for (uint32 successor : node.successors)
+		{
+			node.isFlushNeeded |= node.isRendererPass && _passes[successor].isBackBufferPass;
+		}
+	}
+}
+
+void RenderGraph::Execute(IDrawable& renderer, JobSystem* jobSystem, float alpha)
+{
+	const uint32 passCount = GetPassCount();
+	if (passCount == 0)
+	{
+		return;
+	}
+
+	_renderer = &renderer;
+	_alpha = alpha;
+	_backBuffer = nullptr;
+	for (const auto& node : _passes)
+	{
+		if (node.isBackBufferPass)
+		{
+			_backBuffer = &renderer.AcquireBackBuffer();
+			break;
+		}
+	}
+
+	const bool isParallel = jobSystem && jobSystem->IsWorkerThread() && jobSystem->GetThreadCount() > 1 && GetAsyncPassCount() > 0;
+	if (!isParallel)
+	{
+		for (uint32 i = 0; i < passCount; i++)
+		{
+			runPass(i);
+			if (_passes[i].isFlushNeeded)
+			{
+				renderer.AcquireBackBuffer();
+			}
+		}
+		return;
+	}
+
+	if (_remainingDependencyCapacity < passCount)
+	{
+		_remainingDependencies = std::make_unique<std::atomic<uint32>[]>(passCount);
+		_remainingDependencyCapacity = passCount;
+	}
+	for (uint32 i = 0; i < passCount; i++)
+	{
+		_remainingDependencies[i].store(_passes[i].dependencyCount, std::memory_order_relaxed);
+	}
+	_finishedPassCount.store(0, std::memory_order_relaxed);
+	_readyRendererPasses.clear();
+	_jobSystem = jobSystem;
+	_rootJob = jobSystem->CreateJob([]() {});
+
+	for (uint32 i = 0; i < passCount; i++)
+	{
+		if (_passes[i].dependencyCount == 0)
+		{
+			launchPass(i);
+		}
+	}
+
+	// The render thread runs the renderer passes and helps with the other ones in between.
+	while (_finishedPassCount.load(std::memory_order_acquire) < passCount)
+	{
+		uint32 passIndex = s_invalidResource;
+		{
+			std::lock_guard<std::mutex> lock(_readyMutex);
+			if (!_readyRendererPasses.empty())
+			{
+				passIndex = _readyRendererPasses.back();
+				_readyRendererPasses.pop_back();
+			}
+		}
+
+		if (passIndex != s_invalidResource)
+		{
+			runPass(passIndex);
+			if (_passes[passIndex].isFlushNeeded)
+			{
+				renderer.AcquireBackBuffer();
+			}
+			completePass(passIndex);
+		}
+		else if (!jobSystem->RunOneJob())
+		{
+			std::this_thread::yield();
+		}
+	}
+
+	// Every pass is done, this only waits for the last jobs to return.
+	jobSystem->Run(_rootJob);
+	jobSystem->Wait(_rootJob);
+	_rootJob = nullptr;
+	_jobSystem = nullptr;
+}
+
+uint32 RenderGraph::GetAsyncPassCount() const
+{
+	uint32 count = 0;
+	for (const auto& node : _passes)
+	{
+		count += node.isRendererPass ? 0 : 1;
+	}
+
+	return count;
+}
+
+void RenderGraph::addAccess(uint32 passIndex, const ResourceAccess& access)
+{
+	GG_ASSERT(access.resource < s_firstTexture + _textures.size(), "Unknown render graph resource!");
+
+	_passes[passIndex].accesses.push_back(access);
+	if (access.resource >= s_firstTexture)
+	{
+		TransientTexture& texture = _textures[access.resource - s_firstTexture];
+		texture.lastPass = std::max(texture.lastPass, passIndex);
+	}
+}
+
+void RenderGraph::addDependency(uint32 from, uint32 to)
+{
+	uint8& isAdded = _dependencyMatrix[static_cast<size_t>(from) * _passes.size() + to];
+	if (isAdded)
+	{
+		return;
+	}
+
+	isAdded = 1;
+	_passes[from].successors.push_back(to);
+	_passes[to].dependencyCount++;
+	_dependencyCount++;
+}
+
+bool RenderGraph::isConflicting(const PassNode& earlier, const PassNode& later) const
+{
+	for (const auto& lhs : earlier.accesses)
+	{
+		for (const auto& rhs : later.accesses)
+		{
+			if (lhs.resource != rhs.resource || (!lhs.isWrite && !rhs.isWrite))
+			{
+				continue;
+			}
+			if (!lhs.isRegion || !rhs.isRegion || is_overlapping(lhs.region, rhs.region))
+			{
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
+
+void RenderGraph::assignPhysicalTextures()
+{
+	for (auto& physical : _physicalTextures)
+	{
+		physical.lastTexture = s_invalidResource;
+	}
+
+	// Textures are created in pass order, so they are already sorted by their first pass.
+	for (uint32 i = 0; i < static_cast<uint32>(_textures.size()); i++)
+	{
+		TransientTexture& texture = _textures[i];
+		const uint32 width = texture.desc.width != 0 ? texture.desc.width : _width;
+		const uint32 height = texture.desc.height != 0 ? texture.desc.height : _height;
+
+		uint32 physicalIndex = s_invalidResource;
+		for (uint32 p = 0; p < static_cast<uint32>(_physicalTextures.size()); p++)
+		{
+			const PhysicalTexture& physical = _physicalTextures[p];
+			if (physical.buffer->GetWidth() != width || physical.buffer->GetHeight() != height || physical.buffer->GetLayout() != texture.desc.layout)
+			{
+				continue;
+			}
+			if (physical.lastTexture == s_invalidResource || (_isTextureAliasingEnabled && _textures[physical.lastTexture].lastPass < texture.firstPass))
+			{
+				physicalIndex = p;
+				break;
+			}
+		}
+
+		if (physicalIndex == s_invalidResource)
+		{
+			physicalIndex = static_cast<uint32>(_physicalTextures.size());
+			_physicalTextures.push_back(PhysicalTexture{ std::make_unique<TextureBuffer>(), s_invalidResource });
+			_physicalTextures.back().buffer->Create(width, height, texture.desc.layout);
+		}
+		else if (_physicalTextures[physicalIndex].lastTexture != s_invalidResource)
+		{
+			// The storage is reused, every pass using the texture before has to be done before the new one is touched.
+			const RenderResource previous = s_firstTexture + _physicalTextures[physicalIndex].lastTexture;
+			const RenderResource current = s_firstTexture + i;
+			const TransientTexture& previousTexture = _textures[previous - s_firstTexture];
+			for (uint32 from = previousTexture.firstPass; from <= previousTexture.lastPass; from++)
+			{
+				for (const auto& fromAccess : _passes[from].accesses)
+				{
+					if (fromAccess.resource != previous)
+					{
+						continue;
+					}
+					for (uint32 to = texture.firstPass; to <= texture.lastPass; to++)
+					{
+						for (const auto& toAccess : _passes[to].accesses)
+						{
+							if (toAccess.resource == current)
+							{
+								addDependency(from, to);
+								break;
+							}
+						}
+					}
+					break;
+				}
+			}
+		}
+
+		_physicalTextures[physicalIndex].lastTexture = i;
+		texture.physicalIndex = physicalIndex;
+		_passes[texture.firstPass].firstUses.push_back(s_firstTexture + i);
+	}
+
+	// Storage this frame didn't need goes, e.g. after a resize.
+	uint32 keptCount = 0;
+	std::vector<uint32> remap(_physicalTextures.size(), s_invalidResource);
+	for (uint32 p = 0; p < static_cast<uint32>(_physicalTextures.size()); p++)
+	{
+		if (_physicalTextures[p].lastTexture != s_invalidResource)
+		{
+			remap[p] = keptCount;
+			_physicalTextures[keptCount++] = std::move(_physicalTextures[p]);
+		}
+	}
+	_physicalTextures.resize(keptCount);
+	for (auto& texture : _textures)
+	{
+		texture.physicalIndex = remap[texture.physicalIndex];
+	}
+}
+
+void RenderGraph::runPass(uint32 passIndex)
+{
+	const PassNode& node = _passes[passIndex];
+	for (RenderResource resource : node.firstUses)
+	{
+		const TransientTexture& texture = _textures[resource - s_firstTexture];
+		_physicalTextures[texture.physicalIndex].buffer->Clear(texture.desc.clearColor);
+	}
+
+	GG_PROFILE_SCOPE_CATEGORY(node.pass->GetProfileName(), "OnExecute");
+	RenderGraphContext context(*this);
+	node.pass->OnExecute(context);
+}
+
+void RenderGraph::completePass(uint32 passIndex)
+{
+	for (uint32 successor : _passes[passIndex].successors)
+	{
+		if (_remainingDependencies[successor].fetch_sub(1, std::memory_order_acq_rel) == 1)
+		{
+			launchPass(successor);
+		}
+	}
+	_finishedPassCount.fetch_add(1, std::memory_order_release);
+}
+
+void RenderGraph::launchPass(uint32 passIndex)
+{
+	if (_passes[passIndex].isRendererPass)
+	{
+		std::lock_guard<std::mutex> lock(_readyMutex);
+		_readyRendererPasses.push_back(passIndex);
+		return;
+	}
+
+	_jobSystem->Run(_jobSystem->CreateJob([this, passIndex]() {
+		runPass(passIndex);
+		completePass(passIndex);
+	}, _rootJob));
+}
+
+}
\ No newline at end of file
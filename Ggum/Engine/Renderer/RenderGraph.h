@@ -0,0 +1,199 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "Base.hpp"
+
+#include "System/gg_system.h"
+
+namespace GG {
+
+class IDrawable;
+class RenderGraph;
+class RenderPass;
+
+// Resource of one frame's render graph.
+using RenderResource = uint32;
+
+// Transient texture of a frame, only alive between the first and the last pass using it.
+struct RenderTextureDesc
+{
+	// 0 follows the framebuffer size.
+	uint32 width = 0;
+	uint32 height = 0;
+	eTextureLayout layout = eTextureLayout::Tiled;
+	// The texture is cleared to this color before the first pass using it runs, O(tiles).
+	uint32 clearColor = 0;
+};
+
+// Handed to RenderPass::OnSetup() to declare what the pass touches this frame.
+class RenderGraphBuilder
+{
+public:
+	RenderResource CreateTexture(const std::string& name, const RenderTextureDesc& desc = RenderTextureDesc());
+	// Texture an earlier pass created this frame, RenderGraph::s_invalidResource if there is none.
+	RenderResource FindTexture(const std::string& name) const;
+
+	void Read(RenderResource resource);
+	void Write(RenderResource resource);
+	// Writes only region of the back buffer through RenderGraphContext::GetBackBuffer(), passes writing disjoint regions may run concurrently.
+	void WriteBackBuffer(const TextureRegion& region);
+	// The pass draws through the IDrawable, which isn't thread safe: it runs on the render thread in pass order,
+	// after every earlier pass which touches the back or the depth buffer.
+	void UseRenderer();
+
+private:
+	friend RenderGraph;
+
+	RenderGraphBuilder(RenderGraph& graph, uint32 passIndex)
+		: _graph{ graph }
+		, _passIndex{ passIndex }
+	{}
+
+	RenderGraph& _graph;
+	uint32 _passIndex;
+};
+
+// Handed to RenderPass::OnExecute(), resolves the resources the pass declared.
+class RenderGraphContext
+{
+public:
+	TextureBuffer& GetTexture(RenderResource resource) const;
+	// The frame's back buffer with the triangles of earlier passes drawn, for passes which declared it without UseRenderer().
+	TextureBuffer& GetBackBuffer() const;
+	// Interpolation between the previous and the latest simulated state, see FrameTiming::alpha.
+	float GetAlpha() const;
+
+private:
+	friend RenderGraph;
+
+	explicit RenderGraphContext(const RenderGraph& graph)
+		: _graph{ graph }
+	{}
+
+	const RenderGraph& _graph;
+};
+
+// Builds the passes of a frame into a DAG from the resources they declare and runs it.
+// A pass depends on every earlier pass (in RenderPassOrder) which shares a resource with it where one of the two writes,
+// back buffer regions only if they overlap. Passes using the renderer run on the render thread in order,
+// every other pass runs as a job as soon as the passes it depends on are done.
+// Transient textures with the same size and layout share storage when their lifetimes don't overlap,
+// the later users then also depend on the earlier ones. The storage is kept across frames until a frame doesn't need it.
+class RenderGraph
+{
+public:
+	static constexpr RenderResource	s_backBuffer = 0;
+	static constexpr RenderResource	s_depthBuffer = 1;
+	static constexpr RenderResource	s_invalidResource = ~0u;
+
+	RenderGraph() = default;
+	~RenderGraph() = default;
+
+	RenderGraph(const RenderGraph&) = delete;
+	RenderGraph& operator=(const RenderGraph&) = delete;
+
+	// Calls OnSetup() of the passes and compiles the graph for a width x height framebuffer.
+	// passes are in RenderPassOrder, conflicting passes keep that order.
+	void Build(const std::vector<RenderPass*>& passes, uint32 width, uint32 height);
+	// Runs the passes of the last Build(). Passes run concurrently on jobSystem if it's started and the calling thread is one of its workers,
+	// otherwise one after another in pass order.
+	void Execute(IDrawable& renderer, JobSystem* jobSystem, float alpha = 1.0f);
+
+	// Shared storage orders the passes of the sharing textures, turning it off trades memory for parallelism. On by default.
+	inline void SetTextureAliasingEnabled(bool isTextureAliasingEnabled) { _isTextureAliasingEnabled = isTextureAliasingEnabled; }
+	inline bool IsTextureAliasingEnabled() const { return _isTextureAliasingEnabled; }
+
+	inline uint32 GetPassCount() const { return static_cast<uint32>(_passes.size()); }
+	// Passes which don't use the renderer.
+	uint32 GetAsyncPassCount() const;
+	inline uint32 GetDependencyCount() const { return _dependencyCount; }
+	inline uint32 GetTransientTextureCount() const { return static_cast<uint32>(_textures.size()); }
+	inline uint32 GetPhysicalTextureCount() const { return static_cast<uint32>(_physicalTextures.size()); }
+
+private:
+	friend RenderGraphBuilder;
+	friend RenderGraphContext;
+
+	// Handle of the first transient texture, the ones before are the built-in resources.
+	static constexpr RenderResource	s_firstTexture = 2;
+
+	struct ResourceAccess
+	{
+		RenderResource resource;
+		bool isWrite;
+		// Back buffer writes of a region, the whole resource otherwise.
+		bool isRegion;
+		TextureRegion region;
+	};
+
+	struct PassNode
+	{
+		RenderPass* pass;
+		std::vector<ResourceAccess> accesses;
+		std::vector<uint32> successors;
+		// Transient textures this pass uses first, cleared before it runs.
+		std::vector<RenderResource> firstUses;
+		uint32 dependencyCount;
+		bool isRendererPass;
+		// Reads or writes the back or the depth buffer without the renderer.
+		bool isBackBufferPass;
+		// A successor touches the back buffer without the renderer, so the queued triangles are drawn right after this pass.
+		bool isFlushNeeded;
+	};
+
+	struct TransientTexture
+	{
+		std::string name;
+		RenderTextureDesc desc;
+		uint32 firstPass;
+		uint32 lastPass;
+		uint32 physicalIndex;
+	};
+
+	struct PhysicalTexture
+	{
+		std::unique_ptr<TextureBuffer> buffer;
+		// Transient texture using it last in the current frame, s_invalidResource if none.
+		uint32 lastTexture;
+	};
+
+	void addAccess(uint32 passIndex, const ResourceAccess& access);
+	void addDependency(uint32 from, uint32 to);
+	void assignPhysicalTextures();
+	bool isConflicting(const PassNode& earlier, const PassNode& later) const;
+
+	void runPass(uint32 passIndex);
+	// Called once a pass is done, launches the successors whose dependencies are done.
+	void completePass(uint32 passIndex);
+	void launchPass(uint32 passIndex);
+
+	std::vector<PassNode>			_passes;
+	std::vector<TransientTexture>	_textures;
+	std::vector<PhysicalTexture>	_physicalTextures;
+	// Row-major pass x pass, set if an edge exists so duplicates aren't added.
+	std::vector<uint8>				_dependencyMatrix;
+	uint32							_dependencyCount = 0;
+	uint32							_width = 0;
+	uint32							_height = 0;
+	bool							_isTextureAliasingEnabled = true;
+
+	// State of the current Execute().
+	IDrawable*						_renderer = nullptr;
+	JobSystem*						_jobSystem = nullptr;
+	TextureBuffer*					_backBuffer = nullptr;
+	float							_alpha = 1.0f;
+	Job*							_rootJob = nullptr;
+	std::unique_ptr<std::atomic<uint32>[]>	_remainingDependencies;
+	uint32							_remainingDependencyCapacity = 0;
+	std::atomic<uint32>				_finishedPassCount{ 0 };
+	// Renderer passes whose dependencies are done, run by the render thread.
+	std::mutex						_readyMutex;
+	std::vector<uint32>				_readyRendererPasses;
+};
+
+}
\ No newline at end of file
@@ -3,7 +3,9 @@
 #include <string>
 
 #include "Base.hpp"
-#include "Renderer/Renderer.h"
+#include "Renderer/Drawable.hpp"
+#include "Renderer/RenderGraph.h"
+#include "Renderer/RenderPassOrder.hpp"
 
 #include "System/gg_system.h"
 
@@ -11,24 +13,6 @@ namespace GG {
 
 class RenderPath;
 
-enum RenderPassOrder
-{
-	BeforeRendering = 0,
-
-	Skybox = 200,
-
-	Opaque = 250,
-
-	Transparent = 300,
-
-	BeforePostProcess = 500,
-
-	AfterPostProcess = 850,
-
-	AfterRendereing = 990
-};
-
-
 class RenderPass
 {
 	friend RenderPath;
@@ -37,7 +21,9 @@ public:
 	RenderPass(const std::string& name, RenderPassOrder renderingOrder)
 		: _name{ name }
 		, _renderer{ nullptr }
+		, _jobSystem{ nullptr }
 		, _order{ renderingOrder }
+		, _profileName{ Profiler::InternName(name) }
 	{}
 
 	~RenderPass() = default;
@@ -47,21 +33,36 @@ public:
 	// Application RenderPass ŵ  ȣ˴ϴ
 	virtual void OnDetach() {}
 	// Application  Update Loop ȣ˴ϴ
+	// With ApplicationProperty::fixedUpdateRate it runs zero or more times per frame, always with the same deltaTime.
 	virtual void OnUpdate(float deltaTime) {}
+	// Pipelined Application only: called on the render thread between frames while no other callback runs.
+	// Copies what OnUpdate() wrote into the state the render callbacks read, see FrameSnapshot.
+	virtual void OnSnapshot() {}
 	// Application ̺Ʈ ߻  ȣ˴ϴ
 	virtual void OnEvent(Event& e) {}
 	// Application  Render Loop ȣ˴ϴ
-	virtual void OnRender() {}
+	// alpha interpolates between the previous and the latest update with a fixed timestep, see FrameTiming::alpha.
+	virtual void OnRender(float alpha) {}
+	// Declares the resources OnExecute() touches this frame, called before every Render Loop.
+	// The default draws through the renderer, so such passes keep running on the render thread in order.
+	virtual void OnSetup(RenderGraphBuilder& builder) { builder.UseRenderer(); }
+	// Runs the pass in the render graph, on a worker thread unless it uses the renderer.
+	virtual void OnExecute(RenderGraphContext& context) { OnRender(context.GetAlpha()); }
 	// Application GUI Render Loop ȣ˴ϴ
 	virtual void OnGUI() {}
 
 	inline RenderPassOrder GetOrder() { return _order; }
 	inline std::string GetName() { return _name; }
+	// The name as the profiler zones of the pass show it.
+	inline const char* GetProfileName() const { return _profileName; }
 
 protected:
-	std::shared_ptr<Renderer> _renderer;
+	std::shared_ptr<IDrawable> _renderer;
+	// Started by Application, CPU heavy work in OnUpdate()/OnRender() goes through ParallelFor() or jobs.
+	std::shared_ptr<JobSystem> _jobSystem;
 	std::string _name;
 	RenderPassOrder _order;
+	const char* _profileName;
 };
 
 
@@ -0,0 +1,22 @@
+#pragma once
+
+namespace GG {
+
+enum RenderPassOrder
+{
+	BeforeRendering = 0,
+
+	Skybox = 200,
+
+	Opaque = 250,
+
+	Transparent = 300,
+
+	BeforePostProcess = 500,
+
+	AfterPostProcess = 850,
+
+	AfterRendereing = 990
+};
+
+}
\ No newline at end of file
@@ -16,11 +16,16 @@ RenderPath::~RenderPath()
 	_renderPasses.clear();
 }
 
-void RenderPath::SetRenderer(std::shared_ptr<Renderer> renderer)
+void RenderPath::SetRenderer(std::shared_ptr<IDrawable> renderer)
 {
 	_renderer = renderer;
 }
 
+void RenderPath::SetJobSystem(std::shared_ptr<JobSystem> jobSystem)
+{
+	_jobSystem = jobSystem;
+}
+
 void RenderPath::Clear()
 {
 	_renderPasses.clear();
@@ -29,14 +34,27 @@ void RenderPath::Clear()
 void RenderPath::AddRenderPass(std::shared_ptr<RenderPass> renderPass)
 {
 	renderPass->_renderer = _renderer;
+	renderPass->_jobSystem = _jobSystem;
 	_renderPasses.push_back(renderPass);
 
-	std::stable_sort(_renderPasses.begin(), _renderPasses.end(), [](const std::shared_ptr<RenderPass>& lPass, const std::shared_ptr<RenderPass>& rPass)->bool {
+	// list::sort is stable, passes of the same order keep the order they were added in.
+	_renderPasses.sort([](const std::shared_ptr<RenderPass>& lPass, const std::shared_ptr<RenderPass>& rPass)->bool {
 		return lPass->GetOrder() < rPass->GetOrder();
 
 		});
 }
 
+void RenderPath::Render(float alpha)
+{
+	_graphPasses.clear();
+	for (auto& renderPass : _renderPasses)
+	{
+		_graphPasses.push_back(renderPass.get());
+	}
+
+	_renderGraph.Build(_graphPasses, _renderer->GetFramebufferWidth(), _renderer->GetFramebufferHeight());
+	_renderGraph.Execute(*_renderer, _jobSystem.get(), alpha);
+}
 
 void RenderPath::DeleteRenderPass(std::shared_ptr<RenderPass> renderPass)
 {
@@ -1,6 +1,10 @@
 #pragma once
 
+#include <list>
+#include <memory>
+
 #include "Base.hpp"
+#include "Renderer/RenderGraph.h"
 #include "Renderer/RenderPass.hpp"
 
 namespace GG {
@@ -12,11 +16,16 @@ public:
 	RenderPath();
 	~RenderPath();
 
-	void SetRenderer(std::shared_ptr<Renderer> renderer);
+	void SetRenderer(std::shared_ptr<IDrawable> renderer);
+	void SetJobSystem(std::shared_ptr<JobSystem> jobSystem);
 	void Clear();
 
 	void AddRenderPass(std::shared_ptr<RenderPass> renderPass);
 	void DeleteRenderPass(std::shared_ptr<RenderPass> renderPass);
+	// Builds the render graph of the passes and runs it on the renderer and the job system, alpha goes to the passes.
+	void Render(float alpha = 1.0f);
+
+	inline RenderGraph& GetRenderGraph() { return _renderGraph; }
 
 	// RenderPass ȸ  Iterator 
 	[[nodiscard]] inline std::list<std::shared_ptr<RenderPass>>::iterator begin() { return _renderPasses.begin(); }
@@ -26,7 +35,11 @@ private:
 	std::list<std::shared_ptr<RenderPass>> _renderPasses;
 	std::list<std::shared_ptr<RenderPass>>::iterator _lastPassIterator;
 
-	std::shared_ptr<Renderer> _renderer;
+	std::shared_ptr<IDrawable> _renderer;
+	std::shared_ptr<JobSystem> _jobSystem;
+
+	RenderGraph _renderGraph;
+	std::vector<RenderPass*> _graphPasses;
 };
 
 }
\ No newline at end of file
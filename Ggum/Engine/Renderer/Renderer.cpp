@@ -1,23 +1,33 @@
 #include "EnginePch.h"
 #include "Renderer.h"
 
+#ifdef GG_WINDOWED_BACKEND
+
 namespace GG {
 
 
 
-void GG::Renderer::Init(HWND hWnd, std::shared_ptr<GraphicsAPI> api)
+void Renderer::Init(std::shared_ptr<GraphicsAPI> api)
 {
 	_api = api;
+
+	_windowWidth = _api->GetFramebufferWidth();
+	_windowHeight = _api->GetFramebufferHeight();
+	// Split pixels left at Submit() are resolved by the upload.
+	_api->SetMultisampleBuffer(&_multisampleBuffer);
 }
 
 void Renderer::Prepare()
 {
-	_api->WaitDeviceIdle();
+	GG_PROFILE_SCOPE("Renderer::Prepare");
 	_api->Begin();
+	beginFrame();
 }
 
 void Renderer::Submit()
 {
+	GG_PROFILE_SCOPE("Renderer::Submit");
+	endFrame();
 	_api->Draw();
 }
 
@@ -49,6 +59,7 @@ void Renderer::SubmitGUI()
 
 void Renderer::Present()
 {
+	GG_PROFILE_SCOPE("Renderer::Present");
 	_api->End();
 }
 
@@ -66,14 +77,63 @@ void Renderer::OnResize(uint32 width, uint32 height)
 	else
 	{
 		_api->SetMinimized(false);
+
+		_windowWidth = width;
+		_windowHeight = height;
+		applyResolution();
 	}
 }
 
-void Renderer::SetPixelForDebug(uint32 row, uint32 col, uint8* color)
+const UploadStatistics& Renderer::GetUploadStatistics() const
+{
+	return _api->GetUploadStatistics();
+}
+
+void Renderer::SetFramesInFlight(uint32 count)
+{
+	_api->SetFramesInFlight(count);
+}
+
+uint32 Renderer::GetFramesInFlight() const
+{
+	return _api->GetFramesInFlight();
+}
+
+void Renderer::SetClearColor(uint32 color)
+{
+	_api->SetClearColor(color);
+}
+
+void Renderer::SetClearEnabled(bool isClearEnabled)
+{
+	_api->SetClearEnabled(isClearEnabled);
+}
+
+uint32 Renderer::GetFramebufferWidth() const
+{
+	return _api->GetFramebufferWidth();
+}
+
+uint32 Renderer::GetFramebufferHeight() const
+{
+	return _api->GetFramebufferHeight();
+}
+
+TextureBuffer& Renderer::acquireBackBuffer()
 {
-#ifdef _DEBUG
-	_api->SetPixel(row, col, color);
-#endif
+	return _api->AcquireBackBuffer();
+}
+
+void Renderer::releaseBackBuffer()
+{
+	_api->ReleaseBackBuffer();
+}
+
+void Renderer::setFramebufferSize(uint32 width, uint32 height)
+{
+	_api->SetFramebufferSize(width, height);
+}
+
 }
 
-}
\ No newline at end of file
+#endif
\ No newline at end of file
@@ -1,13 +1,19 @@
 #pragma once
 
-#include "Renderer/Drawable.hpp"
+#include "Base.hpp"
+
+#ifdef GG_WINDOWED_BACKEND
+
+#include "Renderer/SoftwareRenderer.h"
 
 namespace GG {
 
-class Renderer : public IDrawable
+// Window backend, draws the CPU framebuffer through GraphicsAPI.
+class Renderer : public SoftwareRenderer
 {
 public:
-	virtual void Init(HWND hWnd, std::shared_ptr<GraphicsAPI> api) override;
+	void Init(std::shared_ptr<GraphicsAPI> api);
+
 	virtual void Prepare() override;
 	virtual void Submit() override;
 	virtual void PrepareGUI() override;
@@ -17,11 +23,27 @@ public:
 	//...
 	virtual void OnResize(uint32 width, uint32 height) override;
 
-	virtual void SetPixelForDebug(uint32 row, uint32 col, uint8* color) override;
+	virtual const UploadStatistics& GetUploadStatistics() const override;
+
+	virtual void SetFramesInFlight(uint32 count) override;
+	virtual uint32 GetFramesInFlight() const override;
+
+	virtual void SetClearColor(uint32 color) override;
+	virtual void SetClearEnabled(bool isClearEnabled) override;
+
+	virtual uint32 GetFramebufferWidth() const override;
+	virtual uint32 GetFramebufferHeight() const override;
+
+protected:
+	virtual TextureBuffer& acquireBackBuffer() override;
+	virtual void releaseBackBuffer() override;
+	virtual void setFramebufferSize(uint32 width, uint32 height) override;
 
 private:
-	//...
+	std::shared_ptr<GraphicsAPI>	_api = nullptr;
 };
 
 
-}
\ No newline at end of file
+}
+
+#endif
\ No newline at end of file
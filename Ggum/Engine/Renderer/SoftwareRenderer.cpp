@@ -0,0 +1,283 @@
+#include "EnginePch.h"
+#include "SoftwareRenderer.h"
+
+namespace GG {
+
+void SoftwareRenderer::SetPixelForDebug(uint32 row, uint32 col, uint8* color)
+{
+#ifdef _DEBUG
+	flushTriangles();
+	resolveSamples();
+	acquireBackBuffer().SetPixel(static_cast<int32>(row), static_cast<int32>(col), PackColor(color));
+#else
+	(void)row;
+	(void)col;
+	(void)color;
+#endif
+}
+
+void SoftwareRenderer::FillSpan(int32 row, int32 col, uint32 count, uint32 color)
+{
+	flushTriangles();
+	resolveSamples();
+	acquireBackBuffer().FillSpan(row, col, count, color);
+}
+
+void SoftwareRenderer::FillRect(int32 row, int32 col, uint32 width, uint32 height, uint32 color)
+{
+	flushTriangles();
+	resolveSamples();
+	acquireBackBuffer().FillRect(row, col, width, height, color);
+}
+
+void SoftwareRenderer::WriteRow(int32 row, int32 col, const uint32* src, uint32 count)
+{
+	flushTriangles();
+	resolveSamples();
+	acquireBackBuffer().WriteRow(row, col, src, count);
+}
+
+void SoftwareRenderer::BlitRect(int32 row, int32 col, uint32 width, uint32 height, const uint32* src, uint32 srcPitch)
+{
+	flushTriangles();
+	resolveSamples();
+	acquireBackBuffer().BlitRect(row, col, width, height, src, srcPitch);
+}
+
+void SoftwareRenderer::BlendSpan(int32 row, int32 col, uint32 count, uint32 color, eBlendMode mode, bool isGammaCorrect)
+{
+	flushTriangles();
+	resolveSamples();
+	acquireBackBuffer().BlendSpan(row, col, count, color, mode, isGammaCorrect);
+}
+
+void SoftwareRenderer::BlendColorRect(int32 row, int32 col, uint32 width, uint32 height, uint32 color, eBlendMode mode, bool isGammaCorrect)
+{
+	flushTriangles();
+	resolveSamples();
+	acquireBackBuffer().BlendColorRect(row, col, width, height, color, mode, isGammaCorrect);
+}
+
+void SoftwareRenderer::BlendRow(int32 row, int32 col, const uint32* src, uint32 count, eBlendMode mode, bool isGammaCorrect)
+{
+	flushTriangles();
+	resolveSamples();
+	acquireBackBuffer().BlendRow(row, col, src, count, mode, isGammaCorrect);
+}
+
+void SoftwareRenderer::BlendRect(int32 row, int32 col, uint32 width, uint32 height, const uint32* src, uint32 srcPitch, eBlendMode mode, bool isGammaCorrect)
+{
+	flushTriangles();
+	resolveSamples();
+	acquireBackBuffer().BlendRect(row, col, width, height, src, srcPitch, mode, isGammaCorrect);
+}
+
+void SoftwareRenderer::DrawTriangle(const RasterVertex& v0, const RasterVertex& v1, const RasterVertex& v2, uint32 color)
+{
+	_rasterizer.DrawTriangle(v0, v1, v2, color);
+}
+
+void SoftwareRenderer::DrawShaded(const ShadedBatch& batch)
+{
+	TextureBuffer& backBuffer = acquireBackBuffer();
+	if (!_drawQueue.IsEmpty())
+	{
+		_drawQueue.Draw(_rasterizer, backBuffer, bindDepthBuffer(backBuffer), bindMultisampleBuffer(backBuffer));
+	}
+	_rasterizer.DrawBatch(backBuffer, batch, bindDepthBuffer(backBuffer), bindMultisampleBuffer(backBuffer));
+}
+
+DrawQueue& SoftwareRenderer::GetDrawQueue()
+{
+	return _drawQueue;
+}
+
+void SoftwareRenderer::DrawLines(const LineSegment* segments, uint32 count, bool isAntialiased)
+{
+	flushTriangles();
+	resolveSamples();
+	_lineRasterizer.DrawLines(acquireBackBuffer(), segments, count, isAntialiased);
+}
+
+void SoftwareRenderer::DrawPoints(const RasterPoint* points, uint32 count, float size, bool isAntialiased)
+{
+	flushTriangles();
+	resolveSamples();
+	_lineRasterizer.DrawPoints(acquireBackBuffer(), points, count, size, isAntialiased);
+}
+
+const RasterStatistics& SoftwareRenderer::GetRasterStatistics() const
+{
+	return _rasterizer.GetStatistics();
+}
+
+void SoftwareRenderer::SetRasterThreadCount(uint32 count)
+{
+	flushTriangles();
+	_rasterizer.SetThreadCount(count);
+}
+
+uint32 SoftwareRenderer::GetRasterThreadCount() const
+{
+	return _rasterizer.GetThreadCount();
+}
+
+void SoftwareRenderer::SetJobSystem(JobSystem* jobSystem)
+{
+	flushTriangles();
+	_rasterizer.SetJobSystem(jobSystem);
+}
+
+void SoftwareRenderer::SetDepthTestEnabled(bool isDepthTestEnabled)
+{
+	flushTriangles();
+	_isDepthTestEnabled = isDepthTestEnabled;
+}
+
+bool SoftwareRenderer::IsDepthTestEnabled() const
+{
+	return _isDepthTestEnabled;
+}
+
+void SoftwareRenderer::SetSampleCount(uint32 count)
+{
+	GG_ASSERT(count == 1 || count == 2 || count == 4 || count == 8, "Sample count has to be 1, 2, 4 or 8!");
+
+	flushTriangles();
+	resolveSamples();
+	_sampleCount = count;
+}
+
+uint32 SoftwareRenderer::GetSampleCount() const
+{
+	return _sampleCount;
+}
+
+TextureBuffer& SoftwareRenderer::AcquireBackBuffer()
+{
+	flushTriangles();
+	resolveSamples();
+
+	return acquireBackBuffer();
+}
+
+void SoftwareRenderer::ReleaseBackBuffer()
+{
+	flushTriangles();
+	releaseBackBuffer();
+}
+
+void SoftwareRenderer::EnableDynamicResolution(float targetMilliseconds, float minScale)
+{
+	_dynamicResolution.SetScaleRange(minScale, 1.0f);
+	_dynamicResolution.SetTargetFrameTime(targetMilliseconds);
+	_isDynamicResolutionEnabled = true;
+
+	applyResolution();
+}
+
+void SoftwareRenderer::DisableDynamicResolution()
+{
+	_isDynamicResolutionEnabled = false;
+
+	applyResolution();
+}
+
+bool SoftwareRenderer::IsDynamicResolutionEnabled() const
+{
+	return _isDynamicResolutionEnabled;
+}
+
+float SoftwareRenderer::GetResolutionScale() const
+{
+	return _isDynamicResolutionEnabled ? _dynamicResolution.GetScale() : 1.0f;
+}
+
+void SoftwareRenderer::beginFrame()
+{
+	_rasterizer.ResetStatistics();
+	_lineRasterizer.ResetStatistics();
+	_depthBuffer.Clear();
+	_multisampleBuffer.Clear();
+
+	_renderTimer.Start();
+}
+
+void SoftwareRenderer::endFrame()
+{
+	flushTriangles();
+
+	// Present and vsync waits are left out, they don't shrink with the resolution.
+	if (_isDynamicResolutionEnabled && _dynamicResolution.Update(_renderTimer.ElapsedMills()))
+	{
+		applyResolution();
+	}
+}
+
+void SoftwareRenderer::applyResolution()
+{
+	if (_isDynamicResolutionEnabled)
+	{
+		setFramebufferSize(_dynamicResolution.ScaleSize(_windowWidth), _dynamicResolution.ScaleSize(_windowHeight));
+	}
+	else
+	{
+		setFramebufferSize(_windowWidth, _windowHeight);
+	}
+}
+
+void SoftwareRenderer::flushTriangles()
+{
+	if (!_drawQueue.IsEmpty())
+	{
+		TextureBuffer& backBuffer = acquireBackBuffer();
+		_drawQueue.Draw(_rasterizer, backBuffer, bindDepthBuffer(backBuffer), bindMultisampleBuffer(backBuffer));
+	}
+	if (_rasterizer.HasPendingTriangles())
+	{
+		TextureBuffer& backBuffer = acquireBackBuffer();
+		_rasterizer.Flush(backBuffer, bindDepthBuffer(backBuffer), bindMultisampleBuffer(backBuffer));
+	}
+}
+
+DepthBuffer* SoftwareRenderer::bindDepthBuffer(const TextureBuffer& target)
+{
+	if (!_isDepthTestEnabled)
+	{
+		return nullptr;
+	}
+
+	if (_depthBuffer.GetWidth() != target.GetWidth() || _depthBuffer.GetHeight() != target.GetHeight() || _depthBuffer.GetLayout() != target.GetLayout())
+	{
+		_depthBuffer.Create(target.GetWidth(), target.GetHeight(), target.GetLayout());
+	}
+
+	return &_depthBuffer;
+}
+
+MultisampleBuffer* SoftwareRenderer::bindMultisampleBuffer(const TextureBuffer& target)
+{
+	if (_sampleCount == 1)
+	{
+		return nullptr;
+	}
+
+	if (_multisampleBuffer.GetSampleCount() != _sampleCount || _multisampleBuffer.GetWidth() != target.GetWidth() || _multisampleBuffer.GetHeight() != target.GetHeight()
+		|| _multisampleBuffer.GetLayout() != target.GetLayout())
+	{
+		_multisampleBuffer.Create(target.GetWidth(), target.GetHeight(), target.GetLayout(), _sampleCount);
+	}
+
+	return &_multisampleBuffer;
+}
+
+void SoftwareRenderer::resolveSamples()
+{
+	if (_multisampleBuffer.GetSplitBlockCount() != 0)
+	{
+		_multisampleBuffer.Resolve(acquireBackBuffer());
+		_multisampleBuffer.Clear();
+	}
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "Renderer/Drawable.hpp"
+#include "Renderer/DynamicResolution.h"
+
+namespace GG {
+
+// Part of the CPU backends which doesn't depend on where the back buffer lives: the writes into it and the dynamic resolution.
+// A backend only acquires and releases the back buffer and applies the framebuffer size.
+class SoftwareRenderer : public IDrawable
+{
+public:
+	virtual ~SoftwareRenderer() = default;
+
+	virtual void SetPixelForDebug(uint32 row, uint32 col, uint8* color) override;
+
+	virtual void FillSpan(int32 row, int32 col, uint32 count, uint32 color) override;
+	virtual void FillRect(int32 row, int32 col, uint32 width, uint32 height, uint32 color) override;
+	virtual void WriteRow(int32 row, int32 col, const uint32* src, uint32 count) override;
+	virtual void BlitRect(int32 row, int32 col, uint32 width, uint32 height, const uint32* src, uint32 srcPitch) override;
+	virtual void BlendSpan(int32 row, int32 col, uint32 count, uint32 color, eBlendMode mode, bool isGammaCorrect = false) override;
+	virtual void BlendColorRect(int32 row, int32 col, uint32 width, uint32 height, uint32 color, eBlendMode mode, bool isGammaCorrect = false) override;
+	virtual void BlendRow(int32 row, int32 col, const uint32* src, uint32 count, eBlendMode mode, bool isGammaCorrect = false) override;
+	virtual void BlendRect(int32 row, int32 col, uint32 width, uint32 height, const uint32* src, uint32 srcPitch, eBlendMode mode, bool isGammaCorrect = false) override;
+
+	virtual void DrawTriangle(const RasterVertex& v0, const RasterVertex& v1, const RasterVertex& v2, uint32 color) override;
+	virtual void DrawShaded(const ShadedBatch& batch) override;
+	virtual DrawQueue& GetDrawQueue() override;
+	virtual void DrawLines(const LineSegment* segments, uint32 count, bool isAntialiased = false) override;
+	virtual void DrawPoints(const RasterPoint* points, uint32 count, float size = 1.0f, bool isAntialiased = false) override;
+	virtual const RasterStatistics& GetRasterStatistics() const override;
+	virtual void SetRasterThreadCount(uint32 count) override;
+	virtual uint32 GetRasterThreadCount() const override;
+	virtual void SetJobSystem(JobSystem* jobSystem) override;
+	virtual void SetDepthTestEnabled(bool isDepthTestEnabled) override;
+	virtual bool IsDepthTestEnabled() const override;
+	virtual void SetSampleCount(uint32 count) override;
+	virtual uint32 GetSampleCount() const override;
+
+	virtual TextureBuffer& AcquireBackBuffer() override;
+	virtual void ReleaseBackBuffer() override;
+
+	virtual void EnableDynamicResolution(float targetMilliseconds, float minScale = 0.5f) override;
+	virtual void DisableDynamicResolution() override;
+	virtual bool IsDynamicResolutionEnabled() const override;
+	virtual float GetResolutionScale() const override;
+
+protected:
+	// This frame's back buffer, acquired by the first call.
+	virtual TextureBuffer& acquireBackBuffer() = 0;
+	virtual void releaseBackBuffer() = 0;
+	// Size the back buffer gets from the next frame on.
+	virtual void setFramebufferSize(uint32 width, uint32 height) = 0;
+
+	// Called by Prepare(), resets the statistics and starts measuring the CPU render time.
+	void beginFrame();
+	// Called by Submit(), draws the queued triangles and picks the next frame's resolution from the CPU render time.
+	void endFrame();
+	void applyResolution();
+	// Draws the sorted draws and the queued triangles before anything else touches the back buffer.
+	void flushTriangles();
+	// Returns the depth buffer matching target, or null while the depth test is off.
+	DepthBuffer* bindDepthBuffer(const TextureBuffer& target);
+	// Returns the multisample buffer matching target, or null without multisampling.
+	MultisampleBuffer* bindMultisampleBuffer(const TextureBuffer& target);
+	// Resolves the split pixels into the back buffer and clears them, before writes which don't know about samples.
+	void resolveSamples();
+
+	uint32				_windowWidth = 0;
+	uint32				_windowHeight = 0;
+	// The window backend also hands it to GraphicsAPI, the upload resolves what is left split at Submit().
+	MultisampleBuffer	_multisampleBuffer;
+
+private:
+	BinnedRasterizer	_rasterizer;
+	LineRasterizer		_lineRasterizer;
+	DrawQueue			_drawQueue;
+	DepthBuffer			_depthBuffer;
+	bool				_isDepthTestEnabled = false;
+	uint32				_sampleCount = 1;
+
+	DynamicResolution	_dynamicResolution;
+	bool				_isDynamicResolutionEnabled = false;
+	// Measures the CPU render time, from Prepare() to Submit().
+	Timer				_renderTimer;
+};
+
+}
\ No newline at end of file
@@ -0,0 +1,321 @@
+#include "EnginePch.h"
+#include "VertexPipeline.h"
+
+#include "Renderer/Drawable.hpp"
+#include "System/Utility/Simd.hpp"
+
+namespace GG {
+
+// Output streams of a transform, indexed like the input.
+struct TransformTarget
+{
+	float* clipX;
+	float* clipY;
+	float* clipZ;
+	float* clipW;
+	float* screenX;
+	float* screenY;
+	float* screenZ;
+	uint8* clipCodes;
+};
+
+// Rows of the transform and the viewport mapping, the same for every vertex.
+struct TransformConstants
+{
+	float m[4][4];
+	float halfWidth;
+	float halfHeight;
+	float guardBandX;
+	float guardBandY;
+};
+
+using TransformFunc = uint32(*)(const TransformConstants&, const VertexPositions&, const TransformTarget&);
+
+static void transform_vertex(const TransformConstants& constants, const VertexPositions& positions, const TransformTarget& target, uint32 i)
+{
+	const float x = positions.x[i];
+	const float y = positions.y[i];
+	const float z = positions.z[i];
+	const auto& m = constants.m;
+	const float clipX = m[0][0] * x + m[0][1] * y + m[0][2] * z + m[0][3];
+	const float clipY = m[1][0] * x + m[1][1] * y + m[1][2] * z + m[1][3];
+	const float clipZ = m[2][0] * x + m[2][1] * y + m[2][2] * z + m[2][3];
+	const float clipW = m[3][0] * x + m[3][1] * y + m[3][2] * z + m[3][3];
+
+	uint8 code = ClipCodeNone;
+	code |= clipX < -clipW ? ClipCodeLeft : 0;
+	code |= clipX > clipW ? ClipCodeRight : 0;
+	code |= clipY < -clipW ? ClipCodeTop : 0;
+	code |= clipY > clipW ? ClipCodeBottom : 0;
+	code |= clipZ < 0.0f ? ClipCodeNear : 0;
+	code |= clipZ > clipW ? ClipCodeFar : 0;
+	code |= std::abs(clipX) > constants.guardBandX * clipW || std::abs(clipY) > constants.guardBandY * clipW ? ClipCodeGuardBand : 0;
+
+	// Vertices behind the eye get meaningless screen positions, they are always clipped.
+	const float inverseW = 1.0f / clipW;
+	target.clipX[i] = clipX;
+	target.clipY[i] = clipY;
+	target.clipZ[i] = clipZ;
+	target.clipW[i] = clipW;
+	target.screenX[i] = clipX * inverseW * constants.halfWidth + constants.halfWidth;
+	target.screenY[i] = clipY * inverseW * constants.halfHeight + constants.halfHeight;
+	target.screenZ[i] = clipZ * inverseW;
+	target.clipCodes[i] = code;
+}
+
+// Returns how many vertices were transformed, the caller finishes the tail one by one.
+static uint32 transform_vertices_sse2(const TransformConstants& constants, const VertexPositions& positions, const TransformTarget& target)
+{
+	const auto& m = constants.m;
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+	const __m128 halfWidth = _mm_set1_ps(constants.halfWidth);
+	const __m128 halfHeight = _mm_set1_ps(constants.halfHeight);
+	const __m128 guardBandX = _mm_set1_ps(constants.guardBandX);
+	const __m128 guardBandY = _mm_set1_ps(constants.guardBandY);
+	const __m128 one = _mm_set1_ps(1.0f);
+
+	const uint32 count = positions.count & ~3u;
+	for (uint32 i = 0; i < count; i += 4)
+	{
+		const __m128 x = _mm_loadu_ps(positions.x + i);
+		const __m128 y = _mm_loadu_ps(positions.y + i);
+		const __m128 z = _mm_loadu_ps(positions.z + i);
+
+		__m128 clip[4];
+		for (uint32 row = 0; row < 4; row++)
+		{
+			clip[row] = _mm_add_ps(
+				_mm_add_ps(_mm_mul_ps(_mm_set1_ps(m[row][0]), x), _mm_mul_ps(_mm_set1_ps(m[row][1]), y)),
+				_mm_add_ps(_mm_mul_ps(_mm_set1_ps(m[row][2]), z), _mm_set1_ps(m[row][3])));
+		}
+		const __m128 minusW = _mm_sub_ps(zero, clip[3]);
+
+		__m128i code = _mm_and_si128(_mm_castps_si128(_mm_cmplt_ps(clip[0], minusW)), _mm_set1_epi32(ClipCodeLeft));
+		code = _mm_or_si128(code, _mm_and_si128(_mm_castps_si128(_mm_cmpgt_ps(clip[0], clip[3])), _mm_set1_epi32(ClipCodeRight)));
+		code = _mm_or_si128(code, _mm_and_si128(_mm_castps_si128(_mm_cmplt_ps(clip[1], minusW)), _mm_set1_epi32(ClipCodeTop)));
+		code = _mm_or_si128(code, _mm_and_si128(_mm_castps_si128(_mm_cmpgt_ps(clip[1], clip[3])), _mm_set1_epi32(ClipCodeBottom)));
+		code = _mm_or_si128(code, _mm_and_si128(_mm_castps_si128(_mm_cmplt_ps(clip[2], zero)), _mm_set1_epi32(ClipCodeNear)));
+		code = _mm_or_si128(code, _mm_and_si128(_mm_castps_si128(_mm_cmpgt_ps(clip[2], clip[3])), _mm_set1_epi32(ClipCodeFar)));
+		const __m128 outsideGuardBand = _mm_or_ps(
+			_mm_cmpgt_ps(_mm_and_ps(clip[0], absMask), _mm_mul_ps(guardBandX, clip[3])),
+			_mm_cmpgt_ps(_mm_and_ps(clip[1], absMask), _mm_mul_ps(guardBandY, clip[3])));
+		code = _mm_or_si128(code, _mm_and_si128(_mm_castps_si128(outsideGuardBand), _mm_set1_epi32(ClipCodeGuardBand)));
+
+		const __m128 inverseW = _mm_div_ps(one, clip[3]);
+		_mm_storeu_ps(target.clipX + i, clip[0]);
+		_mm_storeu_ps(target.clipY + i, clip[1]);
+		_mm_storeu_ps(target.clipZ + i, clip[2]);
+		_mm_storeu_ps(target.clipW + i, clip[3]);
+		_mm_storeu_ps(target.screenX + i, _mm_add_ps(_mm_mul_ps(_mm_mul_ps(clip[0], inverseW), halfWidth), halfWidth));
+		_mm_storeu_ps(target.screenY + i, _mm_add_ps(_mm_mul_ps(_mm_mul_ps(clip[1], inverseW), halfHeight), halfHeight));
+		_mm_storeu_ps(target.screenZ + i, _mm_mul_ps(clip[2], inverseW));
+
+		// Codes fit in a byte, narrow the four words down to four bytes.
+		const __m128i code16 = _mm_packs_epi32(code, code);
+		const int32 code8 = _mm_cvtsi128_si32(_mm_packus_epi16(code16, code16));
+		std::memcpy(target.clipCodes + i, &code8, sizeof(code8));
+	}
+
+	return count;
+}
+
+GG_TARGET_AVX2 static uint32 transform_vertices_avx2(const TransformConstants& constants, const VertexPositions& positions, const TransformTarget& target)
+{
+	const auto& m = constants.m;
+	const __m256 zero = _mm256_setzero_ps();
+	const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF));
+	const __m256 halfWidth = _mm256_set1_ps(constants.halfWidth);
+	const __m256 halfHeight = _mm256_set1_ps(constants.halfHeight);
+	const __m256 guardBandX = _mm256_set1_ps(constants.guardBandX);
+	const __m256 guardBandY = _mm256_set1_ps(constants.guardBandY);
+	const __m256 one = _mm256_set1_ps(1.0f);
+
+	const uint32 count = positions.count & ~7u;
+	for (uint32 i = 0; i < count; i += 8)
+	{
+		const __m256 x = _mm256_loadu_ps(positions.x + i);
+		const __m256 y = _mm256_loadu_ps(positions.y + i);
+		const __m256 z = _mm256_loadu_ps(positions.z + i);
+
+		__m256 clip[4];
+		for (uint32 row = 0; row < 4; row++)
+		{
+			clip[row] = _mm256_fmadd_ps(_mm256_set1_ps(m[row][0]), x,
+				_mm256_fmadd_ps(_mm256_set1_ps(m[row][1]), y,
+				_mm256_fmadd_ps(_mm256_set1_ps(m[row][2]), z, _mm256_set1_ps(m[row][3]))));
+		}
+		const __m256 minusW = _mm256_sub_ps(zero, clip[3]);
+
+		__m256i code = _mm256_and_si256(_mm256_castps_si256(_mm256_cmp_ps(clip[0], minusW, _CMP_LT_OQ)), _mm256_set1_epi32(ClipCodeLeft));
+		code = _mm256_or_si256(code, _mm256_and_si256(_mm256_castps_si256(_mm256_cmp_ps(clip[0], clip[3], _CMP_GT_OQ)), _mm256_set1_epi32(ClipCodeRight)));
+		code = _mm256_or_si256(code, _mm256_and_si256(_mm256_castps_si256(_mm256_cmp_ps(clip[1], minusW, _CMP_LT_OQ)), _mm256_set1_epi32(ClipCodeTop)));
+		code = _mm256_or_si256(code, _mm256_and_si256(_mm256_castps_si256(_mm256_cmp_ps(clip[1], clip[3], _CMP_GT_OQ)), _mm256_set1_epi32(ClipCodeBottom)));
+		code = _mm256_or_si256(code, _mm256_and_si256(_mm256_castps_si256(_mm256_cmp_ps(clip[2], zero, _CMP_LT_OQ)), _mm256_set1_epi32(ClipCodeNear)));
+		code = _mm256_or_si256(code, _mm256_and_si256(_mm256_castps_si256(_mm256_cmp_ps(clip[2], clip[3], _CMP_GT_OQ)), _mm256_set1_epi32(ClipCodeFar)));
+		const __m256 outsideGuardBand = _mm256_or_ps(
+			_mm256_cmp_ps(_mm256_and_ps(clip[0], absMask), _mm256_mul_ps(guardBandX, clip[3]), _CMP_GT_OQ),
+			_mm256_cmp_ps(_mm256_and_ps(clip[1], absMask), _mm256_mul_ps(guardBandY, clip[3]), _CMP_GT_OQ));
+		code = _mm256_or_si256(code, _mm256_and_si256(_mm256_castps_si256(outsideGuardBand), _mm256_set1_epi32(ClipCodeGuardBand)));
+
+		const __m256 inverseW = _mm256_div_ps(one, clip[3]);
+		_mm256_storeu_ps(target.clipX + i, clip[0]);
+		_mm256_storeu_ps(target.clipY + i, clip[1]);
+		_mm256_storeu_ps(target.clipZ + i, clip[2]);
+		_mm256_storeu_ps(target.clipW + i, clip[3]);
+		_mm256_storeu_ps(target.screenX + i, _mm256_fmadd_ps(_mm256_mul_ps(clip[0], inverseW), halfWidth, halfWidth));
+		_mm256_storeu_ps(target.screenY + i, _mm256_fmadd_ps(_mm256_mul_ps(clip[1], inverseW), halfHeight, halfHeight));
+		_mm256_storeu_ps(target.screenZ + i, _mm256_mul_ps(clip[2], inverseW));
+
+		const __m128i code16 = _mm_packs_epi32(_mm256_castsi256_si128(code), _mm256_extracti128_si256(code, 1));
+		_mm_storel_epi64(reinterpret_cast<__m128i*>(target.clipCodes + i), _mm_packus_epi16(code16, code16));
+	}
+
+	return count;
+}
+
+static TransformFunc get_transform_func()
+{
+	static const TransformFunc s_func = Simd::IsAVX2Supported() ? transform_vertices_avx2 : transform_vertices_sse2;
+
+	return s_func;
+}
+
+// Clip space vertex for the Sutherland-Hodgman clipper.
+struct ClipVertex
+{
+	float x;
+	float y;
+	float z;
+	float w;
+};
+
+// Signed distance to a clip plane, inside is >= 0.
+static float plane_distance(const ClipVertex& vertex, uint8 plane, float guardBandX, float guardBandY)
+{
+	switch (plane)
+	{
+	case ClipCodeNear:		return vertex.z;
+	case ClipCodeFar:		return vertex.w - vertex.z;
+	case ClipCodeLeft:		return vertex.x + guardBandX * vertex.w;
+	case ClipCodeRight:		return guardBandX * vertex.w - vertex.x;
+	case ClipCodeTop:		return vertex.y + guardBandY * vertex.w;
+	case ClipCodeBottom:	return guardBandY * vertex.w - vertex.y;
+	default:				GG_UNREACHABLE();
+	}
+}
+
+void VertexPipeline::SetViewport(uint32 width, uint32 height)
+{
+	_halfWidth = width * 0.5f;
+	_halfHeight = height * 0.5f;
+
+	// Largest |x / w| whose screen position stays inside the rasterizer's guard band, with some margin for rounding.
+	_guardBandX = std::max((Rasterizer::s_guardBand * 0.99f - _halfWidth) / _halfWidth, 1.0f);
+	_guardBandY = std::max((Rasterizer::s_guardBand * 0.99f - _halfHeight) / _halfHeight, 1.0f);
+}
+
+void VertexPipeline::TransformVertices(const Matrix4& transform, const VertexPositions& positions)
+{
+	GG_ASSERT(_halfWidth > 0.0f && _halfHeight > 0.0f, "Viewport is not set!");
+
+	const uint32 count = positions.count;
+	_clipX.resize(count);
+	_clipY.resize(count);
+	_clipZ.resize(count);
+	_clipW.resize(count);
+	_screenX.resize(count);
+	_screenY.resize(count);
+	_screenZ.resize(count);
+	_clipCodes.resize(count);
+
+	TransformConstants constants;
+	std::memcpy(constants.m, transform.m, sizeof(constants.m));
+	constants.halfWidth = _halfWidth;
+	constants.halfHeight = _halfHeight;
+	constants.guardBandX = _guardBandX;
+	constants.guardBandY = _guardBandY;
+
+	const TransformTarget target{ _clipX.data(), _clipY.data(), _clipZ.data(), _clipW.data(), _screenX.data(), _screenY.data(), _screenZ.data(), _clipCodes.data() };
+	for (uint32 i = get_transform_func()(constants, positions, target); i < count; i++)
+	{
+		transform_vertex(constants, positions, target, i);
+	}
+
+	_statistics.vertexCount += count;
+}
+
+void VertexPipeline::DrawIndexed(IDrawable& renderer, const uint32* indices, uint32 indexCount, const uint32* triangleColors)
+{
+	AssembleTriangles(indices, indexCount, [&](const RasterVertex& v0, const RasterVertex& v1, const RasterVertex& v2, uint32 triangle) {
+		renderer.DrawTriangle(v0, v1, v2, triangleColors[triangle]);
+		});
+}
+
+uint32 VertexPipeline::clipTriangle(uint32 i0, uint32 i1, uint32 i2, RasterVertex* outPolygon) const
+{
+	ClipVertex buffers[2][s_maxClipVertexCount];
+	ClipVertex* input = buffers[0];
+	ClipVertex* output = buffers[1];
+	uint32 count = 0;
+	for (uint32 index : { i0, i1, i2 })
+	{
+		input[count++] = ClipVertex{ _clipX[index], _clipY[index], _clipZ[index], _clipW[index] };
+	}
+
+	// Only the planes some vertex is outside of, the guard band planes stand in for the viewport's.
+	const uint8 codes = _clipCodes[i0] | _clipCodes[i1] | _clipCodes[i2];
+	const bool isOutsideGuardBand = (codes & ClipCodeGuardBand) != 0;
+	const uint8 planes[]{ ClipCodeNear, ClipCodeFar, ClipCodeLeft, ClipCodeRight, ClipCodeTop, ClipCodeBottom };
+	for (uint8 plane : planes)
+	{
+		const bool isGuardBandPlane = plane != ClipCodeNear && plane != ClipCodeFar;
+		if (isGuardBandPlane ? !isOutsideGuardBand : (codes & plane) == 0)
+		{
+			continue;
+		}
+
+		uint32 outputCount = 0;
+		for (uint32 i = 0; i < count; i++)
+		{
+			const ClipVertex& current = input[i];
+			const ClipVertex& next = input[i + 1 == count ? 0 : i + 1];
+			const float currentDistance = plane_distance(current, plane, _guardBandX, _guardBandY);
+			const float nextDistance = plane_distance(next, plane, _guardBandX, _guardBandY);
+
+			if (currentDistance >= 0.0f)
+			{
+				output[outputCount++] = current;
+			}
+			if ((currentDistance >= 0.0f) != (nextDistance >= 0.0f))
+			{
+				const float t = currentDistance / (currentDistance - nextDistance);
+				output[outputCount++] = ClipVertex{
+					current.x + (next.x - current.x) * t,
+					current.y + (next.y - current.y) * t,
+					current.z + (next.z - current.z) * t,
+					current.w + (next.w - current.w) * t,
+				};
+			}
+		}
+
+		std::swap(input, output);
+		count = outputCount;
+		if (count < 3)
+		{
+			return 0;
+		}
+	}
+
+	for (uint32 i = 0; i < count; i++)
+	{
+		const float inverseW = 1.0f / input[i].w;
+		outPolygon[i].x = input[i].x * inverseW * _halfWidth + _halfWidth;
+		outPolygon[i].y = input[i].y * inverseW * _halfHeight + _halfHeight;
+		outPolygon[i].z = input[i].z * inverseW;
+	}
+
+	return count;
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <vector>
+
+#include "Base.hpp"
+
+#include "System/gg_system.h"
+#include "System/Utility/Matrix.hpp"
+#include "Renderer/Rasterizer.h"
+
+namespace GG {
+
+class IDrawable;
+
+// Clip space follows Vulkan: a vertex is inside if -w <= x, y <= w and 0 <= z <= w.
+enum ClipCode : uint8
+{
+	ClipCodeNone = 0,
+	ClipCodeLeft		= BIT_UINT8(0),
+	ClipCodeRight		= BIT_UINT8(1),
+	ClipCodeTop			= BIT_UINT8(2),
+	ClipCodeBottom		= BIT_UINT8(3),
+	ClipCodeNear		= BIT_UINT8(4),
+	ClipCodeFar			= BIT_UINT8(5),
+	// Outside of the rasterizer's guard band, see Rasterizer::s_guardBand.
+	ClipCodeGuardBand	= BIT_UINT8(6),
+};
+
+// Positions in structure of arrays layout, all three arrays hold count floats.
+struct VertexPositions
+{
+	const float* x;
+	const float* y;
+	const float* z;
+	uint32 count;
+};
+
+struct VertexStatistics
+{
+	uint64 vertexCount = 0;
+	uint64 triangleCount = 0;
+	// Every vertex outside of the same frustum plane.
+	uint64 culledTriangleCount = 0;
+	// Crossing the near or far plane or leaving the guard band, everything else goes straight to triangle setup.
+	uint64 clippedTriangleCount = 0;
+};
+
+// Front end of the software renderer: transforms positions to clip space, divides by w and maps them to the viewport
+// in one pass over structure of arrays batches, 8 vertices per instruction with AVX2 or 4 with SSE2, and stores a clip code per vertex.
+// Triangle assembly then culls by the clip codes and only clips triangles crossing the near/far planes or the guard band;
+// triangles which leave the viewport but stay in the guard band are left to the rasterizer's bounding box clamp.
+class VertexPipeline
+{
+public:
+	// Enough for a triangle clipped by the near and far planes and all four guard band planes.
+	static constexpr uint32			s_maxClipVertexCount = 9;
+
+	VertexPipeline() = default;
+	~VertexPipeline() = default;
+
+	void SetViewport(uint32 width, uint32 height);
+
+	// Replaces the transformed vertices of the last call.
+	void TransformVertices(const Matrix4& transform, const VertexPositions& positions);
+
+	// Culls, clips and emits the screen space triangles of indexCount / 3 triangles of the transformed vertices.
+	// emit(const RasterVertex&, const RasterVertex&, const RasterVertex&, uint32 triangleIndex) may be called several times
+	// for a clipped triangle.
+	template<typename EmitFunc>
+	void AssembleTriangles(const uint32* indices, uint32 indexCount, EmitFunc&& emit);
+	// Assembles the triangles into the renderer, triangleColors holds one packed color per triangle.
+	void DrawIndexed(IDrawable& renderer, const uint32* indices, uint32 indexCount, const uint32* triangleColors);
+
+	inline uint32 GetVertexCount() const { return static_cast<uint32>(_clipCodes.size()); }
+	inline uint8 GetClipCode(uint32 index) const { return _clipCodes[index]; }
+	inline RasterVertex GetScreenVertex(uint32 index) const { return RasterVertex{ _screenX[index], _screenY[index], _screenZ[index] }; }
+
+	inline const VertexStatistics& GetStatistics() const { return _statistics; }
+	inline void ResetStatistics() { _statistics = VertexStatistics{}; }
+
+private:
+	static constexpr uint8			s_cullMask = ClipCodeLeft | ClipCodeRight | ClipCodeTop | ClipCodeBottom | ClipCodeNear | ClipCodeFar;
+	static constexpr uint8			s_clipMask = ClipCodeNear | ClipCodeFar | ClipCodeGuardBand;
+
+	// Clips the triangle in clip space and returns the screen space polygon, a fan of up to s_maxClipVertexCount vertices.
+	uint32 clipTriangle(uint32 i0, uint32 i1, uint32 i2, RasterVertex* outPolygon) const;
+
+	float							_halfWidth = 0.0f;
+	float							_halfHeight = 0.0f;
+	// Guard band in clip space units of w.
+	float							_guardBandX = 1.0f;
+	float							_guardBandY = 1.0f;
+
+	std::vector<float>				_clipX;
+	std::vector<float>				_clipY;
+	std::vector<float>				_clipZ;
+	std::vector<float>				_clipW;
+	std::vector<float>				_screenX;
+	std::vector<float>				_screenY;
+	std::vector<float>				_screenZ;
+	std::vector<uint8>				_clipCodes;
+
+	VertexStatistics				_statistics;
+};
+
+template<typename EmitFunc>
+void VertexPipeline::AssembleTriangles(const uint32* indices, uint32 indexCount, EmitFunc&& emit)
+{
+	const uint32 triangleCount = indexCount / 3;
+	_statistics.triangleCount += triangleCount;
+
+	for (uint32 triangle = 0; triangle < triangleCount; triangle++)
+	{
+		const uint32 i0 = indices[triangle * 3 + 0];
+		const uint32 i1 = indices[triangle * 3 + 1];
+		const uint32 i2 = indices[triangle * 3 + 2];
+		const uint8 code0 = _clipCodes[i0];
+		const uint8 code1 = _clipCodes[i1];
+		const uint8 code2 = _clipCodes[i2];
+
+		if ((code0 & code1 & code2 & s_cullMask) != 0)
+		{
+			_statistics.culledTriangleCount++;
+			continue;
+		}
+
+		if (((code0 | code1 | code2) & s_clipMask) == 0)
+		{
+			emit(GetScreenVertex(i0), GetScreenVertex(i1), GetScreenVertex(i2), triangle);
+			continue;
+		}
+
+		_statistics.clippedTriangleCount++;
+		RasterVertex polygon[s_maxClipVertexCount];
+		const uint32 vertexCount = clipTriangle(i0, i1, i2, polygon);
+		for (uint32 i = 2; i < vertexCount; i++)
+		{
+			emit(polygon[0], polygon[i - 1], polygon[i], triangle);
+		}
+	}
+}
+
+}
\ No newline at end of file
@@ -4,7 +4,11 @@
 #include "System/gg_system.h"
 
 #include "Core/Application.h"
+#include "Core/FrameSnapshot.hpp"
 #include "Renderer/RenderPass.hpp"
 #include "Renderer/RenderPath.h"
 
-#include "Renderer/Renderer.h"
\ No newline at end of file
+#include "Renderer/Renderer.h"
+#include "Renderer/HeadlessRenderer.h"
+#include "Renderer/VertexPipeline.h"
+#include "Renderer/PixelShader.hpp"
\ No newline at end of file
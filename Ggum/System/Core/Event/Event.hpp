@@ -40,7 +40,7 @@ enum EventCategory : uint16
 	EventCategoryMouseButton	= BIT(4),
 };
 
-#define EVENT_CLASS_TYPE(type) static eEventType GetStaticType() { return eEventType::##type; } \
+#define EVENT_CLASS_TYPE(type) static eEventType GetStaticType() { return eEventType::type; } \
 								virtual eEventType GetEventType() const override { return GetStaticType(); } \
 								virtual const char* GetName() const override { return #type; }
 
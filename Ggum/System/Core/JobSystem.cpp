@@ -0,0 +1,292 @@
+#include "SystemPch.h"
+
+#include "JobSystem.h"
+
+#include "Core/Profiler.h"
+
+namespace GG {
+
+static thread_local JobSystem* s_threadJobSystem = nullptr;
+static thread_local uint32 s_threadIndex = 0;
+
+bool JobDeque::Push(Job* job)
+{
+	const int64 bottom = _bottom.load(std::memory_order_relaxed);
+	if (bottom - _top.load(std::memory_order_acquire) >= static_cast<int64>(s_capacity))
+	{
+		return false;
+	}
+
+	_jobs[bottom & (s_capacity - 1)].store(job, std::memory_order_relaxed);
+	// Publishes the job and its contents to the thieves.
+	_bottom.store(bottom + 1, std::memory_order_release);
+
+	return true;
+}
+
+Job* JobDeque::Pop()
+{
+	const int64 bottom = _bottom.load(std::memory_order_relaxed) - 1;
+	_bottom.store(bottom, std::memory_order_relaxed);
+	// Thieves have to see the reservation of the bottom job before the top is read.
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	int64 top = _top.load(std::memory_order_relaxed);
+
+	if (top > bottom)
+	{
+		_bottom.store(bottom + 1, std::memory_order_relaxed);
+		return nullptr;
+	}
+
+	Job* job = _jobs[bottom & (s_capacity - 1)].load(std::memory_order_relaxed);
+	if (top == bottom)
+	{
+		// Last job, race the thieves for it.
+		if (!_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+		{
+			job = nullptr;
+		}
+		_bottom.store(bottom + 1, std::memory_order_relaxed);
+	}
+
+	return job;
+}
+
+Job* JobDeque::Steal()
+{
+	int64 top = _top.load(std::memory_order_acquire);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	const int64 bottom = _bottom.load(std::memory_order_acquire);
+	if (top >= bottom)
+	{
+		return nullptr;
+	}
+
+	Job* job = _jobs[top & (s_capacity - 1)].load(std::memory_order_relaxed);
+	if (!_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+	{
+		return nullptr;
+	}
+
+	return job;
+}
+
+JobSystem::~JobSystem()
+{
+	Stop();
+}
+
+void JobSystem::Start(uint32 threadCount)
+{
+	GG_ASSERT(!IsStarted(), "Job system is already started!");
+
+	if (threadCount == 0)
+	{
+		threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+	}
+
+	_isStopping.store(false);
+	_queuedJobCount.store(0);
+	_workers.resize(threadCount);
+	for (uint32 i = 0; i < threadCount; i++)
+	{
+		_workers[i] = std::make_unique<Worker>();
+		_workers[i]->jobs.reset(new Job[s_maxJobCount]());
+		_workers[i]->randomState = 0x9E3779B9u * (i + 1);
+	}
+
+	s_threadJobSystem = this;
+	s_threadIndex = 0;
+	for (uint32 i = 1; i < threadCount; i++)
+	{
+		_workers[i]->thread = std::thread(&JobSystem::workerMain, this, i);
+	}
+}
+
+void JobSystem::Stop()
+{
+	if (!IsStarted())
+	{
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(_sleepMutex);
+		_isStopping.store(true);
+	}
+	_wakeCondition.notify_all();
+
+	for (auto& worker : _workers)
+	{
+		if (worker->thread.joinable())
+		{
+			worker->thread.join();
+		}
+	}
+	_workers.clear();
+
+	if (s_threadJobSystem == this)
+	{
+		s_threadJobSystem = nullptr;
+	}
+}
+
+bool JobSystem::IsWorkerThread() const
+{
+	return s_threadJobSystem == this;
+}
+
+uint32 JobSystem::GetThreadIndex()
+{
+	return s_threadIndex;
+}
+
+void JobSystem::Run(Job* job)
+{
+	GG_ASSERT(IsWorkerThread(), "Jobs can only be run from the job system's threads!");
+
+	// Counted before the push, so a thread which sees the job never finds the count at zero.
+	_queuedJobCount.fetch_add(1);
+	if (!_workers[s_threadIndex]->deque.Push(job))
+	{
+		_queuedJobCount.fetch_sub(1);
+		execute(job);
+		return;
+	}
+
+	// Pairs with the sleeping count a thread raises before it checks the queued count.
+	if (_sleepingThreadCount.load() > 0)
+	{
+		std::lock_guard<std::mutex> lock(_sleepMutex);
+		_wakeCondition.notify_one();
+	}
+}
+
+void JobSystem::Wait(const Job* job)
+{
+	GG_ASSERT(IsWorkerThread(), "Jobs can only be waited on from the job system's threads!");
+
+	Worker& worker = *_workers[s_threadIndex];
+	while (!IsDone(job))
+	{
+		if (Job* next = getJob(worker))
+		{
+			execute(next);
+		}
+		else
+		{
+			std::this_thread::yield();
+		}
+	}
+}
+
+bool JobSystem::RunOneJob()
+{
+	GG_ASSERT(IsWorkerThread(), "Jobs can only be run from the job system's threads!");
+
+	Job* job = getJob(*_workers[s_threadIndex]);
+	if (!job)
+	{
+		return false;
+	}
+
+	execute(job);
+	return true;
+}
+
+Job* JobSystem::allocateJob()
+{
+	GG_ASSERT(IsWorkerThread(), "Jobs can only be created from the job system's threads!");
+
+	// Parents stay unfinished while their children are created, step over them.
+	Worker& worker = *_workers[s_threadIndex];
+	for (uint32 i = 0; i < s_maxJobCount; i++)
+	{
+		Job* job = &worker.jobs[worker.nextJob++ & (s_maxJobCount - 1)];
+		if (IsDone(job))
+		{
+			return job;
+		}
+	}
+
+	GG_ASSERT(false, "Too many unfinished jobs on one thread!");
+	return nullptr;
+}
+
+Job* JobSystem::getJob(Worker& worker)
+{
+	Job* job = worker.deque.Pop();
+	if (!job)
+	{
+		const uint32 workerCount = static_cast<uint32>(_workers.size());
+		// xorshift, a fixed victim order would make every idle thread hammer the same deque.
+		worker.randomState ^= worker.randomState << 13;
+		worker.randomState ^= worker.randomState >> 17;
+		worker.randomState ^= worker.randomState << 5;
+		const uint32 first = worker.randomState % workerCount;
+		for (uint32 i = 0; i < workerCount && !job; i++)
+		{
+			Worker& victim = *_workers[(first + i) % workerCount];
+			if (&victim != &worker)
+			{
+				job = victim.deque.Steal();
+			}
+		}
+	}
+
+	if (job)
+	{
+		_queuedJobCount.fetch_sub(1, std::memory_order_relaxed);
+	}
+
+	return job;
+}
+
+void JobSystem::execute(Job* job)
+{
+	job->function(*job);
+	finish(job);
+}
+
+void JobSystem::finish(Job* job)
+{
+	// Read before the count drops, the slot can be reused right after.
+	Job* parent = job->parent;
+	if (job->unfinishedJobCount.fetch_sub(1, std::memory_order_acq_rel) == 1 && parent)
+	{
+		finish(parent);
+	}
+}
+
+void JobSystem::workerMain(uint32 workerIndex)
+{
+	s_threadJobSystem = this;
+	s_threadIndex = workerIndex;
+	Profiler::SetThreadName("Job worker " + std::to_string(workerIndex));
+
+	Worker& worker = *_workers[workerIndex];
+	uint32 idleCount = 0;
+	while (!_isStopping.load(std::memory_order_relaxed))
+	{
+		if (Job* job = getJob(worker))
+		{
+			execute(job);
+			idleCount = 0;
+			continue;
+		}
+
+		if (++idleCount < s_idleSpinCount)
+		{
+			std::this_thread::yield();
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(_sleepMutex);
+		_sleepingThreadCount.fetch_add(1);
+		_wakeCondition.wait(lock, [&]() { return _queuedJobCount.load() > 0 || _isStopping.load(); });
+		_sleepingThreadCount.fetch_sub(1);
+		idleCount = 0;
+	}
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,196 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "Base.hpp"
+
+#include "Core/Log.h"
+
+namespace GG {
+
+// A unit of work. A job is done once its function and every child job created with it as parent have finished,
+// so waiting on a parent waits for the whole group.
+struct alignas(64) Job
+{
+	static constexpr uint32			s_dataSize = 40;
+
+	void (*function)(Job&);
+	Job* parent;
+	std::atomic<int32> unfinishedJobCount;
+	// The callable of CreateJob(), copied in place.
+	alignas(8) uint8 data[s_dataSize];
+};
+
+// Lock-free work-stealing deque of Chase and Lev with a fixed capacity.
+// Only the owning thread pushes and pops at the bottom, any thread steals from the top.
+class JobDeque
+{
+public:
+	static constexpr uint32			s_capacity = 4096;
+
+	JobDeque() = default;
+
+	// Returns false if the deque is full.
+	bool Push(Job* job);
+	Job* Pop();
+	Job* Steal();
+
+private:
+	alignas(64) std::atomic<int64>	_top{ 0 };
+	alignas(64) std::atomic<int64>	_bottom{ 0 };
+	std::atomic<Job*>				_jobs[s_capacity]{};
+};
+
+// Worker threads with a job deque each. Idle threads steal from the others, so a job runs on whatever thread is free.
+// The thread calling Start() is worker 0 and runs jobs whenever it waits, jobs can only be created and waited on from the workers.
+// Jobs come from a ring of s_maxJobCount per thread which skips unfinished jobs, no thread may have more unfinished jobs than that.
+// Jobs run while the thread's deque is full execute right away, so a group can have any number of children.
+class JobSystem
+{
+public:
+	static constexpr uint32			s_maxJobCount = JobDeque::s_capacity * 2;
+	// Rounds an idle thread looks for jobs before it goes to sleep.
+	static constexpr uint32			s_idleSpinCount = 256;
+
+	JobSystem() = default;
+	~JobSystem();
+
+	JobSystem(const JobSystem&) = delete;
+	JobSystem& operator=(const JobSystem&) = delete;
+
+	// threadCount includes the calling thread, 0 uses every hardware thread.
+	void Start(uint32 threadCount = 0);
+	// Waits for the running jobs, jobs which haven't started yet are dropped.
+	void Stop();
+
+	inline uint32 GetThreadCount() const { return static_cast<uint32>(_workers.size()); }
+	inline bool IsStarted() const { return !_workers.empty(); }
+	// Only the workers can create, run and wait on jobs.
+	bool IsWorkerThread() const;
+	// Index of the calling worker, 0 for the thread which called Start().
+	static uint32 GetThreadIndex();
+
+	// Copies func into a new job, func() or func(Job&) runs once the job is queued with Run(). func has to fit Job::s_dataSize
+	// and be trivially destructible, capture large state by reference. A parent isn't done until all of its children are.
+	template<typename Func>
+	Job* CreateJob(Func&& func, Job* parent = nullptr);
+	void Run(Job* job);
+	// Runs other jobs until job and its children are done.
+	void Wait(const Job* job);
+	// Runs one queued job on the calling worker, false if there was none. For threads with work of their own between jobs.
+	bool RunOneJob();
+	inline static bool IsDone(const Job* job) { return job->unfinishedJobCount.load(std::memory_order_acquire) == 0; }
+
+	// Calls func(rangeBegin, rangeEnd) over [begin, end) in ranges of at most grain elements on every thread and returns when all are done.
+	// The range is split in halves recursively, so idle threads steal big pieces first. Runs inline on threads outside the system.
+	template<typename Func>
+	void ParallelFor(uint32 begin, uint32 end, uint32 grain, Func&& func);
+
+private:
+	// Own cache lines, the deque's ends are written all the time.
+	struct alignas(64) Worker
+	{
+		JobDeque deque;
+		std::unique_ptr<Job[]> jobs;
+		uint32 nextJob = 0;
+		uint32 randomState = 0;
+		std::thread thread;
+	};
+
+	Job* allocateJob();
+	// Own deque first, then a random victim.
+	Job* getJob(Worker& worker);
+	void execute(Job* job);
+	void finish(Job* job);
+	void workerMain(uint32 workerIndex);
+
+	template<typename Func>
+	static void runParallelFor(JobSystem& jobSystem, Job& job, uint32 begin, uint32 end, uint32 grain, Func* func);
+
+	std::vector<std::unique_ptr<Worker>>	_workers;
+	// Jobs queued and not yet taken, lets idle threads sleep.
+	std::atomic<int32>				_queuedJobCount{ 0 };
+	std::atomic<int32>				_sleepingThreadCount{ 0 };
+	std::atomic<bool>				_isStopping{ false };
+	std::mutex						_sleepMutex;
+	std::condition_variable			_wakeCondition;
+};
+
+template<typename Func>
+Job* JobSystem::CreateJob(Func&& func, Job* parent)
+{
+	using Callable = std::decay_t<Func>;
+	static_assert(sizeof(Callable) <= Job::s_dataSize, "Job function is too large, capture by reference!");
+	static_assert(alignof(Callable) <= 8, "Job function is over-aligned!");
+	static_assert(std::is_trivially_destructible_v<Callable>, "Job function has to be trivially destructible!");
+
+	Job* job = allocateJob();
+	job->function = [](Job& self) {
+		Callable& callable = *std::launder(reinterpret_cast<Callable*>(self.data));
+		if constexpr (std::is_invocable_v<Callable&, Job&>)
+		{
+			callable(self);
+		}
+		else
+		{
+			callable();
+		}
+	};
+	job->parent = parent;
+	job->unfinishedJobCount.store(1, std::memory_order_relaxed);
+	new (job->data) Callable(std::forward<Func>(func));
+	if (parent)
+	{
+		parent->unfinishedJobCount.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	return job;
+}
+
+template<typename Func>
+void JobSystem::runParallelFor(JobSystem& jobSystem, Job& job, uint32 begin, uint32 end, uint32 grain, Func* func)
+{
+	// Keeps the lower half and hands the upper one out, until the range fits the grain.
+	while (end - begin > grain)
+	{
+		const uint32 middle = begin + (end - begin) / 2;
+		jobSystem.Run(jobSystem.CreateJob([&jobSystem, middle, end, grain, func](Job& child) {
+			runParallelFor(jobSystem, child, middle, end, grain, func);
+		}, &job));
+		end = middle;
+	}
+	(*func)(begin, end);
+}
+
+template<typename Func>
+void JobSystem::ParallelFor(uint32 begin, uint32 end, uint32 grain, Func&& func)
+{
+	if (begin >= end)
+	{
+		return;
+	}
+	grain = std::max(grain, 1u);
+	if (_workers.size() <= 1 || end - begin <= grain || !IsWorkerThread())
+	{
+		func(begin, end);
+		return;
+	}
+
+	auto* callable = &func;
+	Job* root = CreateJob([this, begin, end, grain, callable](Job& job) {
+		runParallelFor(*this, job, begin, end, grain, callable);
+	});
+	Run(root);
+	Wait(root);
+}
+
+}
\ No newline at end of file
@@ -7,6 +7,12 @@ std::shared_ptr<spdlog::logger> Log::s_logger = nullptr;
 
 void Log::Init()
 {
+	// Every Application calls it, a second one in the same process keeps the logger.
+	if (s_logger)
+	{
+		return;
+	}
+
 	spdlog::set_pattern("%^[%T] %n: %v%$");
 
 	s_logger = spdlog::stdout_color_mt("GG");
@@ -0,0 +1,231 @@
+#include "SystemPch.h"
+#include "Profiler.h"
+
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <unordered_set>
+#include <vector>
+
+namespace GG {
+
+struct ProfilerThreadBuffer
+{
+	static constexpr uint32 s_eventCapacity = Profiler::s_eventCapacity;
+
+	// Written by the owning thread only, the exporter reads it after EndCapture().
+	// Allocated by the first zone, threads which only name themselves don't pay for it.
+	std::unique_ptr<ProfileEvent[]> events;
+	std::atomic<uint64> eventCount{ 0 };
+	std::atomic<uint32> captureIndex{ 0 };
+	uint32 threadId = 0;
+	std::string threadName;
+};
+
+std::atomic<bool> Profiler::s_isCapturing{ false };
+std::atomic<uint32> Profiler::s_captureIndex{ 0 };
+uint64 Profiler::s_captureBegin = 0;
+uint64 Profiler::s_captureEnd = 0;
+uint64 Profiler::s_captureBeginNanoseconds = 0;
+uint64 Profiler::s_captureEndNanoseconds = 0;
+
+namespace {
+
+const uint64 s_overwriteMargin = 64;
+
+uint64 get_nanoseconds()
+{
+	return static_cast<uint64>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+// Buffers of every thread which recorded, kept until the process ends so a capture outlives its threads.
+std::mutex s_registryMutex;
+std::vector<std::unique_ptr<ProfilerThreadBuffer>>* s_threadBuffers = nullptr;
+std::unordered_set<std::string>* s_names = nullptr;
+
+void write_escaped(std::FILE* file, const char* text)
+{
+	for (; *text != '\0'; text++)
+	{
+		const char c = *text;
+		if (c == '"' || c == '\\')
+		{
+			std::fputc('\\', file);
+			std::fputc(c, file);
+		}
+		else if (static_cast<unsigned char>(c) < 0x20)
+		{
+			std::fprintf(file, "\\u%04x", c);
+		}
+		else
+		{
+			std::fputc(c, file);
+		}
+	}
+}
+
+}
+
+void Profiler::BeginCapture()
+{
+	s_captureBeginNanoseconds = get_nanoseconds();
+	s_captureBegin = GetTimestamp();
+	s_captureIndex.fetch_add(1, std::memory_order_relaxed);
+	s_isCapturing.store(true, std::memory_order_release);
+}
+
+void Profiler::EndCapture()
+{
+	s_isCapturing.store(false, std::memory_order_release);
+	s_captureEnd = GetTimestamp();
+	s_captureEndNanoseconds = get_nanoseconds();
+}
+
+bool Profiler::WriteChromeTrace(const std::string& path)
+{
+	GG_ASSERT(!IsCapturing(), "End the capture before writing it!");
+
+	std::FILE* file = std::fopen(path.c_str(), "wb");
+	if (file == nullptr)
+	{
+		GG_ERROR("Can't write the profiler trace to {0}.", path);
+		return false;
+	}
+
+	std::lock_guard<std::mutex> lock(s_registryMutex);
+	const uint32 captureIndex = s_captureIndex.load(std::memory_order_relaxed);
+	// Microseconds per TSC tick.
+	const double tickMicroseconds = s_captureEnd > s_captureBegin
+		? (s_captureEndNanoseconds - s_captureBeginNanoseconds) * 1e-3 / (s_captureEnd - s_captureBegin) : 1e-3;
+	bool isFirstEvent = true;
+	auto beginEvent = [&]() {
+		std::fputs(isFirstEvent ? "\n" : ",\n", file);
+		isFirstEvent = false;
+	};
+
+	std::fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", file);
+	if (s_threadBuffers != nullptr)
+	{
+		for (const auto& buffer : *s_threadBuffers)
+		{
+			if (buffer->captureIndex.load(std::memory_order_acquire) != captureIndex)
+			{
+				continue;
+			}
+
+			beginEvent();
+			std::fprintf(file, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"", buffer->threadId);
+			write_escaped(file, buffer->threadName.c_str());
+			std::fputs("\"}}", file);
+
+			const uint64 eventCount = buffer->eventCount.load(std::memory_order_acquire);
+			// A thread closing a zone right at EndCapture() may still overwrite the oldest slots of a full buffer, those are skipped.
+			const uint64 first = eventCount > s_eventCapacity ? eventCount - s_eventCapacity + s_overwriteMargin : 0;
+			for (uint64 i = first; i < eventCount; i++)
+			{
+				const ProfileEvent& event = buffer->events[i % s_eventCapacity];
+				if (event.begin < s_captureBegin)
+				{
+					continue;
+				}
+
+				beginEvent();
+				std::fputs("{\"name\":\"", file);
+				write_escaped(file, event.name);
+				std::fputs("\",\"cat\":\"", file);
+				write_escaped(file, event.category);
+				// Microseconds with nanosecond fractions.
+				std::fprintf(file, "\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}", buffer->threadId,
+					(event.begin - s_captureBegin) * tickMicroseconds, (event.end - event.begin) * tickMicroseconds);
+			}
+		}
+	}
+	std::fputs("\n]}\n", file);
+
+	const bool isWritten = std::ferror(file) == 0;
+	std::fclose(file);
+
+	return isWritten;
+}
+
+uint64 Profiler::GetEventCount()
+{
+	std::lock_guard<std::mutex> lock(s_registryMutex);
+	const uint32 captureIndex = s_captureIndex.load(std::memory_order_relaxed);
+	uint64 count = 0;
+	if (s_threadBuffers != nullptr)
+	{
+		for (const auto& buffer : *s_threadBuffers)
+		{
+			if (buffer->captureIndex.load(std::memory_order_acquire) == captureIndex)
+			{
+				count += std::min<uint64>(buffer->eventCount.load(std::memory_order_acquire), s_eventCapacity);
+			}
+		}
+	}
+
+	return count;
+}
+
+void Profiler::SetThreadName(const std::string& name)
+{
+	ProfilerThreadBuffer& buffer = getThreadBuffer();
+	std::lock_guard<std::mutex> lock(s_registryMutex);
+	buffer.threadName = name;
+}
+
+const char* Profiler::InternName(const std::string& name)
+{
+	std::lock_guard<std::mutex> lock(s_registryMutex);
+	if (s_names == nullptr)
+	{
+		s_names = new std::unordered_set<std::string>();
+	}
+
+	// Nodes of an unordered_set don't move, so the pointer stays valid across rehashes.
+	return s_names->insert(name).first->c_str();
+}
+
+void Profiler::Record(const char* name, const char* category, uint64 begin, uint64 end)
+{
+	ProfilerThreadBuffer& buffer = getThreadBuffer();
+	const uint32 captureIndex = s_captureIndex.load(std::memory_order_relaxed);
+	uint64 eventCount = buffer.eventCount.load(std::memory_order_relaxed);
+	if (buffer.captureIndex.load(std::memory_order_relaxed) != captureIndex)
+	{
+		if (!buffer.events)
+		{
+			buffer.events.reset(new ProfileEvent[s_eventCapacity]);
+		}
+		eventCount = 0;
+		buffer.eventCount.store(0, std::memory_order_relaxed);
+		buffer.captureIndex.store(captureIndex, std::memory_order_release);
+	}
+
+	buffer.events[eventCount % s_eventCapacity] = ProfileEvent{ name, category, begin, end };
+	buffer.eventCount.store(eventCount + 1, std::memory_order_release);
+}
+
+ProfilerThreadBuffer& Profiler::getThreadBuffer()
+{
+	// The registry owns the buffer, the thread only caches it.
+	thread_local ProfilerThreadBuffer* t_buffer = nullptr;
+	if (t_buffer == nullptr)
+	{
+		std::lock_guard<std::mutex> lock(s_registryMutex);
+		if (s_threadBuffers == nullptr)
+		{
+			s_threadBuffers = new std::vector<std::unique_ptr<ProfilerThreadBuffer>>();
+		}
+
+		auto buffer = std::make_unique<ProfilerThreadBuffer>();
+		buffer->threadId = static_cast<uint32>(s_threadBuffers->size()) + 1;
+		buffer->threadName = "Thread " + std::to_string(buffer->threadId);
+		t_buffer = buffer.get();
+		s_threadBuffers->push_back(std::move(buffer));
+	}
+
+	return *t_buffer;
+}
+
+}
\ No newline at end of file
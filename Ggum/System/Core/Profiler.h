@@ -0,0 +1,112 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <string>
+
+#include <immintrin.h>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+#include "Base.hpp"
+
+#include "Core/Log.h"
+
+namespace GG {
+
+struct ProfilerThreadBuffer;
+
+// Zone recorded by one thread, names have to outlive the capture (literals or Profiler::InternName()).
+struct ProfileEvent
+{
+	const char* name;
+	const char* category;
+	uint64 begin;
+	uint64 end;
+};
+
+// Low overhead CPU profiler of scoped zones, exported as a Chrome trace (chrome://tracing, ui.perfetto.dev).
+// Every thread records into its own ring buffer without locks, a full buffer overwrites its oldest events,
+// so a capture keeps the last s_eventCapacity zones of every thread. Zones are timed with the TSC,
+// which costs half of a steady_clock read, and converted to time with the rate measured over the capture.
+// Outside of a capture a zone costs one relaxed load, and the zone macros compile to nothing with GG_PROFILER_DISABLED.
+class Profiler
+{
+public:
+	static constexpr uint32			s_eventCapacity = 1 << 16;
+
+	// Starts recording from scratch, the previous capture is dropped.
+	static void BeginCapture();
+	// Stops recording. Zones which are still open on other threads are dropped.
+	static void EndCapture();
+	static inline bool IsCapturing() { return s_isCapturing.load(std::memory_order_relaxed); }
+
+	// Writes the last capture in the Chrome trace event format, returns false if the file can't be written.
+	static bool WriteChromeTrace(const std::string& path);
+	// Zones of the last capture on every thread.
+	static uint64 GetEventCount();
+
+	// Shown as the calling thread's name in the trace.
+	static void SetThreadName(const std::string& name);
+	// Returns a copy of name which lives until the process ends, equal names share it.
+	static const char* InternName(const std::string& name);
+
+	// TSC ticks, only meaningful relative to other timestamps of the same capture.
+	static inline uint64 GetTimestamp() { return __rdtsc(); }
+	static void Record(const char* name, const char* category, uint64 begin, uint64 end);
+
+private:
+	static ProfilerThreadBuffer& getThreadBuffer();
+
+	static std::atomic<bool>		s_isCapturing;
+	// Bumped by BeginCapture(), each thread resets its buffer when it records the first zone of a new capture.
+	static std::atomic<uint32>		s_captureIndex;
+	// TSC and steady_clock at both ends of the capture, the ratio converts zone timestamps to nanoseconds.
+	static uint64					s_captureBegin;
+	static uint64					s_captureEnd;
+	static uint64					s_captureBeginNanoseconds;
+	static uint64					s_captureEndNanoseconds;
+};
+
+class ProfileScope
+{
+public:
+	ProfileScope(const char* name, const char* category)
+		: _name{ name }
+		, _category{ category }
+		, _begin{ Profiler::IsCapturing() ? Profiler::GetTimestamp() : 0 }
+	{}
+
+	~ProfileScope()
+	{
+		if (_begin != 0 && Profiler::IsCapturing())
+		{
+			Profiler::Record(_name, _category, _begin, Profiler::GetTimestamp());
+		}
+	}
+
+	ProfileScope(const ProfileScope&) = delete;
+	ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+	const char* _name;
+	const char* _category;
+	uint64 _begin;
+};
+
+}
+
+#define GG_PROFILE_CONCAT_IMPL(a, b) a##b
+#define GG_PROFILE_CONCAT(a, b) GG_PROFILE_CONCAT_IMPL(a, b)
+
+#ifdef GG_PROFILER_ENABLED
+	#define GG_PROFILE_SCOPE_CATEGORY(name, category) ::GG::ProfileScope GG_PROFILE_CONCAT(ggProfileScope, __LINE__)(name, category)
+	#define GG_PROFILE_SCOPE(name) GG_PROFILE_SCOPE_CATEGORY(name, "GG")
+	#define GG_PROFILE_FUNCTION() GG_PROFILE_SCOPE(__func__)
+#else
+	#define GG_PROFILE_SCOPE_CATEGORY(name, category)
+	#define GG_PROFILE_SCOPE(name)
+	#define GG_PROFILE_FUNCTION()
+#endif
\ No newline at end of file
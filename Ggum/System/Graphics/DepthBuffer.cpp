@@ -0,0 +1,105 @@
+#include "SystemPch.h"
+
+#include "DepthBuffer.h"
+#include "Utility/Simd.hpp"
+
+namespace GG {
+
+// Morton offsets inside an 8x8 block, the same order as TextureBuffer's tiled layout.
+static constexpr uint8 s_mortonX[DepthBuffer::s_blockSize]{ 0, 1, 4, 5, 16, 17, 20, 21 };
+static constexpr uint8 s_mortonY[DepthBuffer::s_blockSize]{ 0, 2, 8, 10, 32, 34, 40, 42 };
+
+DepthBuffer::DepthBuffer()
+	: _width{ 0 }
+	, _height{ 0 }
+	, _layout{ eTextureLayout::Linear }
+	, _blockColumns{ 0 }
+	, _blockRows{ 0 }
+	, _clearDepth{ 1.0f }
+{
+
+}
+
+void DepthBuffer::Create(uint32 width, uint32 height, eTextureLayout layout)
+{
+	GG_ASSERT(width != 0 && height != 0, "DepthBuffer size should't be zero!");
+
+	_width = width;
+	_height = height;
+	_layout = layout;
+	_blockColumns = (width + s_blockSize - 1) / s_blockSize;
+	_blockRows = (height + s_blockSize - 1) / s_blockSize;
+
+	const size_t blockCount = static_cast<size_t>(_blockColumns) * _blockRows;
+	_depths.assign(blockCount * s_blockPixels, 0.0f);
+	_blockMinDepths.resize(blockCount);
+	_blockMaxDepths.resize(blockCount);
+	_pendingClears.resize(blockCount);
+
+	Clear(_clearDepth);
+}
+
+void DepthBuffer::Release()
+{
+	_depths.clear();
+	_blockMinDepths.clear();
+	_blockMaxDepths.clear();
+	_pendingClears.clear();
+	_width = 0;
+	_height = 0;
+	_blockColumns = 0;
+	_blockRows = 0;
+}
+
+void DepthBuffer::Clear(float depth)
+{
+	_clearDepth = depth;
+	std::fill(_blockMinDepths.begin(), _blockMinDepths.end(), depth);
+	std::fill(_blockMaxDepths.begin(), _blockMaxDepths.end(), depth);
+	std::fill(_pendingClears.begin(), _pendingClears.end(), 1);
+}
+
+float DepthBuffer::GetDepth(int32 row, int32 col) const
+{
+	if (static_cast<uint32>(row) >= _height || static_cast<uint32>(col) >= _width)
+	{
+		return 1.0f;
+	}
+
+	const size_t index = blockIndex(static_cast<uint32>(row), static_cast<uint32>(col));
+	if (_pendingClears[index])
+	{
+		return _clearDepth;
+	}
+
+	const uint32 x = static_cast<uint32>(col) % s_blockSize;
+	const uint32 y = static_cast<uint32>(row) % s_blockSize;
+	const uint32 offset = _layout == eTextureLayout::Linear ? y * s_blockSize + x : s_mortonY[y] + s_mortonX[x];
+
+	return _depths[index * s_blockPixels + offset];
+}
+
+void DepthBuffer::UpdateBlockBounds(uint32 row, uint32 col)
+{
+	const size_t index = blockIndex(row, col);
+	const float* block = _depths.data() + index * s_blockPixels;
+
+	// Padding pixels of blocks on the right and bottom border keep the clear depth, which only widens the bounds.
+	__m128 minDepth = _mm_loadu_ps(block);
+	__m128 maxDepth = minDepth;
+	for (uint32 i = 4; i < s_blockPixels; i += 4)
+	{
+		const __m128 depth = _mm_loadu_ps(block + i);
+		minDepth = _mm_min_ps(minDepth, depth);
+		maxDepth = _mm_max_ps(maxDepth, depth);
+	}
+	minDepth = _mm_min_ps(minDepth, _mm_shuffle_ps(minDepth, minDepth, _MM_SHUFFLE(1, 0, 3, 2)));
+	minDepth = _mm_min_ps(minDepth, _mm_shuffle_ps(minDepth, minDepth, _MM_SHUFFLE(2, 3, 0, 1)));
+	maxDepth = _mm_max_ps(maxDepth, _mm_shuffle_ps(maxDepth, maxDepth, _MM_SHUFFLE(1, 0, 3, 2)));
+	maxDepth = _mm_max_ps(maxDepth, _mm_shuffle_ps(maxDepth, maxDepth, _MM_SHUFFLE(2, 3, 0, 1)));
+
+	_blockMinDepths[index] = _mm_cvtss_f32(minDepth);
+	_blockMaxDepths[index] = _mm_cvtss_f32(maxDepth);
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <vector>
+
+#include "Base.hpp"
+
+#include "Core/Log.h"
+#include "Graphics/TextureBuffer.h"
+
+namespace GG {
+
+// CPU depth buffer for the rasterizer, 32-bit float depth in [0, 1], smaller is closer.
+// Depths are stored in TextureBuffer::s_blockSize blocks of 64 contiguous values, in the same pixel order as the blocks of a
+// TextureBuffer with the same layout, so the rasterizer reads depth and color with the same lane offsets.
+// Every block keeps the min/max of its depths as a coarse Z level: the rasterizer rejects whole blocks against the max
+// before any per pixel test. Clearing is lazy like TextureBuffer::Clear(), only the block flags and bounds are reset.
+class DepthBuffer
+{
+public:
+	static constexpr uint32			s_blockSize = TextureBuffer::s_blockSize;
+	static constexpr uint32			s_blockPixels = s_blockSize * s_blockSize;
+
+	DepthBuffer();
+	~DepthBuffer() = default;
+
+	DepthBuffer(const DepthBuffer&) = delete;
+	DepthBuffer& operator=(const DepthBuffer&) = delete;
+
+	void Create(uint32 width, uint32 height, eTextureLayout layout = eTextureLayout::Linear);
+	void Release();
+	// O(blocks), no depth is touched until its block is written again.
+	void Clear(float depth = 1.0f);
+
+	// Returns 1 outside of the buffer.
+	float GetDepth(int32 row, int32 col) const;
+
+	// Raw block access for rasterizers, row and col are multiples of s_blockSize. The block is cleared first if it's pending.
+	inline float* GetBlockForWrite(uint32 row, uint32 col);
+	// Bounds of a block's depths, conservative until UpdateBlockBounds() is called after writing it.
+	inline float GetBlockMinDepth(uint32 row, uint32 col) const { return _blockMinDepths[blockIndex(row, col)]; }
+	inline float GetBlockMaxDepth(uint32 row, uint32 col) const { return _blockMaxDepths[blockIndex(row, col)]; }
+	void UpdateBlockBounds(uint32 row, uint32 col);
+
+	inline uint32 GetWidth() const { return _width; }
+	inline uint32 GetHeight() const { return _height; }
+	inline eTextureLayout GetLayout() const { return _layout; }
+	inline bool IsCreated() const { return !_depths.empty(); }
+	inline float GetClearDepth() const { return _clearDepth; }
+
+private:
+	inline size_t blockIndex(uint32 row, uint32 col) const { return static_cast<size_t>(row / s_blockSize) * _blockColumns + col / s_blockSize; }
+
+	std::vector<float>				_depths;
+	std::vector<float>				_blockMinDepths;
+	std::vector<float>				_blockMaxDepths;
+	// One byte per block, non-zero while the block still has to be filled with the clear depth.
+	std::vector<uint8>				_pendingClears;
+	uint32							_width;
+	uint32							_height;
+	eTextureLayout					_layout;
+	uint32							_blockColumns;
+	uint32							_blockRows;
+	float							_clearDepth;
+};
+
+// Inline since rasterizers call it for every block they touch.
+inline float* DepthBuffer::GetBlockForWrite(uint32 row, uint32 col)
+{
+	GG_ASSERT(row % s_blockSize == 0 && col % s_blockSize == 0 && row < _height && col < _width, "Block is out of the buffer!");
+
+	const size_t index = blockIndex(row, col);
+	float* block = _depths.data() + index * s_blockPixels;
+	if (_pendingClears[index])
+	{
+		std::fill(block, block + s_blockPixels, _clearDepth);
+		_pendingClears[index] = 0;
+	}
+
+	return block;
+}
+
+}
\ No newline at end of file
@@ -3,6 +3,7 @@
 
 #include "GraphicsAPI.h"
 #include "Core/Log.h"
+#include "Core/Profiler.h"
 #include "Utility/Utility.hpp"
 
 #include <vulkan/vulkan_win32.h>
@@ -30,6 +31,25 @@ static std::vector<const char*> layerExtensions
 	VK_KHR_WIN32_SURFACE_EXTENSION_NAME,
 };
 
+// bufferOffset points at the region's first pixel, rowLength is the pitch of the source in pixels.
+static VkBufferImageCopy make_copy_region(VkDeviceSize bufferOffset, uint32 rowLength, const TextureRegion& region)
+{
+	VkBufferImageCopy copyRegion{};
+	copyRegion.bufferOffset = bufferOffset;
+	copyRegion.bufferRowLength = rowLength;
+	copyRegion.bufferImageHeight = 0;
+
+	copyRegion.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+	copyRegion.imageSubresource.mipLevel = 0;
+	copyRegion.imageSubresource.baseArrayLayer = 0;
+	copyRegion.imageSubresource.layerCount = 1;
+
+	copyRegion.imageOffset = { static_cast<int32>(region.x), static_cast<int32>(region.y), 0 };
+	copyRegion.imageExtent = { region.width, region.height, 1 };
+
+	return copyRegion;
+}
+
 
 GraphicsAPI::GraphicsAPI(HWND hWnd, uint32 frameBufferWidth, uint32 frameBufferHeight)
 	: _hWnd{ hWnd }
@@ -46,13 +66,28 @@ GraphicsAPI::GraphicsAPI(HWND hWnd, uint32 frameBufferWidth, uint32 frameBufferH
 	, _pipeline{ nullptr }
 	, _commandPool{ nullptr }
 	, _descriptorPool{ nullptr }
+	, _stagingBuffer{ nullptr }
+	, _stagingBufferMemory{ nullptr }
+	, _stagingData{ nullptr }
+	, _stagingSlotSize{ 0 }
+	, _stagingClearOffset{ 0 }
+	, _stagingClearColors{ 0, 0, 0 }
 	, _submitIndex{ 0 }
+	, _framesInFlight{ s_maxSubmitIndex }
+	, _pendingFramesInFlight{ s_maxSubmitIndex }
 	, _frameBufferWidth{ frameBufferWidth }
 	, _frameBufferHeight{ frameBufferHeight }
+	, _textureWidth{ frameBufferWidth }
+	, _textureHeight{ frameBufferHeight }
+	, _frameBufferLayout{ eTextureLayout::Linear }
+	, _textureLayout{ eTextureLayout::Linear }
+	, _clearColor{ 0 }
+	, _isClearEnabled{ true }
+	, _multisampleBuffer{ nullptr }
+	, _uploadedClearColor{ 0 }
+	, _backBufferState{ eBackBufferState::Free }
 	, _isBeginCalled{ false, false, false }
 	, _isMinimized{ false }
-	, _textureBuffer{ nullptr }
-	, _needUpdateTexture{ false }
 {
 
 }
@@ -83,6 +118,7 @@ void GraphicsAPI::Init()
 	createFrameBuffers();
 	createCommandPool();
 	createCommandBuffers();
+	createStagingBuffers(_textureWidth, _textureHeight);
 	createTextureImage();
 	createTextureImageView();
 	createTextureSampler();
@@ -201,7 +237,7 @@ void GraphicsAPI::initImGui()
 
 void GraphicsAPI::Draw()
 {
-	if (!_isBeginCalled[_imageIndex])
+	if (!_isBeginCalled[_submitIndex])
 	{
 		return;
 	}
@@ -209,18 +245,19 @@ void GraphicsAPI::Draw()
 	{
 		return;
 	}
-	if (_needUpdateTexture)
+	if (_backBufferState == eBackBufferState::Acquired)
 	{
-		updateTextureImage();
+		ReleaseBackBuffer();
 	}
+	updateTextureImage();
 
-	beginRenderPass(_commandBuffers[_imageIndex], _swapChainFramebuffers[_imageIndex]);
-	bindPipeline(_commandBuffers[_imageIndex], _pipeline);
-	bindDescriptorSets(_commandBuffers[_imageIndex]);
-	setViewport(_commandBuffers[_imageIndex], 0.0f, 0.0f, static_cast<float>(_swapChainExtent.width), static_cast<float>(_swapChainExtent.height));
-	setScissor(_commandBuffers[_imageIndex], 0, 0);
-	draw(_commandBuffers[_imageIndex], 6, 1, 0, 0);
-	endRenderPass(_commandBuffers[_imageIndex]);
+	beginRenderPass(_commandBuffers[_submitIndex], _swapChainFramebuffers[_imageIndex]);
+	bindPipeline(_commandBuffers[_submitIndex], _pipeline);
+	bindDescriptorSets(_commandBuffers[_submitIndex]);
+	setViewport(_commandBuffers[_submitIndex], 0.0f, 0.0f, static_cast<float>(_swapChainExtent.width), static_cast<float>(_swapChainExtent.height));
+	setScissor(_commandBuffers[_submitIndex], 0, 0);
+	draw(_commandBuffers[_submitIndex], 6, 1, 0, 0);
+	endRenderPass(_commandBuffers[_submitIndex]);
 }
 
 void GraphicsAPI::WaitDeviceIdle()
@@ -236,11 +273,7 @@ void GraphicsAPI::Release()
 	vkDestroyImageView(_device, _textureImageView, nullptr);
 	vkDestroyImage(_device, _textureImage, nullptr);
 	vkFreeMemory(_device, _textureImageMemory, nullptr);
-	if (_textureBuffer)
-	{
-		delete[] _textureBuffer;
-		_textureBuffer = nullptr;
-	}
+	destroyStagingBuffers();
 
 	for (size_t i = 0; i < s_maxSubmitIndex; i++)
 	{
@@ -269,22 +302,23 @@ void GraphicsAPI::Release()
 
 void GraphicsAPI::RenderImGui()
 {
-	if (!_isBeginCalled[_imageIndex]) return;
+	if (!_isBeginCalled[_submitIndex]) return;
 
-	beginRenderPass(_commandBuffers[_imageIndex], _swapChainFramebuffers[_imageIndex]);
+	beginRenderPass(_commandBuffers[_submitIndex], _swapChainFramebuffers[_imageIndex]);
 
 	ImDrawData* mainDrawData = ImGui::GetDrawData();
 
-	ImGui_ImplVulkan_RenderDrawData(mainDrawData, _commandBuffers[_imageIndex]);
+	ImGui_ImplVulkan_RenderDrawData(mainDrawData, _commandBuffers[_submitIndex]);
 
-	endRenderPass(_commandBuffers[_imageIndex]);
+	endRenderPass(_commandBuffers[_submitIndex]);
 }
 
 
 void GraphicsAPI::Begin()
 {
+	AcquireBackBuffer();
+
 	if (_isMinimized) return;
-	vkWaitForFences(_device, 1, &_inFlightFences[_submitIndex], VK_TRUE, UINT64_MAX);
 
 	VkResult result = vkAcquireNextImageKHR(_device, _swapChain, UINT64_MAX, _imageAvailableSemaphores[_submitIndex], VK_NULL_HANDLE, &_imageIndex);
 
@@ -306,19 +340,22 @@ void GraphicsAPI::Begin()
 	// Mark the image as now being in use by this frame
 	_imagesInFlight[_imageIndex] = _inFlightFences[_submitIndex];
 
-	vkResetCommandBuffer(_commandBuffers[_imageIndex], 0);
+	vkResetCommandBuffer(_commandBuffers[_submitIndex], 0);
 
-	beginCommandBuffer(_commandBuffers[_imageIndex]);
+	beginCommandBuffer(_commandBuffers[_submitIndex]);
 
-	_isBeginCalled[_imageIndex] = true;
+	_isBeginCalled[_submitIndex] = true;
 }
 
 void GraphicsAPI::End()
 {
-	if (!_isBeginCalled[_imageIndex]) return;
+	// A frame which isn't submitted is dropped, the next acquire clears its back buffer again.
+	_backBufferState = eBackBufferState::Free;
+
+	if (!_isBeginCalled[_submitIndex]) return;
 	if (_isMinimized) return;
 
-	endCommandBuffer(_commandBuffers[_imageIndex]);
+	endCommandBuffer(_commandBuffers[_submitIndex]);
 
 	VkPipelineStageFlags waitStage = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
 	VkSubmitInfo submitInfo{};
@@ -327,13 +364,13 @@ void GraphicsAPI::End()
 	submitInfo.pWaitSemaphores = &_imageAvailableSemaphores[_submitIndex];
 	submitInfo.pWaitDstStageMask = &waitStage;
 	submitInfo.commandBufferCount = 1;
-	submitInfo.pCommandBuffers = &_commandBuffers[_imageIndex];
+	submitInfo.pCommandBuffers = &_commandBuffers[_submitIndex];
 	submitInfo.signalSemaphoreCount = 1;
 	submitInfo.pSignalSemaphores = &_renderFinishedSemaphores[_submitIndex];
 
-	vkResetFences(_device, 1, &_inFlightFences[_imageIndex]);
+	vkResetFences(_device, 1, &_inFlightFences[_submitIndex]);
 
-	if (vkQueueSubmit(_graphicsQueue, 1, &submitInfo, _inFlightFences[_imageIndex]) != VK_SUCCESS)
+	if (vkQueueSubmit(_graphicsQueue, 1, &submitInfo, _inFlightFences[_submitIndex]) != VK_SUCCESS)
 	{
 		GG_CRITICAL("Fail to submit graphics queue to Render ImGui!");
 	}
@@ -358,45 +395,109 @@ void GraphicsAPI::End()
 		GG_CRITICAL("Fail to present graphics queue!");
 	}
 
-	_submitIndex = (_submitIndex + 1) % s_maxSubmitIndex;
-
-	_isBeginCalled[_imageIndex] = false;
+	_isBeginCalled[_submitIndex] = false;
 
-	clearTextureImage();
+	_submitIndex = (_submitIndex + 1) % _framesInFlight;
 }
 
-void GraphicsAPI::SetPixel(uint32 row, uint32 col, uint8* color)
+TextureBuffer& GraphicsAPI::AcquireBackBuffer()
 {
-	if (row >= _textureHeight || col >= _textureWidth)
-	{
-		return;
-	}
-	uint32 index = (_textureWidth * row + col) * _textureChannel;
-	for (uint32 i = 0; i < 4; i++)
+	if (_backBufferState != eBackBufferState::Free)
 	{
-		_textureBuffer[index + i] = color[i];
+		return currentTextureBuffer();
 	}
 
-	// TODO: Need set dirty system!
-	_needUpdateTexture = true;
+	applyFramesInFlight();
+	applyFramebufferChanges();
+
+	// The GPU may still be copying out of this slot's staging memory until its fence is signaled.
+	vkWaitForFences(_device, 1, &_inFlightFences[_submitIndex], VK_TRUE, UINT64_MAX);
+	clearTextureImage();
+
+	_backBufferState = eBackBufferState::Acquired;
+
+	return currentTextureBuffer();
+}
+
+void GraphicsAPI::ReleaseBackBuffer()
+{
+	GG_ASSERT(_backBufferState == eBackBufferState::Acquired, "Back buffer is not acquired!");
+
+	_backBufferState = eBackBufferState::Released;
+}
+
+void GraphicsAPI::SetFramebufferSize(uint32 width, uint32 height)
+{
+	GG_ASSERT(width != 0 && height != 0, "Framebuffer size should't be zero!");
+
+	_frameBufferWidth = width;
+	_frameBufferHeight = height;
+}
+
+void GraphicsAPI::SetFramesInFlight(uint32 count)
+{
+	_pendingFramesInFlight = Utility::clamp(count, 1u, s_maxSubmitIndex);
+}
+
+void GraphicsAPI::SetPixel(uint32 row, uint32 col, uint8* color)
+{
+	backBuffer().SetPixel(static_cast<int32>(row), static_cast<int32>(col), PackColor(color));
 }
 
 void GraphicsAPI::SetPixel(uint32 row, uint32 col, uint8 r, uint8 g, uint8 b, uint8 a)
 {
-	uint8 color[]{ r, g, b, a };
-	SetPixel(row, col, color);
+	backBuffer().SetPixel(static_cast<int32>(row), static_cast<int32>(col), PackColor(r, g, b, a));
 }
 
 void GraphicsAPI::SetPixel(uint32 row, uint32 col, float* color)
 {
-	uint8 u8color[]{ static_cast<uint8>(color[0] * 255.0f), static_cast<uint8>(color[1] * 255.0f) ,static_cast<uint8>(color[2] * 255.0f) ,static_cast<uint8>(color[3] * 255.0f) };
-	SetPixel(row, col, u8color);
+	backBuffer().SetPixel(static_cast<int32>(row), static_cast<int32>(col), PackColor(color));
 }
 
 void GraphicsAPI::SetPixel(uint32 row, uint32 col, float r, float g, float b, float a)
 {
-	uint8 u8color[]{ static_cast<uint8>(r * 255.0f), static_cast<uint8>(g * 255.0f), static_cast<uint8>(b * 255.0f), static_cast<uint8>(a * 255.0f) };
-	SetPixel(row, col, u8color);
+	float color[]{ r, g, b, a };
+	backBuffer().SetPixel(static_cast<int32>(row), static_cast<int32>(col), PackColor(color));
+}
+
+void GraphicsAPI::FillSpan(int32 row, int32 col, uint32 count, uint32 color)
+{
+	backBuffer().FillSpan(row, col, count, color);
+}
+
+void GraphicsAPI::FillRect(int32 row, int32 col, uint32 width, uint32 height, uint32 color)
+{
+	backBuffer().FillRect(row, col, width, height, color);
+}
+
+void GraphicsAPI::WriteRow(int32 row, int32 col, const uint32* src, uint32 count)
+{
+	backBuffer().WriteRow(row, col, src, count);
+}
+
+void GraphicsAPI::BlitRect(int32 row, int32 col, uint32 width, uint32 height, const uint32* src, uint32 srcPitch)
+{
+	backBuffer().BlitRect(row, col, width, height, src, srcPitch);
+}
+
+void GraphicsAPI::BlendSpan(int32 row, int32 col, uint32 count, uint32 color, eBlendMode mode, bool isGammaCorrect)
+{
+	backBuffer().BlendSpan(row, col, count, color, mode, isGammaCorrect);
+}
+
+void GraphicsAPI::BlendColorRect(int32 row, int32 col, uint32 width, uint32 height, uint32 color, eBlendMode mode, bool isGammaCorrect)
+{
+	backBuffer().BlendColorRect(row, col, width, height, color, mode, isGammaCorrect);
+}
+
+void GraphicsAPI::BlendRow(int32 row, int32 col, const uint32* src, uint32 count, eBlendMode mode, bool isGammaCorrect)
+{
+	backBuffer().BlendRow(row, col, src, count, mode, isGammaCorrect);
+}
+
+void GraphicsAPI::BlendRect(int32 row, int32 col, uint32 width, uint32 height, const uint32* src, uint32 srcPitch, eBlendMode mode, bool isGammaCorrect)
+{
+	backBuffer().BlendRect(row, col, width, height, src, srcPitch, mode, isGammaCorrect);
 }
 
 void GraphicsAPI::createInstance()
@@ -982,6 +1083,18 @@ void GraphicsAPI::createBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMe
 }
 
 uint32 GraphicsAPI::findMemoryType(uint32 typeFilter, VkMemoryPropertyFlags properties)
+{
+	int32 index = findMemoryTypeIndex(typeFilter, properties);
+	if (index < 0)
+	{
+		GG_CRITICAL("Failed to find suitable memory type!");
+		return 0;
+	}
+
+	return static_cast<uint32>(index);
+}
+
+int32 GraphicsAPI::findMemoryTypeIndex(uint32 typeFilter, VkMemoryPropertyFlags properties)
 {
 	VkPhysicalDeviceMemoryProperties memProperties;
 	vkGetPhysicalDeviceMemoryProperties(_physicalDevice, &memProperties);
@@ -990,12 +1103,11 @@ uint32 GraphicsAPI::findMemoryType(uint32 typeFilter, VkMemoryPropertyFlags prop
 	{
 		if (typeFilter & BIT(i) && (memProperties.memoryTypes[i].propertyFlags & properties) == properties)
 		{
-			return i;
+			return static_cast<int32>(i);
 		}
 	}
 
-	GG_CRITICAL("Failed to find suitable memory type!");
-	return 0;
+	return -1;
 }
 
 void GraphicsAPI::createImage(uint32_t width, uint32_t height, VkFormat format, VkImageTiling tiling, VkImageUsageFlags usage, VkMemoryPropertyFlags properties, VkImage& image, VkDeviceMemory& imageMemory)
@@ -1041,20 +1153,6 @@ void GraphicsAPI::createImage(uint32_t width, uint32_t height, VkFormat format,
 
 void GraphicsAPI::createTextureImage()
 {
-	VkDeviceSize size = _textureWidth * _textureHeight * _textureChannel;
-
-	GG_ASSERT(size != 0, "Size should't be zero!");
-
-	VkBuffer stagingBuffer;
-	VkDeviceMemory stagingBufferMemory;
-
-	createBuffer(size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, stagingBuffer, stagingBufferMemory);
-
-	void* data;
-	vkMapMemory(_device, stagingBufferMemory, 0, size, 0, &data);
-	::memcpy(data, _textureBuffer, static_cast<size_t>(size));
-	vkUnmapMemory(_device, stagingBufferMemory);
-
 	createImage(_textureWidth,
 		_textureHeight,
 		VK_FORMAT_R8G8B8A8_UNORM,
@@ -1065,12 +1163,24 @@ void GraphicsAPI::createTextureImage()
 		_textureImageMemory
 	);
 
-	transitionImageLayout(_textureImage, VK_FORMAT_R8G8B8A8_UNORM, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
-	copyBufferToImage(stagingBuffer, _textureImage, _textureWidth, _textureHeight);
-	transitionImageLayout(_textureImage, VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+	VkCommandBuffer commandBuffer = beginSingleTimeCommands();
+
+	transitionImageLayout(commandBuffer, _textureImage, VK_FORMAT_R8G8B8A8_UNORM, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+
+	// Every tile of a new image holds the clear color 0.
+	VkClearColorValue clearColor{};
+	VkImageSubresourceRange range{};
+	range.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+	range.baseMipLevel = 0;
+	range.levelCount = 1;
+	range.baseArrayLayer = 0;
+	range.layerCount = 1;
+	vkCmdClearColorImage(commandBuffer, _textureImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, &clearColor, 1, &range);
+	_uploadedClearColor = 0;
 
-	vkDestroyBuffer(_device, stagingBuffer, nullptr);
-	vkFreeMemory(_device, stagingBufferMemory, nullptr);
+	transitionImageLayout(commandBuffer, _textureImage, VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+
+	endSingleTimeCommands(commandBuffer);
 }
 
 void GraphicsAPI::createTextureSampler()
@@ -1106,31 +1216,111 @@ void GraphicsAPI::createTextureSampler()
 
 void GraphicsAPI::updateTextureImage()
 {
-	// TODO: Update Texture
-	VkDeviceSize size = _textureWidth * _textureHeight * _textureChannel;
-	VkBuffer stagingBuffer;
-	VkDeviceMemory stagingBufferMemory;
+	GG_PROFILE_SCOPE("GraphicsAPI::updateTextureImage");
+	GG_ASSERT(_backBufferState == eBackBufferState::Released, "Back buffer should be released before the upload!");
 
-	createBuffer(size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, stagingBuffer, stagingBufferMemory);
+	// Written tiles are copied from the back buffer.
+	// Tiles which aren't written go back to the clear color if the image holds something else there.
+	TextureBuffer& textureBuffer = currentTextureBuffer();
+	if (_multisampleBuffer && _multisampleBuffer->GetSplitBlockCount() != 0)
+	{
+		_multisampleBuffer->Resolve(textureBuffer);
+	}
+	const std::vector<uint8>& writtenTiles = textureBuffer.GetWrittenTiles();
+	const uint32 clearColor = textureBuffer.GetClearColor();
+	const bool isClearColorChanged = _isClearEnabled && clearColor != _uploadedClearColor;
 
-	void* data;
-	vkMapMemory(_device, stagingBufferMemory, 0, size, 0, &data);
-	::memcpy(data, _textureBuffer, static_cast<size_t>(size));
-	vkUnmapMemory(_device, stagingBufferMemory);
+	uint32 writtenTileCount = 0;
+	uint32 clearedTileCount = 0;
+	for (size_t i = 0; i < writtenTiles.size(); i++)
+	{
+		uint8 isCleared = !writtenTiles[i] && _isClearEnabled && (_uploadedTiles[i] || isClearColorChanged);
+		_uploadTileMask[i] = writtenTiles[i];
+		_clearTileMask[i] = isCleared;
+		_uploadedTiles[i] = writtenTiles[i] || (_uploadedTiles[i] && !isCleared);
 
-	transitionImageLayout(_textureImage, VK_FORMAT_R8G8B8A8_UNORM, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
-	copyBufferToImage(stagingBuffer, _textureImage, _textureWidth, _textureHeight);
-	transitionImageLayout(_textureImage, VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+		writtenTileCount += writtenTiles[i] ? 1 : 0;
+		clearedTileCount += isCleared;
+	}
+	if (_isClearEnabled)
+	{
+		_uploadedClearColor = clearColor;
+	}
+
+	_uploadStatistics.dirtyTileCount = writtenTileCount + clearedTileCount;
+	_uploadStatistics.clearedTileCount = clearedTileCount;
+	_uploadStatistics.totalTileCount = textureBuffer.GetTileCount();
+	_uploadStatistics.regionCount = 0;
+	_uploadStatistics.uploadedBytes = 0;
+
+	if (writtenTileCount + clearedTileCount == 0)
+	{
+		return;
+	}
+
+	const uint32 pitch = textureBuffer.GetWidth();
+	const VkDeviceSize slotOffset = _stagingSlotSize * _submitIndex;
+	_uploadCopies.clear();
+
+	// A linear texture buffer already lives in its staging slot, the regions are copied straight from there.
+	textureBuffer.BuildRegions(_uploadTileMask, _uploadRegions);
+	uint32* slotPixels = reinterpret_cast<uint32*>(_stagingData + slotOffset);
+	for (const auto& region : _uploadRegions)
+	{
+		if (textureBuffer.GetLayout() != eTextureLayout::Linear)
+		{
+			textureBuffer.Resolve(region, slotPixels + static_cast<size_t>(region.y) * pitch + region.x, pitch);
+		}
+
+		VkDeviceSize offset = slotOffset + (static_cast<VkDeviceSize>(region.y) * pitch + region.x) * sizeof(uint32);
+		_uploadCopies.push_back(make_copy_region(offset, pitch, region));
+		_uploadStatistics.uploadedBytes += static_cast<uint64>(region.width) * region.height * sizeof(uint32);
+	}
+
+	if (clearedTileCount > 0)
+	{
+		uint32* clearStrip = reinterpret_cast<uint32*>(_stagingData + slotOffset + _stagingClearOffset);
+		if (_stagingClearColors[_submitIndex] != clearColor)
+		{
+			PixelKernel::Fill(clearStrip, clearColor, pitch * TextureBuffer::s_tileSize);
+			_stagingClearColors[_submitIndex] = clearColor;
+		}
 
-	vkDestroyBuffer(_device, stagingBuffer, nullptr);
-	vkFreeMemory(_device, stagingBufferMemory, nullptr);
+		// Every tile row of a cleared region reads the same strip, only bandwidth for the image writes is spent.
+		textureBuffer.BuildRegions(_clearTileMask, _clearRegions);
+		for (const auto& region : _clearRegions)
+		{
+			for (uint32 row = region.y; row < region.y + region.height; row += TextureBuffer::s_tileSize)
+			{
+				TextureRegion tileRow{ region.x, row, region.width, std::min(TextureBuffer::s_tileSize, region.y + region.height - row) };
+				VkDeviceSize offset = slotOffset + _stagingClearOffset + static_cast<VkDeviceSize>(region.x) * sizeof(uint32);
+				_uploadCopies.push_back(make_copy_region(offset, pitch, tileRow));
+			}
+		}
+	}
+	_uploadStatistics.regionCount = static_cast<uint32>(_uploadCopies.size());
 
-	_needUpdateTexture = false;
+	// Recorded ahead of the render pass in the frame's own command buffer, the barriers order it against the previous frame's sampling.
+	// Keep the untouched tiles, so the image can't be transitioned from VK_IMAGE_LAYOUT_UNDEFINED.
+	VkCommandBuffer commandBuffer = _commandBuffers[_submitIndex];
+	transitionImageLayout(commandBuffer, _textureImage, VK_FORMAT_R8G8B8A8_UNORM, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+	copyBufferToImage(commandBuffer, _stagingBuffer, _textureImage, _uploadCopies);
+	transitionImageLayout(commandBuffer, _textureImage, VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
 }
 
 void GraphicsAPI::clearTextureImage()
 {
-	::memset(_textureBuffer, 0, _textureWidth * _textureHeight * _textureChannel);
+	// Without clearing the written flags are still reset, keeping the buffer's own clear color, so only this frame's tiles are uploaded.
+	// The slot's older tiles are frames behind the image when several frames are in flight.
+	TextureBuffer& textureBuffer = currentTextureBuffer();
+	textureBuffer.Clear(_isClearEnabled ? _clearColor : textureBuffer.GetClearColor());
+}
+
+TextureBuffer& GraphicsAPI::backBuffer()
+{
+	GG_ASSERT(_backBufferState == eBackBufferState::Acquired, "Writing to a back buffer which isn't acquired!");
+
+	return currentTextureBuffer();
 }
 
 void GraphicsAPI::createTextureImageView()
@@ -1173,38 +1363,22 @@ void GraphicsAPI::endSingleTimeCommands(VkCommandBuffer commandBuffer)
 	vkFreeCommandBuffers(_device, _commandPool, 1, &commandBuffer);
 }
 
-void GraphicsAPI::copyBufferToImage(VkBuffer buffer, VkImage image, uint32 width, uint32 height)
+void GraphicsAPI::copyBufferToImage(VkCommandBuffer commandBuffer, VkBuffer buffer, VkImage image, const std::vector<VkBufferImageCopy>& copies)
 {
-	VkCommandBuffer commandBuffer = beginSingleTimeCommands();
-
-	VkBufferImageCopy region = {};
-	region.bufferOffset = 0;
-	region.bufferRowLength = 0;
-	region.bufferImageHeight = 0;
-
-	region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-	region.imageSubresource.mipLevel = 0;
-	region.imageSubresource.baseArrayLayer = 0;
-	region.imageSubresource.layerCount = 1;
-
-	region.imageOffset = { 0, 0, 0 };
-	region.imageExtent =
-	{
-		width,
-		height,
-		1
-	};
+	vkCmdCopyBufferToImage(commandBuffer, buffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, static_cast<uint32>(copies.size()), copies.data());
+}
 
-	vkCmdCopyBufferToImage(commandBuffer, buffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+void GraphicsAPI::transitionImageLayout(VkImage image, VkFormat format, VkImageLayout oldLayout, VkImageLayout newLayout)
+{
+	VkCommandBuffer commandBuffer = beginSingleTimeCommands();
 
+	transitionImageLayout(commandBuffer, image, format, oldLayout, newLayout);
 
 	endSingleTimeCommands(commandBuffer);
 }
 
-void GraphicsAPI::transitionImageLayout(VkImage image, VkFormat format, VkImageLayout oldLayout, VkImageLayout newLayout)
+void GraphicsAPI::transitionImageLayout(VkCommandBuffer commandBuffer, VkImage image, VkFormat format, VkImageLayout oldLayout, VkImageLayout newLayout)
 {
-	VkCommandBuffer commandBuffer = beginSingleTimeCommands();
-
 	VkImageMemoryBarrier barrier{};
 	barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
 	barrier.oldLayout = oldLayout;
@@ -1239,6 +1413,14 @@ void GraphicsAPI::transitionImageLayout(VkImage image, VkFormat format, VkImageL
 		sourceStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
 		destinationStage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
 	}
+	else if (oldLayout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL && newLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL)
+	{
+		barrier.srcAccessMask = VK_ACCESS_SHADER_READ_BIT;
+		barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+
+		sourceStage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+		destinationStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
+	}
 	else
 	{
 		GG_CRITICAL("unsupported layout transition!");
@@ -1252,13 +1434,11 @@ void GraphicsAPI::transitionImageLayout(VkImage image, VkFormat format, VkImageL
 		0, nullptr,
 		1, &barrier
 	);
-
-	endSingleTimeCommands(commandBuffer);
 }
 
 void GraphicsAPI::createCommandBuffers()
 {
-	_commandBuffers.resize(_swapChainFramebuffers.size());
+	_commandBuffers.resize(s_maxSubmitIndex);
 
 	VkCommandBufferAllocateInfo allocInfo{};
 	allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
@@ -1363,6 +1543,11 @@ void GraphicsAPI::createDescriptorSets()
 		throw std::runtime_error("failed to allocate descriptor sets!");
 	}
 
+	updateDescriptorSets();
+}
+
+void GraphicsAPI::updateDescriptorSets()
+{
 	for (size_t i = 0; i < s_maxSubmitIndex; i++)
 	{
 		VkDescriptorImageInfo imageInfo{};
@@ -1395,7 +1580,43 @@ void GraphicsAPI::recreateSwapChain()
 	createRenderPass();
 	createGraphicsPipeline();
 	createFrameBuffers();
-	createCommandBuffers();
+}
+
+void GraphicsAPI::applyFramesInFlight()
+{
+	if (_pendingFramesInFlight == _framesInFlight)
+	{
+		return;
+	}
+
+	// Every slot has to be idle before the ring is resized, restart it from the first slot.
+	WaitDeviceIdle();
+	_framesInFlight = _pendingFramesInFlight;
+	_submitIndex = 0;
+}
+
+void GraphicsAPI::applyFramebufferChanges()
+{
+	if (_frameBufferWidth == _textureWidth && _frameBufferHeight == _textureHeight && _frameBufferLayout == _textureLayout)
+	{
+		return;
+	}
+
+	// The texture and every staging slot may still be in use by frames in flight.
+	WaitDeviceIdle();
+
+	vkDestroyImageView(_device, _textureImageView, nullptr);
+	vkDestroyImage(_device, _textureImage, nullptr);
+	vkFreeMemory(_device, _textureImageMemory, nullptr);
+
+	_textureWidth = _frameBufferWidth;
+	_textureHeight = _frameBufferHeight;
+	_textureLayout = _frameBufferLayout;
+
+	createStagingBuffers(_textureWidth, _textureHeight);
+	createTextureImage();
+	createTextureImageView();
+	updateDescriptorSets();
 }
 
 void GraphicsAPI::cleanupSwapChain()
@@ -1405,8 +1626,6 @@ void GraphicsAPI::cleanupSwapChain()
 		vkDestroyFramebuffer(_device, _swapChainFramebuffers[i], nullptr);
 	}
 
-	vkFreeCommandBuffers(_device, _commandPool, static_cast<uint32_t>(_commandBuffers.size()), _commandBuffers.data());
-
 	vkDestroyPipeline(_device, _pipeline, nullptr);
 	vkDestroyPipelineLayout(_device, _pipelineLayout, nullptr);
 	vkDestroyRenderPass(_device, _renderPass, nullptr);
@@ -1467,7 +1686,7 @@ void GraphicsAPI::bindPipeline(VkCommandBuffer commandBuffer, VkPipeline pipelin
 
 void GraphicsAPI::bindDescriptorSets(VkCommandBuffer commandBuffer)
 {
-	vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, _pipelineLayout, 0, 1, &_descriptorSets[_imageIndex], 0, nullptr);
+	vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, _pipelineLayout, 0, 1, &_descriptorSets[_submitIndex], 0, nullptr);
 }
 
 void GraphicsAPI::setViewport(VkCommandBuffer commandBuffer, float x, float y, float width, float height)
@@ -1698,11 +1917,6 @@ VkExtent2D GraphicsAPI::chooseSwapExtent(const VkSurfaceCapabilitiesKHR& capabil
 		extent = actualExtent;
 	}
 
-	if (!_textureBuffer)
-	{
-		createTextureBuffer(_textureWidth, _textureHeight);
-	}
-
 	return extent;
 }
 
@@ -1719,15 +1933,98 @@ VkSurfaceFormatKHR GraphicsAPI::chooseSwapSurfaceFormat(const std::vector<VkSurf
 	return availableFormats[0];
 }
 
-void GraphicsAPI::createTextureBuffer(uint32 width, uint32 height)
+void GraphicsAPI::createStagingBuffers(uint32 width, uint32 height)
+{
+	destroyStagingBuffers();
+
+	// Slots start on a 256 byte boundary, which covers the copy offset and the mapped pointer alignment on every driver we know of.
+	const VkDeviceSize alignment = 256;
+	const VkDeviceSize clearStripSize = static_cast<VkDeviceSize>(width) * TextureBuffer::s_tileSize * sizeof(uint32);
+	_stagingClearOffset = (static_cast<VkDeviceSize>(width) * height * sizeof(uint32) + alignment - 1) & ~(alignment - 1);
+	_stagingSlotSize = (_stagingClearOffset + clearStripSize + alignment - 1) & ~(alignment - 1);
+
+	VkBufferCreateInfo createInfo{};
+	createInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+	createInfo.size = _stagingSlotSize * s_maxSubmitIndex;
+	createInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+	createInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+	if (vkCreateBuffer(_device, &createInfo, nullptr, &_stagingBuffer) != VK_SUCCESS)
+	{
+		GG_CRITICAL("Failed to create staging buffer!");
+	}
+
+	VkMemoryRequirements memRequirements;
+	vkGetBufferMemoryRequirements(_device, _stagingBuffer, &memRequirements);
+
+	// The CPU renders into these slots and may read them back, so prefer cached memory over write-combined memory.
+	int32 memoryType = findMemoryTypeIndex(memRequirements.memoryTypeBits, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT | VK_MEMORY_PROPERTY_HOST_CACHED_BIT);
+	if (memoryType < 0)
+	{
+		memoryType = static_cast<int32>(findMemoryType(memRequirements.memoryTypeBits, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT));
+	}
+
+	VkMemoryAllocateInfo allocInfo{};
+	allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+	allocInfo.allocationSize = memRequirements.size;
+	allocInfo.memoryTypeIndex = static_cast<uint32>(memoryType);
+
+	if (vkAllocateMemory(_device, &allocInfo, nullptr, &_stagingBufferMemory) != VK_SUCCESS)
+	{
+		GG_CRITICAL("Failed to allocate staging buffer memory!");
+	}
+	vkBindBufferMemory(_device, _stagingBuffer, _stagingBufferMemory, 0);
+
+	void* data;
+	if (vkMapMemory(_device, _stagingBufferMemory, 0, VK_WHOLE_SIZE, 0, &data) != VK_SUCCESS)
+	{
+		GG_CRITICAL("Failed to map staging buffer memory!");
+	}
+	_stagingData = static_cast<uint8*>(data);
+
+	for (uint32 i = 0; i < s_maxSubmitIndex; i++)
+	{
+		uint8* slot = _stagingData + _stagingSlotSize * i;
+		if (_textureLayout == eTextureLayout::Linear)
+		{
+			_textureBuffers[i].Create(width, height, slot);
+		}
+		else
+		{
+			_textureBuffers[i].Create(width, height, _textureLayout);
+		}
+		_textureBuffers[i].Clear(_clearColor);
+
+		PixelKernel::Fill(reinterpret_cast<uint32*>(slot + _stagingClearOffset), _clearColor, width * TextureBuffer::s_tileSize);
+		_stagingClearColors[i] = _clearColor;
+	}
+
+	_uploadedTiles.assign(_textureBuffers[0].GetTileCount(), 0);
+	_uploadTileMask.assign(_textureBuffers[0].GetTileCount(), 0);
+	_clearTileMask.assign(_textureBuffers[0].GetTileCount(), 0);
+}
+
+void GraphicsAPI::destroyStagingBuffers()
 {
-	if (_textureBuffer)
+	for (auto& textureBuffer : _textureBuffers)
+	{
+		textureBuffer.Release();
+	}
+
+	if (_stagingBuffer == nullptr)
 	{
-		delete[] _textureBuffer;
-		_textureBuffer = nullptr;
+		return;
 	}
 
-	_textureBuffer = new uint8[width * height * _textureChannel]{ 0 };
+	vkUnmapMemory(_device, _stagingBufferMemory);
+	vkDestroyBuffer(_device, _stagingBuffer, nullptr);
+	vkFreeMemory(_device, _stagingBufferMemory, nullptr);
+
+	_stagingBuffer = nullptr;
+	_stagingBufferMemory = nullptr;
+	_stagingData = nullptr;
+	_stagingSlotSize = 0;
+	_stagingClearOffset = 0;
 }
 
 VkShaderModule GraphicsAPI::createShaderModule(uint32* spvCode, size_t size)
@@ -3,6 +3,9 @@
 #include "vulkan/vulkan.h"
 
 #include "Base.hpp"
+#include "Graphics/TextureBuffer.h"
+#include "Graphics/MultisampleBuffer.h"
+#include "Graphics/UploadStatistics.h"
 
 #include "imgui.h"
 #include "imgui_impl_win32.h"
@@ -30,14 +33,51 @@ public:
 	void Begin();
 	void End();
 
+	// The CPU framebuffers form a ring with one back buffer per frame in flight.
+	// AcquireBackBuffer() waits until the GPU is done with the next one and clears it, repeated calls in a frame return the same buffer.
+	// ReleaseBackBuffer() hands it over for upload, no more writes are allowed until the next frame acquires a buffer.
+	// Begin() acquires and Draw() releases implicitly, so passes only need this to write outside of that window.
+	TextureBuffer& AcquireBackBuffer();
+	void ReleaseBackBuffer();
+
 	void SetPixel(uint32 row, uint32 col, uint8* color);
 	void SetPixel(uint32 row, uint32 col, uint8 r, uint8 g, uint8 b, uint8 a);
 	void SetPixel(uint32 row, uint32 col, float* color);
 	void SetPixel(uint32 row, uint32 col, float r, float g, float b, float a);
 
+	// Bulk write paths. color/src are packed RGBA8 words (see PackColor), src pitch is in pixels.
+	void FillSpan(int32 row, int32 col, uint32 count, uint32 color);
+	void FillRect(int32 row, int32 col, uint32 width, uint32 height, uint32 color);
+	void WriteRow(int32 row, int32 col, const uint32* src, uint32 count);
+	void BlitRect(int32 row, int32 col, uint32 width, uint32 height, const uint32* src, uint32 srcPitch);
+	// Blending variants of the bulk writes with premultiplied colors, see TextureBuffer::BlendColorRect().
+	void BlendSpan(int32 row, int32 col, uint32 count, uint32 color, eBlendMode mode, bool isGammaCorrect = false);
+	void BlendColorRect(int32 row, int32 col, uint32 width, uint32 height, uint32 color, eBlendMode mode, bool isGammaCorrect = false);
+	void BlendRow(int32 row, int32 col, const uint32* src, uint32 count, eBlendMode mode, bool isGammaCorrect = false);
+	void BlendRect(int32 row, int32 col, uint32 width, uint32 height, const uint32* src, uint32 srcPitch, eBlendMode mode, bool isGammaCorrect = false);
+
 	inline void SetMinimized(bool isMinimized) { _isMinimized = isMinimized; }
+	// How many frames the CPU may run ahead of the GPU, between 1 and s_maxSubmitIndex. Applied at the next Begin().
+	void SetFramesInFlight(uint32 count);
+	inline uint32 GetFramesInFlight() const { return _framesInFlight; }
+	// Packed RGBA8 color the back buffers are cleared to, applied at the next acquire.
+	inline void SetClearColor(uint32 color) { _clearColor = color; }
+	inline uint32 GetClearColor() const { return _clearColor; }
+	// Disable for passes which overwrite the whole framebuffer, tiles they don't write keep the previous content.
+	// A partially written tile still gets the clear color in its unwritten pixels.
+	inline void SetClearEnabled(bool isClearEnabled) { _isClearEnabled = isClearEnabled; }
+	inline bool IsClearEnabled() const { return _isClearEnabled; }
+	// Size of the CPU framebuffer, the sampler scales it to the swap chain. Reallocated at the next acquire.
+	void SetFramebufferSize(uint32 width, uint32 height);
 	inline uint32 GetFramebufferWidth() const { return _textureWidth; }
 	inline uint32 GetFramebufferHeight() const { return _textureHeight; }
+	// Storage layout of the CPU back buffers. Tiled buffers are resolved into staging during the upload.
+	inline void SetFramebufferLayout(eTextureLayout layout) { _frameBufferLayout = layout; }
+	inline eTextureLayout GetFramebufferLayout() const { return _textureLayout; }
+	inline const UploadStatistics& GetUploadStatistics() const { return _uploadStatistics; }
+	// Split pixels of a multisampled back buffer are resolved into it right before the upload, null without multisampling.
+	// The buffer stays owned and cleared by the caller.
+	inline void SetMultisampleBuffer(MultisampleBuffer* multisampleBuffer) { _multisampleBuffer = multisampleBuffer; }
 
 private:
 
@@ -75,18 +115,24 @@ private:
 	void createCommandPool();
 	void createBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties, VkBuffer& buffer, VkDeviceMemory& bufferMemory);
 	uint32 findMemoryType(uint32 typeFilter, VkMemoryPropertyFlags properties);
+	// Returns -1 instead of failing when no memory type matches.
+	int32 findMemoryTypeIndex(uint32 typeFilter, VkMemoryPropertyFlags properties);
 	void createImage(uint32_t width, uint32_t height, VkFormat format, VkImageTiling tiling, VkImageUsageFlags usage, VkMemoryPropertyFlags properties, VkImage& image, VkDeviceMemory& imageMemory);
 	void createTextureImage();
 	void createTextureSampler();
 	void updateTextureImage();
 	void clearTextureImage();
 	void createTextureImageView();
+	// One command buffer per submit slot, they don't depend on the swap chain.
 	void createCommandBuffers();
 	void createSyncObjects();
 	void createDescriptorPool();
 	void createDescriptorSetLayout();
 	void createDescriptorSets();
+	void updateDescriptorSets();
 
+	void applyFramesInFlight();
+	void applyFramebufferChanges();
 	void recreateSwapChain();
 	void cleanupSwapChain();
 
@@ -111,9 +157,14 @@ private:
 	VkExtent2D chooseSwapExtent(const VkSurfaceCapabilitiesKHR& capabilities);
 	VkSurfaceFormatKHR chooseSwapSurfaceFormat(const std::vector<VkSurfaceFormatKHR>& availableFormats);
 
-	void createTextureBuffer(uint32 width, uint32 height);
+	void createStagingBuffers(uint32 width, uint32 height);
+	void destroyStagingBuffers();
+	inline TextureBuffer& currentTextureBuffer() { return _textureBuffers[_submitIndex]; }
+	TextureBuffer& backBuffer();
 	void transitionImageLayout(VkImage image, VkFormat format, VkImageLayout oldLayout, VkImageLayout newLayout);
-	void copyBufferToImage(VkBuffer buffer, VkImage image, uint32 width, uint32 height);
+	// Records the barrier into commandBuffer instead of submitting it on its own.
+	void transitionImageLayout(VkCommandBuffer commandBuffer, VkImage image, VkFormat format, VkImageLayout oldLayout, VkImageLayout newLayout);
+	void copyBufferToImage(VkCommandBuffer commandBuffer, VkBuffer buffer, VkImage image, const std::vector<VkBufferImageCopy>& copies);
 	VkCommandBuffer beginSingleTimeCommands();
 	void endSingleTimeCommands(VkCommandBuffer commandBuffer);
 	VkShaderModule createShaderModule(uint32* spvCode, size_t size);
@@ -158,9 +209,13 @@ private:
 	std::vector<VkFence>			_imagesInFlight;
 
 	uint32							_submitIndex;
+	uint32							_framesInFlight;
+	uint32							_pendingFramesInFlight;
 	uint32							_imageIndex;
+	// Requested framebuffer size, _textureWidth/_textureHeight follow it at the next acquire.
 	uint32							_frameBufferWidth;
 	uint32							_frameBufferHeight;
+	eTextureLayout					_frameBufferLayout;
 
 	VkDescriptorSetLayout			_descriptorSetLayout;
 	std::vector<VkDescriptorSet>	_descriptorSets;
@@ -171,14 +226,46 @@ private:
 	VkImageView						_textureImageView;
 	VkSampler						_textureSampler;
 
-	uint8*							_textureBuffer;
-	const uint32					_textureWidth = 1280;
-	const uint32					_textureHeight = 720;
-	const uint32					_textureChannel = 4;
+	// Persistently mapped staging ring, one slot per submit index.
+	// Linear TextureBuffers live directly in their slot, so the CPU writes are uploaded without another copy.
+	// Tiled ones own their storage and the dirty regions are detiled into the slot.
+	// A slot ends with a full width strip of s_tileSize rows in the clear color, every cleared tile is copied out of it.
+	VkBuffer						_stagingBuffer;
+	VkDeviceMemory					_stagingBufferMemory;
+	uint8*							_stagingData;
+	VkDeviceSize					_stagingSlotSize;
+	VkDeviceSize					_stagingClearOffset;
+	uint32							_stagingClearColors[s_maxSubmitIndex];
+	TextureBuffer					_textureBuffers[s_maxSubmitIndex];
+	uint32							_textureWidth;
+	uint32							_textureHeight;
+	eTextureLayout					_textureLayout;
+
+	uint32							_clearColor;
+	bool							_isClearEnabled;
+	MultisampleBuffer*				_multisampleBuffer;
+
+	// Tiles which hold written content in _textureImage, they must be cleared again once they aren't written.
+	// The rest of the image holds _uploadedClearColor.
+	std::vector<uint8>				_uploadedTiles;
+	uint32							_uploadedClearColor;
+	std::vector<uint8>				_uploadTileMask;
+	std::vector<uint8>				_clearTileMask;
+	std::vector<TextureRegion>		_uploadRegions;
+	std::vector<TextureRegion>		_clearRegions;
+	std::vector<VkBufferImageCopy>	_uploadCopies;
+	UploadStatistics				_uploadStatistics;
+
+	enum class eBackBufferState
+	{
+		Free,
+		Acquired,
+		Released,
+	};
+	eBackBufferState				_backBufferState;
 
 	bool							_isBeginCalled[s_maxSubmitIndex];
 	bool							_isMinimized;
-	bool							_needUpdateTexture;
 };
 
 }
\ No newline at end of file
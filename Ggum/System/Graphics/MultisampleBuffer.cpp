@@ -0,0 +1,214 @@
+#include "SystemPch.h"
+
+#include "MultisampleBuffer.h"
+#include "Utility/Simd.hpp"
+
+namespace GG {
+
+static constexpr SamplePattern s_samplePatterns[4]
+{
+	{ 1, { 0 }, { 0 } },
+	{ 2, { 4, -4 }, { 4, -4 } },
+	{ 4, { -2, 6, -6, 2 }, { -6, -2, 2, 6 } },
+	{ 8, { 1, -1, 5, -3, -5, -7, 3, 7 }, { -3, 3, 1, -5, 5, -1, 7, -7 } },
+};
+
+// Averages the samples of the 8 pixels of a run and writes the lanes set in laneMask to dst.
+// samples is the run's first pixel of sample 0, the next sample follows s_blockPixels later.
+using ResolveRunFunc = void(*)(const uint32*, uint32, uint32, uint32, uint32*);
+
+static void resolve_run_sse2(const uint32* samples, uint32 sampleCount, uint32 sampleShift, uint32 laneMask, uint32* dst)
+{
+	const __m128i zero = _mm_setzero_si128();
+	__m128i sum0 = zero;
+	__m128i sum1 = zero;
+	__m128i sum2 = zero;
+	__m128i sum3 = zero;
+	for (uint32 sample = 0; sample < sampleCount; sample++)
+	{
+		// 8 samples of 8 bits add up to 11 bits, 16-bit lanes don't overflow.
+		const __m128i* colors = reinterpret_cast<const __m128i*>(samples + sample * MultisampleBuffer::s_blockPixels);
+		const __m128i colors0 = _mm_loadu_si128(colors);
+		const __m128i colors1 = _mm_loadu_si128(colors + 1);
+		sum0 = _mm_add_epi16(sum0, _mm_unpacklo_epi8(colors0, zero));
+		sum1 = _mm_add_epi16(sum1, _mm_unpackhi_epi8(colors0, zero));
+		sum2 = _mm_add_epi16(sum2, _mm_unpacklo_epi8(colors1, zero));
+		sum3 = _mm_add_epi16(sum3, _mm_unpackhi_epi8(colors1, zero));
+	}
+
+	const __m128i rounding = _mm_set1_epi16(static_cast<int16>(sampleCount / 2));
+	const __m128i shift = _mm_cvtsi32_si128(static_cast<int>(sampleShift));
+	const __m128i average0 = _mm_packus_epi16(_mm_srl_epi16(_mm_add_epi16(sum0, rounding), shift), _mm_srl_epi16(_mm_add_epi16(sum1, rounding), shift));
+	const __m128i average1 = _mm_packus_epi16(_mm_srl_epi16(_mm_add_epi16(sum2, rounding), shift), _mm_srl_epi16(_mm_add_epi16(sum3, rounding), shift));
+
+	const __m128i maskValue = _mm_set1_epi32(static_cast<int>(laneMask));
+	const __m128i laneBits0 = _mm_setr_epi32(1, 2, 4, 8);
+	const __m128i laneBits1 = _mm_setr_epi32(16, 32, 64, 128);
+	const __m128i mask0 = _mm_cmpeq_epi32(_mm_and_si128(maskValue, laneBits0), laneBits0);
+	const __m128i mask1 = _mm_cmpeq_epi32(_mm_and_si128(maskValue, laneBits1), laneBits1);
+	__m128i* pixels = reinterpret_cast<__m128i*>(dst);
+	_mm_storeu_si128(pixels, _mm_or_si128(_mm_and_si128(mask0, average0), _mm_andnot_si128(mask0, _mm_loadu_si128(pixels))));
+	_mm_storeu_si128(pixels + 1, _mm_or_si128(_mm_and_si128(mask1, average1), _mm_andnot_si128(mask1, _mm_loadu_si128(pixels + 1))));
+}
+
+GG_TARGET_AVX2 static void resolve_run_avx2(const uint32* samples, uint32 sampleCount, uint32 sampleShift, uint32 laneMask, uint32* dst)
+{
+	const __m256i zero = _mm256_setzero_si256();
+	__m256i sumLow = zero;
+	__m256i sumHigh = zero;
+	for (uint32 sample = 0; sample < sampleCount; sample++)
+	{
+		const __m256i colors = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(samples + sample * MultisampleBuffer::s_blockPixels));
+		sumLow = _mm256_add_epi16(sumLow, _mm256_unpacklo_epi8(colors, zero));
+		sumHigh = _mm256_add_epi16(sumHigh, _mm256_unpackhi_epi8(colors, zero));
+	}
+
+	// Unpacking and packing both work per 128-bit lane, the pixels end up in their original order.
+	const __m256i rounding = _mm256_set1_epi16(static_cast<int16>(sampleCount / 2));
+	const __m128i shift = _mm_cvtsi32_si128(static_cast<int>(sampleShift));
+	const __m256i average = _mm256_packus_epi16(_mm256_srl_epi16(_mm256_add_epi16(sumLow, rounding), shift), _mm256_srl_epi16(_mm256_add_epi16(sumHigh, rounding), shift));
+
+	const __m256i laneBits = _mm256_setr_epi32(1, 2, 4, 8, 16, 32, 64, 128);
+	const __m256i mask = _mm256_cmpeq_epi32(_mm256_and_si256(_mm256_set1_epi32(static_cast<int>(laneMask)), laneBits), laneBits);
+	__m256i* pixels = reinterpret_cast<__m256i*>(dst);
+	_mm256_storeu_si256(pixels, _mm256_blendv_epi8(_mm256_loadu_si256(pixels), average, mask));
+}
+
+static ResolveRunFunc get_resolve_run_func()
+{
+	static const ResolveRunFunc s_func = Simd::IsAVX2Supported() ? resolve_run_avx2 : resolve_run_sse2;
+
+	return s_func;
+}
+
+MultisampleBuffer::MultisampleBuffer()
+	: _slotSize{ 0 }
+	, _width{ 0 }
+	, _height{ 0 }
+	, _layout{ eTextureLayout::Linear }
+	, _blockColumns{ 0 }
+	, _blockRows{ 0 }
+	, _sampleCount{ 1 }
+{
+
+}
+
+void MultisampleBuffer::Create(uint32 width, uint32 height, eTextureLayout layout, uint32 sampleCount)
+{
+	GG_ASSERT(width != 0 && height != 0, "MultisampleBuffer size should't be zero!");
+	GG_ASSERT(sampleCount == 2 || sampleCount == 4 || sampleCount == 8, "Sample count has to be 2, 4 or 8!");
+
+	Release();
+
+	_width = width;
+	_height = height;
+	_layout = layout;
+	_blockColumns = (width + s_blockSize - 1) / s_blockSize;
+	_blockRows = (height + s_blockSize - 1) / s_blockSize;
+	_sampleCount = sampleCount;
+	_slotSize = s_blockPixels * sampleCount * 2;
+
+	const size_t blockCount = static_cast<size_t>(_blockColumns) * _blockRows;
+	_splitMasks.assign(blockCount, 0);
+	_blockSlots.assign(blockCount, nullptr);
+}
+
+void MultisampleBuffer::Release()
+{
+	_splitMasks.clear();
+	_blockSlots.clear();
+	_chunks.clear();
+	_splitBlocks.clear();
+	_width = 0;
+	_height = 0;
+	_blockColumns = 0;
+	_blockRows = 0;
+}
+
+void MultisampleBuffer::Clear()
+{
+	for (uint32 block : _splitBlocks)
+	{
+		_splitMasks[block] = 0;
+		_blockSlots[block] = nullptr;
+	}
+	_splitBlocks.clear();
+}
+
+void MultisampleBuffer::Resolve(TextureBuffer& target) const
+{
+	GG_ASSERT(target.GetWidth() == _width && target.GetHeight() == _height && target.GetLayout() == _layout, "Target doesn't match the multisample buffer!");
+
+	const ResolveRunFunc resolveRun = get_resolve_run_func();
+	const uint32 runPitch = target.GetBlockRunPitch();
+	const uint32 sampleShift = _sampleCount == 2 ? 1 : _sampleCount == 4 ? 2 : 3;
+
+	for (uint32 block : _splitBlocks)
+	{
+		const uint64 splitMask = _splitMasks[block];
+		if (splitMask == 0)
+		{
+			continue;
+		}
+
+		const uint32 row = block / _blockColumns * s_blockSize;
+		const uint32 col = block % _blockColumns * s_blockSize;
+		const uint32* samples = _blockSlots[block];
+		uint32* pixels = target.GetBlockForWrite(row, col);
+
+		// Runs of blocks on the border may leave the buffer, their split pixels are averaged one by one.
+		if (row + s_blockSize > _height || col + s_blockSize > _width)
+		{
+			for (uint64 mask = splitMask; mask != 0; mask &= mask - 1)
+			{
+				const uint32 pixel = static_cast<uint32>(Simd::CountTrailingZeros(mask));
+				uint32 sums[4]{ _sampleCount / 2, _sampleCount / 2, _sampleCount / 2, _sampleCount / 2 };
+				for (uint32 sample = 0; sample < _sampleCount; sample++)
+				{
+					const uint32 color = samples[sample * s_blockPixels + pixel];
+					for (uint32 channel = 0; channel < 4; channel++)
+					{
+						sums[channel] += (color >> (channel * 8)) & 0xFF;
+					}
+				}
+				pixels[pixel / s_blockSize * runPitch + pixel % s_blockSize] = (sums[0] >> sampleShift) | ((sums[1] >> sampleShift) << 8) | ((sums[2] >> sampleShift) << 16) | ((sums[3] >> sampleShift) << 24);
+			}
+			continue;
+		}
+
+		for (uint32 run = 0; run < s_blockSize; run++)
+		{
+			const uint32 laneMask = static_cast<uint32>(splitMask >> (run * s_blockSize)) & 0xFF;
+			if (laneMask != 0)
+			{
+				resolveRun(samples + run * s_blockSize, _sampleCount, sampleShift, laneMask, pixels + run * runPitch);
+			}
+		}
+	}
+}
+
+const SamplePattern& MultisampleBuffer::GetSamplePattern(uint32 sampleCount)
+{
+	return s_samplePatterns[sampleCount >= 8 ? 3 : sampleCount >= 4 ? 2 : sampleCount >= 2 ? 1 : 0];
+}
+
+MultisampleBuffer::BlockSamples MultisampleBuffer::allocateSlot(size_t blockIndex)
+{
+	uint32* slot;
+	{
+		std::lock_guard<std::mutex> lock(_slotMutex);
+
+		const size_t slotIndex = _splitBlocks.size();
+		if (slotIndex / s_chunkSlotCount >= _chunks.size())
+		{
+			_chunks.push_back(std::make_unique<uint32[]>(static_cast<size_t>(_slotSize) * s_chunkSlotCount));
+		}
+		slot = _chunks[slotIndex / s_chunkSlotCount].get() + slotIndex % s_chunkSlotCount * _slotSize;
+		_splitBlocks.push_back(static_cast<uint32>(blockIndex));
+	}
+	_blockSlots[blockIndex] = slot;
+
+	return BlockSamples{ slot, reinterpret_cast<float*>(slot + s_blockPixels * _sampleCount) };
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "Base.hpp"
+
+#include "Core/Log.h"
+#include "Graphics/TextureBuffer.h"
+
+namespace GG {
+
+// Sample positions in 1/16 pixel from the pixel center, the standard 2x/4x/8x patterns of D3D and Vulkan.
+struct SamplePattern
+{
+	uint32 count;
+	int8 x[8];
+	int8 y[8];
+};
+
+// Sample storage of a multisampled TextureBuffer. The TextureBuffer keeps one color per pixel and stays the render target:
+// as long as every sample of a pixel is equal it holds the pixel, and the pixel costs the same as without multisampling.
+// Only pixels on the edges of triangles are split, their samples live here in per block slots which are allocated
+// on demand, so memory and the resolve scale with the edges instead of the screen. Each block has a 64-bit mask
+// of its split pixels (bit run * s_blockSize + lane, the pixel order of TextureBuffer::GetBlockForWrite()).
+// Depth is kept the same way: a DepthBuffer holds the center depth of every pixel which isn't split, and the largest
+// sample depth of split pixels for the coarse Z, their sample depths live here.
+class MultisampleBuffer
+{
+public:
+	static constexpr uint32			s_maxSampleCount = 8;
+	static constexpr uint32			s_blockSize = TextureBuffer::s_blockSize;
+	static constexpr uint32			s_blockPixels = s_blockSize * s_blockSize;
+
+	// Samples of one block, sample major: sample s of pixel i is colors[s * s_blockPixels + i].
+	struct BlockSamples
+	{
+		uint32* colors;
+		float* depths;
+	};
+
+	MultisampleBuffer();
+	~MultisampleBuffer() = default;
+
+	MultisampleBuffer(const MultisampleBuffer&) = delete;
+	MultisampleBuffer& operator=(const MultisampleBuffer&) = delete;
+
+	// sampleCount is 2, 4 or 8, width, height and layout have to match the target.
+	void Create(uint32 width, uint32 height, eTextureLayout layout, uint32 sampleCount);
+	void Release();
+	// O(split blocks), every pixel goes back to a single sample. Slots stay allocated for the next frame.
+	void Clear();
+
+	inline uint64 GetSplitMask(uint32 row, uint32 col) const { return _splitMasks[blockIndex(row, col)]; }
+	inline void SetSplitMask(uint32 row, uint32 col, uint64 mask) { _splitMasks[blockIndex(row, col)] = mask; }
+	// Samples of the block at (row, col), multiples of s_blockSize, allocated the first time a frame splits the block.
+	// The contents of new slots are undefined. Safe to call from several threads as long as they write different blocks.
+	inline BlockSamples GetBlockSamplesForWrite(uint32 row, uint32 col);
+
+	// Averages the samples of every split pixel into target, which has to match the buffer's size and layout.
+	// The pixels stay split, call Clear() if more than triangles are drawn into target afterwards.
+	void Resolve(TextureBuffer& target) const;
+
+	static const SamplePattern& GetSamplePattern(uint32 sampleCount);
+
+	inline uint32 GetWidth() const { return _width; }
+	inline uint32 GetHeight() const { return _height; }
+	inline eTextureLayout GetLayout() const { return _layout; }
+	inline uint32 GetSampleCount() const { return _sampleCount; }
+	inline bool IsCreated() const { return !_splitMasks.empty(); }
+	// Blocks holding samples since the last clear.
+	inline uint32 GetSplitBlockCount() const { return static_cast<uint32>(_splitBlocks.size()); }
+
+private:
+	// Slots per chunk of sample storage, chunks are never freed before Release() so slots don't move.
+	static constexpr uint32			s_chunkSlotCount = 64;
+
+	inline size_t blockIndex(uint32 row, uint32 col) const { return static_cast<size_t>(row / s_blockSize) * _blockColumns + col / s_blockSize; }
+	BlockSamples allocateSlot(size_t blockIndex);
+
+	std::vector<uint64>				_splitMasks;
+	// Slot of every block with samples this frame, colors then depths of s_blockPixels * _sampleCount values each.
+	std::vector<uint32*>			_blockSlots;
+	std::vector<std::unique_ptr<uint32[]>>	_chunks;
+	// Blocks in the order they got their slots, slot i belongs to _splitBlocks[i].
+	std::vector<uint32>				_splitBlocks;
+	std::mutex						_slotMutex;
+	uint32							_slotSize;
+	uint32							_width;
+	uint32							_height;
+	eTextureLayout					_layout;
+	uint32							_blockColumns;
+	uint32							_blockRows;
+	uint32							_sampleCount;
+};
+
+// Inline since rasterizers call it for every split block they touch.
+inline MultisampleBuffer::BlockSamples MultisampleBuffer::GetBlockSamplesForWrite(uint32 row, uint32 col)
+{
+	GG_ASSERT(row % s_blockSize == 0 && col % s_blockSize == 0 && row < _height && col < _width, "Block is out of the buffer!");
+
+	const size_t index = blockIndex(row, col);
+	uint32* slot = _blockSlots[index];
+	if (slot == nullptr)
+	{
+		return allocateSlot(index);
+	}
+
+	return BlockSamples{ slot, reinterpret_cast<float*>(slot + s_blockPixels * _sampleCount) };
+}
+
+}
\ No newline at end of file
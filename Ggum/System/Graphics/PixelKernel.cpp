@@ -0,0 +1,780 @@
+#include "SystemPch.h"
+
+#include "PixelKernel.h"
+#include "Utility/Simd.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace GG {
+namespace PixelKernel {
+
+using FillFunc = void(*)(uint32*, uint32, uint32);
+using CopyFunc = void(*)(uint32*, const uint32*, uint32);
+
+static void fill_sse2(uint32* dst, uint32 color, uint32 count)
+{
+	// Scalar head until dst is 16-byte aligned so the body can use aligned stores.
+	while (count > 0 && (reinterpret_cast<uintptr_t>(dst) & 15) != 0)
+	{
+		*dst++ = color;
+		count--;
+	}
+
+	const __m128i value = _mm_set1_epi32(static_cast<int>(color));
+	while (count >= 16)
+	{
+		_mm_store_si128(reinterpret_cast<__m128i*>(dst), value);
+		_mm_store_si128(reinterpret_cast<__m128i*>(dst + 4), value);
+		_mm_store_si128(reinterpret_cast<__m128i*>(dst + 8), value);
+		_mm_store_si128(reinterpret_cast<__m128i*>(dst + 12), value);
+		dst += 16;
+		count -= 16;
+	}
+	while (count >= 4)
+	{
+		_mm_store_si128(reinterpret_cast<__m128i*>(dst), value);
+		dst += 4;
+		count -= 4;
+	}
+	while (count > 0)
+	{
+		*dst++ = color;
+		count--;
+	}
+}
+
+GG_TARGET_AVX2 static void fill_avx2(uint32* dst, uint32 color, uint32 count)
+{
+	while (count > 0 && (reinterpret_cast<uintptr_t>(dst) & 31) != 0)
+	{
+		*dst++ = color;
+		count--;
+	}
+
+	const __m256i value = _mm256_set1_epi32(static_cast<int>(color));
+	while (count >= 32)
+	{
+		_mm256_store_si256(reinterpret_cast<__m256i*>(dst), value);
+		_mm256_store_si256(reinterpret_cast<__m256i*>(dst + 8), value);
+		_mm256_store_si256(reinterpret_cast<__m256i*>(dst + 16), value);
+		_mm256_store_si256(reinterpret_cast<__m256i*>(dst + 24), value);
+		dst += 32;
+		count -= 32;
+	}
+	while (count >= 8)
+	{
+		_mm256_store_si256(reinterpret_cast<__m256i*>(dst), value);
+		dst += 8;
+		count -= 8;
+	}
+	while (count > 0)
+	{
+		*dst++ = color;
+		count--;
+	}
+}
+
+static void copy_sse2(uint32* dst, const uint32* src, uint32 count)
+{
+	while (count > 0 && (reinterpret_cast<uintptr_t>(dst) & 15) != 0)
+	{
+		*dst++ = *src++;
+		count--;
+	}
+
+	while (count >= 16)
+	{
+		__m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+		__m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 4));
+		__m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 8));
+		__m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 12));
+		_mm_store_si128(reinterpret_cast<__m128i*>(dst), a);
+		_mm_store_si128(reinterpret_cast<__m128i*>(dst + 4), b);
+		_mm_store_si128(reinterpret_cast<__m128i*>(dst + 8), c);
+		_mm_store_si128(reinterpret_cast<__m128i*>(dst + 12), d);
+		dst += 16;
+		src += 16;
+		count -= 16;
+	}
+	while (count >= 4)
+	{
+		_mm_store_si128(reinterpret_cast<__m128i*>(dst), _mm_loadu_si128(reinterpret_cast<const __m128i*>(src)));
+		dst += 4;
+		src += 4;
+		count -= 4;
+	}
+	while (count > 0)
+	{
+		*dst++ = *src++;
+		count--;
+	}
+}
+
+GG_TARGET_AVX2 static void copy_avx2(uint32* dst, const uint32* src, uint32 count)
+{
+	while (count > 0 && (reinterpret_cast<uintptr_t>(dst) & 31) != 0)
+	{
+		*dst++ = *src++;
+		count--;
+	}
+
+	while (count >= 32)
+	{
+		__m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src));
+		__m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + 8));
+		__m256i c = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + 16));
+		__m256i d = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + 24));
+		_mm256_store_si256(reinterpret_cast<__m256i*>(dst), a);
+		_mm256_store_si256(reinterpret_cast<__m256i*>(dst + 8), b);
+		_mm256_store_si256(reinterpret_cast<__m256i*>(dst + 16), c);
+		_mm256_store_si256(reinterpret_cast<__m256i*>(dst + 24), d);
+		dst += 32;
+		src += 32;
+		count -= 32;
+	}
+	while (count >= 8)
+	{
+		_mm256_store_si256(reinterpret_cast<__m256i*>(dst), _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src)));
+		dst += 8;
+		src += 8;
+		count -= 8;
+	}
+	while (count > 0)
+	{
+		*dst++ = *src++;
+		count--;
+	}
+}
+
+static FillFunc get_fill_func()
+{
+	static const FillFunc s_func = Simd::IsAVX2Supported() ? fill_avx2 : fill_sse2;
+
+	return s_func;
+}
+
+static CopyFunc get_copy_func()
+{
+	static const CopyFunc s_func = Simd::IsAVX2Supported() ? copy_avx2 : copy_sse2;
+
+	return s_func;
+}
+
+void Fill(uint32* dst, uint32 color, uint32 count)
+{
+	get_fill_func()(dst, color, count);
+}
+
+void Copy(uint32* dst, const uint32* src, uint32 count)
+{
+	get_copy_func()(dst, src, count);
+}
+
+// In Morton order every 4 pixels form a 2x2 quad and every 16 pixels a 4x4 block,
+// so two rows of a 4x4 block are the low and high halves of two neighbouring quads and the conversion is its own inverse.
+static inline void transpose_quads(__m128i a, __m128i b, __m128i& outLow, __m128i& outHigh)
+{
+	outLow = _mm_unpacklo_epi64(a, b);
+	outHigh = _mm_unpackhi_epi64(a, b);
+}
+
+void TileBlock(uint32* dst, const uint32* src, uint32 srcPitch)
+{
+	for (uint32 block = 0; block < 4; block++)
+	{
+		// Blocks of 4x4 are stored top-left, top-right, bottom-left, bottom-right.
+		const uint32* rows = src + (block >> 1) * 4 * srcPitch + (block & 1) * 4;
+		__m128i* quads = reinterpret_cast<__m128i*>(dst + block * 16);
+
+		for (uint32 half = 0; half < 2; half++)
+		{
+			__m128i row0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rows + (half * 2) * srcPitch));
+			__m128i row1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rows + (half * 2 + 1) * srcPitch));
+			__m128i quad0, quad1;
+			transpose_quads(row0, row1, quad0, quad1);
+			_mm_storeu_si128(quads + half * 2, quad0);
+			_mm_storeu_si128(quads + half * 2 + 1, quad1);
+		}
+	}
+}
+
+void DetileBlock(uint32* dst, uint32 dstPitch, const uint32* src)
+{
+	for (uint32 block = 0; block < 4; block++)
+	{
+		uint32* rows = dst + (block >> 1) * 4 * dstPitch + (block & 1) * 4;
+		const __m128i* quads = reinterpret_cast<const __m128i*>(src + block * 16);
+
+		for (uint32 half = 0; half < 2; half++)
+		{
+			__m128i quad0 = _mm_loadu_si128(quads + half * 2);
+			__m128i quad1 = _mm_loadu_si128(quads + half * 2 + 1);
+			__m128i row0, row1;
+			transpose_quads(quad0, quad1, row0, row1);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(rows + (half * 2) * dstPitch), row0);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(rows + (half * 2 + 1) * dstPitch), row1);
+		}
+	}
+}
+
+void FillRect(uint32* dst, uint32 dstPitch, uint32 width, uint32 height, uint32 color)
+{
+	if (width == dstPitch)
+	{
+		get_fill_func()(dst, color, width * height);
+		return;
+	}
+
+	FillFunc fill = get_fill_func();
+	for (uint32 row = 0; row < height; row++)
+	{
+		fill(dst, color, width);
+		dst += dstPitch;
+	}
+}
+
+void CopyRect(uint32* dst, uint32 dstPitch, const uint32* src, uint32 srcPitch, uint32 width, uint32 height)
+{
+	if (width == dstPitch && width == srcPitch)
+	{
+		get_copy_func()(dst, src, width * height);
+		return;
+	}
+
+	CopyFunc copy = get_copy_func();
+	for (uint32 row = 0; row < height; row++)
+	{
+		copy(dst, src, width);
+		dst += dstPitch;
+		src += srcPitch;
+	}
+}
+
+
+// Rounded x / 255 for x up to 255 * 255.
+static inline uint32 div255(uint32 x)
+{
+	x += 128;
+
+	return (x + (x >> 8)) >> 8;
+}
+
+template<eBlendMode Mode>
+static inline uint32 blend_pixel(uint32 dst, uint32 src)
+{
+	const uint32 inverseAlpha = 255 - (src >> 24);
+	uint32 result = 0;
+	for (uint32 shift = 0; shift < 32; shift += 8)
+	{
+		const uint32 s = (src >> shift) & 0xFF;
+		const uint32 d = (dst >> shift) & 0xFF;
+		uint32 value;
+		if constexpr (Mode == eBlendMode::SourceOver)
+		{
+			value = std::min(s + div255(d * inverseAlpha), 255u);
+		}
+		else if constexpr (Mode == eBlendMode::Additive)
+		{
+			value = std::min(s + d, 255u);
+		}
+		else if constexpr (Mode == eBlendMode::Multiply)
+		{
+			value = div255(s * d);
+		}
+		else if constexpr (Mode == eBlendMode::Min)
+		{
+			value = std::min(s, d);
+		}
+		else
+		{
+			value = std::max(s, d);
+		}
+		result |= value << shift;
+	}
+
+	return result;
+}
+
+// div255() on 16-bit lanes, the sums stay below 2^16.
+static inline __m128i div255_sse2(__m128i x)
+{
+	x = _mm_add_epi16(x, _mm_set1_epi16(128));
+
+	return _mm_srli_epi16(_mm_add_epi16(x, _mm_srli_epi16(x, 8)), 8);
+}
+
+// a * b / 255 of every byte.
+static inline __m128i mul_div255_sse2(__m128i a, __m128i b)
+{
+	const __m128i zero = _mm_setzero_si128();
+	__m128i low = div255_sse2(_mm_mullo_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero)));
+	__m128i high = div255_sse2(_mm_mullo_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero)));
+
+	return _mm_packus_epi16(low, high);
+}
+
+// Alpha of every pixel copied into all four of its bytes.
+static inline __m128i broadcast_alpha_sse2(__m128i pixels)
+{
+	__m128i alpha = _mm_srli_epi32(pixels, 24);
+	alpha = _mm_or_si128(alpha, _mm_slli_epi32(alpha, 8));
+
+	return _mm_or_si128(alpha, _mm_slli_epi32(alpha, 16));
+}
+
+template<eBlendMode Mode>
+static inline __m128i blend_pixels_sse2(__m128i d, __m128i s)
+{
+	if constexpr (Mode == eBlendMode::SourceOver)
+	{
+		const __m128i inverseAlpha = _mm_xor_si128(broadcast_alpha_sse2(s), _mm_set1_epi32(-1));
+		return _mm_adds_epu8(s, mul_div255_sse2(d, inverseAlpha));
+	}
+	else if constexpr (Mode == eBlendMode::Additive)
+	{
+		return _mm_adds_epu8(s, d);
+	}
+	else if constexpr (Mode == eBlendMode::Multiply)
+	{
+		return mul_div255_sse2(s, d);
+	}
+	else if constexpr (Mode == eBlendMode::Min)
+	{
+		return _mm_min_epu8(s, d);
+	}
+	else
+	{
+		return _mm_max_epu8(s, d);
+	}
+}
+
+GG_TARGET_AVX2 static inline __m256i div255_avx2(__m256i x)
+{
+	x = _mm256_add_epi16(x, _mm256_set1_epi16(128));
+
+	return _mm256_srli_epi16(_mm256_add_epi16(x, _mm256_srli_epi16(x, 8)), 8);
+}
+
+// Unpack and pack work per 128-bit lane, so the pixel order is kept.
+GG_TARGET_AVX2 static inline __m256i mul_div255_avx2(__m256i a, __m256i b)
+{
+	const __m256i zero = _mm256_setzero_si256();
+	__m256i low = div255_avx2(_mm256_mullo_epi16(_mm256_unpacklo_epi8(a, zero), _mm256_unpacklo_epi8(b, zero)));
+	__m256i high = div255_avx2(_mm256_mullo_epi16(_mm256_unpackhi_epi8(a, zero), _mm256_unpackhi_epi8(b, zero)));
+
+	return _mm256_packus_epi16(low, high);
+}
+
+GG_TARGET_AVX2 static inline __m256i broadcast_alpha_avx2(__m256i pixels)
+{
+	const __m256i alphaShuffle = _mm256_setr_epi8(3, 3, 3, 3, 7, 7, 7, 7, 11, 11, 11, 11, 15, 15, 15, 15, 3, 3, 3, 3, 7, 7, 7, 7, 11, 11, 11, 11, 15, 15, 15, 15);
+
+	return _mm256_shuffle_epi8(pixels, alphaShuffle);
+}
+
+template<eBlendMode Mode>
+GG_TARGET_AVX2 static inline __m256i blend_pixels_avx2(__m256i d, __m256i s)
+{
+	if constexpr (Mode == eBlendMode::SourceOver)
+	{
+		const __m256i inverseAlpha = _mm256_xor_si256(broadcast_alpha_avx2(s), _mm256_set1_epi32(-1));
+		return _mm256_adds_epu8(s, mul_div255_avx2(d, inverseAlpha));
+	}
+	else if constexpr (Mode == eBlendMode::Additive)
+	{
+		return _mm256_adds_epu8(s, d);
+	}
+	else if constexpr (Mode == eBlendMode::Multiply)
+	{
+		return mul_div255_avx2(s, d);
+	}
+	else if constexpr (Mode == eBlendMode::Min)
+	{
+		return _mm256_min_epu8(s, d);
+	}
+	else
+	{
+		return _mm256_max_epu8(s, d);
+	}
+}
+
+// With IsColor src points to a single color blended over every pixel.
+using BlendFunc = void(*)(uint32*, const uint32*, uint32);
+
+template<eBlendMode Mode, bool IsColor>
+static void blend_scalar(uint32* dst, const uint32* src, uint32 count)
+{
+	for (uint32 i = 0; i < count; i++)
+	{
+		dst[i] = blend_pixel<Mode>(dst[i], IsColor ? *src : src[i]);
+	}
+}
+
+template<eBlendMode Mode, bool IsColor>
+static void blend_sse2(uint32* dst, const uint32* src, uint32 count)
+{
+	const __m128i color = _mm_set1_epi32(IsColor ? static_cast<int>(*src) : 0);
+	while (count >= 4)
+	{
+		__m128i s = IsColor ? color : _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+		__m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst), blend_pixels_sse2<Mode>(d, s));
+		dst += 4;
+		src += IsColor ? 0 : 4;
+		count -= 4;
+	}
+	while (count > 0)
+	{
+		*dst = blend_pixel<Mode>(*dst, *src);
+		dst++;
+		src += IsColor ? 0 : 1;
+		count--;
+	}
+}
+
+template<eBlendMode Mode, bool IsColor>
+GG_TARGET_AVX2 static void blend_avx2(uint32* dst, const uint32* src, uint32 count)
+{
+	const __m256i color = _mm256_set1_epi32(IsColor ? static_cast<int>(*src) : 0);
+	while (count >= 16)
+	{
+		__m256i s0 = IsColor ? color : _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src));
+		__m256i s1 = IsColor ? color : _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + 8));
+		__m256i d0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst));
+		__m256i d1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst + 8));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst), blend_pixels_avx2<Mode>(d0, s0));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + 8), blend_pixels_avx2<Mode>(d1, s1));
+		dst += 16;
+		src += IsColor ? 0 : 16;
+		count -= 16;
+	}
+	while (count >= 8)
+	{
+		__m256i s = IsColor ? color : _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src));
+		__m256i d = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst), blend_pixels_avx2<Mode>(d, s));
+		dst += 8;
+		src += IsColor ? 0 : 8;
+		count -= 8;
+	}
+	while (count > 0)
+	{
+		*dst = blend_pixel<Mode>(*dst, *src);
+		dst++;
+		src += IsColor ? 0 : 1;
+		count--;
+	}
+}
+
+// Linear values are quantized to s_linearSteps for the way back to sRGB, enough to give every 8-bit code its own step.
+static constexpr uint32 s_linearSteps = 4096;
+
+struct SrgbTables
+{
+	float toLinear[256];
+	// Padded so 32-bit gathers of the last entries stay inside.
+	uint8 toSrgb[s_linearSteps + 3];
+};
+
+static const SrgbTables& get_srgb_tables()
+{
+	static const SrgbTables s_tables = []() {
+		SrgbTables tables{};
+		for (uint32 code = 0; code < 256; code++)
+		{
+			const float value = code / 255.0f;
+			tables.toLinear[code] = value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+		}
+		for (uint32 step = 0; step < s_linearSteps; step++)
+		{
+			const float value = step / static_cast<float>(s_linearSteps - 1);
+			const float encoded = value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+			tables.toSrgb[step] = static_cast<uint8>(std::min(encoded, 1.0f) * 255.0f + 0.5f);
+		}
+		// Untouched pixels have to round trip exactly, whatever the rounding of the curves above.
+		for (uint32 code = 0; code < 256; code++)
+		{
+			tables.toSrgb[static_cast<uint32>(tables.toLinear[code] * (s_linearSteps - 1) + 0.5f)] = static_cast<uint8>(code);
+		}
+
+		return tables;
+	}();
+
+	return s_tables;
+}
+
+template<eBlendMode Mode>
+static inline uint32 blend_pixel_srgb(uint32 dst, uint32 src, const SrgbTables& tables)
+{
+	const float inverseAlpha = 1.0f - (src >> 24) * (1.0f / 255.0f);
+	uint32 result = blend_pixel<Mode>(dst, src) & 0xFF000000u;
+	for (uint32 shift = 0; shift < 24; shift += 8)
+	{
+		const float s = tables.toLinear[(src >> shift) & 0xFF];
+		const float d = tables.toLinear[(dst >> shift) & 0xFF];
+		float value;
+		if constexpr (Mode == eBlendMode::SourceOver)
+		{
+			value = s + d * inverseAlpha;
+		}
+		else if constexpr (Mode == eBlendMode::Additive)
+		{
+			value = s + d;
+		}
+		else
+		{
+			value = s * d;
+		}
+		const uint32 step = static_cast<uint32>(std::min(value, 1.0f) * (s_linearSteps - 1) + 0.5f);
+		result |= static_cast<uint32>(tables.toSrgb[step]) << shift;
+	}
+
+	return result;
+}
+
+template<eBlendMode Mode, bool IsColor>
+static void blend_srgb_scalar(uint32* dst, const uint32* src, uint32 count)
+{
+	const SrgbTables& tables = get_srgb_tables();
+	for (uint32 i = 0; i < count; i++)
+	{
+		dst[i] = blend_pixel_srgb<Mode>(dst[i], IsColor ? *src : src[i], tables);
+	}
+}
+
+// Decodes with gathers from the 1KB table and encodes with byte gathers from the 4KB one, both stay in L1.
+template<eBlendMode Mode, bool IsColor>
+GG_TARGET_AVX2 static void blend_srgb_avx2(uint32* dst, const uint32* src, uint32 count)
+{
+	const SrgbTables& tables = get_srgb_tables();
+	const __m256i color = _mm256_set1_epi32(IsColor ? static_cast<int>(*src) : 0);
+	const __m256i byteMask = _mm256_set1_epi32(0xFF);
+	const __m256i alphaMask = _mm256_set1_epi32(static_cast<int>(0xFF000000u));
+	const __m256 one = _mm256_set1_ps(1.0f);
+	const __m256 stepScale = _mm256_set1_ps(static_cast<float>(s_linearSteps - 1));
+	const __m256 half = _mm256_set1_ps(0.5f);
+	while (count >= 8)
+	{
+		__m256i s = IsColor ? color : _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src));
+		// Transparent black leaves dst as it is in every mode the conversion is used for, e.g. the corners of sprites.
+		if (Mode != eBlendMode::Multiply && _mm256_testz_si256(s, s))
+		{
+			dst += 8;
+			src += IsColor ? 0 : 8;
+			count -= 8;
+			continue;
+		}
+		__m256i d = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst));
+		__m256i result = _mm256_and_si256(blend_pixels_avx2<Mode>(d, s), alphaMask);
+		__m256 inverseAlpha = _mm256_sub_ps(one, _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_srli_epi32(s, 24)), _mm256_set1_ps(1.0f / 255.0f)));
+		for (int32 shift = 0; shift < 24; shift += 8)
+		{
+			__m256 sLinear = _mm256_i32gather_ps(tables.toLinear, _mm256_and_si256(_mm256_srli_epi32(s, shift), byteMask), 4);
+			__m256 dLinear = _mm256_i32gather_ps(tables.toLinear, _mm256_and_si256(_mm256_srli_epi32(d, shift), byteMask), 4);
+			__m256 value;
+			if constexpr (Mode == eBlendMode::SourceOver)
+			{
+				value = _mm256_add_ps(sLinear, _mm256_mul_ps(dLinear, inverseAlpha));
+			}
+			else if constexpr (Mode == eBlendMode::Additive)
+			{
+				value = _mm256_add_ps(sLinear, dLinear);
+			}
+			else
+			{
+				value = _mm256_mul_ps(sLinear, dLinear);
+			}
+			__m256i step = _mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(_mm256_min_ps(value, one), stepScale), half));
+			__m256i code = _mm256_and_si256(_mm256_i32gather_epi32(reinterpret_cast<const int*>(tables.toSrgb), step, 1), byteMask);
+			result = _mm256_or_si256(result, _mm256_slli_epi32(code, shift));
+		}
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst), result);
+		dst += 8;
+		src += IsColor ? 0 : 8;
+		count -= 8;
+	}
+	while (count > 0)
+	{
+		*dst = blend_pixel_srgb<Mode>(*dst, *src, tables);
+		dst++;
+		src += IsColor ? 0 : 1;
+		count--;
+	}
+}
+
+template<eBlendMode Mode, bool IsColor>
+static BlendFunc select_blend_func(eKernelPath path, bool isGammaCorrect)
+{
+	// Min and max commute with the monotonic sRGB curve, they need no conversion.
+	if (isGammaCorrect && Mode != eBlendMode::Min && Mode != eBlendMode::Max)
+	{
+		return path == eKernelPath::AVX2 ? blend_srgb_avx2<Mode, IsColor> : blend_srgb_scalar<Mode, IsColor>;
+	}
+
+	switch (path)
+	{
+	case eKernelPath::Scalar:
+		return blend_scalar<Mode, IsColor>;
+	case eKernelPath::SSE2:
+		return blend_sse2<Mode, IsColor>;
+	default:
+		return blend_avx2<Mode, IsColor>;
+	}
+}
+
+template<bool IsColor>
+static BlendFunc select_blend_func(eBlendMode mode, eKernelPath path, bool isGammaCorrect)
+{
+	switch (mode)
+	{
+	case eBlendMode::SourceOver:
+		return select_blend_func<eBlendMode::SourceOver, IsColor>(path, isGammaCorrect);
+	case eBlendMode::Additive:
+		return select_blend_func<eBlendMode::Additive, IsColor>(path, isGammaCorrect);
+	case eBlendMode::Multiply:
+		return select_blend_func<eBlendMode::Multiply, IsColor>(path, isGammaCorrect);
+	case eBlendMode::Min:
+		return select_blend_func<eBlendMode::Min, IsColor>(path, isGammaCorrect);
+	default:
+		return select_blend_func<eBlendMode::Max, IsColor>(path, isGammaCorrect);
+	}
+}
+
+static eKernelPath s_blendPath = eKernelPath::Default;
+
+static BlendFunc get_blend_func(eBlendMode mode, bool isColor, bool isGammaCorrect)
+{
+	static constexpr uint32 s_pathCount = 3;
+	static constexpr uint32 s_modeCount = static_cast<uint32>(eBlendMode::Max) + 1;
+	struct BlendFuncs
+	{
+		// [path - eKernelPath::Scalar][mode][isGammaCorrect][isColor]
+		BlendFunc funcs[s_pathCount][s_modeCount][2][2];
+		uint32 defaultPath;
+	};
+
+	static const BlendFuncs s_funcs = []() {
+		const bool isAVX2Supported = Simd::IsAVX2Supported();
+		BlendFuncs funcs{};
+		for (uint32 path = 0; path < s_pathCount; path++)
+		{
+			eKernelPath kernelPath = static_cast<eKernelPath>(path + static_cast<uint32>(eKernelPath::Scalar));
+			if (kernelPath == eKernelPath::AVX2 && !isAVX2Supported)
+			{
+				kernelPath = eKernelPath::SSE2;
+			}
+			for (uint32 i = 0; i < s_modeCount; i++)
+			{
+				for (uint32 gamma = 0; gamma < 2; gamma++)
+				{
+					funcs.funcs[path][i][gamma][0] = select_blend_func<false>(static_cast<eBlendMode>(i), kernelPath, gamma != 0);
+					funcs.funcs[path][i][gamma][1] = select_blend_func<true>(static_cast<eBlendMode>(i), kernelPath, gamma != 0);
+				}
+			}
+		}
+		funcs.defaultPath = static_cast<uint32>(isAVX2Supported ? eKernelPath::AVX2 : eKernelPath::SSE2) - static_cast<uint32>(eKernelPath::Scalar);
+
+		return funcs;
+	}();
+
+	const uint32 path = s_blendPath == eKernelPath::Default ? s_funcs.defaultPath : static_cast<uint32>(s_blendPath) - static_cast<uint32>(eKernelPath::Scalar);
+
+	return s_funcs.funcs[path][static_cast<uint32>(mode)][isGammaCorrect ? 1 : 0][isColor ? 1 : 0];
+}
+
+void SetBlendKernelPath(eKernelPath path)
+{
+	s_blendPath = path;
+}
+
+void Blend(uint32* dst, const uint32* src, uint32 count, eBlendMode mode, bool isGammaCorrect)
+{
+	get_blend_func(mode, false, isGammaCorrect)(dst, src, count);
+}
+
+void BlendColor(uint32* dst, uint32 color, uint32 count, eBlendMode mode, bool isGammaCorrect)
+{
+	get_blend_func(mode, true, isGammaCorrect)(dst, &color, count);
+}
+
+void BlendRect(uint32* dst, uint32 dstPitch, const uint32* src, uint32 srcPitch, uint32 width, uint32 height, eBlendMode mode, bool isGammaCorrect)
+{
+	BlendFunc blend = get_blend_func(mode, false, isGammaCorrect);
+	if (width == dstPitch && width == srcPitch)
+	{
+		blend(dst, src, width * height);
+		return;
+	}
+
+	for (uint32 row = 0; row < height; row++)
+	{
+		blend(dst, src, width);
+		dst += dstPitch;
+		src += srcPitch;
+	}
+}
+
+void BlendColorRect(uint32* dst, uint32 dstPitch, uint32 width, uint32 height, uint32 color, eBlendMode mode, bool isGammaCorrect)
+{
+	BlendFunc blend = get_blend_func(mode, true, isGammaCorrect);
+	if (width == dstPitch)
+	{
+		blend(dst, &color, width * height);
+		return;
+	}
+
+	for (uint32 row = 0; row < height; row++)
+	{
+		blend(dst, &color, width);
+		dst += dstPitch;
+	}
+}
+
+static inline uint32 premultiply_pixel(uint32 pixel)
+{
+	const uint32 alpha = pixel >> 24;
+
+	return div255((pixel & 0xFF) * alpha) | (div255(((pixel >> 8) & 0xFF) * alpha) << 8) | (div255(((pixel >> 16) & 0xFF) * alpha) << 16) | (pixel & 0xFF000000u);
+}
+
+void Premultiply(uint32* pixels, uint32 count, bool isGammaCorrect)
+{
+	if (isGammaCorrect)
+	{
+		const SrgbTables& tables = get_srgb_tables();
+		for (uint32 i = 0; i < count; i++)
+		{
+			const uint32 pixel = pixels[i];
+			const float alpha = (pixel >> 24) * (1.0f / 255.0f);
+			uint32 result = pixel & 0xFF000000u;
+			for (uint32 shift = 0; shift < 24; shift += 8)
+			{
+				const float value = tables.toLinear[(pixel >> shift) & 0xFF] * alpha;
+				result |= static_cast<uint32>(tables.toSrgb[static_cast<uint32>(value * (s_linearSteps - 1) + 0.5f)]) << shift;
+			}
+			pixels[i] = result;
+		}
+		return;
+	}
+
+	// Straight alpha content is converted once at load time, SSE2 is enough.
+	const __m128i alphaMask = _mm_set1_epi32(static_cast<int>(0xFF000000u));
+	while (count >= 4)
+	{
+		__m128i p = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pixels));
+		__m128i color = mul_div255_sse2(p, broadcast_alpha_sse2(p));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(pixels), _mm_or_si128(_mm_andnot_si128(alphaMask, color), _mm_and_si128(p, alphaMask)));
+		pixels += 4;
+		count -= 4;
+	}
+	while (count > 0)
+	{
+		*pixels = premultiply_pixel(*pixels);
+		pixels++;
+		count--;
+	}
+}
+
+}
+}
\ No newline at end of file
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "Base.hpp"
+
+namespace GG {
+
+// Pixels are RGBA8 packed into a 32-bit word, R in the lowest byte (VK_FORMAT_R8G8B8A8_UNORM in memory).
+inline uint32 PackColor(uint8 r, uint8 g, uint8 b, uint8 a)
+{
+	return static_cast<uint32>(r) | (static_cast<uint32>(g) << 8) | (static_cast<uint32>(b) << 16) | (static_cast<uint32>(a) << 24);
+}
+
+inline uint32 PackColor(const uint8* color)
+{
+	return PackColor(color[0], color[1], color[2], color[3]);
+}
+
+inline uint32 PackColor(const float* color)
+{
+	return PackColor(static_cast<uint8>(color[0] * 255.0f), static_cast<uint8>(color[1] * 255.0f), static_cast<uint8>(color[2] * 255.0f), static_cast<uint8>(color[3] * 255.0f));
+}
+
+// Blend equations of the blend kernels, on colors premultiplied by alpha. Every channel including alpha follows the equation.
+enum class eBlendMode
+{
+	// dst = src + dst * (1 - src.a), translucent content.
+	SourceOver,
+	// dst = min(src + dst, 1), glows and particles.
+	Additive,
+	// dst = src * dst, modulates dst by src.
+	Multiply,
+	Min,
+	Max,
+};
+
+// Instruction sets of the blend kernels. Default is AVX2 when the CPU has it and SSE2 otherwise.
+enum class eKernelPath
+{
+	Default,
+	Scalar,
+	SSE2,
+	AVX2,
+};
+
+// Bulk 32-bit pixel kernels. SSE2 is the baseline, AVX2 is selected once at runtime.
+// None of these clip; callers clip once per call and pass in-range pointers.
+namespace PixelKernel {
+
+void Fill(uint32* dst, uint32 color, uint32 count);
+void Copy(uint32* dst, const uint32* src, uint32 count);
+
+void FillRect(uint32* dst, uint32 dstPitch, uint32 width, uint32 height, uint32 color);
+void CopyRect(uint32* dst, uint32 dstPitch, const uint32* src, uint32 srcPitch, uint32 width, uint32 height);
+
+// Converts one 8x8 block between row-major and Morton order (x in the even bits, y in the odd bits of the index).
+// Pitches are in pixels, the Morton side is 64 contiguous pixels.
+void TileBlock(uint32* dst, const uint32* src, uint32 srcPitch);
+void DetileBlock(uint32* dst, uint32 dstPitch, const uint32* src);
+
+// Blends src (or a single color) over dst, with premultiplied colors. AVX2 blends 8 pixels per instruction.
+// With isGammaCorrect the color channels are sRGB encoded and blended in linear space through lookup tables, alpha is always linear.
+void Blend(uint32* dst, const uint32* src, uint32 count, eBlendMode mode, bool isGammaCorrect = false);
+void BlendColor(uint32* dst, uint32 color, uint32 count, eBlendMode mode, bool isGammaCorrect = false);
+void BlendRect(uint32* dst, uint32 dstPitch, const uint32* src, uint32 srcPitch, uint32 width, uint32 height, eBlendMode mode, bool isGammaCorrect = false);
+void BlendColorRect(uint32* dst, uint32 dstPitch, uint32 width, uint32 height, uint32 color, eBlendMode mode, bool isGammaCorrect = false);
+// Picks the blend kernels of every following blend, for checking the paths against each other. AVX2 falls back to SSE2 without CPU support.
+// Not thread safe, nothing may blend while it changes.
+void SetBlendKernelPath(eKernelPath path);
+// Multiplies the color channels of straight alpha pixels by their alpha in place, in linear space with isGammaCorrect.
+void Premultiply(uint32* pixels, uint32 count, bool isGammaCorrect = false);
+
+}
+}
\ No newline at end of file
@@ -0,0 +1,526 @@
+#include "SystemPch.h"
+
+#include "Texture2D.h"
+#include "Utility/Simd.hpp"
+
+namespace GG {
+
+// Samples per call of the level kernels inside SampleQuads() and Sample(), bounds the scratch buffers on the stack.
+static constexpr uint32 s_sampleChunk = 64;
+
+// What the level kernels need of a level and a sampler.
+struct LevelSampler
+{
+	const uint32* texels;
+	int32 width;
+	int32 height;
+	int32 pitch;
+	float widthF;
+	float heightF;
+	float inverseWidth;
+	float inverseHeight;
+	bool isTiled;
+	bool isPoint;
+	bool isRepeatU;
+	bool isRepeatV;
+};
+
+using SampleLevelFunc = void(*)(const LevelSampler&, const float*, const float*, uint32*, uint32);
+using BlendFunc = void(*)(uint32*, const uint32*, const int32*, uint32);
+
+static inline uint32 texel_offset(const LevelSampler& sampler, int32 x, int32 y)
+{
+	if (!sampler.isTiled)
+	{
+		return static_cast<uint32>(y * sampler.pitch + x);
+	}
+
+	const uint32 tile = static_cast<uint32>((y >> 2) * sampler.pitch + (x >> 2));
+	const uint32 inner = (x & 1) | ((y & 1) << 1) | ((x & 2) << 1) | ((y & 2) << 2);
+
+	return tile * Texture2D::s_tileTexels + inner;
+}
+
+// SSE2 has no floor, truncate and step down where that rounded up.
+static inline __m128 floor_sse2(__m128 value)
+{
+	const __m128 truncated = _mm_cvtepi32_ps(_mm_cvttps_epi32(value));
+
+	return _mm_sub_ps(truncated, _mm_and_ps(_mm_cmpgt_ps(truncated, value), _mm_set1_ps(1.0f)));
+}
+
+// Integral texel coordinate to [0, size). Repeat takes the float remainder, the quotient may be one off from rounding
+// the reciprocal, which the correction step fixes. NaN and coordinates too large for the float remainder end up anywhere,
+// so the result is clamped as well: max_ps returns its second operand for NaN, which turns it into 0.
+static inline __m128 wrap_sse2(__m128 coordinate, __m128 size, __m128 inverseSize, bool isRepeat)
+{
+	if (isRepeat)
+	{
+		const __m128 wrapped = _mm_sub_ps(coordinate, _mm_mul_ps(floor_sse2(_mm_mul_ps(coordinate, inverseSize)), size));
+		const __m128 corrected = _mm_sub_ps(wrapped, _mm_and_ps(_mm_cmpge_ps(wrapped, size), size));
+		const __m128 positive = _mm_add_ps(corrected, _mm_and_ps(_mm_cmplt_ps(corrected, _mm_setzero_ps()), size));
+
+		return _mm_min_ps(_mm_max_ps(positive, _mm_setzero_ps()), _mm_sub_ps(size, _mm_set1_ps(1.0f)));
+	}
+
+	return _mm_min_ps(_mm_max_ps(coordinate, _mm_setzero_ps()), _mm_sub_ps(size, _mm_set1_ps(1.0f)));
+}
+
+// a * (256 - weight) + b * weight per channel, rounded. Weights are 32-bit per texel in [0, 256],
+// the sum stays below 2^16 so unsigned 16-bit lanes hold it exactly.
+static inline __m128i lerp_texels_sse2(__m128i a, __m128i b, __m128i weights)
+{
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i full = _mm_set1_epi16(256);
+	const __m128i half = _mm_set1_epi16(128);
+
+	__m128i weights16 = _mm_packs_epi32(weights, weights);
+	weights16 = _mm_unpacklo_epi16(weights16, weights16);
+	const __m128i weightsLo = _mm_unpacklo_epi32(weights16, weights16);
+	const __m128i weightsHi = _mm_unpackhi_epi32(weights16, weights16);
+
+	const __m128i lo = _mm_add_epi16(
+		_mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(a, zero), _mm_sub_epi16(full, weightsLo)), _mm_mullo_epi16(_mm_unpacklo_epi8(b, zero), weightsLo)), half);
+	const __m128i hi = _mm_add_epi16(
+		_mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(a, zero), _mm_sub_epi16(full, weightsHi)), _mm_mullo_epi16(_mm_unpackhi_epi8(b, zero), weightsHi)), half);
+
+	return _mm_packus_epi16(_mm_srli_epi16(lo, 8), _mm_srli_epi16(hi, 8));
+}
+
+// count is a multiple of 4. Coordinates and weights are computed 4 wide, the texels are fetched one by one.
+static void sample_level_sse2(const LevelSampler& sampler, const float* u, const float* v, uint32* outColors, uint32 count)
+{
+	const __m128 width = _mm_set1_ps(sampler.widthF);
+	const __m128 height = _mm_set1_ps(sampler.heightF);
+	const __m128 inverseWidth = _mm_set1_ps(sampler.inverseWidth);
+	const __m128 inverseHeight = _mm_set1_ps(sampler.inverseHeight);
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 weightScale = _mm_set1_ps(256.0f);
+	// Bilinear samples between the centers of the texels around the coordinate.
+	const __m128 centerOffset = _mm_set1_ps(sampler.isPoint ? 0.0f : 0.5f);
+
+	for (uint32 i = 0; i < count; i += 4)
+	{
+		const __m128 texelU = _mm_sub_ps(_mm_mul_ps(_mm_loadu_ps(u + i), width), centerOffset);
+		const __m128 texelV = _mm_sub_ps(_mm_mul_ps(_mm_loadu_ps(v + i), height), centerOffset);
+		const __m128 floorU = floor_sse2(texelU);
+		const __m128 floorV = floor_sse2(texelV);
+
+		alignas(16) int32 x0[4];
+		alignas(16) int32 y0[4];
+		_mm_store_si128(reinterpret_cast<__m128i*>(x0), _mm_cvttps_epi32(wrap_sse2(floorU, width, inverseWidth, sampler.isRepeatU)));
+		_mm_store_si128(reinterpret_cast<__m128i*>(y0), _mm_cvttps_epi32(wrap_sse2(floorV, height, inverseHeight, sampler.isRepeatV)));
+
+		if (sampler.isPoint)
+		{
+			for (uint32 lane = 0; lane < 4; lane++)
+			{
+				outColors[i + lane] = sampler.texels[texel_offset(sampler, x0[lane], y0[lane])];
+			}
+			continue;
+		}
+
+		alignas(16) int32 x1[4];
+		alignas(16) int32 y1[4];
+		_mm_store_si128(reinterpret_cast<__m128i*>(x1), _mm_cvttps_epi32(wrap_sse2(_mm_add_ps(floorU, one), width, inverseWidth, sampler.isRepeatU)));
+		_mm_store_si128(reinterpret_cast<__m128i*>(y1), _mm_cvttps_epi32(wrap_sse2(_mm_add_ps(floorV, one), height, inverseHeight, sampler.isRepeatV)));
+		const __m128i weightU = _mm_cvttps_epi32(_mm_mul_ps(_mm_sub_ps(texelU, floorU), weightScale));
+		const __m128i weightV = _mm_cvttps_epi32(_mm_mul_ps(_mm_sub_ps(texelV, floorV), weightScale));
+
+		alignas(16) uint32 texels[4][4];
+		for (uint32 lane = 0; lane < 4; lane++)
+		{
+			texels[0][lane] = sampler.texels[texel_offset(sampler, x0[lane], y0[lane])];
+			texels[1][lane] = sampler.texels[texel_offset(sampler, x1[lane], y0[lane])];
+			texels[2][lane] = sampler.texels[texel_offset(sampler, x0[lane], y1[lane])];
+			texels[3][lane] = sampler.texels[texel_offset(sampler, x1[lane], y1[lane])];
+		}
+
+		const __m128i top = lerp_texels_sse2(_mm_load_si128(reinterpret_cast<const __m128i*>(texels[0])), _mm_load_si128(reinterpret_cast<const __m128i*>(texels[1])), weightU);
+		const __m128i bottom = lerp_texels_sse2(_mm_load_si128(reinterpret_cast<const __m128i*>(texels[2])), _mm_load_si128(reinterpret_cast<const __m128i*>(texels[3])), weightU);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(outColors + i), lerp_texels_sse2(top, bottom, weightV));
+	}
+}
+
+GG_TARGET_AVX2 static inline __m256 wrap_avx2(__m256 coordinate, __m256 size, __m256 inverseSize, bool isRepeat)
+{
+	if (isRepeat)
+	{
+		const __m256 wrapped = _mm256_fnmadd_ps(_mm256_floor_ps(_mm256_mul_ps(coordinate, inverseSize)), size, coordinate);
+		const __m256 corrected = _mm256_sub_ps(wrapped, _mm256_and_ps(_mm256_cmp_ps(wrapped, size, _CMP_GE_OQ), size));
+		const __m256 positive = _mm256_add_ps(corrected, _mm256_and_ps(_mm256_cmp_ps(corrected, _mm256_setzero_ps(), _CMP_LT_OQ), size));
+
+		// Same clamp as wrap_sse2().
+		return _mm256_min_ps(_mm256_max_ps(positive, _mm256_setzero_ps()), _mm256_sub_ps(size, _mm256_set1_ps(1.0f)));
+	}
+
+	return _mm256_min_ps(_mm256_max_ps(coordinate, _mm256_setzero_ps()), _mm256_sub_ps(size, _mm256_set1_ps(1.0f)));
+}
+
+GG_TARGET_AVX2 static inline __m256i texel_offset_avx2(const LevelSampler& sampler, __m256i x, __m256i y)
+{
+	const __m256i pitch = _mm256_set1_epi32(sampler.pitch);
+	if (!sampler.isTiled)
+	{
+		return _mm256_add_epi32(_mm256_mullo_epi32(y, pitch), x);
+	}
+
+	const __m256i one = _mm256_set1_epi32(1);
+	const __m256i two = _mm256_set1_epi32(2);
+	const __m256i tile = _mm256_add_epi32(_mm256_mullo_epi32(_mm256_srli_epi32(y, 2), pitch), _mm256_srli_epi32(x, 2));
+	__m256i inner = _mm256_or_si256(_mm256_and_si256(x, one), _mm256_slli_epi32(_mm256_and_si256(y, one), 1));
+	inner = _mm256_or_si256(inner, _mm256_or_si256(_mm256_slli_epi32(_mm256_and_si256(x, two), 1), _mm256_slli_epi32(_mm256_and_si256(y, two), 2)));
+
+	return _mm256_add_epi32(_mm256_slli_epi32(tile, 4), inner);
+}
+
+GG_TARGET_AVX2 static inline __m256i lerp_texels_avx2(__m256i a, __m256i b, __m256i weights)
+{
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i full = _mm256_set1_epi16(256);
+	const __m256i half = _mm256_set1_epi16(128);
+
+	// The unpacks work inside each 128-bit half, texels and weights are spread the same way.
+	__m256i weights16 = _mm256_packs_epi32(weights, weights);
+	weights16 = _mm256_unpacklo_epi16(weights16, weights16);
+	const __m256i weightsLo = _mm256_unpacklo_epi32(weights16, weights16);
+	const __m256i weightsHi = _mm256_unpackhi_epi32(weights16, weights16);
+
+	const __m256i lo = _mm256_add_epi16(
+		_mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpacklo_epi8(a, zero), _mm256_sub_epi16(full, weightsLo)), _mm256_mullo_epi16(_mm256_unpacklo_epi8(b, zero), weightsLo)), half);
+	const __m256i hi = _mm256_add_epi16(
+		_mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpackhi_epi8(a, zero), _mm256_sub_epi16(full, weightsHi)), _mm256_mullo_epi16(_mm256_unpackhi_epi8(b, zero), weightsHi)), half);
+
+	return _mm256_packus_epi16(_mm256_srli_epi16(lo, 8), _mm256_srli_epi16(hi, 8));
+}
+
+// 8 samples per iteration with gathered texels, a remaining group of 4 goes to the SSE2 kernel.
+GG_TARGET_AVX2 static void sample_level_avx2(const LevelSampler& sampler, const float* u, const float* v, uint32* outColors, uint32 count)
+{
+	const __m256 width = _mm256_set1_ps(sampler.widthF);
+	const __m256 height = _mm256_set1_ps(sampler.heightF);
+	const __m256 inverseWidth = _mm256_set1_ps(sampler.inverseWidth);
+	const __m256 inverseHeight = _mm256_set1_ps(sampler.inverseHeight);
+	const __m256 one = _mm256_set1_ps(1.0f);
+	const __m256 weightScale = _mm256_set1_ps(256.0f);
+	const __m256 centerOffset = _mm256_set1_ps(sampler.isPoint ? 0.0f : 0.5f);
+	const int* texels = reinterpret_cast<const int*>(sampler.texels);
+
+	uint32 i = 0;
+	for (; i + 8 <= count; i += 8)
+	{
+		const __m256 texelU = _mm256_fmsub_ps(_mm256_loadu_ps(u + i), width, centerOffset);
+		const __m256 texelV = _mm256_fmsub_ps(_mm256_loadu_ps(v + i), height, centerOffset);
+		const __m256 floorU = _mm256_floor_ps(texelU);
+		const __m256 floorV = _mm256_floor_ps(texelV);
+		const __m256i x0 = _mm256_cvttps_epi32(wrap_avx2(floorU, width, inverseWidth, sampler.isRepeatU));
+		const __m256i y0 = _mm256_cvttps_epi32(wrap_avx2(floorV, height, inverseHeight, sampler.isRepeatV));
+
+		if (sampler.isPoint)
+		{
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(outColors + i), _mm256_i32gather_epi32(texels, texel_offset_avx2(sampler, x0, y0), 4));
+			continue;
+		}
+
+		const __m256i x1 = _mm256_cvttps_epi32(wrap_avx2(_mm256_add_ps(floorU, one), width, inverseWidth, sampler.isRepeatU));
+		const __m256i y1 = _mm256_cvttps_epi32(wrap_avx2(_mm256_add_ps(floorV, one), height, inverseHeight, sampler.isRepeatV));
+		const __m256i weightU = _mm256_cvttps_epi32(_mm256_mul_ps(_mm256_sub_ps(texelU, floorU), weightScale));
+		const __m256i weightV = _mm256_cvttps_epi32(_mm256_mul_ps(_mm256_sub_ps(texelV, floorV), weightScale));
+
+		const __m256i texel00 = _mm256_i32gather_epi32(texels, texel_offset_avx2(sampler, x0, y0), 4);
+		const __m256i texel10 = _mm256_i32gather_epi32(texels, texel_offset_avx2(sampler, x1, y0), 4);
+		const __m256i texel01 = _mm256_i32gather_epi32(texels, texel_offset_avx2(sampler, x0, y1), 4);
+		const __m256i texel11 = _mm256_i32gather_epi32(texels, texel_offset_avx2(sampler, x1, y1), 4);
+
+		const __m256i top = lerp_texels_avx2(texel00, texel10, weightU);
+		const __m256i bottom = lerp_texels_avx2(texel01, texel11, weightU);
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(outColors + i), lerp_texels_avx2(top, bottom, weightV));
+	}
+
+	if (i < count)
+	{
+		sample_level_sse2(sampler, u + i, v + i, outColors + i, count - i);
+	}
+}
+
+static SampleLevelFunc get_sample_level_func()
+{
+	static const SampleLevelFunc s_func = Simd::IsAVX2Supported() ? sample_level_avx2 : sample_level_sse2;
+
+	return s_func;
+}
+
+// Blends the samples of the next level into colors, count is a multiple of 4.
+static void blend_levels_sse2(uint32* colors, const uint32* nextColors, const int32* weights, uint32 count)
+{
+	for (uint32 i = 0; i < count; i += 4)
+	{
+		__m128i* dst = reinterpret_cast<__m128i*>(colors + i);
+		const __m128i next = _mm_loadu_si128(reinterpret_cast<const __m128i*>(nextColors + i));
+		_mm_storeu_si128(dst, lerp_texels_sse2(_mm_loadu_si128(dst), next, _mm_loadu_si128(reinterpret_cast<const __m128i*>(weights + i))));
+	}
+}
+
+GG_TARGET_AVX2 static void blend_levels_avx2(uint32* colors, const uint32* nextColors, const int32* weights, uint32 count)
+{
+	uint32 i = 0;
+	for (; i + 8 <= count; i += 8)
+	{
+		__m256i* dst = reinterpret_cast<__m256i*>(colors + i);
+		const __m256i next = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(nextColors + i));
+		_mm256_storeu_si256(dst, lerp_texels_avx2(_mm256_loadu_si256(dst), next, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(weights + i))));
+	}
+
+	if (i < count)
+	{
+		blend_levels_sse2(colors + i, nextColors + i, weights + i, count - i);
+	}
+}
+
+static BlendFunc get_blend_func()
+{
+	static const BlendFunc s_func = Simd::IsAVX2Supported() ? blend_levels_avx2 : blend_levels_sse2;
+
+	return s_func;
+}
+
+// Rounded average of up to four texels per channel.
+static uint32 average_texels(uint32 c00, uint32 c10, uint32 c01, uint32 c11)
+{
+	uint32 result = 0;
+	for (uint32 shift = 0; shift < 32; shift += 8)
+	{
+		const uint32 sum = ((c00 >> shift) & 0xFF) + ((c10 >> shift) & 0xFF) + ((c01 >> shift) & 0xFF) + ((c11 >> shift) & 0xFF);
+		result |= ((sum + 2) / 4) << shift;
+	}
+
+	return result;
+}
+
+void Texture2D::Create(uint32 width, uint32 height, const uint32* pixels, uint32 pitch, bool generateMips, eTextureLayout layout)
+{
+	GG_ASSERT(width > 0 && height > 0 && pixels, "Texture needs texels!");
+
+	_layout = layout;
+	_levels.clear();
+
+	size_t texelCount = 0;
+	for (uint32 levelWidth = width, levelHeight = height; ; levelWidth = std::max(levelWidth / 2, 1u), levelHeight = std::max(levelHeight / 2, 1u))
+	{
+		Level level;
+		level.width = levelWidth;
+		level.height = levelHeight;
+		level.offset = texelCount;
+		if (layout == eTextureLayout::Tiled)
+		{
+			level.pitch = (levelWidth + s_tileSize - 1) / s_tileSize;
+			texelCount += static_cast<size_t>(level.pitch) * ((levelHeight + s_tileSize - 1) / s_tileSize) * s_tileTexels;
+		}
+		else
+		{
+			level.pitch = levelWidth;
+			texelCount += static_cast<size_t>(levelWidth) * levelHeight;
+		}
+		_levels.push_back(level);
+
+		if (!generateMips || (levelWidth == 1 && levelHeight == 1))
+		{
+			break;
+		}
+	}
+	_texels.assign(texelCount, 0);
+
+	// Every level is filtered from the linear copy of the one above it, then stored in the texture's layout.
+	std::vector<uint32> source(static_cast<size_t>(width) * height);
+	for (uint32 y = 0; y < height; y++)
+	{
+		std::copy(pixels + static_cast<size_t>(y) * pitch, pixels + static_cast<size_t>(y) * pitch + width, source.data() + static_cast<size_t>(y) * width);
+	}
+
+	std::vector<uint32> filtered;
+	for (size_t levelIndex = 0; levelIndex < _levels.size(); levelIndex++)
+	{
+		const Level& level = _levels[levelIndex];
+		if (levelIndex > 0)
+		{
+			const Level& parent = _levels[levelIndex - 1];
+			filtered.resize(static_cast<size_t>(level.width) * level.height);
+			for (uint32 y = 0; y < level.height; y++)
+			{
+				const uint32* row0 = source.data() + static_cast<size_t>(std::min(y * 2, parent.height - 1)) * parent.width;
+				const uint32* row1 = source.data() + static_cast<size_t>(std::min(y * 2 + 1, parent.height - 1)) * parent.width;
+				for (uint32 x = 0; x < level.width; x++)
+				{
+					const uint32 x0 = std::min(x * 2, parent.width - 1);
+					const uint32 x1 = std::min(x * 2 + 1, parent.width - 1);
+					filtered[static_cast<size_t>(y) * level.width + x] = average_texels(row0[x0], row0[x1], row1[x0], row1[x1]);
+				}
+			}
+			source.swap(filtered);
+		}
+
+		for (uint32 y = 0; y < level.height; y++)
+		{
+			for (uint32 x = 0; x < level.width; x++)
+			{
+				_texels[texelIndex(level, x, y)] = source[static_cast<size_t>(y) * level.width + x];
+			}
+		}
+	}
+}
+
+void Texture2D::Release()
+{
+	_texels.clear();
+	_texels.shrink_to_fit();
+	_levels.clear();
+}
+
+void Texture2D::Sample(const SamplerState& sampler, const float* u, const float* v, float lod, uint32* outColors, uint32 count) const
+{
+	GG_ASSERT(IsCreated(), "Texture isn't created!");
+
+	uint32 level;
+	int32 blendWeight;
+	selectLevel(sampler, lod, level, blendWeight);
+
+	alignas(32) int32 blendWeights[s_sampleChunk];
+	std::fill(blendWeights, blendWeights + s_sampleChunk, blendWeight);
+	const int32* weights = blendWeight != 0 ? blendWeights : nullptr;
+
+	const uint32 count4 = count & ~3u;
+	for (uint32 i = 0; i < count4; i += s_sampleChunk)
+	{
+		sampleLevels(sampler, level, weights, u + i, v + i, outColors + i, std::min(s_sampleChunk, count4 - i));
+	}
+
+	// The kernels work on groups of 4, pad the tail.
+	if (count4 < count)
+	{
+		float tailU[4]{};
+		float tailV[4]{};
+		uint32 tailColors[4];
+		std::copy(u + count4, u + count, tailU);
+		std::copy(v + count4, v + count, tailV);
+		sampleLevels(sampler, level, weights, tailU, tailV, tailColors, 4);
+		std::copy(tailColors, tailColors + (count - count4), outColors + count4);
+	}
+}
+
+void Texture2D::SampleQuads(const SamplerState& sampler, const float* u, const float* v, uint32* outColors, uint32 count) const
+{
+	GG_ASSERT(IsCreated(), "Texture isn't created!");
+	GG_ASSERT(count % 4 == 0, "Samples have to be whole quads!");
+
+	alignas(32) int32 blendWeights[s_sampleChunk];
+	for (uint32 begin = 0; begin < count; )
+	{
+		// Consecutive quads in the same level are sampled together, a run of a block usually is.
+		uint32 level;
+		int32 blendWeight;
+		selectLevel(sampler, ComputeQuadLod(u + begin, v + begin), level, blendWeight);
+		bool isBlended = blendWeight != 0;
+		std::fill(blendWeights, blendWeights + 4, blendWeight);
+
+		uint32 end = begin + 4;
+		while (end < count && end - begin < s_sampleChunk)
+		{
+			uint32 nextLevel;
+			selectLevel(sampler, ComputeQuadLod(u + end, v + end), nextLevel, blendWeight);
+			if (nextLevel != level)
+			{
+				break;
+			}
+			isBlended |= blendWeight != 0;
+			std::fill(blendWeights + (end - begin), blendWeights + (end - begin) + 4, blendWeight);
+			end += 4;
+		}
+
+		sampleLevels(sampler, level, isBlended ? blendWeights : nullptr, u + begin, v + begin, outColors + begin, end - begin);
+		begin = end;
+	}
+}
+
+float Texture2D::ComputeQuadLod(const float* u, const float* v) const
+{
+	const float width = static_cast<float>(_levels[0].width);
+	const float height = static_cast<float>(_levels[0].height);
+	const float dudx = (u[1] - u[0]) * width;
+	const float dvdx = (v[1] - v[0]) * height;
+	const float dudy = (u[2] - u[0]) * width;
+	const float dvdy = (v[2] - v[0]) * height;
+	const float footprint = std::max(dudx * dudx + dvdx * dvdx, dudy * dudy + dvdy * dvdy);
+
+	// log2 of the footprint's length, -inf for a magnified constant quad which clamps to level 0.
+	return 0.5f * std::log2(footprint);
+}
+
+uint32 Texture2D::GetTexel(uint32 level, uint32 x, uint32 y) const
+{
+	GG_ASSERT(level < _levels.size() && x < _levels[level].width && y < _levels[level].height, "Texel is out of the texture!");
+
+	return _texels[texelIndex(_levels[level], x, y)];
+}
+
+size_t Texture2D::texelIndex(const Level& level, uint32 x, uint32 y) const
+{
+	if (_layout == eTextureLayout::Linear)
+	{
+		return level.offset + static_cast<size_t>(y) * level.pitch + x;
+	}
+
+	const size_t tile = static_cast<size_t>(y / s_tileSize) * level.pitch + x / s_tileSize;
+	const uint32 inner = (x & 1) | ((y & 1) << 1) | ((x & 2) << 1) | ((y & 2) << 2);
+
+	return level.offset + tile * s_tileTexels + inner;
+}
+
+void Texture2D::sampleLevel(const SamplerState& sampler, uint32 level, const float* u, const float* v, uint32* outColors, uint32 count) const
+{
+	const Level& source = _levels[level];
+	LevelSampler levelSampler;
+	levelSampler.texels = _texels.data() + source.offset;
+	levelSampler.width = static_cast<int32>(source.width);
+	levelSampler.height = static_cast<int32>(source.height);
+	levelSampler.pitch = static_cast<int32>(source.pitch);
+	levelSampler.widthF = static_cast<float>(source.width);
+	levelSampler.heightF = static_cast<float>(source.height);
+	levelSampler.inverseWidth = 1.0f / levelSampler.widthF;
+	levelSampler.inverseHeight = 1.0f / levelSampler.heightF;
+	levelSampler.isTiled = _layout == eTextureLayout::Tiled;
+	levelSampler.isPoint = sampler.filter == eTextureFilter::Point;
+	levelSampler.isRepeatU = sampler.wrapU == eTextureWrap::Repeat;
+	levelSampler.isRepeatV = sampler.wrapV == eTextureWrap::Repeat;
+
+	get_sample_level_func()(levelSampler, u, v, outColors, count);
+}
+
+void Texture2D::sampleLevels(const SamplerState& sampler, uint32 level, const int32* blendWeights, const float* u, const float* v, uint32* outColors, uint32 count) const
+{
+	sampleLevel(sampler, level, u, v, outColors, count);
+	if (blendWeights)
+	{
+		alignas(32) uint32 nextColors[s_sampleChunk];
+		sampleLevel(sampler, level + 1, u, v, nextColors, count);
+		get_blend_func()(outColors, nextColors, blendWeights, count);
+	}
+}
+
+void Texture2D::selectLevel(const SamplerState& sampler, float lod, uint32& outLevel, int32& outBlendWeight) const
+{
+	const float maxLevel = static_cast<float>(_levels.size() - 1);
+	// 0 first, so a NaN LOD ends up at level 0 as well.
+	const float clampedLod = std::min(std::max(0.0f, lod + sampler.lodBias), maxLevel);
+
+	if (sampler.filter != eTextureFilter::Trilinear)
+	{
+		outLevel = static_cast<uint32>(clampedLod + 0.5f);
+		outBlendWeight = 0;
+		return;
+	}
+
+	outLevel = static_cast<uint32>(clampedLod);
+	outBlendWeight = static_cast<int32>((clampedLod - static_cast<float>(outLevel)) * 256.0f);
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <vector>
+
+#include "Base.hpp"
+
+#include "Core/Log.h"
+#include "Graphics/TextureBuffer.h"
+
+namespace GG {
+
+enum class eTextureFilter
+{
+	Point,
+	// Bilinear in the nearest mip level.
+	Bilinear,
+	// Bilinear in the two nearest mip levels, blended by the fraction of the LOD.
+	Trilinear,
+};
+
+enum class eTextureWrap
+{
+	Repeat,
+	Clamp,
+};
+
+struct SamplerState
+{
+	eTextureFilter filter = eTextureFilter::Trilinear;
+	eTextureWrap wrapU = eTextureWrap::Repeat;
+	eTextureWrap wrapV = eTextureWrap::Repeat;
+	float lodBias = 0.0f;
+};
+
+// Read only RGBA8 texture with a mip chain for the software rasterizer, texel (0, 0) covers [0, 1 / width) x [0, 1 / height).
+// The tiled layout stores every level in s_tileSize x s_tileSize tiles of one cache line each, texels in Morton order inside
+// and tiles row by row, so a bilinear footprint mostly hits a single line whichever way the screen walks over the texture.
+// Samplers filter 8 texels at a time with AVX2 gathers or 4 with SSE2, in 8-bit fixed point weights like GPUs.
+class Texture2D
+{
+public:
+	static constexpr uint32			s_tileSize = 4;
+	static constexpr uint32			s_tileTexels = s_tileSize * s_tileSize;
+
+	Texture2D() = default;
+	~Texture2D() = default;
+
+	Texture2D(const Texture2D&) = delete;
+	Texture2D& operator=(const Texture2D&) = delete;
+
+	// pixels holds width x height packed RGBA8 texels in rows of pitch texels. The mip chain is a 2x2 box filter down to 1x1.
+	void Create(uint32 width, uint32 height, const uint32* pixels, uint32 pitch, bool generateMips = true, eTextureLayout layout = eTextureLayout::Tiled);
+	void Release();
+
+	// count samples at normalized coordinates u, v, all at the same LOD (0 is the base level) plus the sampler's bias.
+	void Sample(const SamplerState& sampler, const float* u, const float* v, float lod, uint32* outColors, uint32 count) const;
+	// count is a multiple of 4 and every 4 samples are a 2x2 pixel quad (top-left, top-right, bottom-left, bottom-right),
+	// the order of the lanes in a run of a tiled TextureBuffer block. Each quad picks its LOD from its own derivatives.
+	void SampleQuads(const SamplerState& sampler, const float* u, const float* v, uint32* outColors, uint32 count) const;
+
+	// LOD of a quad in the SampleQuads() order, log2 of the larger texel footprint of a screen pixel step.
+	float ComputeQuadLod(const float* u, const float* v) const;
+
+	uint32 GetTexel(uint32 level, uint32 x, uint32 y) const;
+
+	inline uint32 GetWidth() const { return _levels.empty() ? 0 : _levels[0].width; }
+	inline uint32 GetHeight() const { return _levels.empty() ? 0 : _levels[0].height; }
+	inline uint32 GetLevelCount() const { return static_cast<uint32>(_levels.size()); }
+	inline eTextureLayout GetLayout() const { return _layout; }
+	inline bool IsCreated() const { return !_levels.empty(); }
+
+private:
+	struct Level
+	{
+		uint32 width;
+		uint32 height;
+		// Tiles per row in the tiled layout, texels per row in the linear one.
+		uint32 pitch;
+		// First texel of the level in _texels.
+		size_t offset;
+	};
+
+	size_t texelIndex(const Level& level, uint32 x, uint32 y) const;
+	// Samples count (a multiple of 4) texels of one level with the sampler's filter, trilinear is bilinear here.
+	void sampleLevel(const SamplerState& sampler, uint32 level, const float* u, const float* v, uint32* outColors, uint32 count) const;
+	// Samples level and, where blendWeights isn't null, blends in level + 1 with the weight of each sample in [0, 256].
+	void sampleLevels(const SamplerState& sampler, uint32 level, const int32* blendWeights, const float* u, const float* v, uint32* outColors, uint32 count) const;
+	// Level and blend weight of a LOD for the sampler's filter, the weight is 0 unless filtering trilinear.
+	void selectLevel(const SamplerState& sampler, float lod, uint32& outLevel, int32& outBlendWeight) const;
+
+	std::vector<uint32>				_texels;
+	std::vector<Level>				_levels;
+	eTextureLayout					_layout = eTextureLayout::Tiled;
+};
+
+}
\ No newline at end of file
@@ -0,0 +1,568 @@
+#include "SystemPch.h"
+
+#include "TextureBuffer.h"
+#include "Core/Log.h"
+
+#include <new>
+
+namespace GG {
+
+static constexpr uint32 s_blockPixels = TextureBuffer::s_blockSize * TextureBuffer::s_blockSize;
+
+// Morton offsets inside an 8x8 block, x goes to the even bits and y to the odd bits.
+static constexpr uint8 s_mortonX[TextureBuffer::s_blockSize]{ 0, 1, 4, 5, 16, 17, 20, 21 };
+static constexpr uint8 s_mortonY[TextureBuffer::s_blockSize]{ 0, 2, 8, 10, 32, 34, 40, 42 };
+
+TextureBuffer::TextureBuffer()
+	: _pixels{ nullptr }
+	, _width{ 0 }
+	, _height{ 0 }
+	, _layout{ eTextureLayout::Linear }
+	, _blockColumns{ 0 }
+	, _tileColumns{ 0 }
+	, _tileRows{ 0 }
+	, _clearColor{ 0 }
+	, _isStorageOwned{ false }
+{
+
+}
+
+TextureBuffer::~TextureBuffer()
+{
+	Release();
+}
+
+void TextureBuffer::Create(uint32 width, uint32 height, eTextureLayout layout)
+{
+	GG_ASSERT(width != 0 && height != 0, "TextureBuffer size should't be zero!");
+
+	Release();
+
+	size_t size = GetStorageSize(width, height, layout);
+	initialize(width, height, layout, static_cast<uint32*>(::operator new[](size, std::align_val_t{ s_alignment })), true);
+}
+
+void TextureBuffer::Create(uint32 width, uint32 height, void* storage)
+{
+	GG_ASSERT(width != 0 && height != 0, "TextureBuffer size should't be zero!");
+	GG_ASSERT(storage != nullptr, "TextureBuffer storage is null!");
+
+	Release();
+
+	initialize(width, height, eTextureLayout::Linear, static_cast<uint32*>(storage), false);
+}
+
+void TextureBuffer::Release()
+{
+	if (_pixels && _isStorageOwned)
+	{
+		::operator delete[](_pixels, std::align_val_t{ s_alignment });
+	}
+	_pixels = nullptr;
+	_isStorageOwned = false;
+	_width = 0;
+	_height = 0;
+	_blockColumns = 0;
+	_tileColumns = 0;
+	_tileRows = 0;
+	_writtenTiles.clear();
+}
+
+void TextureBuffer::SetPixel(int32 row, int32 col, uint32 color)
+{
+	if (static_cast<uint32>(row) >= _height || static_cast<uint32>(col) >= _width)
+	{
+		return;
+	}
+
+	uint8& isWritten = _writtenTiles[(row / s_tileSize) * _tileColumns + col / s_tileSize];
+	if (!isWritten)
+	{
+		materializeTile(row / s_tileSize, col / s_tileSize);
+		isWritten = 1;
+	}
+	_pixels[pixelOffset(row, col)] = color;
+}
+
+void TextureBuffer::FillSpan(int32 row, int32 col, uint32 count, uint32 color)
+{
+	FillRect(row, col, count, 1, color);
+}
+
+void TextureBuffer::FillRect(int32 row, int32 col, uint32 width, uint32 height, uint32 color)
+{
+	uint32 skippedRows, skippedCols;
+	if (!clip(row, col, width, height, skippedRows, skippedCols))
+	{
+		return;
+	}
+
+	materialize(row, col, width, height, true);
+	fillPixels(row, col, width, height, color);
+}
+
+void TextureBuffer::WriteRow(int32 row, int32 col, const uint32* src, uint32 count)
+{
+	BlitRect(row, col, count, 1, src, count);
+}
+
+void TextureBuffer::BlitRect(int32 row, int32 col, uint32 width, uint32 height, const uint32* src, uint32 srcPitch)
+{
+	uint32 skippedRows, skippedCols;
+	if (!clip(row, col, width, height, skippedRows, skippedCols))
+	{
+		return;
+	}
+
+	src += static_cast<size_t>(skippedRows) * srcPitch + skippedCols;
+	materialize(row, col, width, height, true);
+	copyPixels(row, col, width, height, src, srcPitch);
+}
+
+void TextureBuffer::BlendSpan(int32 row, int32 col, uint32 count, uint32 color, eBlendMode mode, bool isGammaCorrect)
+{
+	BlendColorRect(row, col, count, 1, color, mode, isGammaCorrect);
+}
+
+void TextureBuffer::BlendColorRect(int32 row, int32 col, uint32 width, uint32 height, uint32 color, eBlendMode mode, bool isGammaCorrect)
+{
+	uint32 skippedRows, skippedCols;
+	if (!clip(row, col, width, height, skippedRows, skippedCols))
+	{
+		return;
+	}
+
+	materialize(row, col, width, height, false);
+	blendPixels(row, col, width, height, nullptr, 0, color, mode, isGammaCorrect);
+}
+
+void TextureBuffer::BlendRow(int32 row, int32 col, const uint32* src, uint32 count, eBlendMode mode, bool isGammaCorrect)
+{
+	BlendRect(row, col, count, 1, src, count, mode, isGammaCorrect);
+}
+
+void TextureBuffer::BlendRect(int32 row, int32 col, uint32 width, uint32 height, const uint32* src, uint32 srcPitch, eBlendMode mode, bool isGammaCorrect)
+{
+	uint32 skippedRows, skippedCols;
+	if (!clip(row, col, width, height, skippedRows, skippedCols))
+	{
+		return;
+	}
+
+	src += static_cast<size_t>(skippedRows) * srcPitch + skippedCols;
+	materialize(row, col, width, height, false);
+	blendPixels(row, col, width, height, src, srcPitch, 0, mode, isGammaCorrect);
+}
+
+void TextureBuffer::Clear(uint32 color)
+{
+	_clearColor = color;
+	std::fill(_writtenTiles.begin(), _writtenTiles.end(), 0);
+}
+
+uint32 TextureBuffer::GetPixel(int32 row, int32 col) const
+{
+	if (static_cast<uint32>(row) >= _height || static_cast<uint32>(col) >= _width)
+	{
+		return 0;
+	}
+	if (!_writtenTiles[(row / s_tileSize) * _tileColumns + col / s_tileSize])
+	{
+		return _clearColor;
+	}
+
+	return _pixels[pixelOffset(row, col)];
+}
+
+void TextureBuffer::Resolve(const TextureRegion& region, uint32* dst, uint32 dstPitch) const
+{
+	GG_ASSERT(region.x + region.width <= _width && region.y + region.height <= _height, "Region is out of the buffer!");
+
+	if (_layout == eTextureLayout::Linear)
+	{
+		PixelKernel::CopyRect(dst, dstPitch, _pixels + static_cast<size_t>(region.y) * _width + region.x, _width, region.width, region.height);
+		return;
+	}
+
+	const uint32 bottom = region.y + region.height;
+	const uint32 right = region.x + region.width;
+	for (uint32 blockRow = region.y / s_blockSize; blockRow * s_blockSize < bottom; blockRow++)
+	{
+		uint32 top = std::max(region.y, blockRow * s_blockSize);
+		uint32 blockBottom = std::min(bottom, (blockRow + 1) * s_blockSize);
+		for (uint32 blockCol = region.x / s_blockSize; blockCol * s_blockSize < right; blockCol++)
+		{
+			uint32 left = std::max(region.x, blockCol * s_blockSize);
+			uint32 blockRight = std::min(right, (blockCol + 1) * s_blockSize);
+			const uint32* block = _pixels + (static_cast<size_t>(blockRow) * _blockColumns + blockCol) * s_blockPixels;
+			uint32* out = dst + static_cast<size_t>(top - region.y) * dstPitch + (left - region.x);
+
+			if (blockBottom - top == s_blockSize && blockRight - left == s_blockSize)
+			{
+				PixelKernel::DetileBlock(out, dstPitch, block);
+				continue;
+			}
+
+			for (uint32 y = top; y < blockBottom; y++)
+			{
+				for (uint32 x = left; x < blockRight; x++)
+				{
+					out[(y - top) * dstPitch + (x - left)] = block[s_mortonY[y % s_blockSize] + s_mortonX[x % s_blockSize]];
+				}
+			}
+		}
+	}
+}
+
+void TextureBuffer::BuildRegions(const std::vector<uint8>& tileMask, std::vector<TextureRegion>& outRegions) const
+{
+	GG_ASSERT(tileMask.size() == GetTileCount(), "Tile mask doesn't match the buffer!");
+
+	// Rectangles that are still growing downwards, in tile units.
+	struct OpenRegion
+	{
+		uint32 beginCol;
+		uint32 endCol;
+		uint32 beginRow;
+	};
+	std::vector<OpenRegion> openRegions;
+	std::vector<OpenRegion> nextRegions;
+
+	auto closeRegion = [&](const OpenRegion& region, uint32 endRow) {
+		TextureRegion pixelRegion{};
+		pixelRegion.x = region.beginCol * s_tileSize;
+		pixelRegion.y = region.beginRow * s_tileSize;
+		pixelRegion.width = std::min(region.endCol * s_tileSize, _width) - pixelRegion.x;
+		pixelRegion.height = std::min(endRow * s_tileSize, _height) - pixelRegion.y;
+		outRegions.push_back(pixelRegion);
+	};
+
+	outRegions.clear();
+	for (uint32 tileRow = 0; tileRow <= _tileRows; tileRow++)
+	{
+		nextRegions.clear();
+		uint32 tileCol = 0;
+		while (tileRow < _tileRows && tileCol < _tileColumns)
+		{
+			if (!tileMask[tileRow * _tileColumns + tileCol])
+			{
+				tileCol++;
+				continue;
+			}
+
+			uint32 beginCol = tileCol;
+			while (tileCol < _tileColumns && tileMask[tileRow * _tileColumns + tileCol])
+			{
+				tileCol++;
+			}
+
+			// Extend the rectangle above if it spans exactly the same columns.
+			auto sameRun = std::find_if(openRegions.begin(), openRegions.end(), [&](const OpenRegion& region) {
+				return region.beginCol == beginCol && region.endCol == tileCol;
+				});
+			if (sameRun != openRegions.end())
+			{
+				nextRegions.push_back(*sameRun);
+				openRegions.erase(sameRun);
+			}
+			else
+			{
+				nextRegions.push_back(OpenRegion{ beginCol, tileCol, tileRow });
+			}
+		}
+
+		for (const auto& region : openRegions)
+		{
+			closeRegion(region, tileRow);
+		}
+		std::swap(openRegions, nextRegions);
+	}
+}
+
+bool TextureBuffer::clip(int32& row, int32& col, uint32& width, uint32& height, uint32& skippedRows, uint32& skippedCols) const
+{
+	int64 top = row;
+	int64 left = col;
+	int64 bottom = top + height;
+	int64 right = left + width;
+
+	skippedRows = top < 0 ? static_cast<uint32>(-top) : 0;
+	skippedCols = left < 0 ? static_cast<uint32>(-left) : 0;
+
+	top = std::max<int64>(top, 0);
+	left = std::max<int64>(left, 0);
+	bottom = std::min<int64>(bottom, _height);
+	right = std::min<int64>(right, _width);
+
+	if (top >= bottom || left >= right)
+	{
+		return false;
+	}
+
+	row = static_cast<int32>(top);
+	col = static_cast<int32>(left);
+	width = static_cast<uint32>(right - left);
+	height = static_cast<uint32>(bottom - top);
+
+	return true;
+}
+
+size_t TextureBuffer::GetStorageSize(uint32 width, uint32 height, eTextureLayout layout)
+{
+	if (layout == eTextureLayout::Tiled)
+	{
+		width = (width + s_blockSize - 1) / s_blockSize * s_blockSize;
+		height = (height + s_blockSize - 1) / s_blockSize * s_blockSize;
+	}
+
+	return static_cast<size_t>(width) * height * sizeof(uint32);
+}
+
+void TextureBuffer::initialize(uint32 width, uint32 height, eTextureLayout layout, uint32* pixels, bool isStorageOwned)
+{
+	_pixels = pixels;
+	_isStorageOwned = isStorageOwned;
+	_width = width;
+	_height = height;
+	_layout = layout;
+	_blockColumns = (width + s_blockSize - 1) / s_blockSize;
+	_tileColumns = (width + s_tileSize - 1) / s_tileSize;
+	_tileRows = (height + s_tileSize - 1) / s_tileSize;
+	_writtenTiles.assign(GetTileCount(), 0);
+	_clearColor = 0;
+}
+
+void TextureBuffer::materialize(uint32 row, uint32 col, uint32 width, uint32 height, bool isOverwritten)
+{
+	uint32 beginTileRow = row / s_tileSize;
+	uint32 endTileRow = (row + height - 1) / s_tileSize;
+	uint32 beginTileCol = col / s_tileSize;
+	uint32 endTileCol = (col + width - 1) / s_tileSize;
+
+	for (uint32 tileRow = beginTileRow; tileRow <= endTileRow; tileRow++)
+	{
+		uint32 tileTop = tileRow * s_tileSize;
+		uint32 tileBottom = std::min(tileTop + s_tileSize, _height);
+		bool isRowCovered = row <= tileTop && row + height >= tileBottom;
+
+		for (uint32 tileCol = beginTileCol; tileCol <= endTileCol; tileCol++)
+		{
+			uint8& isWritten = _writtenTiles[tileRow * _tileColumns + tileCol];
+			if (isWritten)
+			{
+				continue;
+			}
+
+			uint32 tileLeft = tileCol * s_tileSize;
+			uint32 tileRight = std::min(tileLeft + s_tileSize, _width);
+			if (!isOverwritten || !isRowCovered || col > tileLeft || col + width < tileRight)
+			{
+				materializeTile(tileRow, tileCol);
+			}
+			isWritten = 1;
+		}
+	}
+}
+
+void TextureBuffer::materializeTile(uint32 tileRow, uint32 tileCol)
+{
+	uint32 row = tileRow * s_tileSize;
+	uint32 col = tileCol * s_tileSize;
+	uint32 width = std::min(s_tileSize, _width - col);
+	uint32 height = std::min(s_tileSize, _height - row);
+	fillPixels(row, col, width, height, _clearColor);
+}
+
+void TextureBuffer::fillPixels(uint32 row, uint32 col, uint32 width, uint32 height, uint32 color)
+{
+	if (_layout == eTextureLayout::Linear)
+	{
+		PixelKernel::FillRect(_pixels + static_cast<size_t>(row) * _width + col, _width, width, height, color);
+		return;
+	}
+
+	const uint32 bottom = row + height;
+	const uint32 right = col + width;
+	for (uint32 blockRow = row / s_blockSize; blockRow * s_blockSize < bottom; blockRow++)
+	{
+		uint32 top = std::max(row, blockRow * s_blockSize) % s_blockSize;
+		uint32 blockBottom = std::min(bottom - blockRow * s_blockSize, s_blockSize);
+		uint32* blocks = _pixels + static_cast<size_t>(blockRow) * _blockColumns * s_blockPixels;
+
+		uint32 blockCol = col / s_blockSize;
+		while (blockCol * s_blockSize < right)
+		{
+			uint32 left = std::max(col, blockCol * s_blockSize) % s_blockSize;
+			uint32 blockRight = std::min(right - blockCol * s_blockSize, s_blockSize);
+
+			// Neighbouring blocks are contiguous, a run of whole blocks is a single fill.
+			if (top == 0 && blockBottom == s_blockSize && left == 0 && blockRight == s_blockSize)
+			{
+				uint32 endCol = blockCol + 1;
+				while ((endCol + 1) * s_blockSize <= right)
+				{
+					endCol++;
+				}
+				PixelKernel::Fill(blocks + blockCol * s_blockPixels, color, (endCol - blockCol) * s_blockPixels);
+				blockCol = endCol;
+				continue;
+			}
+
+			uint32* block = blocks + blockCol * s_blockPixels;
+			for (uint32 y = top; y < blockBottom; y++)
+			{
+				for (uint32 x = left; x < blockRight; x++)
+				{
+					block[s_mortonY[y] + s_mortonX[x]] = color;
+				}
+			}
+			blockCol++;
+		}
+	}
+}
+
+void TextureBuffer::copyPixels(uint32 row, uint32 col, uint32 width, uint32 height, const uint32* src, uint32 srcPitch)
+{
+	if (_layout == eTextureLayout::Linear)
+	{
+		PixelKernel::CopyRect(_pixels + static_cast<size_t>(row) * _width + col, _width, src, srcPitch, width, height);
+		return;
+	}
+
+	const uint32 bottom = row + height;
+	const uint32 right = col + width;
+	for (uint32 blockRow = row / s_blockSize; blockRow * s_blockSize < bottom; blockRow++)
+	{
+		uint32 top = std::max(row, blockRow * s_blockSize);
+		uint32 blockBottom = std::min(bottom, (blockRow + 1) * s_blockSize);
+		for (uint32 blockCol = col / s_blockSize; blockCol * s_blockSize < right; blockCol++)
+		{
+			uint32 left = std::max(col, blockCol * s_blockSize);
+			uint32 blockRight = std::min(right, (blockCol + 1) * s_blockSize);
+			uint32* block = _pixels + (static_cast<size_t>(blockRow) * _blockColumns + blockCol) * s_blockPixels;
+			const uint32* in = src + static_cast<size_t>(top - row) * srcPitch + (left - col);
+
+			if (blockBottom - top == s_blockSize && blockRight - left == s_blockSize)
+			{
+				PixelKernel::TileBlock(block, in, srcPitch);
+				continue;
+			}
+
+			for (uint32 y = top; y < blockBottom; y++)
+			{
+				for (uint32 x = left; x < blockRight; x++)
+				{
+					block[s_mortonY[y % s_blockSize] + s_mortonX[x % s_blockSize]] = in[(y - top) * srcPitch + (x - left)];
+				}
+			}
+		}
+	}
+}
+
+void TextureBuffer::blendPixels(uint32 row, uint32 col, uint32 width, uint32 height, const uint32* src, uint32 srcPitch, uint32 color, eBlendMode mode, bool isGammaCorrect)
+{
+	if (_layout == eTextureLayout::Linear)
+	{
+		uint32* dst = _pixels + static_cast<size_t>(row) * _width + col;
+		if (src)
+		{
+			PixelKernel::BlendRect(dst, _width, src, srcPitch, width, height, mode, isGammaCorrect);
+		}
+		else
+		{
+			PixelKernel::BlendColorRect(dst, _width, width, height, color, mode, isGammaCorrect);
+		}
+		return;
+	}
+
+	const uint32 bottom = row + height;
+	const uint32 right = col + width;
+	for (uint32 blockRow = row / s_blockSize; blockRow * s_blockSize < bottom; blockRow++)
+	{
+		uint32 top = std::max(row, blockRow * s_blockSize);
+		uint32 blockBottom = std::min(bottom, (blockRow + 1) * s_blockSize);
+		uint32* blocks = _pixels + static_cast<size_t>(blockRow) * _blockColumns * s_blockPixels;
+
+		uint32 blockCol = col / s_blockSize;
+		while (blockCol * s_blockSize < right)
+		{
+			uint32 left = std::max(col, blockCol * s_blockSize);
+			uint32 blockRight = std::min(right, (blockCol + 1) * s_blockSize);
+			uint32* block = blocks + blockCol * s_blockPixels;
+			const bool isWholeBlock = blockBottom - top == s_blockSize && blockRight - left == s_blockSize;
+
+			// A constant color doesn't care about the pixel order, a run of whole blocks is a single blend.
+			if (isWholeBlock && !src)
+			{
+				uint32 endCol = blockCol + 1;
+				while ((endCol + 1) * s_blockSize <= right)
+				{
+					endCol++;
+				}
+				PixelKernel::BlendColor(block, color, (endCol - blockCol) * s_blockPixels, mode, isGammaCorrect);
+				blockCol = endCol;
+				continue;
+			}
+
+			const uint32* in = src ? src + static_cast<size_t>(top - row) * srcPitch + (left - col) : nullptr;
+			if (isWholeBlock)
+			{
+				uint32 tiled[s_blockPixels];
+				PixelKernel::TileBlock(tiled, in, srcPitch);
+				PixelKernel::Blend(block, tiled, s_blockPixels, mode, isGammaCorrect);
+				blockCol++;
+				continue;
+			}
+
+			// Partial blocks gather the covered pixels into a run, blend it with a single call and scatter it back.
+			uint32 run[s_blockPixels];
+			uint32 runSrc[s_blockPixels];
+			uint32 count = 0;
+			for (uint32 y = top; y < blockBottom; y++)
+			{
+				const uint32 rowOffset = s_mortonY[y % s_blockSize];
+				for (uint32 x = left; x < blockRight; x++)
+				{
+					run[count] = block[rowOffset + s_mortonX[x % s_blockSize]];
+					if (in)
+					{
+						runSrc[count] = in[(y - top) * srcPitch + (x - left)];
+					}
+					count++;
+				}
+			}
+			if (in)
+			{
+				PixelKernel::Blend(run, runSrc, count, mode, isGammaCorrect);
+			}
+			else
+			{
+				PixelKernel::BlendColor(run, color, count, mode, isGammaCorrect);
+			}
+			count = 0;
+			for (uint32 y = top; y < blockBottom; y++)
+			{
+				const uint32 rowOffset = s_mortonY[y % s_blockSize];
+				for (uint32 x = left; x < blockRight; x++)
+				{
+					block[rowOffset + s_mortonX[x % s_blockSize]] = run[count++];
+				}
+			}
+			blockCol++;
+		}
+	}
+}
+
+size_t TextureBuffer::pixelOffset(uint32 row, uint32 col) const
+{
+	if (_layout == eTextureLayout::Linear)
+	{
+		return static_cast<size_t>(row) * _width + col;
+	}
+
+	size_t block = static_cast<size_t>(row / s_blockSize) * _blockColumns + col / s_blockSize;
+
+	return block * s_blockPixels + s_mortonY[row % s_blockSize] + s_mortonX[col % s_blockSize];
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,154 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "Base.hpp"
+
+#include "Core/Log.h"
+#include "Graphics/PixelKernel.h"
+
+namespace GG {
+
+// Linear is plain row-major, the layout the GPU upload expects.
+// Tiled stores 8x8 blocks row by row with the pixels of each block in Morton order,
+// so a small 2D footprint touches a few cache lines instead of one line per row.
+enum class eTextureLayout
+{
+	Linear,
+	Tiled,
+};
+
+// Pixel rectangle inside a TextureBuffer.
+struct TextureRegion
+{
+	uint32 x;
+	uint32 y;
+	uint32 width;
+	uint32 height;
+};
+
+// CPU side RGBA8 render target which is uploaded to the GPU texture every frame.
+// Every write path clips once per call and works on whole 32-bit pixels.
+// Written pixels are tracked per s_tileSize x s_tileSize tile so only touched tiles are uploaded.
+// Clearing is lazy: Clear() only resets the tile flags, the first write into a tile fills it with the clear color.
+// Pixels of tiles which aren't written are undefined, read them as GetClearColor().
+// Every write path works on both layouts, Resolve() reads a region back in linear layout.
+class TextureBuffer
+{
+public:
+	static constexpr uint32			s_tileSize = 64;
+	// Edge of a block in the tiled layout.
+	static constexpr uint32			s_blockSize = 8;
+
+	TextureBuffer();
+	~TextureBuffer();
+
+	TextureBuffer(const TextureBuffer&) = delete;
+	TextureBuffer& operator=(const TextureBuffer&) = delete;
+
+	void Create(uint32 width, uint32 height, eTextureLayout layout = eTextureLayout::Linear);
+	// Builds a linear buffer on top of storage (at least width * height * 4 bytes) instead of allocating, e.g. mapped staging memory.
+	void Create(uint32 width, uint32 height, void* storage);
+	void Release();
+
+	void SetPixel(int32 row, int32 col, uint32 color);
+	void FillSpan(int32 row, int32 col, uint32 count, uint32 color);
+	void FillRect(int32 row, int32 col, uint32 width, uint32 height, uint32 color);
+	void WriteRow(int32 row, int32 col, const uint32* src, uint32 count);
+	// srcPitch is in pixels.
+	void BlitRect(int32 row, int32 col, uint32 width, uint32 height, const uint32* src, uint32 srcPitch);
+	// Blending writes of premultiplied colors, see PixelKernel::Blend(). Pixels of unwritten tiles blend over the clear color.
+	void BlendSpan(int32 row, int32 col, uint32 count, uint32 color, eBlendMode mode, bool isGammaCorrect = false);
+	void BlendColorRect(int32 row, int32 col, uint32 width, uint32 height, uint32 color, eBlendMode mode, bool isGammaCorrect = false);
+	void BlendRow(int32 row, int32 col, const uint32* src, uint32 count, eBlendMode mode, bool isGammaCorrect = false);
+	void BlendRect(int32 row, int32 col, uint32 width, uint32 height, const uint32* src, uint32 srcPitch, eBlendMode mode, bool isGammaCorrect = false);
+	// O(tiles), no pixel is touched until it's written again.
+	void Clear(uint32 color = 0);
+
+	// Raw block access for rasterizers. Marks the tile holding the s_blockSize block at (row, col), both multiples of s_blockSize, as written
+	// and returns its first pixel. The block is stored as 8 runs of 8 contiguous pixels, run i starts at i * GetBlockRunPitch():
+	// the block's rows in the linear layout, 4x2 pixel groups in Morton order in the tiled one.
+	// Runs of blocks on the right edge of a linear buffer continue into the next row, callers have to clip them.
+	inline uint32* GetBlockForWrite(uint32 row, uint32 col);
+	inline uint32 GetBlockRunPitch() const { return _layout == eTextureLayout::Linear ? _width : s_blockSize; }
+
+	// Returns the clear color for pixels of unwritten tiles and 0 outside of the buffer.
+	uint32 GetPixel(int32 row, int32 col) const;
+	// Copies a region of written tiles out in linear layout, dstPitch is in pixels.
+	void Resolve(const TextureRegion& region, uint32* dst, uint32 dstPitch) const;
+
+	// Merges the tiles set in tileMask into horizontal runs and stacks equal runs into rectangles.
+	void BuildRegions(const std::vector<uint8>& tileMask, std::vector<TextureRegion>& outRegions) const;
+
+	inline uint32 GetWidth() const { return _width; }
+	inline uint32 GetHeight() const { return _height; }
+	inline eTextureLayout GetLayout() const { return _layout; }
+	// Bytes of storage, the tiled layout pads the size to whole blocks.
+	inline size_t GetSize() const { return GetStorageSize(_width, _height, _layout); }
+	// Raw storage in the buffer's layout.
+	inline const uint32* GetData() const { return _pixels; }
+	inline uint32* GetData() { return _pixels; }
+	inline bool IsCreated() const { return _pixels != nullptr; }
+	inline uint32 GetClearColor() const { return _clearColor; }
+
+	inline uint32 GetTileColumnCount() const { return _tileColumns; }
+	inline uint32 GetTileRowCount() const { return _tileRows; }
+	inline uint32 GetTileCount() const { return _tileColumns * _tileRows; }
+	// One byte per tile, non-zero if the tile was written since the last clear.
+	inline const std::vector<uint8>& GetWrittenTiles() const { return _writtenTiles; }
+
+	static size_t GetStorageSize(uint32 width, uint32 height, eTextureLayout layout);
+
+private:
+	// Clips the rectangle against the buffer and returns how many leading rows/columns were cut off.
+	bool clip(int32& row, int32& col, uint32& width, uint32& height, uint32& skippedRows, uint32& skippedCols) const;
+	// Fills the untouched tiles covered by an already clipped rectangle with the clear color and marks them written.
+	// Tiles the rectangle covers completely are only marked when isOverwritten, the caller overwrites them anyway.
+	void materialize(uint32 row, uint32 col, uint32 width, uint32 height, bool isOverwritten);
+	void materializeTile(uint32 tileRow, uint32 tileCol);
+	void initialize(uint32 width, uint32 height, eTextureLayout layout, uint32* pixels, bool isStorageOwned);
+
+	// Raw writes of an already clipped rectangle in the buffer's layout.
+	void fillPixels(uint32 row, uint32 col, uint32 width, uint32 height, uint32 color);
+	void copyPixels(uint32 row, uint32 col, uint32 width, uint32 height, const uint32* src, uint32 srcPitch);
+	// Blends src, or color if src is null.
+	void blendPixels(uint32 row, uint32 col, uint32 width, uint32 height, const uint32* src, uint32 srcPitch, uint32 color, eBlendMode mode, bool isGammaCorrect);
+	size_t pixelOffset(uint32 row, uint32 col) const;
+
+	static constexpr size_t			s_alignment = 64;
+
+	uint32*							_pixels;
+	uint32							_width;
+	uint32							_height;
+	eTextureLayout					_layout;
+	uint32							_blockColumns;
+	uint32							_tileColumns;
+	uint32							_tileRows;
+	uint32							_clearColor;
+	bool							_isStorageOwned;
+
+	std::vector<uint8>				_writtenTiles;
+};
+
+// Inline since rasterizers call it for every block they touch.
+inline uint32* TextureBuffer::GetBlockForWrite(uint32 row, uint32 col)
+{
+	GG_ASSERT(row % s_blockSize == 0 && col % s_blockSize == 0 && row < _height && col < _width, "Block is out of the buffer!");
+
+	uint8& isWritten = _writtenTiles[(row / s_tileSize) * _tileColumns + col / s_tileSize];
+	if (!isWritten)
+	{
+		materializeTile(row / s_tileSize, col / s_tileSize);
+		isWritten = 1;
+	}
+
+	if (_layout == eTextureLayout::Linear)
+	{
+		return _pixels + static_cast<size_t>(row) * _width + col;
+	}
+
+	return _pixels + (static_cast<size_t>(row / s_blockSize) * _blockColumns + col / s_blockSize) * s_blockSize * s_blockSize;
+}
+
+}
\ No newline at end of file
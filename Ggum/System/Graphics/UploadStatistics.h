@@ -0,0 +1,18 @@
+#pragma once
+
+#include "Base.hpp"
+
+namespace GG {
+
+// Per frame counters of the CPU framebuffer upload.
+struct UploadStatistics
+{
+	uint32 dirtyTileCount = 0;
+	// Dirty tiles which only needed the clear color, they are copied from one shared clear strip.
+	uint32 clearedTileCount = 0;
+	uint32 totalTileCount = 0;
+	uint32 regionCount = 0;
+	uint64 uploadedBytes = 0;
+};
+
+}
\ No newline at end of file
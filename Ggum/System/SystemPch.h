@@ -20,7 +20,8 @@
 #include <tchar.h>
 
 #else
-#error GG Only Support Windows!
+#include <cstdlib>
+#include <cstring>
 #endif
 
 #include <iostream>
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <chrono>
+#include <thread>
+
+#include "Base.hpp"
+
+namespace GG {
+
+// 64-bit tick source in nanoseconds. Frame scheduling goes through it so it can run on a fake clock.
+class IClock
+{
+public:
+	static constexpr uint64 s_ticksPerSecond = 1000000000ull;
+
+	virtual ~IClock() {}
+
+	// Monotonic, the origin is arbitrary.
+	virtual uint64 GetTicks() const = 0;
+	// Sleeps about ticks, the OS may oversleep.
+	virtual void Sleep(uint64 ticks) = 0;
+	// One iteration of a busy wait.
+	virtual void SpinWait() = 0;
+
+	static inline double ToSeconds(uint64 ticks) { return static_cast<double>(ticks) / s_ticksPerSecond; }
+	static inline uint64 FromSeconds(double seconds) { return static_cast<uint64>(seconds * s_ticksPerSecond + 0.5); }
+};
+
+class SteadyClock : public IClock
+{
+public:
+	virtual uint64 GetTicks() const override
+	{
+		return static_cast<uint64>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+	}
+
+	virtual void Sleep(uint64 ticks) override { std::this_thread::sleep_for(std::chrono::nanoseconds(ticks)); }
+	virtual void SpinWait() override { std::this_thread::yield(); }
+};
+
+}
\ No newline at end of file
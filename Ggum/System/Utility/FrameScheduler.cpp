@@ -0,0 +1,133 @@
+#include "SystemPch.h"
+#include "FrameScheduler.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace GG {
+
+FrameScheduler::FrameScheduler(IClock& clock)
+	: _clock{ clock }
+{
+	Reset();
+}
+
+void FrameScheduler::SetFixedTimestep(uint64 stepTicks)
+{
+	_stepTicks = stepTicks;
+	_accumulatedTicks = 0;
+}
+
+void FrameScheduler::SetMaxStepsPerFrame(uint32 count)
+{
+	GG_ASSERT(count > 0, "A frame needs at least one step!");
+
+	_maxStepsPerFrame = count;
+}
+
+void FrameScheduler::SetTargetFrameTicks(uint64 ticks)
+{
+	_targetFrameTicks = ticks;
+	_deadline = _clock.GetTicks();
+}
+
+void FrameScheduler::Reset()
+{
+	_frameIndex = 0;
+	_accumulatedTicks = 0;
+	_isStarted = false;
+	_lastFrameTicks = _clock.GetTicks();
+	_deadline = _lastFrameTicks;
+	// Until slices are measured, assume a coarse OS timer.
+	_sleepCount = 0;
+	_sleepMean = 0.0;
+	_sleepVariance = 0.0;
+	_sleepEstimate = 2 * s_sleepSliceTicks;
+}
+
+FrameTiming FrameScheduler::BeginFrame()
+{
+	const uint64 now = _clock.GetTicks();
+	const uint64 frameTicks = _isStarted ? now - _lastFrameTicks : 0;
+	_lastFrameTicks = now;
+	if (!_isStarted)
+	{
+		_deadline = now;
+		_isStarted = true;
+	}
+
+	FrameTiming timing{};
+	timing.frameIndex = _frameIndex++;
+	timing.frameTicks = frameTicks;
+	if (_stepTicks == 0)
+	{
+		timing.stepCount = 1;
+		timing.stepSeconds = static_cast<float>(IClock::ToSeconds(frameTicks));
+		timing.alpha = 1.0f;
+		return timing;
+	}
+
+	const uint64 maxTicks = _stepTicks * _maxStepsPerFrame;
+	_accumulatedTicks += std::min(frameTicks, maxTicks);
+	timing.stepCount = static_cast<uint32>(std::min<uint64>(_accumulatedTicks / _stepTicks, _maxStepsPerFrame));
+	_accumulatedTicks -= timing.stepCount * _stepTicks;
+	// A capped frame drops what it couldn't simulate instead of carrying it into the next one.
+	_accumulatedTicks = std::min(_accumulatedTicks, _stepTicks - 1);
+	timing.stepSeconds = static_cast<float>(IClock::ToSeconds(_stepTicks));
+	timing.alpha = static_cast<float>(static_cast<double>(_accumulatedTicks) / _stepTicks);
+
+	return timing;
+}
+
+void FrameScheduler::WaitForNextFrame()
+{
+	if (_targetFrameTicks == 0)
+	{
+		return;
+	}
+
+	_deadline += _targetFrameTicks;
+	uint64 now = _clock.GetTicks();
+	if (now >= _deadline)
+	{
+		// More than a frame behind, the schedule restarts from now instead of rushing frames to catch up.
+		if (now - _deadline >= _targetFrameTicks)
+		{
+			_deadline = now;
+		}
+		return;
+	}
+
+	while (_deadline - now > _sleepEstimate)
+	{
+		const uint64 start = now;
+		_clock.Sleep(s_sleepSliceTicks);
+		now = _clock.GetTicks();
+		observeSleep(now - start);
+		if (now >= _deadline)
+		{
+			return;
+		}
+	}
+
+	while (_clock.GetTicks() < _deadline)
+	{
+		_clock.SpinWait();
+	}
+}
+
+void FrameScheduler::observeSleep(uint64 ticks)
+{
+	// Past the window the average turns exponential, so the estimate follows changes of the OS timer resolution.
+	static constexpr uint64 s_sleepWindow = 256;
+
+	_sleepCount = std::min(_sleepCount + 1, s_sleepWindow);
+	const double weight = 1.0 / _sleepCount;
+	const double delta = static_cast<double>(ticks) - _sleepMean;
+	_sleepMean += weight * delta;
+	_sleepVariance = (1.0 - weight) * (_sleepVariance + weight * delta * delta);
+	// Capped, a coarse timer or a preempted slice must not push the estimate past the frame and turn every wait into a spin.
+	_sleepEstimate = std::min(static_cast<uint64>(_sleepMean + std::sqrt(_sleepVariance)), s_maxSleepEstimateTicks);
+}
+
+}
\ No newline at end of file
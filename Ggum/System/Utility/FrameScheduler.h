@@ -0,0 +1,76 @@
+#pragma once
+
+#include "Base.hpp"
+
+#include "Core/Log.h"
+#include "Utility/Clock.hpp"
+
+namespace GG {
+
+struct FrameTiming
+{
+	uint64 frameIndex;
+	// Ticks since the previous frame began, 0 for the first frame.
+	uint64 frameTicks;
+	// Updates to run this frame, each advancing the simulation by stepSeconds.
+	// Without a fixed timestep it's a single step of the frame's time.
+	uint32 stepCount;
+	float stepSeconds;
+	// Fraction of a step which passed but isn't simulated yet, render between the previous and the latest state with it.
+	// Always 1 without a fixed timestep.
+	float alpha;
+};
+
+// Fixed timestep accumulator and frame limiter on 64-bit ticks, so the precision doesn't drop in long running processes.
+// The limiter sleeps in short slices while the remaining time is above the measured oversleep, then spins to the deadline.
+class FrameScheduler
+{
+public:
+	explicit FrameScheduler(IClock& clock);
+	~FrameScheduler() = default;
+
+	// 0 advances the simulation by the frame's time in one step (the default).
+	void SetFixedTimestep(uint64 stepTicks);
+	// Caps the steps of a frame after a stall, the rest of the time is dropped instead of simulated.
+	void SetMaxStepsPerFrame(uint32 count);
+	// Minimum time between two frames, 0 doesn't limit (the default).
+	void SetTargetFrameTicks(uint64 ticks);
+
+	// Starts over from now, the next BeginFrame() is a first frame.
+	void Reset();
+	FrameTiming BeginFrame();
+	// Returns at the target time of the next frame, right away without a target or when the frame ran late.
+	void WaitForNextFrame();
+
+	inline uint64 GetFixedTimestep() const { return _stepTicks; }
+	inline uint64 GetTargetFrameTicks() const { return _targetFrameTicks; }
+	// Expected duration of one sleep slice including the OS oversleep, mean plus one deviation, at most 4 slices.
+	inline uint64 GetSleepEstimate() const { return _sleepEstimate; }
+
+private:
+	void observeSleep(uint64 ticks);
+
+	// Sleeps are requested in slices this long so the estimate tracks the OS timer granularity.
+	static constexpr uint64	s_sleepSliceTicks = IClock::s_ticksPerSecond / 1000;
+	// Remaining time above this always sleeps, whatever slices were measured.
+	static constexpr uint64	s_maxSleepEstimateTicks = 4 * s_sleepSliceTicks;
+
+	IClock&	_clock;
+	uint64	_stepTicks = 0;
+	uint32	_maxStepsPerFrame = 8;
+	uint64	_targetFrameTicks = 0;
+
+	uint64	_frameIndex = 0;
+	uint64	_lastFrameTicks = 0;
+	uint64	_accumulatedTicks = 0;
+	uint64	_deadline = 0;
+	bool	_isStarted = false;
+
+	// Running mean and variance of the slices slept so far.
+	uint64	_sleepCount = 0;
+	double	_sleepMean = 0.0;
+	double	_sleepVariance = 0.0;
+	uint64	_sleepEstimate = 0;
+};
+
+}
\ No newline at end of file
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cmath>
+
+#include "Base.hpp"
+
+namespace GG {
+
+// Row-major 4x4 matrix for column vectors: clip = matrix * (x, y, z, 1).
+struct Matrix4
+{
+	float m[4][4];
+
+	static Matrix4 Identity()
+	{
+		return Matrix4{ {
+			{ 1.0f, 0.0f, 0.0f, 0.0f },
+			{ 0.0f, 1.0f, 0.0f, 0.0f },
+			{ 0.0f, 0.0f, 1.0f, 0.0f },
+			{ 0.0f, 0.0f, 0.0f, 1.0f },
+		} };
+	}
+
+	static Matrix4 Translation(float x, float y, float z)
+	{
+		Matrix4 result = Identity();
+		result.m[0][3] = x;
+		result.m[1][3] = y;
+		result.m[2][3] = z;
+
+		return result;
+	}
+
+	static Matrix4 RotationX(float radians)
+	{
+		const float c = std::cos(radians);
+		const float s = std::sin(radians);
+		Matrix4 result = Identity();
+		result.m[1][1] = c;
+		result.m[1][2] = -s;
+		result.m[2][1] = s;
+		result.m[2][2] = c;
+
+		return result;
+	}
+
+	static Matrix4 RotationY(float radians)
+	{
+		const float c = std::cos(radians);
+		const float s = std::sin(radians);
+		Matrix4 result = Identity();
+		result.m[0][0] = c;
+		result.m[0][2] = s;
+		result.m[2][0] = -s;
+		result.m[2][2] = c;
+
+		return result;
+	}
+
+	// Right-handed view space looking down -z, Vulkan clip space: y points down and depth goes from 0 at nearZ to 1 at farZ.
+	static Matrix4 Perspective(float fovY, float aspect, float nearZ, float farZ)
+	{
+		const float focal = 1.0f / std::tan(fovY * 0.5f);
+		Matrix4 result{};
+		result.m[0][0] = focal / aspect;
+		result.m[1][1] = -focal;
+		result.m[2][2] = farZ / (nearZ - farZ);
+		result.m[2][3] = nearZ * farZ / (nearZ - farZ);
+		result.m[3][2] = -1.0f;
+
+		return result;
+	}
+
+	Matrix4 operator*(const Matrix4& rhs) const
+	{
+		Matrix4 result{};
+		for (uint32 row = 0; row < 4; row++)
+		{
+			for (uint32 col = 0; col < 4; col++)
+			{
+				for (uint32 i = 0; i < 4; i++)
+				{
+					result.m[row][col] += m[row][i] * rhs.m[i][col];
+				}
+			}
+		}
+
+		return result;
+	}
+};
+
+}
\ No newline at end of file
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <immintrin.h>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+#include "Base.hpp"
+
+// MSVC can emit AVX2 intrinsics in any function, GCC/Clang need the target attribute.
+#if defined(_MSC_VER)
+	#define GG_TARGET_AVX2
+#else
+	#define GG_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#endif
+
+namespace GG {
+namespace Simd {
+
+// SSE2 is always available on x64, so only AVX2 is checked at runtime, along with FMA which GG_TARGET_AVX2 also enables.
+inline bool IsAVX2Supported()
+{
+	static const bool s_isSupported = []() -> bool {
+#if defined(_MSC_VER)
+		int info[4]{};
+		::__cpuid(info, 1);
+		const bool isOSXSaveSupported = (info[2] & BIT(27)) != 0;
+		const bool isAVXSupported = (info[2] & BIT(28)) != 0;
+		const bool isFMASupported = (info[2] & BIT(12)) != 0;
+		if (!isOSXSaveSupported || !isAVXSupported || !isFMASupported)
+		{
+			return false;
+		}
+		// OS must save YMM registers on context switch.
+		if ((::_xgetbv(0) & 0x6) != 0x6)
+		{
+			return false;
+		}
+		::__cpuidex(info, 7, 0);
+
+		return (info[1] & BIT(5)) != 0;
+#else
+		return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#endif
+	}();
+
+	return s_isSupported;
+}
+
+// Index of the lowest set bit, value can't be 0.
+inline uint32 CountTrailingZeros(uint64 value)
+{
+#if defined(_MSC_VER)
+	unsigned long index;
+	::_BitScanForward64(&index, value);
+
+	return static_cast<uint32>(index);
+#else
+	return static_cast<uint32>(__builtin_ctzll(value));
+#endif
+}
+
+inline uint32 CountBits(uint64 value)
+{
+#if defined(_MSC_VER)
+	// __popcnt64 needs POPCNT, which x64 doesn't guarantee.
+	value = value - ((value >> 1) & 0x5555555555555555ull);
+	value = (value & 0x3333333333333333ull) + ((value >> 2) & 0x3333333333333333ull);
+	value = (value + (value >> 4)) & 0x0F0F0F0F0F0F0F0Full;
+
+	return static_cast<uint32>((value * 0x0101010101010101ull) >> 56);
+#else
+	return static_cast<uint32>(__builtin_popcountll(value));
+#endif
+}
+
+}
+}
\ No newline at end of file
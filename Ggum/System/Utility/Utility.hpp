@@ -1,11 +1,19 @@
 #pragma once
 
 #include <string>
+#include <utility>
+
+#include "Base.hpp"
+
+#ifdef GG_PLATFORM_WINDOWS
 #include <stringapiset.h>
+#endif
 
 namespace GG {
 namespace Utility {
 
+#ifdef GG_PLATFORM_WINDOWS
+
 inline std::wstring string_to_wstring(const std::string& str)
 {
 	int len = ::MultiByteToWideChar(CP_ACP, 0, str.c_str(), static_cast<int>(str.length()), nullptr, 0);
@@ -29,6 +37,7 @@ inline std::string wstring_to_string(const std::wstring& wstr)
 
 	return str;
 }
+#endif
 
 inline void swap_endian(void* data, size_t size)
 {
@@ -1,15 +1,29 @@
 #pragma once
 
 
+#include "Base.hpp"
+
 #include "Core/Log.h"
-#include "Core/Window.h"
 #include "Core/Input.h"
+#include "Core/JobSystem.h"
+#include "Core/Profiler.h"
 
 #include "Core/Event/KeyEvent.hpp"
 #include "Core/Event/MouseEvent.hpp"
 #include "Core/Event/ApplicationEvent.hpp"
 
+#include "Graphics/TextureBuffer.h"
+#include "Graphics/DepthBuffer.h"
+#include "Graphics/MultisampleBuffer.h"
+#include "Graphics/Texture2D.h"
+#include "Graphics/UploadStatistics.h"
+
+#ifdef GG_WINDOWED_BACKEND
+#include "Core/Window.h"
 #include "Graphics/GraphicsAPI.h"
+#endif
 
 #include "Utility/Timer.hpp"
+#include "Utility/Clock.hpp"
+#include "Utility/FrameScheduler.h"
 #include "Utility/Random.hpp"